@@ -0,0 +1,331 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qbinarylog_p.h"
+
+#include <QtCore/qatomic.h>
+#include <QtCore/qcoreapplication.h>
+#include <QtCore/qdatetime.h>
+#include <QtCore/qelapsedtimer.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qvarlengtharray.h>
+#include <QtCore/private/qlocking_p.h>
+#include <QtCore/private/qstringconverter_p.h>
+
+#include <atomic>
+#include <cstring>
+#include <iterator>
+
+QT_BEGIN_NAMESPACE
+
+using namespace QtPrivate::BinaryLog;
+
+/*!
+    \internal
+    \class QBinaryLogWriter
+    \inmodule QtCore
+
+    QBinaryLogWriter records log messages in a compact binary file, to be
+    turned into text later, e.g. with the qtlogdecode tool. Writing a
+    message costs little more than copying it: the file is memory-mapped
+    and threads reserve space in it with an atomic counter, and neither the
+    message pattern nor any I/O is involved.
+
+    The file has a fixed capacity, reserved on creation; messages that don't
+    fit any more are dropped and counted. finish() truncates the file to what
+    was used, and so does destroying the writer. If the application crashes,
+    the file keeps the messages completed until then.
+
+    The default message handler uses a writer if the QT_LOGGING_BINARY
+    environment variable names a file.
+*/
+
+class QBinaryLogWriterPrivate
+{
+public:
+    QFile file;
+    uchar *base = nullptr;
+    quint64 capacity = 0;
+    QElapsedTimer clock;
+    QAtomicInteger<quint64> used = 0;
+    QAtomicInteger<quint64> dropped = 0;
+    QAtomicInteger<bool> finished = false;
+    const int serial;
+
+    QBasicMutex mutex;
+    QHash<QByteArray, quint32> ids;
+    quint32 nextId = 1;
+
+    QBinaryLogWriterPrivate()
+        : serial(nextSerial.fetchAndAddRelaxed(1))
+    {}
+
+    uchar *reserve(quint64 size) noexcept;
+    static void commit(uchar *record, quint32 size) noexcept;
+    quint32 intern(const char *string);
+
+    static QBasicAtomicInt nextSerial;
+};
+
+Q_CONSTINIT QBasicAtomicInt QBinaryLogWriterPrivate::nextSerial = Q_BASIC_ATOMIC_INITIALIZER(1);
+
+uchar *QBinaryLogWriterPrivate::reserve(quint64 size) noexcept
+{
+    const quint64 offset = used.fetchAndAddRelaxed(size);
+    if (offset + size > capacity)
+        return nullptr;
+    return base + offset;
+}
+
+void QBinaryLogWriterPrivate::commit(uchar *record, quint32 size) noexcept
+{
+    // The size marks the record as complete, so it must be written last.
+    std::atomic_thread_fence(std::memory_order_release);
+    reinterpret_cast<RecordHeader *>(record)->size = size;
+}
+
+quint32 QBinaryLogWriterPrivate::intern(const char *string)
+{
+    if (!string)
+        return 0;
+
+    // Categories, file and function names are almost always literals, so
+    // look their ids up by address first. Other strings may have been freed
+    // since, and their address reused for different contents, so a hit must
+    // also match the contents of the string interned; those are owned by
+    // the writer. Key by writer, in case there is more than one during the
+    // lifetime of the thread. The cache must be trivially destructible:
+    // messages can still be logged by static destructors, after the main
+    // thread's thread_local objects are gone.
+    struct CacheEntry
+    {
+        const char *string;
+        const char *interned;
+        quint32 id;
+        int serial;
+    };
+    static thread_local CacheEntry cache[64];
+    CacheEntry &entry = cache[(quintptr(string) >> 3) % std::size(cache)];
+    if (entry.string == string && entry.serial == serial && strcmp(entry.interned, string) == 0)
+        return entry.id;
+
+    const QByteArray key(string);
+    quint32 id;
+    const char *interned;
+    {
+        const auto locker = qt_scoped_lock(mutex);
+        auto it = ids.find(key);
+        if (it != ids.end()) {
+            id = it.value();
+        } else {
+            const auto length = quint32(key.size());
+            const quint32 size = alignedSize(sizeof(StringRecord) + length);
+            uchar *record = reserve(size);
+            if (!record)
+                return 0;
+            id = nextId++;
+            auto header = reinterpret_cast<StringRecord *>(record);
+            header->header.type = RecordType::String;
+            header->id = id;
+            header->length = length;
+            memcpy(record + sizeof(StringRecord), key.constData(), length);
+            commit(record, size);
+            it = ids.insert(key, id);
+        }
+        // the hash never removes anything, so the key stays put
+        interned = it.key().constData();
+    }
+    entry = { string, interned, id, serial };
+    return id;
+}
+
+/*!
+    \internal
+    Creates the file \a fileName, or overwrites it, and reserves \a capacity
+    bytes in it. Use isOpen() to find out whether that worked.
+*/
+QBinaryLogWriter::QBinaryLogWriter(const QString &fileName, qint64 capacity)
+    : d(new QBinaryLogWriterPrivate)
+{
+    d->file.setFileName(fileName);
+    if (capacity < qint64(sizeof(FileHeader)) || !d->file.open(QIODevice::ReadWrite | QIODevice::Truncate)
+            || !d->file.resize(capacity)) {
+        return;
+    }
+    d->base = d->file.map(0, capacity);
+    if (!d->base)
+        return;
+
+    d->capacity = quint64(capacity);
+    auto header = reinterpret_cast<FileHeader *>(d->base);
+    memcpy(header->magic, Magic, sizeof Magic);
+    header->version = Version;
+    header->headerSize = sizeof(FileHeader);
+    header->startTime = QDateTime::currentMSecsSinceEpoch();
+    header->pid = QCoreApplication::applicationPid();
+    d->used.storeRelaxed(sizeof(FileHeader));
+    d->clock.start();
+}
+
+/*!
+    \internal
+    Finishes the file, then unmaps and closes it. No other thread may be
+    writing at this point; see finish().
+*/
+QBinaryLogWriter::~QBinaryLogWriter()
+{
+    if (d->base) {
+        finish();
+        d->file.unmap(d->base);
+    }
+    delete d;
+}
+
+/*!
+    \internal
+    Completes the file and truncates it to the size used. Messages written
+    afterwards are dropped. The file stays mapped, so this is safe while other
+    threads are still writing messages.
+*/
+void QBinaryLogWriter::finish()
+{
+    if (!d->base || d->finished.fetchAndStoreRelaxed(true))
+        return;
+
+    // Push the counter beyond the capacity, so that every further
+    // reservation fails. Those that succeeded before all end below the
+    // value it had; writing them may still be going on.
+    const quint64 used = qMin(d->used.fetchAndAddRelaxed(d->capacity), d->capacity);
+    auto header = reinterpret_cast<FileHeader *>(d->base);
+    header->used = used;
+    header->dropped = d->dropped.loadRelaxed();
+    d->file.resize(qint64(used));
+}
+
+bool QBinaryLogWriter::isOpen() const noexcept
+{
+    return d->base != nullptr;
+}
+
+QString QBinaryLogWriter::errorString() const
+{
+    return d->file.errorString();
+}
+
+/*!
+    \internal
+    Records \a message, of type \a type, with the category, file, line and
+    function of \a context and \a threadId. This function is thread-safe.
+*/
+void QBinaryLogWriter::write(QtMsgType type, const QMessageLogContext &context,
+                             QStringView message, quint64 threadId)
+{
+    if (!d->base)
+        return;
+
+    const auto time = quint64(d->clock.nsecsElapsed());
+    const quint32 category = d->intern(context.category);
+    const quint32 file = d->intern(context.file);
+    const quint32 function = d->intern(context.function);
+
+    QVarLengthArray<char, 512> text(message.size() * 3);
+    QStringConverter::State state;
+    const auto length = quint32(QUtf8::convertFromUnicode(text.data(), message, &state)
+                                - text.data());
+
+    const quint64 size = alignedSize(sizeof(MessageRecord) + quint64(length));
+    uchar *record = d->reserve(size);
+    if (!record) {
+        d->dropped.fetchAndAddRelaxed(1);
+        return;
+    }
+    auto header = reinterpret_cast<MessageRecord *>(record);
+    header->header.type = RecordType::Message;
+    header->header.msgType = quint8(type);
+    header->category = category;
+    header->file = file;
+    header->function = function;
+    header->line = context.line;
+    header->time = time;
+    header->threadId = threadId;
+    header->length = length;
+    memcpy(record + sizeof(MessageRecord), text.constData(), length);
+    d->commit(record, quint32(size));
+}
+
+/*!
+    \internal
+    Returns the number of messages that didn't fit into the file.
+*/
+quint64 QBinaryLogWriter::dropped() const noexcept
+{
+    return d->dropped.loadRelaxed();
+}
+
+/*!
+    \internal
+    \class QBinaryLogReader
+    \inmodule QtCore
+
+    Reads the contents of a file written by QBinaryLogWriter, as given by
+    \a data. Reading stops at the first incomplete or damaged record.
+*/
+QBinaryLogReader::QBinaryLogReader(const QByteArray &data)
+{
+    FileHeader header;
+    if (size_t(data.size()) < sizeof header)
+        return;
+    memcpy(&header, data.constData(), sizeof header);
+    if (memcmp(header.magic, Magic, sizeof Magic) != 0 || header.version != Version
+            || header.headerSize < sizeof header || header.headerSize > quint64(data.size())) {
+        return;
+    }
+    valid = true;
+    start = header.startTime;
+    pid = header.pid;
+    droppedCount = header.dropped;
+
+    // A file left behind by a crash has no size in the header.
+    quint64 end = quint64(data.size());
+    if (header.used)
+        end = qMin(end, header.used);
+
+    QHash<quint32, QByteArray> strings;
+    const char *base = data.constData();
+    for (quint64 offset = header.headerSize; offset + sizeof(RecordHeader) <= end; ) {
+        RecordHeader record;
+        memcpy(&record, base + offset, sizeof record);
+        if (record.size < sizeof record || record.size % 8 || offset + record.size > end)
+            break;
+
+        if (record.type == RecordType::String && record.size >= sizeof(StringRecord)) {
+            StringRecord string;
+            memcpy(&string, base + offset, sizeof string);
+            if (sizeof string + string.length > record.size)
+                break;
+            strings.insert(string.id, QByteArray(base + offset + sizeof string, string.length));
+        } else if (record.type == RecordType::Message && record.size >= sizeof(MessageRecord)) {
+            MessageRecord message;
+            memcpy(&message, base + offset, sizeof message);
+            if (sizeof message + message.length > record.size)
+                break;
+            Entry entry;
+            entry.type = QtMsgType(message.header.msgType);
+            entry.category = strings.value(message.category);
+            entry.file = strings.value(message.file);
+            entry.function = strings.value(message.function);
+            entry.line = message.line;
+            entry.time = qint64(message.time);
+            entry.threadId = message.threadId;
+            entry.message = QString::fromUtf8(base + offset + sizeof message, message.length);
+            list.append(std::move(entry));
+        } else {
+            break;
+        }
+        offset += record.size;
+    }
+}
+
+QT_END_NAMESPACE
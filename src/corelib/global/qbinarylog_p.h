@@ -0,0 +1,151 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QBINARYLOG_P_H
+#define QBINARYLOG_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qbytearray.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qlogging.h>
+#include <QtCore/qstring.h>
+
+QT_BEGIN_NAMESPACE
+
+class QFile;
+
+namespace QtPrivate::BinaryLog {
+/*
+    The file starts with a FileHeader, followed by records, each of which
+    starts with a RecordHeader and is padded to a multiple of 8 bytes. All
+    numbers are in the byte order of the machine that wrote the file.
+
+    Strings that repeat, i.e. categories, file and function names, are
+    written once, in a String record, and referred to by id; id 0 is the
+    null string. A String record always precedes the records using it.
+
+    A record's size is written last, so a record with size 0 is one that
+    was never completed, e.g. because the application crashed; reading
+    stops there.
+*/
+constexpr char Magic[8] = { 'Q', 'T', 'B', 'I', 'N', 'L', 'O', 'G' };
+constexpr quint32 Version = 1;
+
+struct FileHeader
+{
+    char magic[8];
+    quint32 version;
+    quint32 headerSize;
+    qint64 startTime;       // ms since the epoch, UTC
+    qint64 pid;
+    quint64 used;           // bytes in use, including this header
+    quint64 dropped;        // messages that didn't fit into the file
+    quint64 reserved[2];
+};
+static_assert(sizeof(FileHeader) == 64);
+
+enum class RecordType : quint8 { String = 1, Message = 2 };
+
+struct RecordHeader
+{
+    quint32 size;           // including this header and the padding
+    RecordType type;
+    quint8 msgType;         // QtMsgType, for Message records
+    quint16 reserved;
+};
+
+struct StringRecord
+{
+    RecordHeader header;
+    quint32 id;
+    quint32 length;
+    // followed by length bytes of UTF-8
+};
+
+struct MessageRecord
+{
+    RecordHeader header;
+    quint32 category;
+    quint32 file;
+    quint32 function;
+    qint32 line;
+    quint64 time;           // ns since FileHeader::startTime
+    quint64 threadId;
+    quint32 length;
+    quint32 padding;
+    // followed by length bytes of UTF-8
+};
+static_assert(sizeof(MessageRecord) % 8 == 0);
+
+constexpr quint32 alignedSize(quint64 size)
+{
+    return quint32((size + 7) & ~quint64(7));
+}
+} // namespace QtPrivate::BinaryLog
+
+class QBinaryLogWriterPrivate;
+
+class Q_CORE_EXPORT QBinaryLogWriter
+{
+public:
+    QBinaryLogWriter(const QString &fileName, qint64 capacity);
+    ~QBinaryLogWriter();
+    Q_DISABLE_COPY_MOVE(QBinaryLogWriter)
+
+    bool isOpen() const noexcept;
+    QString errorString() const;
+
+    void write(QtMsgType type, const QMessageLogContext &context, QStringView message,
+               quint64 threadId);
+    void finish();
+    quint64 dropped() const noexcept;
+
+private:
+    QBinaryLogWriterPrivate *d;
+};
+
+class Q_CORE_EXPORT QBinaryLogReader
+{
+public:
+    struct Entry
+    {
+        QtMsgType type = QtDebugMsg;
+        QByteArray category;
+        QByteArray file;
+        QByteArray function;
+        int line = 0;
+        qint64 time = 0;        // ns since startTime()
+        quint64 threadId = 0;
+        QString message;
+    };
+
+    explicit QBinaryLogReader(const QByteArray &data);
+
+    bool isValid() const noexcept { return valid; }
+    qint64 startTime() const noexcept { return start; }
+    qint64 processId() const noexcept { return pid; }
+    quint64 dropped() const noexcept { return droppedCount; }
+    const QList<Entry> &entries() const noexcept { return list; }
+
+private:
+    QList<Entry> list;
+    qint64 start = 0;
+    qint64 pid = 0;
+    quint64 droppedCount = 0;
+    bool valid = false;
+};
+
+QT_END_NAMESPACE
+
+#endif // QBINARYLOG_P_H
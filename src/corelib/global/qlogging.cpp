@@ -21,6 +21,10 @@
 #include "qdatetime.h"
 #include "qcoreapplication.h"
 #include "qthread.h"
+#if QT_CONFIG(thread)
+#include "qsemaphore.h"
+#endif
+#include "private/qbinarylog_p.h"
 #include "private/qloggingregistry_p.h"
 #include "private/qcoreapplication_p.h"
 #include <qtcore_tracepoints_p.h>
@@ -58,6 +62,7 @@
 # include <sys/types.h>
 # include <sys/stat.h>
 # include <unistd.h>
+# include <pthread.h>
 # include "private/qcore_unix_p.h"
 #endif
 
@@ -123,6 +128,9 @@ static QT_PREPEND_NAMESPACE(qint64) qt_gettid()
 #include <algorithm>
 #include <memory>
 #include <vector>
+#if !defined(QT_BOOTSTRAPPED) && QT_CONFIG(thread)
+#include <thread>
+#endif
 
 #include <stdio.h>
 
@@ -1957,6 +1965,233 @@ static bool wasm_default_message_handler(QtMsgType type,
 
 // --------------------------------------------------------------------------
 
+#if !defined(QT_BOOTSTRAPPED) && QT_CONFIG(thread)
+namespace {
+/*
+    Writes the messages meant for stderr on a thread of its own, so that
+    threads logging a lot don't stall on the I/O. Enabled by setting
+    QT_LOGGING_ASYNC to "block" (or "1"), in which case a thread logging
+    into a full queue waits for room, or to "drop", in which case such
+    messages are dropped and counted, and the count is reported.
+
+    Messages are still formatted by the thread logging them, as the pattern
+    may refer to it; only the encoded text is queued. The queue is a ring of
+    slots claimed with an atomic counter, so loggers don't take a lock; the
+    semaphores only block when the queue is full or empty. The queue is
+    drained before a fatal message aborts the application and on exit.
+
+    The writer is a plain std::thread: a QThread would log and set up thread
+    data of its own, neither of which is welcome inside the message handler.
+
+    A child process created with fork() has no writer thread, and messages
+    queued by the parent are the parent's to write. So the child abandons
+    the queue and writes synchronously, like without QT_LOGGING_ASYNC.
+*/
+class AsyncStderrWriter
+{
+public:
+    enum OverflowPolicy { Block, Drop };
+
+    AsyncStderrWriter();
+    ~AsyncStderrWriter();
+    Q_DISABLE_COPY_MOVE(AsyncStderrWriter)
+
+    bool isRunning() const noexcept { return thread && !stopping.loadRelaxed(); }
+    void post(QByteArray &&text);
+    void flush();
+    QtPrivate::AsyncLoggingStatistics statistics() const noexcept;
+
+private:
+    static constexpr quint64 Capacity = 4096; // must be a power of two
+
+    struct Slot
+    {
+        QByteArray text;
+        QAtomicInteger<bool> ready = false;
+    };
+
+    void run();
+    QByteArray takeSlot(quint64 pos);
+    static void write(const QByteArray &text);
+#ifdef Q_OS_UNIX
+    static void childAfterFork();
+#endif
+
+    std::unique_ptr<Slot[]> ring;
+    QSemaphore freeSlots;
+    QSemaphore usedSlots;
+    QAtomicInteger<quint64> head = 0;       // next slot to claim
+    QAtomicInteger<quint64> written = 0;    // messages taken off the queue
+    QAtomicInteger<quint64> dropped = 0;
+    QAtomicInteger<quint64> maxQueued = 0;
+    QAtomicInteger<bool> stopping = false;
+    OverflowPolicy policy = Block;
+    std::unique_ptr<std::thread> thread;
+};
+
+AsyncStderrWriter::AsyncStderrWriter()
+{
+    const QByteArray value = qgetenv("QT_LOGGING_ASYNC").trimmed().toLower();
+    if (value == "block" || value == "1")
+        policy = Block;
+    else if (value == "drop")
+        policy = Drop;
+    else
+        return;
+
+    QT_TRY {
+        ring.reset(new Slot[Capacity]);
+        freeSlots.release(int(Capacity));
+        thread = std::make_unique<std::thread>([this] { run(); });
+    } QT_CATCH(...) {
+        // no thread, no queue: write synchronously
+        return;
+    }
+#ifdef Q_OS_UNIX
+    pthread_atfork(nullptr, nullptr, &AsyncStderrWriter::childAfterFork);
+#endif
+}
+
+AsyncStderrWriter::~AsyncStderrWriter()
+{
+    if (!thread)
+        return;
+    stopping.storeRelease(true);
+    usedSlots.release();   // wake the writer up, with one token too many
+    thread->join();
+
+    // Messages posted concurrently with the shutdown, if any:
+    for (quint64 pos = written.loadRelaxed(), end = head.loadAcquire(); pos < end; ++pos)
+        write(takeSlot(pos));
+}
+
+void AsyncStderrWriter::post(QByteArray &&text)
+{
+    if (policy == Block) {
+        freeSlots.acquire();
+    } else if (!freeSlots.tryAcquire()) {
+        dropped.fetchAndAddRelaxed(1);
+        return;
+    }
+
+    const quint64 pos = head.fetchAndAddRelaxed(1);
+    Slot &slot = ring[pos & (Capacity - 1)];
+    slot.text = std::move(text);
+    slot.ready.storeRelease(true);
+    usedSlots.release();
+
+    // The writer may well have taken this and later messages off already:
+    const quint64 done = written.loadRelaxed();
+    const quint64 queued = pos < done ? 0 : pos + 1 - done;
+    quint64 max = maxQueued.loadRelaxed();
+    while (queued > max && !maxQueued.testAndSetRelaxed(max, queued, max))
+        ;
+}
+
+QByteArray AsyncStderrWriter::takeSlot(quint64 pos)
+{
+    Slot &slot = ring[pos & (Capacity - 1)];
+    // The slot has been claimed, but its logger may not have filled it yet.
+    while (!slot.ready.loadAcquire())
+        std::this_thread::yield();
+    QByteArray text = std::move(slot.text);
+    slot.text = QByteArray();
+    slot.ready.storeRelaxed(false);
+    return text;
+}
+
+void AsyncStderrWriter::write(const QByteArray &text)
+{
+    fwrite(text.constData(), 1, size_t(text.size()), stderr);
+}
+
+void AsyncStderrWriter::run()
+{
+    quint64 pos = 0;
+    quint64 reportedDrops = 0;
+    QByteArray batch;
+    for (bool stop = false; !stop; ) {
+        usedSlots.acquire();
+        int count = 1;
+        if (int more = usedSlots.available(); more > 0 && usedSlots.tryAcquire(more))
+            count += more;
+
+        // Write everything that is ready in one go:
+        int taken = 0;
+        for (; taken < count; ++taken) {
+            if (pos == head.loadAcquire()) {
+                // the token the destructor released
+                Q_ASSERT(stopping.loadRelaxed());
+                stop = true;
+                break;
+            }
+            batch += takeSlot(pos++);
+        }
+        if (const quint64 drops = dropped.loadRelaxed(); drops != reportedDrops) {
+            batch += "qt.core.logging: " + QByteArray::number(drops - reportedDrops)
+                    + " messages dropped\n";
+            reportedDrops = drops;
+        }
+        write(batch);
+        fflush(stderr);
+        batch.clear();
+
+        written.storeRelease(pos);
+        if (taken)
+            freeSlots.release(taken);
+    }
+}
+
+void AsyncStderrWriter::flush()
+{
+    if (!isRunning() || thread->get_id() == std::this_thread::get_id())
+        return;
+    const quint64 target = head.loadAcquire();
+    while (written.loadAcquire() < target && !stopping.loadAcquire())
+        std::this_thread::yield();
+}
+
+QtPrivate::AsyncLoggingStatistics AsyncStderrWriter::statistics() const noexcept
+{
+    return { written.loadRelaxed(), dropped.loadRelaxed(), maxQueued.loadRelaxed() };
+}
+} // unnamed namespace
+
+Q_GLOBAL_STATIC(AsyncStderrWriter, asyncStderrWriter)
+
+#ifdef Q_OS_UNIX
+void AsyncStderrWriter::childAfterFork()
+{
+    AsyncStderrWriter *writer = asyncStderrWriter();
+    if (!writer || !writer->thread)
+        return;
+    // The thread doesn't exist in this process, so it can neither be joined
+    // nor detached; forget about it without touching it.
+    Q_UNUSED(writer->thread.release());
+}
+#endif
+
+/*!
+    \internal
+    Returns the counters of the asynchronous stderr writer enabled by
+    QT_LOGGING_ASYNC; all are zero if it isn't enabled.
+*/
+QtPrivate::AsyncLoggingStatistics QtPrivate::asyncLoggingStatistics()
+{
+    if (AsyncStderrWriter *writer = asyncStderrWriter())
+        return writer->statistics();
+    return {};
+}
+
+static void flushAsyncStderrWriter()
+{
+    if (AsyncStderrWriter *writer = asyncStderrWriter())
+        writer->flush();
+}
+#else
+static void flushAsyncStderrWriter() { }
+#endif // !QT_BOOTSTRAPPED && QT_CONFIG(thread)
+
 static void stderr_message_handler(QtMsgType type, const QMessageLogContext &context,
                                    const QString &formattedMessage)
 {
@@ -1967,6 +2202,16 @@ static void stderr_message_handler(QtMsgType type, const QMessageLogContext &con
     // (still print empty lines, e.g. because message itself was empty)
     if (formattedMessage.isNull())
         return;
+#if !defined(QT_BOOTSTRAPPED) && QT_CONFIG(thread)
+    if (AsyncStderrWriter *writer = asyncStderrWriter(); writer && writer->isRunning()) {
+        // A fatal message is the last one, make sure it gets out:
+        if (type != QtFatalMsg) {
+            writer->post(formattedMessage.toLocal8Bit() + '\n');
+            return;
+        }
+        writer->flush();
+    }
+#endif
     fprintf(stderr, "%s\n", formattedMessage.toLocal8Bit().constData());
     fflush(stderr);
 }
@@ -2014,12 +2259,67 @@ QT_WARNING_POP
     stderr_message_handler(type, context, formattedMessage);
 }
 
+#ifndef QT_BOOTSTRAPPED
+namespace {
+struct BinaryLogFile
+{
+    // Never deleted: threads that aren't joined on exit may still be logging
+    // after this object is destroyed, so the file must stay mapped.
+    QBinaryLogWriter *writer = nullptr;
+
+    BinaryLogFile()
+    {
+        QString fileName = qEnvironmentVariable("QT_LOGGING_BINARY");
+        if (fileName.isEmpty())
+            return;
+        // Child processes inherit the variable. Each process needs a file of
+        // its own, or a child would truncate the file its parent has mapped.
+        const QString pid = QString::number(QCoreApplication::applicationPid());
+        if (fileName.contains("%p"_L1))
+            fileName.replace("%p"_L1, pid);
+        else
+            fileName += u'.' + pid;
+
+        bool ok;
+        int megabytes = qEnvironmentVariableIntValue("QT_LOGGING_BINARY_SIZE", &ok);
+        if (!ok || megabytes <= 0)
+            megabytes = 64;
+        auto w = std::make_unique<QBinaryLogWriter>(fileName, qint64(megabytes) << 20);
+        if (!w->isOpen()) {
+            fprintf(stderr, "QT_LOGGING_BINARY: Cannot write %s: %s\n",
+                    qPrintable(fileName), qPrintable(w->errorString()));
+            return;
+        }
+        writer = w.release();
+    }
+
+    ~BinaryLogFile()
+    {
+        if (writer)
+            writer->finish();
+    }
+};
+}
+
+Q_GLOBAL_STATIC(BinaryLogFile, binaryLogFile)
+#endif // !QT_BOOTSTRAPPED
+
 /*!
     \internal
 */
 static void qDefaultMessageHandler(QtMsgType type, const QMessageLogContext &context,
                                    const QString &message)
 {
+#ifndef QT_BOOTSTRAPPED
+    // Messages for the binary log are formatted when it is decoded; a fatal
+    // message is also printed, as the application is about to go away.
+    if (BinaryLogFile *binary = binaryLogFile(); binary && binary->writer) {
+        binary->writer->write(type, context, message, quint64(qt_gettid()));
+        if (type != QtFatalMsg)
+            return;
+    }
+#endif
+
     // A message sink logs the message to a structured or unstructured destination,
     // optionally formatting the message if the latter, and returns true if the sink
     // handled stderr output as well, which will shortcut our default stderr output.
@@ -2088,6 +2388,9 @@ static void qt_message_print(QtMsgType msgType, const QMessageLogContext &contex
 template <typename String>
 static void qt_message_fatal(QtMsgType, const QMessageLogContext &context, String &&message)
 {
+    // Don't lose the messages leading up to this one
+    flushAsyncStderrWriter();
+
 #if defined(Q_CC_MSVC_ONLY) && defined(QT_DEBUG) && defined(_DEBUG) && defined(_CRT_ERROR)
     wchar_t contextFileL[256];
     // we probably should let the compiler do this for us, by declaring QMessageLogContext::file to
@@ -2313,6 +2616,23 @@ void qErrnoWarning(int code, const char *msg, ...)
 
     Custom message handlers can use qFormatLogMessage() to take \a pattern into account.
 
+    By default, messages printed to \c stderr are written by the thread logging
+    them. If the QT_LOGGING_ASYNC environment variable is set to \c block, a
+    separate thread writes them instead, and threads logging only wait when
+    several thousand messages are queued. If it is set to \c drop, they never
+    wait; messages that don't fit into the queue are dropped, and how many were
+    dropped is reported. Queued messages are written before the application
+    exits or aborts on a fatal message.
+
+    If the QT_LOGGING_BINARY environment variable names a file, the default
+    message handler records messages in that file, in a binary format, instead
+    of printing them. This is much cheaper than formatting and printing them;
+    the qtlogdecode tool turns the file into text later. The file holds up to
+    64 MB of messages, or as many megabytes as QT_LOGGING_BINARY_SIZE says.
+    Every process writes a file of its own: \c{%p} in the name is replaced by
+    the process ID, and if there is none, a dot and the process ID are
+    appended to the name.
+
     \sa qInstallMessageHandler(), {Debugging Techniques}, {QLoggingCategory}, QMessageLogContext
  */
 
@@ -39,6 +39,17 @@ namespace QtPrivate {
 
 Q_CORE_EXPORT bool shouldLogToStderr();
 
+#if !defined(QT_BOOTSTRAPPED) && QT_CONFIG(thread)
+struct AsyncLoggingStatistics
+{
+    quint64 written = 0;    // messages handed to stderr
+    quint64 dropped = 0;    // messages dropped because the queue was full
+    quint64 maxQueued = 0;  // the highest number of messages waiting
+};
+
+Q_CORE_EXPORT AsyncLoggingStatistics asyncLoggingStatistics();
+#endif
+
 }
 
 class QInternalMessageLogContext : public QMessageLogContext
@@ -116,6 +116,7 @@
 */
 
 #include "qdirlisting.h"
+#include "qdirlisting_p.h"
 #include "qdirentryinfo_p.h"
 
 #include "qdir_p.h"
@@ -132,6 +133,13 @@
 #include <QtCore/private/qfilesystemengine_p.h>
 #include <QtCore/private/qfileinfo_p.h>
 #include <QtCore/private/qduplicatetracker_p.h>
+#include <QtCore/private/qlocking_p.h>
+
+#include <QtCore/qmutex.h>
+#if QT_CONFIG(thread)
+#include <QtCore/qthreadpool.h>
+#endif
+#include <QtCore/qwaitcondition.h>
 
 #include <memory>
 #include <vector>
@@ -155,6 +163,8 @@ static QDirListing::IteratorFlags toDirListingFlags(QDirIterator::IteratorFlags
     return listerFlags;
 }
 
+class QParallelDirListing;
+
 class QDirListingPrivate
 {
 public:
@@ -166,10 +176,19 @@ public:
     void pushDirectory(QDirEntryInfo &info);
     void pushInitialDirectory();
 
+#ifndef QT_NO_FILESYSTEMITERATOR
+    void pushNativeIterator(QDirEntryInfo &info);
+#endif
+
     void checkAndPushDirectory(QDirEntryInfo &info);
     bool matchesFilters(QDirEntryInfo &data) const;
     bool hasIterators() const;
 
+    static void forEachParallel(const QString &path, const QStringList &nameFilters,
+                                QDirListing::IteratorFlags flags,
+                                qxp::function_ref<void(const QDirListing::DirEntry &)> callback,
+                                QThreadPool *pool);
+
     bool matchesLegacyFilters(QDirEntryInfo &data) const;
     void setLegacyFilters(QDir::Filters dirFilters, QDirIterator::IteratorFlags dirIteratorFlags)
     {
@@ -207,8 +226,49 @@ public:
 
     // Loop protection
     QDuplicateTracker<QString> visitedLinks;
+
+    // Set when listing a single directory of a parallel recursive listing
+    QParallelDirListing *parallel = nullptr;
 };
 
+#ifndef QT_NO_FILESYSTEMITERATOR
+/*!
+    \internal
+
+    Shares a listing among threads: each thread lists one directory at a
+    time, with a QDirListingPrivate of its own, and queues the
+    subdirectories it finds for any thread to pick up.
+*/
+class QParallelDirListing
+{
+public:
+    using Callback = qxp::function_ref<void(const QDirListing::DirEntry &)>;
+
+    QParallelDirListing(const QStringList &nameFilters, QDirListing::IteratorFlags flags,
+                        Callback callback)
+        : nameFilters(nameFilters), iteratorFlags(flags), callback(callback)
+    {}
+
+    void push(const QDirEntryInfo &entryInfo);
+    void run(bool caller);
+
+    const QStringList nameFilters;
+    const QDirListing::IteratorFlags iteratorFlags;
+    const Callback callback;
+#if QT_CONFIG(thread)
+    QThreadPool *pool = nullptr;
+    int maxWorkers = 0;
+#endif
+
+    QMutex mutex;
+    QWaitCondition condition;
+    std::vector<QDirEntryInfo> pending;
+    int busy = 0;       // threads listing a directory
+    int workers = 0;    // threads started in the pool
+    QDuplicateTracker<QString> visitedLinks;
+};
+#endif // QT_NO_FILESYSTEMITERATOR
+
 void QDirListingPrivate::init(bool resolveEngine = true)
 {
     if (nameFilters.contains("*"_L1))
@@ -257,6 +317,11 @@ void QDirListingPrivate::beginIterating()
 
 void QDirListingPrivate::pushDirectory(QDirEntryInfo &entryInfo)
 {
+#ifndef QT_NO_FILESYSTEMITERATOR
+    if (parallel)
+        return parallel->push(entryInfo);
+#endif
+
     const QString path = [&entryInfo] {
 #ifdef Q_OS_WIN
         if (entryInfo.isSymLink())
@@ -281,18 +346,25 @@ void QDirListingPrivate::pushDirectory(QDirEntryInfo &entryInfo)
         }
     } else {
 #ifndef QT_NO_FILESYSTEMITERATOR
-        QFileSystemEntry *fentry = nullptr;
-        if (entryInfo.fileInfoOpt)
-            fentry = &entryInfo.fileInfoOpt->d_ptr->fileEntry;
-        else
-            fentry = &entryInfo.entry;
-        nativeIterators.emplace_back(std::make_unique<QFileSystemIterator>(*fentry, iteratorFlags));
+        pushNativeIterator(entryInfo);
 #else
         qWarning("Qt was built with -no-feature-filesystemiterator: no files/plugins will be found!");
 #endif
     }
 }
 
+#ifndef QT_NO_FILESYSTEMITERATOR
+void QDirListingPrivate::pushNativeIterator(QDirEntryInfo &entryInfo)
+{
+    QFileSystemEntry *fentry = nullptr;
+    if (entryInfo.fileInfoOpt)
+        fentry = &entryInfo.fileInfoOpt->d_ptr->fileEntry;
+    else
+        fentry = &entryInfo.entry;
+    nativeIterators.emplace_back(std::make_unique<QFileSystemIterator>(*fentry, iteratorFlags));
+}
+#endif
+
 bool QDirListingPrivate::entryMatches(QDirEntryInfo &entryInfo)
 {
     checkAndPushDirectory(entryInfo);
@@ -539,6 +611,144 @@ bool QDirListingPrivate::hasIterators() const
     return false;
 }
 
+#ifndef QT_NO_FILESYSTEMITERATOR
+/*!
+    \internal
+
+    Queues the directory \a entryInfo, and starts another thread in the pool
+    for it if there is one to spare right now. Otherwise, the threads already
+    at work pick it up: waiting for the pool could deadlock when all of its
+    threads are listing, e.g. from nested calls.
+*/
+void QParallelDirListing::push(const QDirEntryInfo &entryInfo)
+{
+    using F = QDirListing::IteratorFlag;
+    const bool followLinks = iteratorFlags.testAnyFlags(F::FollowDirSymlinks);
+    QDirEntryInfo info = entryInfo;
+    const QString canonicalPath = followLinks ? info.canonicalFilePath() : QString();
+
+    const auto locker = qt_scoped_lock(mutex);
+    // Stop link loops
+    if (followLinks && visitedLinks.hasSeen(canonicalPath))
+        return;
+    pending.push_back(std::move(info));
+#if QT_CONFIG(thread)
+    // The first directory is for the calling thread
+    if (busy && workers < maxWorkers) {
+        // Only count threads that actually start, as the caller waits for
+        // them to return
+        if (pool->tryStart([this] { run(false); }))
+            ++workers;
+    }
+#endif
+    condition.wakeOne();
+}
+
+/*!
+    \internal
+
+    Lists queued directories until there are none left. The calling thread,
+    \a caller, also waits until the other threads are done; the threads in
+    the pool return as soon as they find nothing to do.
+*/
+void QParallelDirListing::run(bool caller)
+{
+    QDirListingPrivate lister;
+    lister.nameFilters = nameFilters;
+    lister.iteratorFlags = iteratorFlags;
+    lister.init(false);
+    lister.parallel = this;
+    QDirListing::DirEntry dirEntry;
+    dirEntry.dirListPtr = &lister;
+
+    auto locker = qt_unique_lock(mutex);
+    for (;;) {
+        if (pending.empty()) {
+            if (!caller) {
+                --workers;
+                condition.wakeOne();
+                return;
+            }
+            if (!busy && !workers)
+                return;
+            condition.wait(&mutex);
+            continue;
+        }
+
+        QDirEntryInfo entryInfo = std::move(pending.back());
+        pending.pop_back();
+        ++busy;
+        locker.unlock();
+
+        lister.pushNativeIterator(entryInfo);
+        for (lister.advance(); lister.hasIterators(); lister.advance())
+            callback(dirEntry);
+
+        locker.lock();
+        if (!--busy)
+            condition.wakeOne();
+    }
+}
+#endif // QT_NO_FILESYSTEMITERATOR
+
+/*!
+    \internal
+
+    Lists the entries in \a path like QDirListing would with \a nameFilters
+    and \a flags, and calls \a callback for each of them. With
+    QDirListing::IteratorFlag::Recursive, the subdirectories are listed in
+    parallel, by the calling thread and threads from \a pool, or from
+    QThreadPool::globalInstance() if \a pool is \nullptr.
+
+    \a callback is called from several threads at once, and must be
+    thread-safe. The entries of any one directory are passed to it one after
+    the other, from the same thread, but in no particular order otherwise.
+    The DirEntry it is passed is only valid during the call.
+
+    This function returns when all entries have been listed. Directories
+    that Qt's own file system code doesn't handle, e.g. resources, are
+    listed by the calling thread alone.
+*/
+void QtPrivate::forEachDirEntryParallel(const QString &path, const QStringList &nameFilters,
+                                        QDirListing::IteratorFlags flags,
+                                        qxp::function_ref<void(const QDirListing::DirEntry &)> callback,
+                                        QThreadPool *pool)
+{
+    QDirListingPrivate::forEachParallel(path, nameFilters, flags, callback, pool);
+}
+
+void QDirListingPrivate::forEachParallel(const QString &path, const QStringList &nameFilters,
+                                         QDirListing::IteratorFlags flags,
+                                         qxp::function_ref<void(const QDirListing::DirEntry &)> callback,
+                                         QThreadPool *pool)
+{
+#ifndef QT_NO_FILESYSTEMITERATOR
+    QDirListingPrivate root;
+    root.initialEntryInfo.entry = QFileSystemEntry(path);
+    root.nameFilters = nameFilters;
+    root.iteratorFlags = flags;
+    root.init();
+    if (!root.engine) {
+        QParallelDirListing listing(root.nameFilters, flags, callback);
+#if QT_CONFIG(thread)
+        listing.pool = pool ? pool : QThreadPool::globalInstance();
+        // the calling thread is one of them
+        listing.maxWorkers = listing.pool->maxThreadCount() - 1;
+#else
+        Q_UNUSED(pool);
+#endif
+        listing.push(root.initialEntryInfo);
+        listing.run(true);
+        return;
+    }
+#else
+    Q_UNUSED(pool);
+#endif
+
+    for (const QDirListing::DirEntry &dirEntry : QDirListing(path, nameFilters, flags))
+        callback(dirEntry);
+}
+
 /*!
     Constructs a QDirListing that can iterate over \a path.
 
@@ -56,6 +56,7 @@ public:
     class Q_CORE_EXPORT DirEntry
     {
         friend class QDirListing;
+        friend class QParallelDirListing;
         QDirListingPrivate *dirListPtr = nullptr;
     public:
         QString fileName() const;
@@ -0,0 +1,36 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QDIRLISTING_P_H
+#define QDIRLISTING_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qdirlisting.h>
+#include <QtCore/qstringlist.h>
+#include <QtCore/qxpfunctional.h>
+
+QT_BEGIN_NAMESPACE
+
+class QThreadPool;
+
+namespace QtPrivate {
+Q_CORE_EXPORT void forEachDirEntryParallel(const QString &path, const QStringList &nameFilters,
+                                           QDirListing::IteratorFlags flags,
+                                           qxp::function_ref<void(const QDirListing::DirEntry &)> callback,
+                                           QThreadPool *pool = nullptr);
+} // namespace QtPrivate
+
+QT_END_NAMESPACE
+
+#endif // QDIRLISTING_P_H
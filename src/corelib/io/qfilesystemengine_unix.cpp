@@ -503,10 +503,18 @@ void QFileSystemMetaData::fillFromDirEnt(const QT_DIRENT &entry)
         }
     }
 #elif defined(_DIRENT_HAVE_D_TYPE) || defined(Q_OS_BSD4)
-    // BSD4 includes OS X and iOS
+    fillFromDirEntType(entry.d_type);
+#else
+    Q_UNUSED(entry);
+#endif
+}
 
+#if defined(_DIRENT_HAVE_D_TYPE) || defined(Q_OS_BSD4)
+// BSD4 includes OS X and iOS
+void QFileSystemMetaData::fillFromDirEntType(unsigned char type)
+{
     // ### This will clear all entry flags and knownFlagsMask
-    switch (entry.d_type)
+    switch (type)
     {
     case DT_DIR:
         knownFlagsMask = QFileSystemMetaData::LinkType
@@ -572,10 +580,8 @@ void QFileSystemMetaData::fillFromDirEnt(const QT_DIRENT &entry)
     default:
         clear();
     }
-#else
-    Q_UNUSED(entry);
-#endif
 }
+#endif
 
 //static
 QFileSystemEntry QFileSystemEngine::getLinkTarget(const QFileSystemEntry &link, QFileSystemMetaData &data)
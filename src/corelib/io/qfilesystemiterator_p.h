@@ -54,6 +54,15 @@ private:
     bool uncFallback;
     int uncShareIndex;
     bool onlyDirs;
+#else
+    bool toFileEntry(QByteArrayView name, QFileSystemEntry &fileEntry);
+
+#if defined(Q_OS_LINUX)
+    // Reads the directory with getdents64(2), in large batches
+    int dirFd = -1;
+    std::unique_ptr<char[]> buffer;
+    int bufferPos = 0;
+    int bufferEnd = 0;
 #else
     struct DirStreamCloser {
         void operator()(QT_DIR *dir) { if (dir) QT_CLOSEDIR(dir); }
@@ -62,6 +71,7 @@ private:
     DirPtr dir;
 
     QT_DIRENT *dirEntry = nullptr;
+#endif
     int lastError = 0;
     QStringDecoder toUtf16;
 #endif
@@ -1236,10 +1236,12 @@ QByteArray QIODevice::readAll()
 
     qint64 readBytes = (d->isSequential() ? Q_INT64_C(0) : size());
     if (readBytes == 0) {
-        // Size is unknown, read incrementally.
+        // Size is unknown, read incrementally. For sequential devices, start
+        // with everything that is already pending (which, for wrappers like
+        // QLocalSocket, includes the data buffered by the underlying device)
+        // so that large payloads are read in one go.
         qint64 readChunkSize = qMax(qint64(d->buffer.chunkSize()),
-                                    d->isSequential() ? (d->buffer.size() - d->transactionPos)
-                                                      : d->buffer.size());
+                                    d->isSequential() ? bytesAvailable() : d->buffer.size());
         qint64 readResult;
         do {
             if (readBytes + readChunkSize >= QByteArray::max_size()) {
@@ -0,0 +1,670 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qrecursivefilesystemwatcher_p.h"
+#include "qdirlisting_p.h"
+
+#include <QtCore/qbasictimer.h>
+#include <QtCore/qcache.h>
+#include <QtCore/qcoreevent.h>
+#include <QtCore/qdir.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qfileinfo.h>
+#include <QtCore/qfilesystemwatcher.h>
+#include <QtCore/qhash.h>
+#include <QtCore/qloggingcategory.h>
+#include <QtCore/qmap.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qset.h>
+#include <QtCore/qsocketnotifier.h>
+#include <QtCore/qvarlengtharray.h>
+#include <QtCore/private/qobject_p.h>
+
+#if defined(Q_OS_LINUX) && QT_CONFIG(inotify)
+#  define USE_INOTIFY
+#  include <QtCore/private/qcore_unix_p.h>
+#  include <sys/inotify.h>
+#  if __has_include(<sys/fanotify.h>)
+#    include <sys/fanotify.h>
+#    if defined(FAN_REPORT_DFID_NAME) && !defined(Q_OS_ANDROID)
+#      define USE_FANOTIFY
+#      include <fcntl.h>
+#      include <limits.h>
+#      include <sys/statfs.h>
+#    endif
+#  endif
+#endif
+
+QT_BEGIN_NAMESPACE
+
+using namespace std::chrono_literals;
+using namespace Qt::StringLiterals;
+
+Q_STATIC_LOGGING_CATEGORY(lcWatcher, "qt.core.filesystemwatcher")
+
+/*!
+    \internal
+    \class QRecursiveFileSystemWatcher
+    \inmodule QtCore
+
+    QRecursiveFileSystemWatcher watches whole directory trees, including
+    the subdirectories created while it watches, and reports changes in
+    batches: the paths that changed during interval() are collected, and
+    pathsChanged() is emitted once for all of them, at most once per
+    interval. A path is reported once per batch, no matter how often it
+    changed.
+
+    On Linux, if the process may use fanotify(7) on the file system, one
+    mark watches everything, however large the tree (Backend::Fanotify).
+    Otherwise, there is one inotify(7) watch for each directory
+    (Backend::Inotify); watchCount() tells how many. On other systems,
+    directories are watched with QFileSystemWatcher (Backend::Generic),
+    which doesn't report changes to the contents of files in all cases.
+
+    If the kernel drops events, e.g. because the application didn't read
+    them fast enough, the watched paths themselves are reported, and the
+    receiver needs to scan them again.
+*/
+
+class QRecursiveFileSystemWatcherPrivate : public QObjectPrivate
+{
+    Q_DECLARE_PUBLIC(QRecursiveFileSystemWatcher)
+
+public:
+    using Backend = QRecursiveFileSystemWatcher::Backend;
+
+    ~QRecursiveFileSystemWatcherPrivate() override;
+
+    void init(Backend preferred);
+    void changed(const QString &path);
+    bool isWatched(const QString &path) const;
+
+    void watchTree(const QString &dir, bool report);
+    void unwatchTree(const QString &dir);
+
+    QStringList roots;
+    QSet<QString> changes;
+    QBasicTimer timer;
+    std::chrono::milliseconds interval = 100ms;
+    Backend backend = Backend::Generic;
+    QSocketNotifier *notifier = nullptr;
+
+    // Watched directories, with their inotify watch descriptors
+    QMap<QString, int> watches;
+
+    bool warnedAboutLimit = false;
+
+#ifdef USE_INOTIFY
+    int inotifyFd = -1;
+    QHash<int, QString> watchPaths;
+
+    void readFromInotify();
+#endif
+
+#ifdef USE_FANOTIFY
+    // A directory that events were reported for; relevant if it is watched,
+    // or contains one of the roots
+    struct DirPath
+    {
+        QString path;
+        bool relevant;
+    };
+
+    int fanotifyFd = -1;
+    QHash<QByteArray, int> mountFds;        // by file system id
+    // By file system id and handle. The mark covers the whole file system,
+    // so this remembers unwatched directories as well, to resolve them only
+    // once; bounded, as the file system may have any number of them.
+    QCache<QByteArray, DirPath> dirPaths{4096};
+
+    bool markFileSystem(const QString &root);
+    void unmarkFileSystems();
+    void fallBackToInotify();
+    const DirPath *pathForHandle(const QByteArray &fsid, const file_handle *handle);
+    void readFromFanotify();
+#endif
+
+    QFileSystemWatcher *generic = nullptr;
+    void genericDirectoryChanged(const QString &path);
+};
+
+QRecursiveFileSystemWatcherPrivate::~QRecursiveFileSystemWatcherPrivate()
+{
+#ifdef USE_FANOTIFY
+    for (int fd : std::as_const(mountFds))
+        qt_safe_close(fd);
+    if (fanotifyFd != -1)
+        qt_safe_close(fanotifyFd);
+#endif
+#ifdef USE_INOTIFY
+    if (inotifyFd != -1)
+        qt_safe_close(inotifyFd);
+#endif
+}
+
+void QRecursiveFileSystemWatcherPrivate::init(Backend preferred)
+{
+    Q_Q(QRecursiveFileSystemWatcher);
+#ifdef USE_FANOTIFY
+    if (preferred == Backend::Fanotify) {
+        fanotifyFd = fanotify_init(FAN_CLASS_NOTIF | FAN_CLOEXEC | FAN_NONBLOCK
+                                   | FAN_REPORT_DFID_NAME, O_RDONLY | O_LARGEFILE);
+        if (fanotifyFd != -1) {
+            backend = Backend::Fanotify;
+            notifier = new QSocketNotifier(fanotifyFd, QSocketNotifier::Read, q);
+            QObjectPrivate::connect(notifier, &QSocketNotifier::activated,
+                                    this, &QRecursiveFileSystemWatcherPrivate::readFromFanotify);
+            return;
+        }
+        qCDebug(lcWatcher, "fanotify_init() failed (%s), using inotify",
+                qPrintable(qt_error_string(errno)));
+    }
+#endif
+#ifdef USE_INOTIFY
+    if (preferred != Backend::Generic) {
+        inotifyFd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (inotifyFd != -1) {
+            backend = Backend::Inotify;
+            notifier = new QSocketNotifier(inotifyFd, QSocketNotifier::Read, q);
+            QObjectPrivate::connect(notifier, &QSocketNotifier::activated,
+                                    this, &QRecursiveFileSystemWatcherPrivate::readFromInotify);
+            return;
+        }
+    }
+#else
+    Q_UNUSED(preferred);
+#endif
+    backend = Backend::Generic;
+    generic = new QFileSystemWatcher(q);
+    QObjectPrivate::connect(generic, &QFileSystemWatcher::directoryChanged,
+                            this, &QRecursiveFileSystemWatcherPrivate::genericDirectoryChanged);
+}
+
+void QRecursiveFileSystemWatcherPrivate::changed(const QString &path)
+{
+    Q_Q(QRecursiveFileSystemWatcher);
+    changes.insert(path);
+    if (!timer.isActive())
+        timer.start(interval, q);
+}
+
+bool QRecursiveFileSystemWatcherPrivate::isWatched(const QString &path) const
+{
+    return std::any_of(roots.cbegin(), roots.cend(), [&path](const QString &root) {
+        return path.startsWith(root)
+                && (path.size() == root.size() || root.endsWith(u'/')
+                    || path.at(root.size()) == u'/');
+    });
+}
+
+/*!
+    \internal
+    Watches \a dir and all directories below it, and reports what is in
+    them as changed if \a report is \c true, i.e. if they are new.
+*/
+void QRecursiveFileSystemWatcherPrivate::watchTree(const QString &dir, bool report)
+{
+    // A directory is watched before it is listed, so that nothing created
+    // in it in the meantime goes unnoticed.
+    QList<std::pair<QString, int>> added;
+    auto watch = [this](const QString &path) {
+#ifdef USE_INOTIFY
+        if (inotifyFd != -1) {
+            constexpr uint32_t mask = IN_ATTRIB | IN_MODIFY | IN_MOVE | IN_CREATE | IN_DELETE
+                    | IN_DELETE_SELF | IN_ONLYDIR | IN_DONT_FOLLOW | IN_EXCL_UNLINK;
+            return inotify_add_watch(inotifyFd, QFile::encodeName(path).constData(), mask);
+        }
+#endif
+        Q_UNUSED(path);
+        return -1;
+    };
+    bool limitReached = false;
+    auto add = [&](const QString &path, int wd, int error) {
+        if (wd == -1 && !generic) {
+            limitReached = limitReached || error == ENOSPC;
+            return;
+        }
+        added.emplace_back(path, wd);
+    };
+
+    const int wd = watch(dir);
+    add(dir, wd, errno);
+
+    using F = QDirListing::IteratorFlag;
+    QStringList found;
+    QMutex mutex;
+    // This runs on the watcher's thread; the listing works through the tree
+    // itself when the global pool has no threads to spare, so it can't stall
+    // behind tasks that wait for this thread.
+    QtPrivate::forEachDirEntryParallel(dir, {}, F::Recursive | F::IncludeHidden,
+                                       [&](const QDirListing::DirEntry &entry) {
+        const bool isDir = !entry.isSymLink() && entry.isDir();
+        if (!isDir && !report)
+            return;
+        const QString path = entry.filePath();
+        const int wd = isDir ? watch(path) : -1;
+        const int error = errno;
+        QMutexLocker locker(&mutex);
+        if (isDir)
+            add(path, wd, error);
+        if (report)
+            found.append(path);
+    });
+
+    if (limitReached && !std::exchange(warnedAboutLimit, true)) {
+        qWarning("QRecursiveFileSystemWatcher: the limit of inotify watches was reached "
+                 "under %ls; raise fs.inotify.max_user_watches to watch all of it",
+                 qUtf16Printable(dir));
+    }
+
+    QStringList genericPaths;
+    for (const auto &[path, wd] : std::as_const(added)) {
+        if (generic && watches.contains(path))
+            continue;
+        watches.insert(path, wd);
+#ifdef USE_INOTIFY
+        if (wd != -1)
+            watchPaths.insert(wd, path);
+#endif
+        if (generic)
+            genericPaths.append(path);
+    }
+    if (!genericPaths.isEmpty())
+        generic->addPaths(genericPaths);
+
+    for (const QString &path : std::as_const(found))
+        changed(path);
+}
+
+void QRecursiveFileSystemWatcherPrivate::unwatchTree(const QString &dir)
+{
+    QStringList removed;
+    auto unwatch = [&](QMap<QString, int>::iterator it) {
+#ifdef USE_INOTIFY
+        if (it.value() != -1) {
+            inotify_rm_watch(inotifyFd, it.value());
+            watchPaths.remove(it.value());
+        }
+#endif
+        removed.append(it.key());
+        return watches.erase(it);
+    };
+
+    if (auto it = watches.find(dir); it != watches.end())
+        unwatch(it);
+    const QString prefix = dir + u'/';
+    for (auto it = watches.lowerBound(prefix); it != watches.end() && it.key().startsWith(prefix); )
+        it = unwatch(it);
+
+    if (generic && !removed.isEmpty())
+        generic->removePaths(removed);
+}
+
+#ifdef USE_INOTIFY
+void QRecursiveFileSystemWatcherPrivate::readFromInotify()
+{
+    for (;;) {
+        alignas(inotify_event) char buffer[16384];
+        const ssize_t read = qt_safe_read(inotifyFd, buffer, sizeof buffer);
+        if (read <= 0)
+            return;
+
+        for (const char *at = buffer; at < buffer + read; ) {
+            const auto *event = reinterpret_cast<const inotify_event *>(at);
+            at += sizeof(inotify_event) + event->len;
+
+            if (event->mask & IN_Q_OVERFLOW) {
+                for (const QString &root : std::as_const(roots))
+                    changed(root);
+                continue;
+            }
+
+            const QString dir = watchPaths.value(event->wd);
+            if (dir.isEmpty())
+                continue;
+            if (event->mask & IN_IGNORED) {
+                // The directory is gone, or no longer ours
+                watchPaths.remove(event->wd);
+                if (watches.value(dir) == event->wd)
+                    watches.remove(dir);
+                continue;
+            }
+
+            const QString path = event->len ? dir + u'/' + QFile::decodeName(event->name) : dir;
+            changed(path);
+            if (event->mask & IN_ISDIR) {
+                if (event->mask & (IN_CREATE | IN_MOVED_TO))
+                    watchTree(path, true);
+                else if (event->mask & IN_MOVED_FROM)
+                    unwatchTree(path);
+            }
+        }
+    }
+}
+#endif
+
+#ifdef USE_FANOTIFY
+static QByteArray fileSystemId(const __kernel_fsid_t &fsid)
+{
+    return QByteArray(reinterpret_cast<const char *>(&fsid), sizeof fsid);
+}
+
+/*!
+    \internal
+    Marks the file system of \a root, so that all changes on it are
+    reported. This takes CAP_SYS_ADMIN, and turning the file handles in the
+    events into paths takes CAP_DAC_READ_SEARCH.
+*/
+bool QRecursiveFileSystemWatcherPrivate::markFileSystem(const QString &root)
+{
+    const QByteArray nativePath = QFile::encodeName(root);
+    const int fd = qt_safe_open(nativePath.constData(), O_RDONLY | O_DIRECTORY);
+    if (fd == -1)
+        return false;
+
+    QVarLengthArray<char, sizeof(file_handle) + MAX_HANDLE_SZ> buffer(sizeof(file_handle)
+                                                                      + MAX_HANDLE_SZ);
+    auto handle = reinterpret_cast<file_handle *>(buffer.data());
+    handle->handle_bytes = MAX_HANDLE_SZ;
+    int mountId;
+    int pathFd = -1;
+    if (name_to_handle_at(fd, "", handle, &mountId, AT_EMPTY_PATH) == 0)
+        pathFd = open_by_handle_at(fd, handle, O_PATH | O_CLOEXEC);
+    struct statfs info;
+    if (pathFd == -1 || fstatfs(fd, &info) == -1
+            || fanotify_mark(fanotifyFd, FAN_MARK_ADD | FAN_MARK_FILESYSTEM,
+                             FAN_CREATE | FAN_DELETE | FAN_MOVE | FAN_MODIFY | FAN_ATTRIB
+                             | FAN_ONDIR, fd, nullptr) == -1) {
+        qCDebug(lcWatcher, "Cannot use fanotify for %ls (%s), using inotify",
+                qUtf16Printable(root), qPrintable(qt_error_string(errno)));
+        if (pathFd != -1)
+            qt_safe_close(pathFd);
+        qt_safe_close(fd);
+        return false;
+    }
+    qt_safe_close(pathFd);
+
+    __kernel_fsid_t fsid;
+    static_assert(sizeof fsid == sizeof info.f_fsid);
+    memcpy(&fsid, &info.f_fsid, sizeof fsid);
+    const QByteArray id = fileSystemId(fsid);
+    if (mountFds.contains(id))
+        qt_safe_close(fd);
+    else
+        mountFds.insert(id, fd);
+    return true;
+}
+
+void QRecursiveFileSystemWatcherPrivate::unmarkFileSystems()
+{
+    fanotify_mark(fanotifyFd, FAN_MARK_FLUSH | FAN_MARK_FILESYSTEM, 0, AT_FDCWD, nullptr);
+    for (int fd : std::as_const(mountFds))
+        qt_safe_close(fd);
+    mountFds.clear();
+    dirPaths.clear();
+}
+
+void QRecursiveFileSystemWatcherPrivate::fallBackToInotify()
+{
+    unmarkFileSystems();
+    delete std::exchange(notifier, nullptr);
+    qt_safe_close(fanotifyFd);
+    fanotifyFd = -1;
+
+    init(Backend::Inotify);
+    for (const QString &root : std::as_const(roots))
+        watchTree(root, false);
+}
+
+auto QRecursiveFileSystemWatcherPrivate::pathForHandle(const QByteArray &fsid,
+                                                       const file_handle *handle) -> const DirPath *
+{
+    const QByteArray key = fsid + QByteArrayView(reinterpret_cast<const char *>(handle),
+                                                 sizeof(file_handle) + handle->handle_bytes);
+    if (const DirPath *dir = dirPaths.object(key))
+        return dir;
+
+    const int mountFd = mountFds.value(fsid, -1);
+    if (mountFd == -1)
+        return nullptr;
+    // open_by_handle_at() wants a modifiable, aligned handle
+    QVarLengthArray<char, sizeof(file_handle) + MAX_HANDLE_SZ> buffer(key.size() - fsid.size());
+    memcpy(buffer.data(), handle, buffer.size());
+    const int fd = open_by_handle_at(mountFd, reinterpret_cast<file_handle *>(buffer.data()),
+                                     O_PATH | O_CLOEXEC);
+    if (fd == -1)
+        return nullptr;     // deleted since
+
+    char path[PATH_MAX];
+    const QByteArray link = "/proc/self/fd/" + QByteArray::number(fd);
+    const ssize_t length = ::readlink(link.constData(), path, sizeof path);
+    qt_safe_close(fd);
+    if (length <= 0 || length == sizeof path)
+        return nullptr;
+
+    auto dir = new DirPath{ QFile::decodeName(QByteArray(path, length)), false };
+    dir->relevant = isWatched(dir->path)
+            || std::any_of(roots.cbegin(), roots.cend(), [dir](const QString &root) {
+                   return QStringView(root).first(qMax(root.lastIndexOf(u'/'), 1)) == dir->path;
+               });
+    return dirPaths.insert(key, dir) ? dir : nullptr;
+}
+
+void QRecursiveFileSystemWatcherPrivate::readFromFanotify()
+{
+    for (;;) {
+        alignas(fanotify_event_metadata) char buffer[16384];
+        ssize_t read = qt_safe_read(fanotifyFd, buffer, sizeof buffer);
+        if (read <= 0)
+            return;
+
+        for (auto *event = reinterpret_cast<const fanotify_event_metadata *>(buffer);
+             FAN_EVENT_OK(event, read); event = FAN_EVENT_NEXT(event, read)) {
+            if (event->vers != FANOTIFY_METADATA_VERSION)
+                return;
+            if (event->mask & FAN_Q_OVERFLOW) {
+                for (const QString &root : std::as_const(roots))
+                    changed(root);
+                continue;
+            }
+
+            const auto *info = reinterpret_cast<const fanotify_event_info_fid *>(
+                    reinterpret_cast<const char *>(event) + event->metadata_len);
+            if (info->hdr.info_type != FAN_EVENT_INFO_TYPE_DFID_NAME)
+                continue;
+            const auto *handle = reinterpret_cast<const file_handle *>(info->handle);
+            const char *name = reinterpret_cast<const char *>(handle->f_handle)
+                    + handle->handle_bytes;
+
+            // A renamed or deleted directory may take the paths we know
+            // for the directories below it with it.
+            if ((event->mask & FAN_ONDIR) && (event->mask & (FAN_MOVE | FAN_DELETE)))
+                dirPaths.clear();
+
+            // Most events on the file system are for directories we don't
+            // watch; those are dismissed by the cache, without building paths
+            const DirPath *dir = pathForHandle(fileSystemId(info->fsid), handle);
+            if (!dir || !dir->relevant)
+                continue;
+            const QString path = qstrcmp(name, ".") == 0
+                    ? dir->path : dir->path + u'/' + QFile::decodeName(name);
+            if (isWatched(path))
+                changed(path);
+        }
+    }
+}
+#endif // USE_FANOTIFY
+
+void QRecursiveFileSystemWatcherPrivate::genericDirectoryChanged(const QString &path)
+{
+    changed(path);
+    if (!QFileInfo::exists(path)) {
+        unwatchTree(path);
+        return;
+    }
+
+    // Look for new subdirectories
+    using F = QDirListing::IteratorFlag;
+    for (const auto &entry : QDirListing(path, F::DirsOnly | F::IncludeHidden)) {
+        if (!entry.isSymLink() && !watches.contains(entry.filePath()))
+            watchTree(entry.filePath(), true);
+    }
+}
+
+/*!
+    Constructs a watcher with the given \a parent, using the most scalable
+    backend available.
+*/
+QRecursiveFileSystemWatcher::QRecursiveFileSystemWatcher(QObject *parent)
+    : QRecursiveFileSystemWatcher(Backend::Fanotify, parent)
+{
+}
+
+/*!
+    Constructs a watcher with the given \a parent, using the \a preferred
+    backend if it is available, or one further down the list otherwise.
+*/
+QRecursiveFileSystemWatcher::QRecursiveFileSystemWatcher(Backend preferred, QObject *parent)
+    : QObject(*new QRecursiveFileSystemWatcherPrivate, parent)
+{
+    Q_D(QRecursiveFileSystemWatcher);
+    d->init(preferred);
+}
+
+QRecursiveFileSystemWatcher::~QRecursiveFileSystemWatcher() = default;
+
+/*!
+    Starts watching the directory \a path and everything below it. Returns
+    \c false if \a path isn't a directory, or is watched already.
+*/
+bool QRecursiveFileSystemWatcher::addPath(const QString &path)
+{
+    Q_D(QRecursiveFileSystemWatcher);
+    const QFileInfo info(path);
+    const QString root = info.canonicalFilePath();
+    if (!info.isDir() || root.isEmpty() || d->roots.contains(root))
+        return false;
+
+    d->roots.append(root);
+#ifdef USE_FANOTIFY
+    if (d->backend == Backend::Fanotify) {
+        d->dirPaths.clear();
+        if (!d->markFileSystem(root))
+            d->fallBackToInotify();
+        return true;
+    }
+#endif
+    d->watchTree(root, false);
+    return true;
+}
+
+/*!
+    Stops watching the directory \a path. Returns \c false if it wasn't
+    watched.
+*/
+bool QRecursiveFileSystemWatcher::removePath(const QString &path)
+{
+    Q_D(QRecursiveFileSystemWatcher);
+    QString root = QFileInfo(path).canonicalFilePath();
+    if (!d->roots.contains(root))
+        root = QDir::cleanPath(QFileInfo(path).absoluteFilePath());   // gone already
+    if (!d->roots.removeOne(root))
+        return false;
+
+#ifdef USE_FANOTIFY
+    if (d->backend == Backend::Fanotify) {
+        d->dirPaths.clear();
+        if (d->roots.isEmpty())
+            d->unmarkFileSystems();
+        return true;
+    }
+#endif
+    d->unwatchTree(root);
+    // Keep what other watched directories still need: all of the tree if
+    // it lies inside one of them, otherwise the ones that lie inside it
+    const auto contains = [](const QString &dir, const QString &path) {
+        return path.startsWith(dir + u'/');
+    };
+    for (const QString &other : std::as_const(d->roots)) {
+        if (contains(other, root)) {
+            d->watchTree(root, false);
+            return true;
+        }
+    }
+    for (const QString &other : std::as_const(d->roots)) {
+        if (contains(root, other))
+            d->watchTree(other, false);
+    }
+    return true;
+}
+
+/*!
+    Returns the watched directories, as canonical paths.
+*/
+QStringList QRecursiveFileSystemWatcher::paths() const
+{
+    Q_D(const QRecursiveFileSystemWatcher);
+    return d->roots;
+}
+
+/*!
+    Sets the time over which changes are collected before pathsChanged() is
+    emitted to \a interval. The default is 100 ms.
+*/
+void QRecursiveFileSystemWatcher::setInterval(std::chrono::milliseconds interval)
+{
+    Q_D(QRecursiveFileSystemWatcher);
+    d->interval = interval;
+}
+
+std::chrono::milliseconds QRecursiveFileSystemWatcher::interval() const
+{
+    Q_D(const QRecursiveFileSystemWatcher);
+    return d->interval;
+}
+
+/*!
+    Returns the backend in use, which may change after addPath() if the
+    preferred one turns out not to be usable for the path.
+*/
+QRecursiveFileSystemWatcher::Backend QRecursiveFileSystemWatcher::backend() const
+{
+    Q_D(const QRecursiveFileSystemWatcher);
+    return d->backend;
+}
+
+/*!
+    Returns the number of directories watched individually; 0 with the
+    fanotify backend, which needs no watch per directory.
+*/
+qsizetype QRecursiveFileSystemWatcher::watchCount() const
+{
+    Q_D(const QRecursiveFileSystemWatcher);
+    return d->watches.size();
+}
+
+/*!
+    \fn void QRecursiveFileSystemWatcher::pathsChanged(const QStringList &paths)
+
+    This signal is emitted with the \a paths, sorted, of the files and
+    directories that were created, modified, removed or renamed since it
+    was last emitted. Removed and renamed entries are reported by their old
+    paths, renamed ones by their new paths as well.
+*/
+
+void QRecursiveFileSystemWatcher::timerEvent(QTimerEvent *event)
+{
+    Q_D(QRecursiveFileSystemWatcher);
+    if (event->timerId() != d->timer.timerId())
+        return QObject::timerEvent(event);
+
+    d->timer.stop();
+    QStringList paths(d->changes.cbegin(), d->changes.cend());
+    d->changes.clear();
+    paths.sort();
+    emit pathsChanged(paths);
+}
+
+QT_END_NAMESPACE
+
+#include "moc_qrecursivefilesystemwatcher_p.cpp"
@@ -0,0 +1,65 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QRECURSIVEFILESYSTEMWATCHER_P_H
+#define QRECURSIVEFILESYSTEMWATCHER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qobject.h>
+#include <QtCore/qstringlist.h>
+
+#include <chrono>
+
+QT_REQUIRE_CONFIG(filesystemwatcher);
+
+QT_BEGIN_NAMESPACE
+
+class QRecursiveFileSystemWatcherPrivate;
+
+class Q_CORE_EXPORT QRecursiveFileSystemWatcher : public QObject
+{
+    Q_OBJECT
+    Q_DECLARE_PRIVATE(QRecursiveFileSystemWatcher)
+
+public:
+    enum class Backend {
+        Fanotify,
+        Inotify,
+        Generic,
+    };
+
+    explicit QRecursiveFileSystemWatcher(QObject *parent = nullptr);
+    explicit QRecursiveFileSystemWatcher(Backend preferred, QObject *parent = nullptr);
+    ~QRecursiveFileSystemWatcher() override;
+
+    bool addPath(const QString &path);
+    bool removePath(const QString &path);
+    QStringList paths() const;
+
+    void setInterval(std::chrono::milliseconds interval);
+    std::chrono::milliseconds interval() const;
+
+    Backend backend() const;
+    qsizetype watchCount() const;
+
+Q_SIGNALS:
+    void pathsChanged(const QStringList &paths);
+
+protected:
+    void timerEvent(QTimerEvent *event) override;
+};
+
+QT_END_NAMESPACE
+
+#endif // QRECURSIVEFILESYSTEMWATCHER_P_H
@@ -16,6 +16,7 @@
 #include "qstringlist.h"
 #include "qendian.h"
 #include <qshareddata.h>
+#include <optional>
 #include <qplatformdefs.h>
 #include <qendian.h>
 #include "private/qabstractfileengine_p.h"
@@ -119,16 +120,29 @@ public:
 private:
     const uchar *tree, *names, *payloads;
     int version;
+#if QT_CONFIG(zstd)
+    mutable QAtomicPointer<ZSTD_DDict> zstdDDict;
+    mutable QAtomicPointer<ZSTD_DCtx> zstdDCtx;    // idle context, taken while in use
+    const ZSTD_DDict *zstdDictionary() const;
+#endif
     inline int findOffset(int node) const { return node * (14 + (version >= 0x02 ? 8 : 0)); } //sizeof each tree element
     uint hash(int node) const;
     QString name(int node) const;
+    bool nameEquals(int node, QStringView segment) const;
     short flags(int node) const;
+    std::optional<int> findNodeInIndex(QStringView path, const QLocale &locale) const;
 public:
     mutable QAtomicInt ref;
 
     inline QResourceRoot(): tree(nullptr), names(nullptr), payloads(nullptr), version(0) {}
     inline QResourceRoot(int version, const uchar *t, const uchar *n, const uchar *d) { setSource(version, t, n, d); }
-    virtual ~QResourceRoot() { }
+    virtual ~QResourceRoot()
+    {
+#if QT_CONFIG(zstd)
+        ZSTD_freeDDict(zstdDDict.loadRelaxed());
+        ZSTD_freeDCtx(zstdDCtx.loadRelaxed());
+#endif
+    }
     int findNode(const QString &path, const QLocale &locale=QLocale()) const;
     inline bool isContainer(int node) const { return flags(node) & Directory; }
     QResource::Compression compressionAlgo(int node)
@@ -141,6 +155,9 @@ public:
         return QResource::NoCompression;
     }
     const uchar *data(int node, qint64 *size) const;
+#if QT_CONFIG(zstd)
+    size_t zstdDecompress(char *buffer, size_t bufferSize, const uchar *data, size_t size) const;
+#endif
     qint64 lastModified(int node) const;
     QStringList children(int node) const;
     virtual QString mappingRoot() const { return QString(); }
@@ -275,7 +292,9 @@ static inline ResourceList *resourceList()
                             be decompressed using the qUncompress() function.
     \value ZstdCompression  Contents are compressed using \l{Zstandard Site}{zstd}. To
                             decompress, use the \c{ZSTD_decompress} function from the zstd
-                            library.
+                            library. Resources compiled with \c{rcc --zstd-dictionary} need
+                            a dictionary stored elsewhere in the resource data; use
+                            uncompressedData() for them.
 
     \sa compressionAlgorithm()
 */
@@ -482,7 +501,8 @@ qsizetype QResourcePrivate::decompress(char *buffer, qsizetype bufferSize) const
 
     case QResource::ZstdCompression: {
 #if QT_CONFIG(zstd)
-        size_t usize = ZSTD_decompress(buffer, bufferSize, data, size);
+        // the first related root is the one with our data
+        size_t usize = related.constFirst()->zstdDecompress(buffer, bufferSize, data, size);
         if (ZSTD_isError(usize)) {
             qWarning("QResource: error decompressing zstd content: %s", ZSTD_getErrorName(usize));
             return -1;
@@ -786,6 +806,122 @@ inline QString QResourceRoot::name(int node) const
     return ret;
 }
 
+inline bool QResourceRoot::nameEquals(int node, QStringView segment) const
+{
+    if (!node) // root
+        return segment.isEmpty();
+    const int offset = findOffset(node);
+
+    qint32 name_offset = qFromBigEndian<qint32>(tree + offset);
+    const quint16 name_length = qFromBigEndian<qint16>(names + name_offset);
+    if (name_length != segment.size())
+        return false;
+    name_offset += 2;
+    name_offset += 4; // jump past hash
+
+    const uchar *data = names + name_offset;
+    for (qsizetype i = 0; i < segment.size(); ++i, data += 2) {
+        if (qFromBigEndian<char16_t>(data) != segment[i].unicode())
+            return false;
+    }
+    return true;
+}
+
+// must match rcc.cpp
+static quint64 resourcePathHash(QStringView path, quint32 seed)
+{
+    quint64 h = Q_UINT64_C(14695981039346656037) ^ seed;
+    for (QChar c : path) {
+        h ^= c.unicode();
+        h *= Q_UINT64_C(1099511628211);
+    }
+    return h;
+}
+
+/*
+    Since format version 4, the root node's name offset may point to an index
+    appended to the tree: a perfect hash over the full paths of all nodes
+    (seed, slot count, bucket count, node count, then the displacement of each
+    bucket, the node in each slot and the parent of each node). Looking a path
+    up there is independent of the depth of the tree and of the number of
+    siblings on the way.
+
+    Returns std::nullopt if there is no index or it cannot answer for \a path,
+    in which case the tree has to be walked.
+*/
+std::optional<int> QResourceRoot::findNodeInIndex(QStringView path, const QLocale &locale) const
+{
+    if (version < 0x04)
+        return std::nullopt;
+    const quint32 index_offset = qFromBigEndian<quint32>(tree);
+    if (!index_offset)
+        return std::nullopt;
+    // the index only knows canonical paths
+    if (!path.startsWith(u'/') || path.endsWith(u'/') || path.contains("//"_L1))
+        return std::nullopt;
+
+    const uchar *index = tree + index_offset;
+    const quint32 seed = qFromBigEndian<quint32>(index);
+    const quint32 slot_count = qFromBigEndian<quint32>(index + 4);
+    const quint32 bucket_count = qFromBigEndian<quint32>(index + 8);
+    const quint32 node_count = qFromBigEndian<quint32>(index + 12);
+    if (!slot_count || (slot_count & (slot_count - 1)) || !bucket_count)
+        return std::nullopt;
+    const uchar *displacements = index + 16;
+    const uchar *slot_nodes = displacements + 4 * bucket_count;
+    const uchar *parents = slot_nodes + 4 * slot_count;
+
+    const quint64 h = resourcePathHash(path, seed);
+    const quint32 lo = quint32(h);
+    const quint32 hi = quint32(h >> 32);
+    const quint32 d = qFromBigEndian<quint32>(displacements + 4 * (hi % bucket_count));
+    const quint32 node = qFromBigEndian<quint32>(slot_nodes + 4 * ((lo + d * (hi | 1)) & (slot_count - 1)));
+    if (!node || node >= node_count)
+        return -1;
+
+    // the slot may hold a different path, compare segment by segment from the end
+    QStringView rest = path;
+    for (quint32 n = node; n; n = qFromBigEndian<quint32>(parents + 4 * n)) {
+        if (n >= node_count)
+            return -1;
+        const qsizetype slash = rest.lastIndexOf(u'/');
+        if (slash < 0 || !nameEquals(n, rest.sliced(slash + 1)))
+            return -1;
+        rest.truncate(slash);
+    }
+    if (!rest.isEmpty())
+        return -1;
+
+    if (isContainer(node))
+        return int(node);
+
+    // locale variants of a file are siblings with the same name, pick one
+    // the same way the tree walk in findNode() does
+    const QStringView segment = path.sliced(path.lastIndexOf(u'/') + 1);
+    const int parent_offset = findOffset(qFromBigEndian<quint32>(parents + 4 * node)) + 6;
+    const int first_child = qFromBigEndian<qint32>(tree + parent_offset + 4);
+    const int last_child = first_child + qFromBigEndian<qint32>(tree + parent_offset) - 1;
+    const uint segment_hash = hash(node);
+    int sub_node = node;
+    while (sub_node > first_child && hash(sub_node - 1) == segment_hash)
+        --sub_node;
+    int found = -1;
+    for (; sub_node <= last_child && hash(sub_node) == segment_hash; ++sub_node) {
+        if (!nameEquals(sub_node, segment))
+            continue;
+        const int offset = findOffset(sub_node) + 6; // jump past name and flags
+        const qint16 territory = qFromBigEndian<qint16>(tree + offset);
+        const qint16 language = qFromBigEndian<qint16>(tree + offset + 2);
+        if (territory == locale.territory() && language == locale.language())
+            return sub_node;
+        if ((territory == QLocale::AnyTerritory && language == locale.language())
+            || (territory == QLocale::AnyTerritory && language == QLocale::C && found == -1)) {
+            found = sub_node;
+        }
+    }
+    return found;
+}
+
 int QResourceRoot::findNode(const QString &_path, const QLocale &locale) const
 {
     QString path = _path;
@@ -811,6 +947,9 @@ int QResourceRoot::findNode(const QString &_path, const QLocale &locale) const
     if (path == "/"_L1)
         return 0;
 
+    if (std::optional<int> indexed = findNodeInIndex(path, locale))
+        return *indexed;
+
     // the root node is always first
     qint32 child_count = qFromBigEndian<qint32>(tree + 6);
     qint32 child       = qFromBigEndian<qint32>(tree + 10);
@@ -944,10 +1083,59 @@ const uchar *QResourceRoot::data(int node, qint64 *size) const
     return nullptr;
 }
 
+#if QT_CONFIG(zstd)
+// Since format version 4, the root has no time stamp. That field holds the
+// offset of the zstd dictionary instead, which some of the payloads need.
+const ZSTD_DDict *QResourceRoot::zstdDictionary() const
+{
+    if (version < 0x04)
+        return nullptr;
+    ZSTD_DDict *dictionary = zstdDDict.loadAcquire();
+    if (!dictionary) {
+        const quint64 offset = qFromBigEndian<quint64>(tree + 14);
+        const quint32 size = qFromBigEndian<quint32>(payloads + offset);
+        ZSTD_DDict *created = ZSTD_createDDict(payloads + offset + 4, size);
+        if (zstdDDict.testAndSetOrdered(nullptr, created, dictionary))
+            dictionary = created;
+        else
+            ZSTD_freeDDict(created);
+    }
+    return dictionary;
+}
+
+// Resources are usually read one after the other, so one decompression
+// context per root is kept around for the next one. Concurrent readers that
+// find it taken use their own.
+size_t QResourceRoot::zstdDecompress(char *buffer, size_t bufferSize,
+                                     const uchar *data, size_t size) const
+{
+    ZSTD_DCtx *dctx = zstdDCtx.fetchAndStoreAcquire(nullptr);
+    if (!dctx)
+        dctx = ZSTD_createDCtx();
+    if (!dctx)
+        return size_t(-ZSTD_error_memory_allocation);
+
+    size_t usize;
+    if (ZSTD_getDictID_fromFrame(data, size) != 0) {
+        // compressed with the dictionary of the resource tree, see rcc --zstd-dictionary
+        usize = ZSTD_decompress_usingDDict(dctx, buffer, bufferSize, data, size,
+                                           zstdDictionary());
+    } else {
+        usize = ZSTD_decompressDCtx(dctx, buffer, bufferSize, data, size);
+    }
+
+    if (!zstdDCtx.testAndSetRelease(nullptr, dctx))
+        ZSTD_freeDCtx(dctx);
+    return usize;
+}
+#endif
+
 qint64 QResourceRoot::lastModified(int node) const
 {
     if (node == -1 || version < 0x02)
         return 0;
+    if (node == 0 && version >= 0x04) // see zstdDictionary()
+        return 0;
 
     const int offset = findOffset(node) + 14;
 
@@ -1004,7 +1192,7 @@ Q_CORE_EXPORT bool qRegisterResourceData(int version, const unsigned char *tree,
         return false;
     const auto locker = qt_scoped_lock(resourceMutex());
     ResourceList *list = resourceList();
-    if (version >= 0x01 && version <= 0x3) {
+    if (version >= 0x01 && version <= 0x04) {
         bool found = false;
         QResourceRoot res(version, tree, name, data);
         for (int i = 0; i < list->size(); ++i) {
@@ -1030,7 +1218,7 @@ Q_CORE_EXPORT bool qUnregisterResourceData(int version, const unsigned char *tre
         return false;
 
     const auto locker = qt_scoped_lock(resourceMutex());
-    if (version >= 0x01 && version <= 0x3) {
+    if (version >= 0x01 && version <= 0x04) {
         QResourceRoot res(version, tree, name, data);
         ResourceList *list = resourceList();
         for (int i = 0; i < list->size();) {
@@ -1110,7 +1298,7 @@ public:
         if (file_flags & ~acceptableFlags)
             return false;
 
-        if (version >= 0x01 && version <= 0x03) {
+        if (version >= 0x01 && version <= 0x04) {
             buffer = b;
             setSource(version, b + tree_offset, b + name_offset, b + data_offset);
             return true;
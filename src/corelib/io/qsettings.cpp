@@ -274,6 +274,8 @@ QString QSettingsPrivate::normalizedKey(QAnyStringView key)
 QSettingsPrivate *QSettingsPrivate::create(QSettings::Format format, QSettings::Scope scope,
                                            const QString &organization, const QString &application)
 {
+    if (isBinaryFormat(format))
+        return createBinary(format, scope, organization, application);
     return new QConfFileSettingsPrivate(format, scope, organization, application);
 }
 #endif
@@ -281,6 +283,8 @@ QSettingsPrivate *QSettingsPrivate::create(QSettings::Format format, QSettings::
 #if !defined(Q_OS_WIN)
 QSettingsPrivate *QSettingsPrivate::create(const QString &fileName, QSettings::Format format)
 {
+    if (isBinaryFormat(format))
+        return createBinary(fileName, format);
     return new QConfFileSettingsPrivate(fileName, format);
 }
 #endif
@@ -1066,29 +1070,26 @@ void Q_AUTOTEST_EXPORT clearDefaultPaths()
 }
 #endif // QT_BUILD_INTERNAL && Q_XDG_PLATFORM && !QT_NO_STANDARDPATHS
 
-QConfFileSettingsPrivate::QConfFileSettingsPrivate(QSettings::Format format,
-                                                   QSettings::Scope scope,
-                                                   const QString &organization,
-                                                   const QString &application)
-    : QSettingsPrivate(format, scope, organization, application),
-      nextPosition(0x40000000) // big positive number
+/*
+    Returns the files that hold the settings of \a organization and
+    \a application, most specific first. The second member of each pair
+    tells whether the file belongs to the user.
+*/
+QList<std::pair<QString, bool>> QSettingsPrivate::settingsFiles(QSettings::Format format,
+                                                                QSettings::Scope scope,
+                                                                const QString &organization,
+                                                                const QString &application,
+                                                                const QString &extension)
 {
-    initFormat();
-
-    QString org = organization;
-    if (org.isEmpty()) {
-        setStatus(QSettings::AccessError);
-        org = "Unknown Organization"_L1;
-    }
-
-    QString appFile = org + QDir::separator() + application + extension;
-    QString orgFile = org + extension;
+    QList<std::pair<QString, bool>> result;
+    const QString appFile = organization + QDir::separator() + application + extension;
+    const QString orgFile = organization + extension;
 
     if (scope == QSettings::UserScope) {
         Path userPath = getPath(format, QSettings::UserScope);
         if (!application.isEmpty())
-            confFiles.append(QConfFile::fromName(userPath.path + appFile, true));
-        confFiles.append(QConfFile::fromName(userPath.path + orgFile, true));
+            result.emplaceBack(userPath.path + appFile, true);
+        result.emplaceBack(userPath.path + orgFile, true);
     }
 
     Path systemPath = getPath(format, QSettings::SystemScope);
@@ -1115,15 +1116,37 @@ QConfFileSettingsPrivate::QConfFileSettingsPrivate(QSettings::Format format,
 
         // Note: No check for existence of files is done intentionally.
         for (const auto &path : std::as_const(paths))
-            confFiles.append(QConfFile::fromName(path, false));
+            result.emplaceBack(path, false);
     } else
 #endif // Q_XDG_PLATFORM && !QT_NO_STANDARDPATHS
     {
         if (!application.isEmpty())
-            confFiles.append(QConfFile::fromName(systemPath.path + appFile, false));
-        confFiles.append(QConfFile::fromName(systemPath.path + orgFile, false));
+            result.emplaceBack(systemPath.path + appFile, false);
+        result.emplaceBack(systemPath.path + orgFile, false);
     }
 
+    return result;
+}
+
+QConfFileSettingsPrivate::QConfFileSettingsPrivate(QSettings::Format format,
+                                                   QSettings::Scope scope,
+                                                   const QString &organization,
+                                                   const QString &application)
+    : QSettingsPrivate(format, scope, organization, application),
+      nextPosition(0x40000000) // big positive number
+{
+    initFormat();
+
+    QString org = organization;
+    if (org.isEmpty()) {
+        setStatus(QSettings::AccessError);
+        org = "Unknown Organization"_L1;
+    }
+
+    const auto files = settingsFiles(format, scope, org, application, extension);
+    for (const auto &[path, userPerms] : files)
+        confFiles.append(QConfFile::fromName(path, userPerms));
+
     initAccess();
 }
 
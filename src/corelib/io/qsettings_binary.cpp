@@ -0,0 +1,806 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qsettings.h"
+#include "qsettings_p.h"
+
+#include "qdatastream.h"
+#include "qdir.h"
+#include "qendian.h"
+#include "qfile.h"
+#include "qfileinfo.h"
+#include "qhash.h"
+#include "qlockfile.h"
+#include "qmutex.h"
+#include "qrandom.h"
+#if QT_CONFIG(temporaryfile)
+#include "qsavefile.h"
+#include "qtemporaryfile.h"
+#endif
+#include "private/qlocking_p.h"
+
+#include <limits>
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+using namespace Qt::StringLiterals;
+
+/*
+    The binary settings format keeps the settings in a log-structured
+    file that is memory-mapped instead of parsed:
+
+        header      magic, generation, index and log offsets
+        snapshot    one Set record per key, sorted by key
+        index       hash table of the offsets of the snapshot records
+        log         Set, Remove and Clear records appended by sync()
+
+    Looking a key up probes the index and decodes a single value; only
+    the log is scanned when the file is opened. sync() appends to the
+    log under a QLockFile instead of rewriting the file, and compacts
+    the file into a new snapshot, atomically with QSaveFile, once the
+    log has grown larger than the snapshot.
+
+    Every record has a checksum. A record torn by a crash fails it, so
+    it and anything after it are ignored and then overwritten by the
+    next sync(). The generation is random and changes with every
+    compaction, which tells other processes that still map the old file
+    that they need to read it again.
+
+    All integers are little endian. Records and the index are aligned
+    to four bytes. Keys are UTF-8, values are QVariants serialized with
+    QDataStream.
+*/
+
+namespace {
+
+constexpr char Magic[4] = { 'Q', 'S', 'B', '1' };
+constexpr quint32 HeaderSize = 24;
+constexpr quint32 RecordHeaderSize = 16;
+constexpr quint32 MinimumCompactionSize = 64 * 1024;
+constexpr QDataStream::Version StreamVersion = QDataStream::Qt_6_0;
+
+enum RecordType : quint8 {
+    SetRecord = 1,
+    RemoveRecord,
+    ClearRecord,
+};
+
+struct Header
+{
+    quint32 generation = 0;
+    quint32 indexOffset = 0;
+    quint32 indexSize = 0;      // number of buckets, a power of two
+    quint32 logOffset = HeaderSize;
+
+    quint32 snapshotEnd() const { return indexSize ? indexOffset : logOffset; }
+};
+
+struct Record
+{
+    quint32 size = 0;           // zero if the record is invalid
+    quint8 type = 0;
+    QByteArrayView key;
+    QByteArrayView value;
+
+    bool isValid() const { return size != 0; }
+};
+
+} // unnamed namespace
+
+// FNV-1a, as the index must not depend on qHash()'s seed or algorithm
+static quint32 keyHash(QByteArrayView key)
+{
+    quint32 h = 2166136261u;
+    for (char c : key) {
+        h ^= uchar(c);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+static const uchar *bytes(QByteArrayView data)
+{
+    return reinterpret_cast<const uchar *>(data.data());
+}
+
+static bool readHeader(QByteArrayView data, Header *header)
+{
+    if (data.size() < HeaderSize || memcmp(data.data(), Magic, sizeof(Magic)) != 0)
+        return false;
+    const uchar *p = bytes(data);
+    if (qFromLittleEndian<quint16>(p + 20) != qChecksum(data.first(20)))
+        return false;
+
+    header->generation = qFromLittleEndian<quint32>(p + 4);
+    header->indexOffset = qFromLittleEndian<quint32>(p + 8);
+    header->indexSize = qFromLittleEndian<quint32>(p + 12);
+    header->logOffset = qFromLittleEndian<quint32>(p + 16);
+
+    if (header->logOffset < HeaderSize || header->logOffset > data.size()
+            || header->logOffset % 4 || header->indexOffset % 4) {
+        return false;
+    }
+    if (header->indexSize) {
+        if (header->indexSize & (header->indexSize - 1))
+            return false;
+        const quint64 indexEnd = header->indexOffset + 4 * quint64(header->indexSize);
+        if (header->indexOffset < HeaderSize || indexEnd > header->logOffset)
+            return false;
+    }
+    return true;
+}
+
+static void writeHeader(uchar *p, const Header &header)
+{
+    memcpy(p, Magic, sizeof(Magic));
+    qToLittleEndian<quint32>(header.generation, p + 4);
+    qToLittleEndian<quint32>(header.indexOffset, p + 8);
+    qToLittleEndian<quint32>(header.indexSize, p + 12);
+    qToLittleEndian<quint32>(header.logOffset, p + 16);
+    qToLittleEndian<quint16>(qChecksum(QByteArrayView(p, 20)), p + 20);
+    qToLittleEndian<quint16>(0, p + 22);
+}
+
+static Record readRecord(QByteArrayView data, quint32 offset)
+{
+    Record record;
+    if (offset % 4 || offset > data.size() || data.size() - offset < RecordHeaderSize)
+        return record;
+
+    const uchar *p = bytes(data) + offset;
+    const quint32 size = qFromLittleEndian<quint32>(p);
+    const quint32 keySize = qFromLittleEndian<quint32>(p + 8);
+    const quint32 valueSize = qFromLittleEndian<quint32>(p + 12);
+    if (size < RecordHeaderSize || size % 4 || size > data.size() - offset)
+        return record;
+    if (keySize > size - RecordHeaderSize || valueSize > size - RecordHeaderSize - keySize)
+        return record;
+    if (p[6] < SetRecord || p[6] > ClearRecord)
+        return record;
+    const QByteArrayView checked(p + 6, RecordHeaderSize - 6 + keySize + valueSize);
+    if (qFromLittleEndian<quint16>(p + 4) != qChecksum(checked))
+        return record;
+
+    record.size = size;
+    record.type = p[6];
+    record.key = QByteArrayView(p + RecordHeaderSize, keySize);
+    record.value = QByteArrayView(p + RecordHeaderSize + keySize, valueSize);
+    return record;
+}
+
+static void appendRecord(QByteArray &out, RecordType type, QByteArrayView key,
+                         QByteArrayView value)
+{
+    const qsizetype payload = RecordHeaderSize + key.size() + value.size();
+    const qsizetype size = (payload + 3) & ~qsizetype(3);
+    const qsizetype start = out.size();
+    out.resize(start + size, '\0');
+
+    uchar *p = reinterpret_cast<uchar *>(out.data()) + start;
+    qToLittleEndian<quint32>(quint32(size), p);
+    p[6] = type;
+    p[7] = 0;
+    qToLittleEndian<quint32>(quint32(key.size()), p + 8);
+    qToLittleEndian<quint32>(quint32(value.size()), p + 12);
+    if (!key.isEmpty())
+        memcpy(p + RecordHeaderSize, key.data(), key.size());
+    if (!value.isEmpty())
+        memcpy(p + RecordHeaderSize + key.size(), value.data(), value.size());
+    qToLittleEndian<quint16>(qChecksum(QByteArrayView(p + 6, payload - 6)), p + 4);
+}
+
+static QByteArray serializedValue(const QVariant &value)
+{
+    QByteArray result;
+    QDataStream stream(&result, QIODevice::WriteOnly);
+    stream.setVersion(StreamVersion);
+    stream << value;
+    return result;
+}
+
+static QVariant deserializedValue(QByteArrayView value)
+{
+    const QByteArray data = QByteArray::fromRawData(value.data(), value.size());
+    QDataStream stream(data);
+    stream.setVersion(StreamVersion);
+    QVariant result;
+    stream >> result;
+    return result;
+}
+
+// ************************************************************************
+// QBinarySettingsFile
+
+/*
+    Like QConfFile, QBinarySettingsFile objects are shared within the
+    application, so that changes made through one QSettings object are
+    immediately visible to the others.
+*/
+class QBinarySettingsFile
+{
+public:
+    static QBinarySettingsFile *fromName(const QString &fileName, bool userPerms);
+    static void release(QBinarySettingsFile *file);
+
+    std::optional<QVariant> value(const QString &key) const;
+    template <typename Callback>
+    void forEachKey(const QString &prefix, Callback callback) const;
+
+    bool hasPendingChanges() const { return pendingClear || !pending.isEmpty(); }
+    bool isWritable() const;
+    QSettings::Status refresh();
+    QSettings::Status write(bool atomicSyncOnly);
+
+    const QString name;
+    QMutex mutex;
+
+    // changes that have not been written yet; nullopt marks a removed key
+    QHash<QString, std::optional<QVariant>> pending;
+    bool pendingClear = false;
+
+private:
+    QBinarySettingsFile(const QString &name, bool userPerms) : name(name), userPerms(userPerms) {}
+    Q_DISABLE_COPY_MOVE(QBinarySettingsFile)
+
+    void reset();
+    void scanLog();
+    QByteArray pendingRecords() const;
+    QByteArray compacted() const;
+
+    std::unique_ptr<QFile> file;    // owns the mapping of data
+    QByteArray contents;            // holds data where the file cannot be mapped
+    QByteArrayView data;
+    Header header;
+    quint32 validEnd = 0;           // end of the last intact record
+    QHash<QString, quint32> log;    // offset of the last log record of each key
+    bool snapshotCleared = false;   // the log starts over with a Clear record
+    int ref = 0;
+    const bool userPerms;
+};
+
+typedef QHash<QString, QBinarySettingsFile *> BinarySettingsFileHash;
+Q_GLOBAL_STATIC(BinarySettingsFileHash, binarySettingsFiles)
+Q_CONSTINIT static QBasicMutex binarySettingsFilesMutex;
+
+QBinarySettingsFile *QBinarySettingsFile::fromName(const QString &fileName, bool userPerms)
+{
+    const QString absPath = QFileInfo(fileName).absoluteFilePath();
+    const auto locker = qt_scoped_lock(binarySettingsFilesMutex);
+    QBinarySettingsFile *&file = (*binarySettingsFiles)[absPath];
+    if (!file)
+        file = new QBinarySettingsFile(absPath, userPerms);
+    ++file->ref;
+    return file;
+}
+
+void QBinarySettingsFile::release(QBinarySettingsFile *file)
+{
+    const auto locker = qt_scoped_lock(binarySettingsFilesMutex);
+    if (--file->ref)
+        return;
+    if (binarySettingsFiles.exists())
+        binarySettingsFiles->remove(file->name);
+    delete file;
+}
+
+std::optional<QVariant> QBinarySettingsFile::value(const QString &key) const
+{
+    if (const auto it = pending.constFind(key); it != pending.cend())
+        return *it;
+    if (pendingClear)
+        return std::nullopt;
+
+    if (const auto it = log.constFind(key); it != log.cend()) {
+        const Record record = readRecord(data, *it);
+        if (record.type != SetRecord)
+            return std::nullopt;
+        return deserializedValue(record.value);
+    }
+
+    if (snapshotCleared || !header.indexSize)
+        return std::nullopt;
+    const QByteArray utf8 = key.toUtf8();
+    const uchar *index = bytes(data) + header.indexOffset;
+    const quint32 mask = header.indexSize - 1;
+    for (quint32 i = keyHash(utf8) & mask, n = 0; n < header.indexSize; i = (i + 1) & mask, ++n) {
+        const quint32 offset = qFromLittleEndian<quint32>(index + 4 * i);
+        if (!offset)
+            break;
+        const Record record = readRecord(data, offset);
+        if (record.isValid() && record.key == utf8)
+            return deserializedValue(record.value);
+    }
+    return std::nullopt;
+}
+
+/*
+    Calls \a callback for every key starting with \a prefix that has a
+    value in this file, once per key.
+*/
+template <typename Callback>
+void QBinarySettingsFile::forEachKey(const QString &prefix, Callback callback) const
+{
+    for (auto it = pending.cbegin(); it != pending.cend(); ++it) {
+        if (it.value() && it.key().startsWith(prefix))
+            callback(it.key());
+    }
+    if (pendingClear)
+        return;
+
+    for (auto it = log.cbegin(); it != log.cend(); ++it) {
+        if (!it.key().startsWith(prefix) || pending.contains(it.key()))
+            continue;
+        if (readRecord(data, it.value()).type == SetRecord)
+            callback(it.key());
+    }
+    if (snapshotCleared)
+        return;
+
+    // The snapshot is sorted, so the keys with the prefix are adjacent.
+    const QByteArray utf8Prefix = prefix.toUtf8();
+    quint32 offset = HeaderSize;
+    while (offset < header.snapshotEnd()) {
+        const Record record = readRecord(data.first(header.snapshotEnd()), offset);
+        if (!record.isValid())
+            break;
+        offset += record.size;
+        if (!record.key.startsWith(utf8Prefix)) {
+            if (record.key.compare(utf8Prefix) > 0)
+                break;
+            continue;
+        }
+        const QString key = QString::fromUtf8(record.key);
+        if (!pending.contains(key) && !log.contains(key))
+            callback(key);
+    }
+}
+
+bool QBinarySettingsFile::isWritable() const
+{
+    QFileInfo fileInfo(name);
+
+#if QT_CONFIG(temporaryfile)
+    if (fileInfo.exists()) {
+#endif
+        QFile file(name);
+        return file.open(QFile::ReadWrite);
+#if QT_CONFIG(temporaryfile)
+    } else {
+        QDir dir(fileInfo.absolutePath());
+        if (!dir.exists()) {
+            if (!dir.mkpath(dir.absolutePath()))
+                return false;
+        }
+
+        QTemporaryFile file(name);
+        return file.open();
+    }
+#endif
+}
+
+void QBinarySettingsFile::reset()
+{
+    file.reset();
+    contents.clear();
+    data = {};
+    header = {};
+    validEnd = 0;
+    log.clear();
+    snapshotCleared = false;
+}
+
+void QBinarySettingsFile::scanLog()
+{
+    while (validEnd < data.size()) {
+        const Record record = readRecord(data, validEnd);
+        if (!record.isValid())
+            break;
+        if (record.type == ClearRecord) {
+            log.clear();
+            snapshotCleared = true;
+        } else {
+            log.insert(QString::fromUtf8(record.key), validEnd);
+        }
+        validEnd += record.size;
+    }
+}
+
+/*
+    Maps the file again. Unless it was compacted or replaced in the
+    meantime, only the records appended since the last call are read.
+*/
+QSettings::Status QBinarySettingsFile::refresh()
+{
+    auto newFile = std::make_unique<QFile>(name);
+    // Files that we can't read are treated as empty files.
+    if (!newFile->open(QIODevice::ReadOnly) || newFile->size() == 0) {
+        reset();
+        return QSettings::NoError;
+    }
+
+    const qint64 size = newFile->size();
+    if (size < HeaderSize || size > std::numeric_limits<quint32>::max()) {
+        reset();
+        return QSettings::FormatError;
+    }
+
+    QByteArray newContents;
+    const uchar *mapped = newFile->map(0, size);
+    if (!mapped) {
+        newContents = newFile->readAll();
+        if (newContents.size() != size) {
+            reset();
+            return QSettings::AccessError;
+        }
+        mapped = reinterpret_cast<const uchar *>(newContents.constData());
+    }
+
+    const QByteArrayView newData(mapped, size);
+    Header newHeader;
+    if (!readHeader(newData, &newHeader)) {
+        reset();
+        return QSettings::FormatError;
+    }
+
+    const bool appended = !data.isEmpty() && newHeader.generation == header.generation
+            && size >= validEnd;
+    file = std::move(newFile);
+    contents = std::move(newContents);
+    data = newData;
+    if (!appended) {
+        header = newHeader;
+        validEnd = header.logOffset;
+        log.clear();
+        snapshotCleared = false;
+    }
+    scanLog();
+    return QSettings::NoError;
+}
+
+QByteArray QBinarySettingsFile::pendingRecords() const
+{
+    QByteArray result;
+    if (pendingClear)
+        appendRecord(result, ClearRecord, {}, {});
+    for (auto it = pending.cbegin(); it != pending.cend(); ++it) {
+        if (it.value())
+            appendRecord(result, SetRecord, it.key().toUtf8(), serializedValue(*it.value()));
+        else
+            appendRecord(result, RemoveRecord, it.key().toUtf8(), {});
+    }
+    return result;
+}
+
+// Returns a new file with a snapshot of the current settings and no log.
+QByteArray QBinarySettingsFile::compacted() const
+{
+    QMap<QByteArray, QByteArray> entries;
+    if (!pendingClear) {
+        if (!snapshotCleared) {
+            quint32 offset = HeaderSize;
+            while (offset < header.snapshotEnd()) {
+                const Record record = readRecord(data.first(header.snapshotEnd()), offset);
+                if (!record.isValid())
+                    break;
+                entries.insert(record.key.toByteArray(), record.value.toByteArray());
+                offset += record.size;
+            }
+        }
+        for (auto it = log.cbegin(); it != log.cend(); ++it) {
+            const Record record = readRecord(data, it.value());
+            if (record.type == SetRecord)
+                entries.insert(record.key.toByteArray(), record.value.toByteArray());
+            else
+                entries.remove(record.key.toByteArray());
+        }
+    }
+    for (auto it = pending.cbegin(); it != pending.cend(); ++it) {
+        if (it.value())
+            entries.insert(it.key().toUtf8(), serializedValue(*it.value()));
+        else
+            entries.remove(it.key().toUtf8());
+    }
+
+    Header newHeader;
+    do {
+        newHeader.generation = QRandomGenerator::global()->generate();
+    } while (newHeader.generation == header.generation);
+
+    QByteArray result(HeaderSize, '\0');
+    QList<std::pair<quint32, quint32>> offsets;     // hash and offset of each record
+    offsets.reserve(entries.size());
+    for (auto it = entries.cbegin(); it != entries.cend(); ++it) {
+        offsets.emplaceBack(keyHash(it.key()), quint32(result.size()));
+        appendRecord(result, SetRecord, it.key(), it.value());
+    }
+
+    // keep the load factor at or below one half
+    newHeader.indexSize = 8;
+    while (newHeader.indexSize < 2 * quint64(offsets.size()))
+        newHeader.indexSize *= 2;
+    newHeader.indexOffset = quint32(result.size());
+    result.resize(result.size() + 4 * qsizetype(newHeader.indexSize), '\0');
+    uchar *index = reinterpret_cast<uchar *>(result.data()) + newHeader.indexOffset;
+    const quint32 mask = newHeader.indexSize - 1;
+    for (const auto &[hash, offset] : std::as_const(offsets)) {
+        quint32 i = hash & mask;
+        while (qFromLittleEndian<quint32>(index + 4 * i))
+            i = (i + 1) & mask;
+        qToLittleEndian<quint32>(offset, index + 4 * i);
+    }
+
+    newHeader.logOffset = quint32(result.size());
+    writeHeader(reinterpret_cast<uchar *>(result.data()), newHeader);
+    return result;
+}
+
+QSettings::Status QBinarySettingsFile::write(bool atomicSyncOnly)
+{
+    if (!isWritable())
+        return QSettings::AccessError;
+
+    /*
+        Use a lockfile in order to protect us against other QSettings instances
+        trying to write the same settings at the same time. Readers don't need
+        it: appended records only become visible once their checksum matches,
+        and compaction replaces the file atomically.
+    */
+    QLockFile lockFile(name + ".lock"_L1);
+    if (!lockFile.lock() && atomicSyncOnly)
+        return QSettings::AccessError;
+
+    // Pick up what other processes wrote, and where our records go.
+    const QSettings::Status status = refresh();
+    if (status == QSettings::AccessError)
+        return status;
+
+    const bool createFile = !QFileInfo::exists(name);
+    const QByteArray records = pendingRecords();
+    const quint64 logSize = quint64(validEnd - header.logOffset) + records.size();
+    const bool compact = data.isEmpty() || status != QSettings::NoError || pendingClear
+            || logSize > std::max(MinimumCompactionSize, header.logOffset)
+            || validEnd + quint64(records.size()) > std::numeric_limits<quint32>::max();
+
+    if (compact) {
+        const QByteArray newContents = compacted();
+        if (newContents.size() > std::numeric_limits<quint32>::max())
+            return QSettings::AccessError;
+        // Some platforms can't replace a file that is still mapped.
+        reset();
+
+#if QT_CONFIG(temporaryfile)
+        QSaveFile sf(name);
+        sf.setDirectWriteFallback(!atomicSyncOnly);
+#else
+        QFile sf(name);
+#endif
+        if (!sf.open(QIODevice::WriteOnly) || sf.write(newContents) != newContents.size())
+            return QSettings::AccessError;
+#if QT_CONFIG(temporaryfile)
+        if (!sf.commit())
+            return QSettings::AccessError;
+#endif
+    } else {
+        QFile f(name);
+        if (!f.open(QIODevice::ReadWrite))
+            return QSettings::AccessError;
+        // drop whatever a crash left behind the last intact record
+        if (f.size() > validEnd && !f.resize(validEnd))
+            return QSettings::AccessError;
+        if (!f.seek(validEnd) || f.write(records) != records.size() || !f.flush())
+            return QSettings::AccessError;
+    }
+
+    pending.clear();
+    pendingClear = false;
+
+    // If we have created the file, apply the file perms
+    if (createFile) {
+        QFile::Permissions perms = QFileInfo(name).permissions() | QFile::ReadOwner | QFile::WriteOwner;
+        if (!userPerms)
+            perms |= QFile::ReadGroup | QFile::ReadOther;
+        QFile(name).setPermissions(perms);
+    }
+
+    return refresh();
+}
+
+// ************************************************************************
+// QBinarySettingsPrivate
+
+class QBinarySettingsPrivate : public QSettingsPrivate
+{
+public:
+    QBinarySettingsPrivate(QSettings::Format format, QSettings::Scope scope,
+                           const QString &organization, const QString &application);
+    QBinarySettingsPrivate(const QString &fileName, QSettings::Format format);
+    ~QBinarySettingsPrivate() override;
+
+    void remove(const QString &key) override;
+    void set(const QString &key, const QVariant &value) override;
+    std::optional<QVariant> get(const QString &key) const override;
+    QStringList children(const QString &prefix, ChildSpec spec) const override;
+    void clear() override;
+    void sync() override;
+    void flush() override;
+    bool isWritable() const override;
+    QString fileName() const override;
+
+private:
+    QList<QBinarySettingsFile *> files;
+};
+
+static constexpr auto binaryExtension = "qsbin"_L1;
+
+QBinarySettingsPrivate::QBinarySettingsPrivate(QSettings::Format format, QSettings::Scope scope,
+                                               const QString &organization,
+                                               const QString &application)
+    : QSettingsPrivate(format, scope, organization, application)
+{
+    QString org = organization;
+    if (org.isEmpty()) {
+        setStatus(QSettings::AccessError);
+        org = "Unknown Organization"_L1;
+    }
+
+    const auto paths = settingsFiles(format, scope, org, application, u'.' + binaryExtension);
+    for (const auto &[path, userPerms] : paths)
+        files.append(QBinarySettingsFile::fromName(path, userPerms));
+
+    sync();
+}
+
+QBinarySettingsPrivate::QBinarySettingsPrivate(const QString &fileName, QSettings::Format format)
+    : QSettingsPrivate(format)
+{
+    files.append(QBinarySettingsFile::fromName(fileName, true));
+
+    sync();
+}
+
+QBinarySettingsPrivate::~QBinarySettingsPrivate()
+{
+    for (QBinarySettingsFile *file : std::as_const(files))
+        QBinarySettingsFile::release(file);
+}
+
+void QBinarySettingsPrivate::remove(const QString &key)
+{
+    if (files.isEmpty())
+        return;
+
+    // Note: First file is always the most specific.
+    QBinarySettingsFile *file = files.at(0);
+    const auto locker = qt_scoped_lock(file->mutex);
+
+    QStringList removed = { key };
+    file->forEachKey(key + u'/', [&removed](const QString &child) { removed.append(child); });
+    for (const QString &k : std::as_const(removed))
+        file->pending.insert(k, std::nullopt);
+}
+
+void QBinarySettingsPrivate::set(const QString &key, const QVariant &value)
+{
+    if (files.isEmpty())
+        return;
+
+    QBinarySettingsFile *file = files.at(0);
+    const auto locker = qt_scoped_lock(file->mutex);
+    file->pending.insert(key, value);
+}
+
+std::optional<QVariant> QBinarySettingsPrivate::get(const QString &key) const
+{
+    for (QBinarySettingsFile *file : files) {
+        const auto locker = qt_scoped_lock(file->mutex);
+        if (std::optional<QVariant> value = file->value(key))
+            return value;
+        if (!fallbacks)
+            break;
+    }
+    return std::nullopt;
+}
+
+QStringList QBinarySettingsPrivate::children(const QString &prefix, ChildSpec spec) const
+{
+    QStringList result;
+    const qsizetype startPos = prefix.size();
+
+    for (QBinarySettingsFile *file : files) {
+        const auto locker = qt_scoped_lock(file->mutex);
+        file->forEachKey(prefix, [&](const QString &key) {
+            processChild(QStringView{key}.sliced(startPos), spec, result);
+        });
+        if (!fallbacks)
+            break;
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
+void QBinarySettingsPrivate::clear()
+{
+    if (files.isEmpty())
+        return;
+
+    QBinarySettingsFile *file = files.at(0);
+    const auto locker = qt_scoped_lock(file->mutex);
+    file->pending.clear();
+    file->pendingClear = true;
+}
+
+void QBinarySettingsPrivate::sync()
+{
+    for (QBinarySettingsFile *file : std::as_const(files)) {
+        const auto locker = qt_scoped_lock(file->mutex);
+        const QSettings::Status result = file->hasPendingChanges() ? file->write(atomicSyncOnly)
+                                                                   : file->refresh();
+        if (result != QSettings::NoError)
+            setStatus(result);
+    }
+}
+
+void QBinarySettingsPrivate::flush()
+{
+    sync();
+}
+
+bool QBinarySettingsPrivate::isWritable() const
+{
+    if (files.isEmpty())
+        return false;
+    return files.at(0)->isWritable();
+}
+
+QString QBinarySettingsPrivate::fileName() const
+{
+    if (files.isEmpty())
+        return QString();
+    return files.at(0)->name;
+}
+
+// ************************************************************************
+// Registration
+
+Q_CONSTINIT static QBasicAtomicInt binaryFormat = Q_BASIC_ATOMIC_INITIALIZER(QSettings::InvalidFormat);
+
+bool QSettingsPrivate::isBinaryFormat(QSettings::Format format)
+{
+    return format != QSettings::InvalidFormat && format == binaryFormat.loadAcquire();
+}
+
+QSettingsPrivate *QSettingsPrivate::createBinary(QSettings::Format format, QSettings::Scope scope,
+                                                 const QString &organization,
+                                                 const QString &application)
+{
+    return new QBinarySettingsPrivate(format, scope, organization, application);
+}
+
+QSettingsPrivate *QSettingsPrivate::createBinary(const QString &fileName, QSettings::Format format)
+{
+    return new QBinarySettingsPrivate(fileName, format);
+}
+
+/*
+    Returns the format of settings files that are memory-mapped and
+    appended to rather than parsed and rewritten as a whole, registering
+    it the first time. Returns QSettings::InvalidFormat if all custom
+    formats are taken.
+
+    Keys are case sensitive. Like for other custom formats, the files
+    live where the IniFormat files do, with a \c .qsbin extension.
+*/
+QSettings::Format QtPrivate::binarySettingsFormat()
+{
+    static const QSettings::Format format = [] {
+        const QSettings::Format registered = QSettings::registerFormat(binaryExtension, nullptr,
+                                                                       nullptr, Qt::CaseSensitive);
+        binaryFormat.storeRelease(registered);
+        return registered;
+    }();
+    return format;
+}
+
+QT_END_NAMESPACE
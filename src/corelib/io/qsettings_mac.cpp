@@ -550,6 +550,8 @@ QSettingsPrivate *QSettingsPrivate::create(QSettings::Format format,
 #endif
     if (format == QSettings::NativeFormat) {
         return new QMacSettingsPrivate(scope, organization, application);
+    } else if (isBinaryFormat(format)) {
+        return createBinary(format, scope, organization, application);
     } else {
         return new QConfFileSettingsPrivate(format, scope, organization, application);
     }
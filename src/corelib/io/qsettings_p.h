@@ -184,6 +184,17 @@ public:
     static QSettingsPrivate *create(QSettings::Format format, QSettings::Scope scope,
                                         const QString &organization, const QString &application);
     static QSettingsPrivate *create(const QString &fileName, QSettings::Format format);
+    static QList<std::pair<QString, bool>> settingsFiles(QSettings::Format format,
+                                                         QSettings::Scope scope,
+                                                         const QString &organization,
+                                                         const QString &application,
+                                                         const QString &extension);
+
+    // implemented in qsettings_binary.cpp
+    static bool isBinaryFormat(QSettings::Format format);
+    static QSettingsPrivate *createBinary(QSettings::Format format, QSettings::Scope scope,
+                                          const QString &organization, const QString &application);
+    static QSettingsPrivate *createBinary(const QString &fileName, QSettings::Format format);
 
     static void processChild(QStringView key, ChildSpec spec, QStringList &result);
 
@@ -269,6 +280,10 @@ private:
 #endif
 };
 
+namespace QtPrivate {
+Q_CORE_EXPORT QSettings::Format binarySettingsFormat();
+} // namespace QtPrivate
+
 QT_END_NAMESPACE
 
 #endif // QSETTINGS_P_H
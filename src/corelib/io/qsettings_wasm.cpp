@@ -367,6 +367,9 @@ QSettingsPrivate *QSettingsPrivate::create(QSettings::Format format, QSettings::
         format = QSettings::IniFormat;
     }
 
+    if (isBinaryFormat(format))
+        return createBinary(format, scope, organization, application);
+
     // Create settings backend according to selected format
     switch (format) {
     case QSettings::Format::WebLocalStorageFormat:
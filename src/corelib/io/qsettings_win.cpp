@@ -804,6 +804,8 @@ QSettingsPrivate *QSettingsPrivate::create(QSettings::Format format, QSettings::
     default:
         break;
     }
+    if (isBinaryFormat(format))
+        return createBinary(format, scope, organization, application);
     return new QConfFileSettingsPrivate(format, scope, organization, application);
 }
 
@@ -819,6 +821,8 @@ QSettingsPrivate *QSettingsPrivate::create(const QString &fileName, QSettings::F
     default:
         break;
     }
+    if (isBinaryFormat(format))
+        return createBinary(fileName, format);
     return new QConfFileSettingsPrivate(fileName, format);
 }
 
@@ -8,14 +8,26 @@
 #include <qendian.h>
 #include <qdebug.h>
 #include <qdir.h>
+#include <qhash.h>
+#if QT_CONFIG(thread)
+#  include <qsemaphore.h>
+#  include <qthreadpool.h>
+#endif
 
+#include <deque>
 #include <memory>
 
 #include <zlib.h>
+#if QT_CONFIG(zstd)
+#  include <zstd.h>
+#endif
 
 // Zip standard version for archives handled by this API
 // (actually, the only basic support of this version is implemented but it is enough for now)
 #define ZIP_VERSION 20
+// needed for entries that use the ZIP64 extensions or Zstandard compression
+#define ZIP64_VERSION 45
+#define ZSTD_VERSION 63
 
 #if 0
 #define ZDEBUG qDebug
@@ -35,6 +47,11 @@ static inline ushort readUShort(const uchar *data)
     return (data[0]) + (data[1]<<8);
 }
 
+static inline quint64 readULongLong(const uchar *data)
+{
+    return quint64(readUInt(data)) | (quint64(readUInt(data + 4)) << 32);
+}
+
 static inline void writeUInt(uchar *data, uint i)
 {
     data[0] = i & 0xff;
@@ -49,6 +66,12 @@ static inline void writeUShort(uchar *data, ushort i)
     data[1] = (i>>8) & 0xff;
 }
 
+static inline void writeULongLong(uchar *data, quint64 i)
+{
+    writeUInt(data, uint(i));
+    writeUInt(data + 4, uint(i >> 32));
+}
+
 static inline void copyUInt(uchar *dest, const uchar *src)
 {
     dest[0] = src[0];
@@ -89,39 +112,15 @@ static void writeMSDosDate(uchar *dest, const QDateTime& dt)
     }
 }
 
-static int inflate(Bytef *dest, ulong *destLen, const Bytef *source, ulong sourceLen)
+static uint crc32(const QByteArray &data)
 {
-    z_stream stream;
-    int err;
-
-    stream.next_in = const_cast<Bytef*>(source);
-    stream.avail_in = (uInt)sourceLen;
-    if ((uLong)stream.avail_in != sourceLen)
-        return Z_BUF_ERROR;
-
-    stream.next_out = dest;
-    stream.avail_out = (uInt)*destLen;
-    if ((uLong)stream.avail_out != *destLen)
-        return Z_BUF_ERROR;
-
-    stream.zalloc = (alloc_func)nullptr;
-    stream.zfree = (free_func)nullptr;
-
-    err = inflateInit2(&stream, -MAX_WBITS);
-    if (err != Z_OK)
-        return err;
-
-    err = inflate(&stream, Z_FINISH);
-    if (err != Z_STREAM_END) {
-        inflateEnd(&stream);
-        if (err == Z_NEED_DICT || (err == Z_BUF_ERROR && stream.avail_in == 0))
-            return Z_DATA_ERROR;
-        return err;
+    uint crc_32 = ::crc32(0, nullptr, 0);
+    for (qsizetype pos = 0; pos < data.size(); ) {
+        const uInt len = uInt(qMin<qsizetype>(data.size() - pos, std::numeric_limits<uInt>::max()));
+        crc_32 = ::crc32(crc_32, reinterpret_cast<const uchar *>(data.constData()) + pos, len);
+        pos += len;
     }
-    *destLen = stream.total_out;
-
-    err = inflateEnd(&stream);
-    return err;
+    return crc_32;
 }
 
 static int deflate (Bytef *dest, ulong *destLen, const Bytef *source, ulong sourceLen)
@@ -306,6 +305,8 @@ enum CompressionMethod {
     CompressionMethodTerse = 18,
     CompressionMethodLz77 = 19,
 
+    CompressionMethodZstd = 93,
+
     CompressionMethodJpeg = 96,
     CompressionMethodWavPack = 97,
     CompressionMethodPPMd = 98,
@@ -370,15 +371,120 @@ struct EndOfDirectory
 };
 Q_DECLARE_TYPEINFO(EndOfDirectory, Q_PRIMITIVE_TYPE);
 
+struct Zip64EndOfDirectory
+{
+    uchar signature[4]; // 0x06064b50
+    uchar record_size[8];
+    uchar version_made[2];
+    uchar version_needed[2];
+    uchar this_disk[4];
+    uchar start_of_directory_disk[4];
+    uchar num_dir_entries_this_disk[8];
+    uchar num_dir_entries[8];
+    uchar directory_size[8];
+    uchar dir_start_offset[8];
+};
+Q_DECLARE_TYPEINFO(Zip64EndOfDirectory, Q_PRIMITIVE_TYPE);
+
+struct Zip64EndOfDirectoryLocator
+{
+    uchar signature[4]; // 0x07064b50
+    uchar start_of_directory_disk[4];
+    uchar eod_offset[8];
+    uchar total_disks[4];
+};
+Q_DECLARE_TYPEINFO(Zip64EndOfDirectoryLocator, Q_PRIMITIVE_TYPE);
+
+// Fields of the headers that do not fit are set to these, and the actual
+// values are in the ZIP64 extended information extra field, or in the ZIP64
+// end of central directory record.
+enum : uint { Zip64Marker = 0xffffffff };
+enum : ushort { Zip64CountMarker = 0xffff, Zip64ExtraFieldId = 0x0001 };
+
 struct FileHeader
 {
     CentralFileHeader h;
     QByteArray file_name;
     QByteArray extra_field;
     QByteArray file_comment;
+
+    // from h, or from the ZIP64 extra field
+    quint64 compressedSize = 0;
+    quint64 uncompressedSize = 0;
+    quint64 localHeaderOffset = 0;
+
+    void readSizes();
+    void setSizes(quint64 uncompressed, quint64 compressed, quint64 offset);
 };
 Q_DECLARE_TYPEINFO(FileHeader, Q_RELOCATABLE_TYPE);
 
+void FileHeader::readSizes()
+{
+    uncompressedSize = readUInt(h.uncompressed_size);
+    compressedSize = readUInt(h.compressed_size);
+    localHeaderOffset = readUInt(h.offset_local_header);
+    if (uncompressedSize != Zip64Marker && compressedSize != Zip64Marker
+        && localHeaderOffset != Zip64Marker) {
+        return;
+    }
+
+    // the ZIP64 extra field only has the values that did not fit, in this order
+    const uchar *p = reinterpret_cast<const uchar *>(extra_field.constData());
+    const uchar *end = p + extra_field.size();
+    while (end - p >= 4) {
+        const ushort id = readUShort(p);
+        const ushort length = readUShort(p + 2);
+        p += 4;
+        if (length > end - p)
+            break;
+        if (id == Zip64ExtraFieldId) {
+            const uchar *field = p;
+            const uchar *fieldEnd = p + length;
+            for (quint64 *value : { &uncompressedSize, &compressedSize, &localHeaderOffset }) {
+                if (*value == Zip64Marker && fieldEnd - field >= 8) {
+                    *value = readULongLong(field);
+                    field += 8;
+                }
+            }
+            return;
+        }
+        p += length;
+    }
+}
+
+// Sets the sizes and the offset in the central directory header, adding the
+// ZIP64 extra field if any of them does not fit.
+void FileHeader::setSizes(quint64 uncompressed, quint64 compressed, quint64 offset)
+{
+    uncompressedSize = uncompressed;
+    compressedSize = compressed;
+    localHeaderOffset = offset;
+
+    uchar zip64[4 + 3 * 8];
+    uchar *field = zip64 + 4;
+    auto setField = [&field](uchar *dest, quint64 value) {
+        if (value < Zip64Marker) {
+            writeUInt(dest, uint(value));
+        } else {
+            writeUInt(dest, Zip64Marker);
+            writeULongLong(field, value);
+            field += 8;
+        }
+    };
+    setField(h.uncompressed_size, uncompressed);
+    setField(h.compressed_size, compressed);
+    setField(h.offset_local_header, offset);
+
+    extra_field.clear();
+    if (field != zip64 + 4) {
+        writeUShort(zip64, Zip64ExtraFieldId);
+        writeUShort(zip64 + 2, ushort(field - zip64 - 4));
+        extra_field = QByteArray(reinterpret_cast<const char *>(zip64), field - zip64);
+        writeUShort(h.version_needed, qMax(readUShort(h.version_needed), ushort(ZIP64_VERSION)));
+    }
+    writeUShort(h.extra_field_length, ushort(extra_field.size()));
+}
+
 class QZipPrivate
 {
 public:
@@ -400,7 +506,7 @@ public:
     bool dirtyFileTree;
     QList<FileHeader> fileHeaders;
     QByteArray comment;
-    uint start_of_directory;
+    qint64 start_of_directory;
 };
 
 QZipReader::FileInfo QZipPrivate::fillFileInfo(int index) const
@@ -455,7 +561,7 @@ QZipReader::FileInfo QZipPrivate::fillFileInfo(int index) const
     const bool inUtf8 = (general_purpose_bits & Utf8Names) != 0;
     fileInfo.filePath = inUtf8 ? QString::fromUtf8(header.file_name) : QString::fromLocal8Bit(header.file_name);
     fileInfo.crc = readUInt(header.h.crc_32);
-    fileInfo.size = readUInt(header.h.uncompressed_size);
+    fileInfo.size = qint64(header.uncompressedSize);
     fileInfo.lastModified = readMSDosDate(header.h.last_mod_file);
 
     // fix the file path, if broken (convert separators, eat leading and trailing ones)
@@ -479,10 +585,16 @@ public:
     }
 
     void scanFiles();
+    int indexOf(const QString &fileName);
+    std::unique_ptr<QIODevice> openFile(int index);
 
     QZipReader::Status status;
+    QHash<QString, int> fileNameIndex;
 };
 
+struct QZipWriterEntry;
+
+
 class QZipWriterPrivate : public QZipPrivate
 {
 public:
@@ -490,17 +602,33 @@ public:
         : QZipPrivate(device, ownDev),
         status(QZipWriter::NoError),
         permissions(QFile::ReadOwner | QFile::WriteOwner),
-        compressionPolicy(QZipWriter::AlwaysCompress)
+        compressionPolicy(QZipWriter::AlwaysCompress),
+        compressionAlgorithm(QZipWriter::Deflate)
     {
     }
+    ~QZipWriterPrivate();
 
     QZipWriter::Status status;
     QFile::Permissions permissions;
     QZipWriter::CompressionPolicy compressionPolicy;
+    QZipWriter::CompressionAlgorithm compressionAlgorithm;
 
     enum EntryType { Directory, File, Symlink };
 
     void addEntry(EntryType type, const QString &fileName, const QByteArray &contents);
+    void addStreamedEntry(const QString &fileName, QIODevice *source);
+    void writePendingEntries(bool wait);
+
+private:
+    bool openDevice();
+    FileHeader makeHeader(EntryType type, const QString &fileName) const;
+    CompressionMethod compressionMethod() const;
+    void writeEntry(QZipWriterEntry &entry);
+    void write(const void *data, qint64 size);
+    void write(const QByteArray &data) { write(data.constData(), data.size()); }
+
+    // compressed in parallel, written in order
+    std::deque<std::unique_ptr<QZipWriterEntry>> pendingEntries;
 };
 
 static LocalFileHeader toLocalHeader(const CentralFileHeader &ch)
@@ -535,6 +663,7 @@ void QZipReaderPrivate::scanFiles()
     }
 
     dirtyFileTree = false;
+    fileNameIndex.clear();
     uchar tmp[4];
     device->read((char *)tmp, 4);
     if (readUInt(tmp) != 0x04034b50) {
@@ -542,37 +671,54 @@ void QZipReaderPrivate::scanFiles()
         return;
     }
 
-    // find EndOfDirectory header
-    int i = 0;
-    int start_of_directory = -1;
-    int num_dir_entries = 0;
-    EndOfDirectory eod;
-    while (start_of_directory == -1) {
-        const int pos = device->size() - int(sizeof(EndOfDirectory)) - i;
-        if (pos < 0 || i > 65535) {
-            qWarning("QZip: EndOfDirectory not found");
-            return;
-        }
-
-        device->seek(pos);
-        device->read((char *)&eod, sizeof(EndOfDirectory));
-        if (readUInt(eod.signature) == 0x06054b50)
+    // find EndOfDirectory header; it is followed by a comment of up to 65535 bytes
+    const qint64 size = device->size();
+    const qint64 tailSize = qMin<qint64>(size, sizeof(EndOfDirectory) + 0xffff);
+    device->seek(size - tailSize);
+    const QByteArray tail = device->read(tailSize);
+    qsizetype i = tail.size() - qsizetype(sizeof(EndOfDirectory));
+    for (; i >= 0; --i) {
+        if (readUInt(reinterpret_cast<const uchar *>(tail.constData()) + i) == 0x06054b50)
             break;
-        ++i;
     }
+    if (i < 0) {
+        qWarning("QZip: EndOfDirectory not found");
+        return;
+    }
+    EndOfDirectory eod;
+    memcpy(&eod, tail.constData() + i, sizeof(EndOfDirectory));
+    const qint64 eodOffset = size - tail.size() + i;
 
     // have the eod
-    start_of_directory = readUInt(eod.dir_start_offset);
-    num_dir_entries = readUShort(eod.num_dir_entries);
-    ZDEBUG("start_of_directory at %d, num_dir_entries=%d", start_of_directory, num_dir_entries);
-    int comment_length = readUShort(eod.comment_length);
-    if (comment_length != i)
+    quint64 start_of_directory = readUInt(eod.dir_start_offset);
+    quint64 num_dir_entries = readUShort(eod.num_dir_entries);
+    const qsizetype trailing = tail.size() - i - qsizetype(sizeof(EndOfDirectory));
+    const int comment_length = readUShort(eod.comment_length);
+    if (comment_length != trailing)
         qWarning("QZip: failed to parse zip file.");
-    comment = device->read(qMin(comment_length, i));
-
+    comment = tail.mid(i + sizeof(EndOfDirectory), qMin<qsizetype>(comment_length, trailing));
+
+    // the ZIP64 end of central directory record has the values that do not fit
+    if (start_of_directory == Zip64Marker || num_dir_entries == Zip64CountMarker
+        || readUInt(eod.directory_size) == Zip64Marker) {
+        Zip64EndOfDirectoryLocator locator;
+        Zip64EndOfDirectory eod64;
+        if (eodOffset >= qint64(sizeof(locator)) && device->seek(eodOffset - sizeof(locator))
+            && device->read((char *)&locator, sizeof(locator)) == sizeof(locator)
+            && readUInt(locator.signature) == 0x07064b50
+            && device->seek(readULongLong(locator.eod_offset))
+            && device->read((char *)&eod64, sizeof(eod64)) == sizeof(eod64)
+            && readUInt(eod64.signature) == 0x06064b50) {
+            start_of_directory = readULongLong(eod64.dir_start_offset);
+            num_dir_entries = readULongLong(eod64.num_dir_entries);
+        } else {
+            qWarning("QZip: Zip64EndOfDirectory not found, index may be incomplete");
+        }
+    }
+    ZDEBUG("start_of_directory at %llu, num_dir_entries=%llu", start_of_directory, num_dir_entries);
 
     device->seek(start_of_directory);
-    for (i = 0; i < num_dir_entries; ++i) {
+    for (quint64 n = 0; n < num_dir_entries; ++n) {
         FileHeader header;
         int read = device->read((char *) &header.h, sizeof(CentralFileHeader));
         if (read < (int)sizeof(CentralFileHeader)) {
@@ -602,49 +748,313 @@ void QZipReaderPrivate::scanFiles()
             qWarning("QZip: Failed to read read file comment, index may be incomplete");
             break;
         }
+        header.readSizes();
 
         ZDEBUG("found file '%s'", header.file_name.data());
         fileHeaders.append(header);
     }
 }
 
-void QZipWriterPrivate::addEntry(EntryType type, const QString &fileName, const QByteArray &contents/*, QFile::Permissions permissions, QZip::Method m*/)
+int QZipReaderPrivate::indexOf(const QString &fileName)
 {
-#ifndef NDEBUG
-    static const char *const entryTypes[] = {
-        "directory",
-        "file     ",
-        "symlink  " };
-    ZDEBUG() << "adding" << entryTypes[type] <<":" << fileName.toUtf8().data() << (type == 2 ? QByteArray(" -> " + contents).constData() : "");
+    scanFiles();
+    if (fileNameIndex.isEmpty() && !fileHeaders.isEmpty()) {
+        fileNameIndex.reserve(fileHeaders.size());
+        for (int i = 0; i < fileHeaders.size(); ++i) {
+            const FileHeader &header = fileHeaders.at(i);
+            const bool inUtf8 = (readUShort(header.h.general_purpose_bits) & Utf8Names) != 0;
+            const QString name = inUtf8 ? QString::fromUtf8(header.file_name)
+                                        : QString::fromLocal8Bit(header.file_name);
+            // like a linear search would, find the first of duplicate entries
+            if (!fileNameIndex.contains(name))
+                fileNameIndex.insert(name, i);
+        }
+    }
+    return fileNameIndex.value(fileName, -1);
+}
+
+namespace {
+// Decompresses one entry of an archive while it is being read, so that it
+// never has to be in memory as a whole.
+class QZipEntryReader final : public QIODevice
+{
+public:
+    QZipEntryReader(QIODevice *archive, qint64 dataOffset, const FileHeader &header, int method);
+    ~QZipEntryReader() override;
+
+    bool isSequential() const override { return true; }
+    // Only promises a chunk at a time, as readAll() would allocate all of it
+    // up front, and the size in the header may be wrong. Until the end of the
+    // data, there's at least one more byte, whatever the header says.
+    qint64 bytesAvailable() const override
+    {
+        if (finished || failed)
+            return QIODevice::bytesAvailable();
+        const quint64 left = uncompressedSize > produced ? uncompressedSize - produced : 1;
+        return QIODevice::bytesAvailable() + qint64(qMin<quint64>(left, ChunkSize));
+    }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override;
+    qint64 writeData(const char *, qint64) override { return -1; }
+
+private:
+    enum { ChunkSize = 64 * 1024 };
+
+    bool fillInput();
+    qint64 decompress(char *data, qint64 maxSize);
+    void fail(const char *message);
+
+    QIODevice *archive;
+    qint64 inputPos;
+    qint64 inputEnd;
+    quint64 uncompressedSize;
+    quint64 produced = 0;
+    uint expectedCrc;
+    uint crc;
+    int method;
+    bool finished = false;
+    bool failed = false;
+
+    QByteArray input;
+    qsizetype inputOffset = 0;
+    z_stream zstream = {};
+#if QT_CONFIG(zstd)
+    ZSTD_DStream *zstdStream = nullptr;
 #endif
+};
 
-    if (! (device->isOpen() || device->open(QIODevice::WriteOnly))) {
-        status = QZipWriter::FileOpenError;
-        return;
+QZipEntryReader::QZipEntryReader(QIODevice *archive, qint64 dataOffset, const FileHeader &header,
+                                 int method)
+    : archive(archive),
+      inputPos(dataOffset),
+      inputEnd(dataOffset + qint64(header.compressedSize)),
+      uncompressedSize(header.uncompressedSize),
+      expectedCrc(readUInt(header.h.crc_32)),
+      crc(::crc32(0, nullptr, 0)),
+      method(method)
+{
+    if (method == CompressionMethodDeflated) {
+        // raw deflate data, without zlib header
+        if (inflateInit2(&zstream, -MAX_WBITS) != Z_OK)
+            fail("QZip: Failed to initialize zlib");
+#if QT_CONFIG(zstd)
+    } else if (method == CompressionMethodZstd) {
+        zstdStream = ZSTD_createDStream();
+        if (!zstdStream)
+            fail("QZip: Failed to initialize zstd");
+#endif
     }
-    device->seek(start_of_directory);
+    open(QIODevice::ReadOnly);
+}
 
-    // don't compress small files
-    QZipWriter::CompressionPolicy compression = compressionPolicy;
-    if (compressionPolicy == QZipWriter::AutoCompress) {
-        if (contents.size() < 64)
-            compression = QZipWriter::NeverCompress;
-        else
-            compression = QZipWriter::AlwaysCompress;
+QZipEntryReader::~QZipEntryReader()
+{
+    if (method == CompressionMethodDeflated)
+        inflateEnd(&zstream);
+#if QT_CONFIG(zstd)
+    ZSTD_freeDStream(zstdStream);
+#endif
+}
+
+void QZipEntryReader::fail(const char *message)
+{
+    qWarning("%s", message);
+    setErrorString(QString::fromLatin1(message));
+    failed = true;
+}
+
+// Makes sure there is unconsumed input, reading the next chunk from the archive
+// if needed. The archive may be used for other entries in between.
+bool QZipEntryReader::fillInput()
+{
+    if (inputOffset < input.size())
+        return true;
+    if (inputPos >= inputEnd)
+        return false;
+    if (archive->pos() != inputPos && !archive->seek(inputPos)) {
+        fail("QZip: Failed to seek in the archive");
+        return false;
+    }
+    input = archive->read(qMin<qint64>(ChunkSize, inputEnd - inputPos));
+    inputOffset = 0;
+    if (input.isEmpty()) {
+        fail("QZip: Failed to read from the archive");
+        return false;
+    }
+    inputPos += input.size();
+    return true;
+}
+
+// Returns the number of bytes decompressed into data, at least one unless the
+// entry is finished, or -1 on error.
+qint64 QZipEntryReader::decompress(char *data, qint64 maxSize)
+{
+    if (method == CompressionMethodStored) {
+        if (!fillInput()) {
+            finished = !failed;
+            return failed ? -1 : 0;
+        }
+        const qsizetype n = qsizetype(qMin<qint64>(maxSize, input.size() - inputOffset));
+        memcpy(data, input.constData() + inputOffset, n);
+        inputOffset += n;
+        finished = inputOffset == input.size() && inputPos >= inputEnd;
+        return n;
     }
 
+    const uInt outSize = uInt(qMin<qint64>(maxSize, std::numeric_limits<uInt>::max()));
+    zstream.next_out = reinterpret_cast<Bytef *>(data);
+    zstream.avail_out = outSize;
+#if QT_CONFIG(zstd)
+    ZSTD_outBuffer out = { data, size_t(outSize), 0 };
+#endif
+    do {
+        if (!fillInput()) {
+            if (!failed)
+                fail("QZip: Unexpected end of compressed data");
+            return -1;
+        }
+#if QT_CONFIG(zstd)
+        if (method == CompressionMethodZstd) {
+            ZSTD_inBuffer in = { input.constData(), size_t(input.size()), size_t(inputOffset) };
+            const size_t res = ZSTD_decompressStream(zstdStream, &out, &in);
+            inputOffset = qsizetype(in.pos);
+            if (ZSTD_isError(res)) {
+                fail("QZip: Input data is corrupted");
+                return -1;
+            }
+            if (res == 0) {
+                finished = true;
+                return qint64(out.pos);
+            }
+            continue;
+        }
+#endif
+        zstream.next_in = reinterpret_cast<Bytef *>(input.data()) + inputOffset;
+        zstream.avail_in = uInt(input.size() - inputOffset);
+        const int res = ::inflate(&zstream, Z_NO_FLUSH);
+        inputOffset = input.size() - zstream.avail_in;
+        if (res == Z_STREAM_END) {
+            finished = true;
+            break;
+        }
+        if (res != Z_OK) {
+            fail(res == Z_MEM_ERROR ? "QZip: Z_MEM_ERROR: Not enough memory"
+                                    : "QZip: Z_DATA_ERROR: Input data is corrupted");
+            return -1;
+        }
+#if QT_CONFIG(zstd)
+    } while (method == CompressionMethodZstd ? out.pos == 0 : zstream.avail_out == outSize);
+    if (method == CompressionMethodZstd)
+        return qint64(out.pos);
+#else
+    } while (zstream.avail_out == outSize);
+#endif
+    return outSize - zstream.avail_out;
+}
+
+qint64 QZipEntryReader::readData(char *data, qint64 maxSize)
+{
+    qint64 total = 0;
+    while (!failed && !finished && total < maxSize) {
+        const qint64 n = decompress(data + total, maxSize - total);
+        if (n < 0)
+            break;
+        crc = ::crc32(crc, reinterpret_cast<const uchar *>(data + total), uInt(n));
+        produced += n;
+        total += n;
+        if (finished && (crc != expectedCrc || produced != uncompressedSize))
+            fail("QZip: The checksum or the size of the entry does not match");
+    }
+    return total == 0 && failed ? -1 : total;
+}
+} // unnamed namespace
+
+std::unique_ptr<QIODevice> QZipReaderPrivate::openFile(int index)
+{
+    const FileHeader &header = fileHeaders.at(index);
+
+    int compression_method = readUShort(header.h.compression_method);
+    ZDEBUG("file=%s: compressed=%llu, uncompressed=%llu", header.file_name.data(),
+           header.compressedSize, header.uncompressedSize);
+
+    ZDEBUG("file: %llu %d", header.localHeaderOffset, (int)device->size());
+    LocalFileHeader lh;
+    if (!device->seek(header.localHeaderOffset)
+        || device->read((char *)&lh, sizeof(LocalFileHeader)) != sizeof(LocalFileHeader)
+        || readUInt(lh.signature) != 0x04034b50) {
+        qWarning("QZip: Failed to read the local file header");
+        return nullptr;
+    }
+    const qint64 dataOffset = qint64(header.localHeaderOffset) + sizeof(LocalFileHeader)
+            + readUShort(lh.file_name_length) + readUShort(lh.extra_field_length);
+
+    const ushort version_needed = readUShort(lh.version_needed);
+    if (version_needed > ZSTD_VERSION) {
+        qWarning("QZip: .ZIP specification version %d implementationis needed to extract the data.", version_needed);
+        return nullptr;
+    }
+
+    ushort general_purpose_bits = readUShort(lh.general_purpose_bits);
+    if ((general_purpose_bits & Encrypted) != 0) {
+        qWarning("QZip: Unsupported encryption method is needed to extract the data.");
+        return nullptr;
+    }
+
+    compression_method = readUShort(lh.compression_method);
+    ZDEBUG("file=%s: local header compression method=%d", header.file_name.data(), compression_method);
+
+    switch (compression_method) {
+    case CompressionMethodStored:
+    case CompressionMethodDeflated:
+#if QT_CONFIG(zstd)
+    case CompressionMethodZstd:
+#endif
+        return std::make_unique<QZipEntryReader>(device, dataOffset, header, compression_method);
+    default:
+        qWarning("QZip: Unsupported compression method %d is needed to extract the data.", compression_method);
+        return nullptr;
+    }
+}
+
+//////////////////////////////  Writer internals
+
+namespace {
+// Bytes that, if reached by an entry, make the writer stream it in chunks
+// instead of compressing it in memory.
+constexpr qint64 StreamingThreshold = 16 * 1024 * 1024;
+// Entries smaller than this are not worth handing over to another thread.
+constexpr qsizetype ParallelThreshold = 16 * 1024;
+constexpr qsizetype ChunkSize = 64 * 1024;
+// Longest a sequential source may go without delivering data (in ms) before
+// its entry is considered complete.
+constexpr int ReadTimeout = 30 * 1000;
+}
+
+struct QZipWriterEntry
+{
     FileHeader header;
-    memset(&header.h, 0, sizeof(CentralFileHeader));
-    writeUInt(header.h.signature, 0x02014b50);
+    QByteArray contents;        // released once compressed
+    QByteArray data;            // what goes into the archive
+    quint64 uncompressedSize = 0;
+    CompressionMethod method = CompressionMethodStored;
+    bool storeIfLarger = false;
+#if QT_CONFIG(thread)
+    QSemaphore done;
+    std::unique_ptr<QRunnable> task;
+#endif
 
-    writeUShort(header.h.version_needed, ZIP_VERSION);
-    writeUInt(header.h.uncompressed_size, contents.size());
-    writeMSDosDate(header.h.last_mod_file, QDateTime::currentDateTime());
-    QByteArray data = contents;
-    if (compression == QZipWriter::AlwaysCompress) {
-        writeUShort(header.h.compression_method, CompressionMethodDeflated);
+    void compress();
+};
+
+void QZipWriterEntry::compress()
+{
+    writeUInt(header.h.crc_32, crc32(contents));
+    uncompressedSize = contents.size();
 
-       ulong len = contents.size();
+    switch (method) {
+    case CompressionMethodDeflated: {
+        ulong len = contents.size();
         // shamelessly copied form zlib
         len += (len >> 12) + (len >> 14) + 11;
         int res;
@@ -657,20 +1067,85 @@ void QZipWriterPrivate::addEntry(EntryType type, const QString &fileName, const
                 data.resize(len);
                 break;
             case Z_MEM_ERROR:
-                qWarning("QZip: Z_MEM_ERROR: Not enough memory to compress file, skipping");
-                data.resize(0);
+                qWarning("QZip: Z_MEM_ERROR: Not enough memory to compress file, storing it");
+                method = CompressionMethodStored;
                 break;
             case Z_BUF_ERROR:
                 len *= 2;
                 break;
             }
         } while (res == Z_BUF_ERROR);
+        break;
+    }
+#if QT_CONFIG(zstd)
+    case CompressionMethodZstd: {
+        data.resize(ZSTD_compressBound(contents.size()));
+        const size_t res = ZSTD_compress(data.data(), data.size(), contents.constData(),
+                                         contents.size(), ZSTD_CLEVEL_DEFAULT);
+        if (ZSTD_isError(res)) {
+            qWarning("QZip: Failed to compress file with zstd (%s), storing it",
+                     ZSTD_getErrorName(res));
+            method = CompressionMethodStored;
+        } else {
+            data.resize(res);
+        }
+        break;
+    }
+#endif
+    default:
+        break;
     }
-// TODO add a check if data.length() > contents.length().  Then try to store the original and revert the compression method to be uncompressed
-    writeUInt(header.h.compressed_size, data.size());
-    uint crc_32 = ::crc32(0, nullptr, 0);
-    crc_32 = ::crc32(crc_32, (const uchar *)contents.constData(), contents.size());
-    writeUInt(header.h.crc_32, crc_32);
+
+    if (method == CompressionMethodStored || (storeIfLarger && data.size() >= contents.size())) {
+        method = CompressionMethodStored;
+        data = contents;
+    }
+    writeUShort(header.h.compression_method, method);
+    if (method == CompressionMethodZstd)
+        writeUShort(header.h.version_needed, ZSTD_VERSION);
+    contents = QByteArray();
+}
+
+QZipWriterPrivate::~QZipWriterPrivate()
+{
+    // nothing may be compressing into entries that are about to go away
+    writePendingEntries(true);
+}
+
+bool QZipWriterPrivate::openDevice()
+{
+    if (! (device->isOpen() || device->open(QIODevice::WriteOnly))) {
+        status = QZipWriter::FileOpenError;
+        return false;
+    }
+    return true;
+}
+
+void QZipWriterPrivate::write(const void *data, qint64 size)
+{
+    if (device->write(static_cast<const char *>(data), size) != size && status == QZipWriter::NoError)
+        status = QZipWriter::FileWriteError;
+}
+
+CompressionMethod QZipWriterPrivate::compressionMethod() const
+{
+    if (compressionPolicy == QZipWriter::NeverCompress)
+        return CompressionMethodStored;
+#if QT_CONFIG(zstd)
+    if (compressionAlgorithm == QZipWriter::Zstandard)
+        return CompressionMethodZstd;
+#endif
+    return CompressionMethodDeflated;
+}
+
+FileHeader QZipWriterPrivate::makeHeader(EntryType type, const QString &fileName) const
+{
+    FileHeader header;
+    memset(&header.h, 0, sizeof(CentralFileHeader));
+    writeUInt(header.h.signature, 0x02014b50);
+
+    writeUShort(header.h.version_needed, ZIP_VERSION);
+    writeMSDosDate(header.h.last_mod_file, QDateTime::currentDateTime());
 
     // if bit 11 is set, the filename and comment fields must be encoded using UTF-8
     ushort general_purpose_bits = Utf8Names; // always use utf-8
@@ -687,7 +1162,6 @@ void QZipWriterPrivate::addEntry(EntryType type, const QString &fileName, const
         header.file_comment.truncate(0xffff - header.file_name.size()); // ### don't break the utf-8 sequence, if any
     }
     writeUShort(header.h.file_name_length, header.file_name.size());
-    //h.extra_field_length[2];
 
     writeUShort(header.h.version_made, HostUnix << 8);
     //uchar internal_file_attributes[2];
@@ -708,16 +1182,285 @@ void QZipWriterPrivate::addEntry(EntryType type, const QString &fileName, const
         break;
     }
     writeUInt(header.h.external_file_attributes, mode << 16);
-    writeUInt(header.h.offset_local_header, start_of_directory);
-
+    return header;
+}
 
-    fileHeaders.append(header);
+// Writes a compressed entry at the end of the archive.
+void QZipWriterPrivate::writeEntry(QZipWriterEntry &entry)
+{
+    FileHeader &header = entry.header;
+    header.setSizes(entry.uncompressedSize, entry.data.size(), start_of_directory);
 
+    // the local header only needs the ZIP64 extra field for the sizes
     LocalFileHeader h = toLocalHeader(header.h);
-    device->write((const char *)&h, sizeof(LocalFileHeader));
-    device->write(header.file_name);
-    device->write(data);
+    QByteArray extra;
+    if (header.uncompressedSize >= Zip64Marker || header.compressedSize >= Zip64Marker) {
+        uchar zip64[4 + 2 * 8];
+        writeUShort(zip64, Zip64ExtraFieldId);
+        writeUShort(zip64 + 2, 2 * 8);
+        writeULongLong(zip64 + 4, header.uncompressedSize);
+        writeULongLong(zip64 + 12, header.compressedSize);
+        writeUInt(h.uncompressed_size, Zip64Marker);
+        writeUInt(h.compressed_size, Zip64Marker);
+        extra = QByteArray(reinterpret_cast<const char *>(zip64), sizeof(zip64));
+    }
+    writeUShort(h.extra_field_length, ushort(extra.size()));
+
+    device->seek(start_of_directory);
+    write(&h, sizeof(LocalFileHeader));
+    write(header.file_name);
+    write(extra);
+    write(entry.data);
     start_of_directory = device->pos();
+    fileHeaders.append(std::move(header));
+    dirtyFileTree = true;
+}
+
+/*
+    Writes the entries that are compressed, in the order they were added. If
+    \a wait is true, or too many entries are pending, waits for the ones that
+    are still being compressed.
+*/
+void QZipWriterPrivate::writePendingEntries(bool wait)
+{
+#if QT_CONFIG(thread)
+    QThreadPool *pool = QThreadPool::globalInstance();
+    const size_t maxPending = pool ? 2 * size_t(qMax(1, pool->maxThreadCount())) : 0;
+    while (!pendingEntries.empty()) {
+        QZipWriterEntry &entry = *pendingEntries.front();
+        if (!entry.done.tryAcquire()) {
+            if (!wait && pendingEntries.size() <= maxPending)
+                return;
+            // rather than waiting for a busy pool, compress it ourselves
+            if (pool && pool->tryTake(entry.task.get()))
+                entry.task->run();
+            entry.done.acquire();
+        }
+        writeEntry(entry);
+        pendingEntries.pop_front();
+    }
+#else
+    Q_UNUSED(wait);
+#endif
+}
+
+void QZipWriterPrivate::addEntry(EntryType type, const QString &fileName, const QByteArray &contents/*, QFile::Permissions permissions, QZip::Method m*/)
+{
+#ifndef NDEBUG
+    static const char *const entryTypes[] = {
+        "directory",
+        "file     ",
+        "symlink  " };
+    ZDEBUG() << "adding" << entryTypes[type] <<":" << fileName.toUtf8().data() << (type == 2 ? QByteArray(" -> " + contents).constData() : "");
+#endif
+
+    if (!openDevice())
+        return;
+
+    auto entry = std::make_unique<QZipWriterEntry>();
+    entry->header = makeHeader(type, fileName);
+    entry->contents = contents;
+    entry->method = compressionMethod();
+    if (compressionPolicy == QZipWriter::AutoCompress) {
+        // don't compress small files, nor files that do not get smaller
+        if (contents.size() < 64)
+            entry->method = CompressionMethodStored;
+        entry->storeIfLarger = true;
+    }
+
+#if QT_CONFIG(thread)
+    // compress large entries on the thread pool, while the ones before them are written
+    QThreadPool *pool = QThreadPool::globalInstance();
+    if (pool && entry->method != CompressionMethodStored && contents.size() >= ParallelThreshold) {
+        QZipWriterEntry *e = entry.get();
+        e->task.reset(QRunnable::create([e] {
+            e->compress();
+            e->done.release();
+        }));
+        e->task->setAutoDelete(false);
+        pool->start(e->task.get());
+    } else {
+        entry->compress();
+        entry->done.release();
+    }
+    pendingEntries.push_back(std::move(entry));
+    writePendingEntries(false);
+#else
+    entry->compress();
+    writeEntry(*entry);
+#endif
+}
+
+/*
+    Compresses \a source into the archive chunk by chunk, for files too large
+    to hold in memory and for sequential devices. The local header is written
+    first and patched once the sizes and the checksum are known.
+
+    Since the data cannot be rewritten, AutoCompress decides from the first
+    chunk whether the entry is stored. A sequential \a source that does not
+    deliver data within ReadTimeout is taken to have ended.
+*/
+void QZipWriterPrivate::addStreamedEntry(const QString &fileName, QIODevice *source)
+{
+    ZDEBUG() << "streaming file     :" << fileName.toUtf8().data();
+
+    if (!openDevice())
+        return;
+
+    const auto readSource = [source](char *data, qint64 maxSize) {
+        qint64 n;
+        while ((n = source->read(data, maxSize)) == 0 && source->isSequential()
+               && source->waitForReadyRead(ReadTimeout)) {
+        }
+        return n;
+    };
+
+    // read the first chunk ahead: entries that fit into it are added like
+    // in-memory ones, and it tells whether the rest is worth compressing
+    QByteArray in(ChunkSize, Qt::Uninitialized);
+    qint64 n = 0;
+    while (n < in.size()) {
+        const qint64 r = readSource(in.data() + n, in.size() - n);
+        if (r < 0) {
+            qWarning("QZip: Failed to read from the source device");
+            status = QZipWriter::FileError;
+            return;
+        }
+        if (r == 0)
+            break;
+        n += r;
+    }
+    if (n < in.size()) {
+        in.truncate(n);
+        addEntry(File, fileName, in);
+        return;
+    }
+    writePendingEntries(true);
+
+    FileHeader header = makeHeader(File, fileName);
+    CompressionMethod method = compressionMethod();
+    if (compressionPolicy == QZipWriter::AutoCompress && method != CompressionMethodStored) {
+        QZipWriterEntry sample;
+        sample.contents = in;
+        sample.method = method;
+        sample.storeIfLarger = true;
+        sample.compress();
+        method = sample.method;
+    }
+    writeUShort(header.h.compression_method, method);
+    if (method == CompressionMethodZstd)
+        writeUShort(header.h.version_needed, ZSTD_VERSION);
+
+    // reserve the ZIP64 extra field if the sizes might not fit in the local header
+    const qint64 sourceSize = source->isSequential() ? -1 : source->size();
+    const bool zip64 = sourceSize < 0 || sourceSize + (sourceSize >> 8) + 1024 >= Zip64Marker;
+    uchar zip64Extra[4 + 2 * 8] = {};
+    const qint64 offset = start_of_directory;
+    LocalFileHeader h = toLocalHeader(header.h);
+    writeUShort(h.extra_field_length, zip64 ? sizeof(zip64Extra) : 0);
+    device->seek(offset);
+    write(&h, sizeof(LocalFileHeader));
+    write(header.file_name);
+    if (zip64)
+        write(zip64Extra, sizeof(zip64Extra));
+
+    z_stream zstream = {};
+    if (method == CompressionMethodDeflated
+        && deflateInit2(&zstream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, -MAX_WBITS, 8,
+                        Z_DEFAULT_STRATEGY) != Z_OK) {
+        qWarning("QZip: Failed to initialize zlib");
+        status = QZipWriter::FileError;
+        return;
+    }
+#if QT_CONFIG(zstd)
+    ZSTD_CCtx *zstdContext = nullptr;
+    if (method == CompressionMethodZstd && !(zstdContext = ZSTD_createCCtx())) {
+        qWarning("QZip: Failed to initialize zstd");
+        status = QZipWriter::FileError;
+        return;
+    }
+#endif
+
+    uint crc_32 = ::crc32(0, nullptr, 0);
+    quint64 uncompressedSize = 0;
+    QByteArray out(ChunkSize, Qt::Uninitialized);
+    for (bool last = false; !last && status == QZipWriter::NoError; ) {
+        last = n == 0;
+        crc_32 = ::crc32(crc_32, reinterpret_cast<const uchar *>(in.constData()), uInt(n));
+        uncompressedSize += n;
+
+        if (method == CompressionMethodStored) {
+            write(in.constData(), n);
+#if QT_CONFIG(zstd)
+        } else if (method == CompressionMethodZstd) {
+            ZSTD_inBuffer input = { in.constData(), size_t(n), 0 };
+            size_t remaining;
+            do {
+                ZSTD_outBuffer output = { out.data(), size_t(out.size()), 0 };
+                remaining = ZSTD_compressStream2(zstdContext, &output, &input,
+                                                 last ? ZSTD_e_end : ZSTD_e_continue);
+                if (ZSTD_isError(remaining)) {
+                    qWarning("QZip: Failed to compress file with zstd (%s)",
+                             ZSTD_getErrorName(remaining));
+                    status = QZipWriter::FileError;
+                    break;
+                }
+                write(out.constData(), qint64(output.pos));
+            } while (last ? remaining != 0 : input.pos < input.size);
+#endif
+        } else {
+            zstream.next_in = reinterpret_cast<Bytef *>(in.data());
+            zstream.avail_in = uInt(n);
+            do {
+                zstream.next_out = reinterpret_cast<Bytef *>(out.data());
+                zstream.avail_out = uInt(out.size());
+                ::deflate(&zstream, last ? Z_FINISH : Z_NO_FLUSH);
+                write(out.constData(), out.size() - zstream.avail_out);
+            } while (zstream.avail_out == 0);
+        }
+
+        if (!last && (n = readSource(in.data(), in.size())) < 0) {
+            qWarning("QZip: Failed to read from the source device");
+            status = QZipWriter::FileError;
+        }
+    }
+    if (method == CompressionMethodDeflated)
+        deflateEnd(&zstream);
+#if QT_CONFIG(zstd)
+    ZSTD_freeCCtx(zstdContext);
+#endif
+
+    // patch the local header now that the sizes are known
+    const qint64 end = device->pos();
+    const quint64 compressedSize = end - offset - sizeof(LocalFileHeader)
+            - header.file_name.size() - (zip64 ? sizeof(zip64Extra) : 0);
+    writeUInt(header.h.crc_32, crc_32);
+    header.setSizes(uncompressedSize, compressedSize, offset);
+    h = toLocalHeader(header.h);
+    if (zip64) {
+        writeUShort(zip64Extra, Zip64ExtraFieldId);
+        writeUShort(zip64Extra + 2, 2 * 8);
+        writeULongLong(zip64Extra + 4, uncompressedSize);
+        writeULongLong(zip64Extra + 12, compressedSize);
+        writeUInt(h.uncompressed_size, Zip64Marker);
+        writeUInt(h.compressed_size, Zip64Marker);
+        writeUShort(h.version_needed, qMax(readUShort(h.version_needed), ushort(ZIP64_VERSION)));
+    } else {
+        // neither can be over the limit, so setSizes() did not need a marker
+        writeUInt(h.uncompressed_size, uint(uncompressedSize));
+        writeUInt(h.compressed_size, uint(compressedSize));
+    }
+    writeUShort(h.extra_field_length, zip64 ? sizeof(zip64Extra) : 0);
+    device->seek(offset);
+    write(&h, sizeof(LocalFileHeader));
+    if (zip64) {
+        device->seek(offset + sizeof(LocalFileHeader) + header.file_name.size());
+        write(zip64Extra, sizeof(zip64Extra));
+    }
+    device->seek(end);
+
+    start_of_directory = end;
+    fileHeaders.append(std::move(header));
     dirtyFileTree = true;
 }
 
@@ -895,85 +1638,55 @@ QZipReader::FileInfo QZipReader::entryInfoAt(int index) const
 
 /*!
     Fetch the file contents from the zip archive and return the uncompressed bytes.
+
+    \sa openFile()
 */
 QByteArray QZipReader::fileData(const QString &fileName) const
 {
-    d->scanFiles();
-    int i;
-    for (i = 0; i < d->fileHeaders.size(); ++i) {
-        if (QString::fromLocal8Bit(d->fileHeaders.at(i).file_name) == fileName)
-            break;
-    }
-    if (i == d->fileHeaders.size())
+    const int index = d->indexOf(fileName);
+    if (index < 0)
         return QByteArray();
-
-    FileHeader header = d->fileHeaders.at(i);
-
-    ushort version_needed = readUShort(header.h.version_needed);
-    if (version_needed > ZIP_VERSION) {
-        qWarning("QZip: .ZIP specification version %d implementationis needed to extract the data.", version_needed);
+    const std::unique_ptr<QIODevice> file = d->openFile(index);
+    if (!file)
         return QByteArray();
-    }
-
-    ushort general_purpose_bits = readUShort(header.h.general_purpose_bits);
-    int compressed_size = readUInt(header.h.compressed_size);
-    int uncompressed_size = readUInt(header.h.uncompressed_size);
-    int start = readUInt(header.h.offset_local_header);
-    //qDebug("uncompressing file %d: local header at %d", i, start);
-
-    d->device->seek(start);
-    LocalFileHeader lh;
-    d->device->read((char *)&lh, sizeof(LocalFileHeader));
-    uint skip = readUShort(lh.file_name_length) + readUShort(lh.extra_field_length);
-    d->device->seek(d->device->pos() + skip);
-
-    int compression_method = readUShort(lh.compression_method);
-    //qDebug("file=%s: compressed_size=%d, uncompressed_size=%d", fileName.toLocal8Bit().data(), compressed_size, uncompressed_size);
 
-    if ((general_purpose_bits & Encrypted) != 0) {
-        qWarning("QZip: Unsupported encryption method is needed to extract the data.");
-        return QByteArray();
+    // The size in the header may be wrong, so don't allocate it up front:
+    // grow the buffer with the data actually read, at most doubling it.
+    const quint64 size = d->fileHeaders.at(index).uncompressedSize;
+    QByteArray data;
+    qsizetype total = 0;
+    while (!file->atEnd()) {
+        const quint64 left = size > quint64(total) ? size - total : 0;
+        const qsizetype chunk = left ? qsizetype(qMin<quint64>(left, qMax(total, ChunkSize)))
+                                     : ChunkSize;
+        data.resize(total + chunk);
+        const qint64 read = file->read(data.data() + total, chunk);
+        if (read <= 0)
+            break;
+        total += read;
     }
+    data.truncate(total);
+    return data;
+}
 
-    //qDebug("file at %lld", d->device->pos());
-    QByteArray compressed = d->device->read(compressed_size);
-    if (compression_method == CompressionMethodStored) {
-        // no compression
-        compressed.truncate(uncompressed_size);
-        return compressed;
-    } else if (compression_method == CompressionMethodDeflated) {
-        // Deflate
-        //qDebug("compressed=%d", compressed.size());
-        compressed.truncate(compressed_size);
-        QByteArray baunzip;
-        ulong len = qMax(uncompressed_size,  1);
-        int res;
-        do {
-            baunzip.resize(len);
-            res = inflate((uchar*)baunzip.data(), &len,
-                          (const uchar*)compressed.constData(), compressed_size);
+/*!
+    \since 6.9
 
-            switch (res) {
-            case Z_OK:
-                if ((int)len != baunzip.size())
-                    baunzip.resize(len);
-                break;
-            case Z_MEM_ERROR:
-                qWarning("QZip: Z_MEM_ERROR: Not enough memory");
-                break;
-            case Z_BUF_ERROR:
-                len *= 2;
-                break;
-            case Z_DATA_ERROR:
-                qWarning("QZip: Z_DATA_ERROR: Input data is corrupted");
-                break;
-            }
-        } while (res == Z_BUF_ERROR);
-        return baunzip;
-    }
+    Returns a sequential device that decompresses the contents of \a fileName
+    while they are read, or \nullptr if the file is not in the archive or
+    cannot be extracted. Unlike fileData(), this does not need to hold the
+    whole file in memory.
 
-    qWarning("QZip: Unsupported compression method %d is needed to extract the data.", compression_method);
-    return QByteArray();
+    The device reads from this reader's device, and must not outlive it. The
+    checksum and the size are verified once the end is reached; if they do
+    not match, the device reports an error.
+*/
+std::unique_ptr<QIODevice> QZipReader::openFile(const QString &fileName) const
+{
+    const int index = d->indexOf(fileName);
+    if (index < 0)
+        return nullptr;
+    return d->openFile(index);
 }
 
 /*!
@@ -1018,10 +1731,12 @@ bool QZipReader::extractAll(const QString &destinationDir) const
     }
 
     // set up symlinks
-    for (const FileInfo &fi : allFiles) {
+    for (qsizetype i = 0; i < allFiles.size(); ++i) {
+        const FileInfo &fi = allFiles.at(i);
         const QString absPath = destinationDir + QDir::separator() + fi.filePath;
         if (fi.isSymLink) {
-            QString destination = QFile::decodeName(fileData(fi.filePath));
+            const std::unique_ptr<QIODevice> link = d->openFile(int(i));
+            QString destination = link ? QFile::decodeName(link->readAll()) : QString();
             if (destination.isEmpty())
                 return false;
             QFileInfo linkFi(absPath);
@@ -1036,13 +1751,22 @@ bool QZipReader::extractAll(const QString &destinationDir) const
         }
     }
 
-    for (const FileInfo &fi : allFiles) {
+    QByteArray buffer(ChunkSize, Qt::Uninitialized);
+    for (qsizetype i = 0; i < allFiles.size(); ++i) {
+        const FileInfo &fi = allFiles.at(i);
         const QString absPath = destinationDir + QDir::separator() + fi.filePath;
         if (fi.isFile) {
             QFile f(absPath);
             if (!f.open(QIODevice::WriteOnly))
                 return false;
-            f.write(fileData(fi.filePath));
+            // copy in chunks, so that large files do not have to fit into memory
+            if (const std::unique_ptr<QIODevice> in = d->openFile(int(i))) {
+                qint64 read;
+                while ((read = in->read(buffer.data(), buffer.size())) > 0) {
+                    if (f.write(buffer.constData(), read) != read)
+                        return false;
+                }
+            }
             f.setPermissions(fi.permissions);
             f.close();
         }
@@ -1218,6 +1942,51 @@ QZipWriter::CompressionPolicy QZipWriter::compressionPolicy() const
     return d->compressionPolicy;
 }
 
+/*!
+    \since 6.9
+    \enum QZipWriter::CompressionAlgorithm
+
+    \value Deflate     Files are compressed with deflate, which every zip
+                        reader supports.
+    \value Zstandard   Files are compressed with Zstandard (method 93), which
+                        is faster and compresses better, but is not supported
+                        by all zip readers.
+*/
+
+/*!
+    \since 6.9
+
+    Sets the algorithm used for compressing newly added files to
+    \a algorithm. If Qt was built without Zstandard support, setting
+    Zstandard has no effect.
+
+    \note the default algorithm is Deflate
+
+    \sa compressionAlgorithm(), setCompressionPolicy()
+*/
+void QZipWriter::setCompressionAlgorithm(CompressionAlgorithm algorithm)
+{
+#if !QT_CONFIG(zstd)
+    if (algorithm == Zstandard) {
+        qWarning("QZip: Zstandard compression is not available, using deflate");
+        return;
+    }
+#endif
+    d->compressionAlgorithm = algorithm;
+}
+
+/*!
+    \since 6.9
+
+    Returns the currently set compression algorithm.
+
+    \sa setCompressionAlgorithm()
+*/
+QZipWriter::CompressionAlgorithm QZipWriter::compressionAlgorithm() const
+{
+    return d->compressionAlgorithm;
+}
+
 /*!
     Sets the permissions that will be used for newly added files.
 
@@ -1251,6 +2020,9 @@ QFile::Permissions QZipWriter::creationPermissions() const
     creationPermissions and it will be compressed using the zip compression
     based on the current compression policy.
 
+    Large files are compressed on other threads while the files before them
+    are written, so the order of the files in the archive does not change.
+
     \sa setCreationPermissions()
     \sa setCompressionPolicy()
 */
@@ -1265,6 +2037,12 @@ void QZipWriter::addFile(const QString &fileName, const QByteArray &data)
     filedata.
     The file will be stored in the archive using the \a fileName which
     includes the full path in the archive.
+
+    Sequential devices and large files are compressed in chunks while they
+    are read, rather than being read into memory first. This needs the
+    archive's device to be seekable. With AutoCompress, whether such a file
+    is compressed is decided from its first 64 KiB. A sequential device that
+    delivers no data for 30 seconds is taken to have ended.
 */
 void QZipWriter::addFile(const QString &fileName, QIODevice *device)
 {
@@ -1278,7 +2056,10 @@ void QZipWriter::addFile(const QString &fileName, QIODevice *device)
             return;
         }
     }
-    d->addEntry(QZipWriterPrivate::File, QDir::fromNativeSeparators(fileName), device->readAll());
+    if (device->isSequential() || device->size() >= StreamingThreshold)
+        d->addStreamedEntry(QDir::fromNativeSeparators(fileName), device);
+    else
+        d->addEntry(QZipWriterPrivate::File, QDir::fromNativeSeparators(fileName), device->readAll());
     if (opened)
         device->close();
 }
@@ -1308,9 +2089,14 @@ void QZipWriter::addSymLink(const QString &fileName, const QString &destination)
 
 /*!
    Closes the zip file.
+
+   This waits for the files that are still being compressed. The ZIP64
+   extensions are used if the archive has too many files or is too large for
+   the original format.
 */
 void QZipWriter::close()
 {
+    d->writePendingEntries(true);
     if (!(d->device->openMode() & QIODevice::WriteOnly)) {
         d->device->close();
         return;
@@ -1326,17 +2112,44 @@ void QZipWriter::close()
         d->device->write(header.extra_field);
         d->device->write(header.file_comment);
     }
-    int dir_size = d->device->pos() - d->start_of_directory;
+    const quint64 num_dir_entries = d->fileHeaders.size();
+    const quint64 dir_size = d->device->pos() - d->start_of_directory;
+    const quint64 start_of_directory = d->start_of_directory;
+
+    if (num_dir_entries >= Zip64CountMarker || dir_size >= Zip64Marker
+        || start_of_directory >= Zip64Marker) {
+        const quint64 eod64Offset = d->device->pos();
+        Zip64EndOfDirectory eod64;
+        memset(&eod64, 0, sizeof(Zip64EndOfDirectory));
+        writeUInt(eod64.signature, 0x06064b50);
+        // the size of the remaining record
+        writeULongLong(eod64.record_size, sizeof(Zip64EndOfDirectory) - 12);
+        writeUShort(eod64.version_made, (HostUnix << 8) | ZIP64_VERSION);
+        writeUShort(eod64.version_needed, ZIP64_VERSION);
+        writeULongLong(eod64.num_dir_entries_this_disk, num_dir_entries);
+        writeULongLong(eod64.num_dir_entries, num_dir_entries);
+        writeULongLong(eod64.directory_size, dir_size);
+        writeULongLong(eod64.dir_start_offset, start_of_directory);
+        d->device->write((const char *)&eod64, sizeof(Zip64EndOfDirectory));
+
+        Zip64EndOfDirectoryLocator locator;
+        memset(&locator, 0, sizeof(Zip64EndOfDirectoryLocator));
+        writeUInt(locator.signature, 0x07064b50);
+        writeULongLong(locator.eod_offset, eod64Offset);
+        writeUInt(locator.total_disks, 1);
+        d->device->write((const char *)&locator, sizeof(Zip64EndOfDirectoryLocator));
+    }
+
     // write end of directory
     EndOfDirectory eod;
     memset(&eod, 0, sizeof(EndOfDirectory));
     writeUInt(eod.signature, 0x06054b50);
     //uchar this_disk[2];
     //uchar start_of_directory_disk[2];
-    writeUShort(eod.num_dir_entries_this_disk, d->fileHeaders.size());
-    writeUShort(eod.num_dir_entries, d->fileHeaders.size());
-    writeUInt(eod.directory_size, dir_size);
-    writeUInt(eod.dir_start_offset, d->start_of_directory);
+    writeUShort(eod.num_dir_entries_this_disk, ushort(qMin<quint64>(num_dir_entries, Zip64CountMarker)));
+    writeUShort(eod.num_dir_entries, ushort(qMin<quint64>(num_dir_entries, Zip64CountMarker)));
+    writeUInt(eod.directory_size, uint(qMin<quint64>(dir_size, Zip64Marker)));
+    writeUInt(eod.dir_start_offset, uint(qMin<quint64>(start_of_directory, Zip64Marker)));
     writeUShort(eod.comment_length, d->comment.size());
 
     d->device->write((const char *)&eod, sizeof(EndOfDirectory));
@@ -21,6 +21,8 @@
 #include <QtCore/qfile.h>
 #include <QtCore/qstring.h>
 
+#include <memory>
+
 QT_BEGIN_NAMESPACE
 
 class QZipReaderPrivate;
@@ -61,6 +63,7 @@ public:
 
     FileInfo entryInfoAt(int index) const;
     QByteArray fileData(const QString &fileName) const;
+    std::unique_ptr<QIODevice> openFile(const QString &fileName) const;
     bool extractAll(const QString &destinationDir) const;
 
     enum Status {
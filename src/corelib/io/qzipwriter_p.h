@@ -55,6 +55,14 @@ public:
     void setCompressionPolicy(CompressionPolicy policy);
     CompressionPolicy compressionPolicy() const;
 
+    enum CompressionAlgorithm {
+        Deflate,
+        Zstandard
+    };
+
+    void setCompressionAlgorithm(CompressionAlgorithm algorithm);
+    CompressionAlgorithm compressionAlgorithm() const;
+
     void setCreationPermissions(QFile::Permissions permissions);
     QFile::Permissions creationPermissions() const;
 
@@ -102,12 +102,26 @@ QMimeGlobPattern::PatternType QMimeGlobPattern::detectPatternType(QStringView pa
 */
 
 bool QMimeGlobPattern::matchFileName(const QString &inputFileName) const
+{
+    return matchFileName(inputFileName, m_caseSensitivity == Qt::CaseInsensitive
+                                        ? inputFileName.toLower() : QString());
+}
+
+/*!
+    \internal
+
+    Same as matchFileName(fileName), for callers that match many patterns
+    against the same file name and only want to convert it to lowercase once.
+    \a lowerCaseFileName must be \a fileName in lowercase.
+*/
+bool QMimeGlobPattern::matchFileName(const QString &inputFileName,
+                                     const QString &lowerCaseFileName) const
 {
     // "Applications MUST match globs case-insensitively, except when the case-sensitive
     // attribute is set to true."
     // The constructor takes care of putting case-insensitive patterns in lowercase.
-    const QString fileName = m_caseSensitivity == Qt::CaseInsensitive
-            ? inputFileName.toLower() : inputFileName;
+    const QString &fileName = m_caseSensitivity == Qt::CaseInsensitive
+            ? lowerCaseFileName : inputFileName;
 
     const qsizetype patternLength = m_pattern.size();
     if (!patternLength)
@@ -154,8 +168,7 @@ bool QMimeGlobPattern::matchFileName(const QString &inputFileName) const
     case OtherPattern:
         // Other fallback patterns: slow but correct method
 #if QT_CONFIG(regularexpression)
-        auto rx = QRegularExpression::fromWildcard(m_pattern);
-        return rx.match(fileName).hasMatch();
+        return m_regExp.match(fileName).hasMatch();
 #else
         return false;
 #endif
@@ -221,10 +234,11 @@ void QMimeAllGlobPatterns::removeMimeType(const QString &mimeType)
 }
 
 void QMimeGlobPatternList::match(QMimeGlobMatchResult &result, const QString &fileName,
+                                 const QString &lowerCaseFileName,
                                  const AddMatchFilterFunc &filterFunc) const
 {
     for (const QMimeGlobPattern &glob : *this) {
-        if (glob.matchFileName(fileName) && filterFunc(glob.mimeType())) {
+        if (glob.matchFileName(fileName, lowerCaseFileName) && filterFunc(glob.mimeType())) {
             const QString pattern = glob.pattern();
             const qsizetype suffixLen = isSimplePattern(pattern) ? pattern.size() - strlen("*.") : 0;
             result.addMatch(glob.mimeType(), glob.weight(), pattern, suffixLen);
@@ -235,8 +249,10 @@ void QMimeGlobPatternList::match(QMimeGlobMatchResult &result, const QString &fi
 void QMimeAllGlobPatterns::matchingGlobs(const QString &fileName, QMimeGlobMatchResult &result,
                                          const AddMatchFilterFunc &filterFunc) const
 {
+    const QString lowerCaseFileName = fileName.toLower();
+
     // First try the high weight matches (>50), if any.
-    m_highWeightGlobs.match(result, fileName, filterFunc);
+    m_highWeightGlobs.match(result, fileName, lowerCaseFileName, filterFunc);
 
     // Now use the "fast patterns" dict, for simple *.foo patterns with weight 50
     // (which is most of them, so this optimization is definitely worth it)
@@ -258,7 +274,7 @@ void QMimeAllGlobPatterns::matchingGlobs(const QString &fileName, QMimeGlobMatch
     }
 
     // Finally, try the low weight matches (<=50)
-    m_lowWeightGlobs.match(result, fileName, filterFunc);
+    m_lowWeightGlobs.match(result, fileName, lowerCaseFileName, filterFunc);
 }
 
 void QMimeAllGlobPatterns::clear()
@@ -21,6 +21,9 @@ QT_REQUIRE_CONFIG(mimetype);
 
 #include <QtCore/qstringlist.h>
 #include <QtCore/qhash.h>
+#if QT_CONFIG(regularexpression)
+#  include <QtCore/qregularexpression.h>
+#endif
 
 #include <algorithm>
 
@@ -52,6 +55,12 @@ public:
         m_caseSensitivity(s),
         m_patternType(detectPatternType(m_pattern))
     {
+#if QT_CONFIG(regularexpression)
+        // created once here rather than for every match; copies share it,
+        // including the compiled pattern once one of them has used it
+        if (m_patternType == OtherPattern)
+            m_regExp = QRegularExpression::fromWildcard(m_pattern);
+#endif
     }
 
     void swap(QMimeGlobPattern &other) noexcept
@@ -61,9 +70,13 @@ public:
         qSwap(m_weight,          other.m_weight);
         qSwap(m_caseSensitivity, other.m_caseSensitivity);
         qSwap(m_patternType,     other.m_patternType);
+#if QT_CONFIG(regularexpression)
+        qSwap(m_regExp,          other.m_regExp);
+#endif
     }
 
     bool matchFileName(const QString &inputFileName) const;
+    bool matchFileName(const QString &fileName, const QString &lowerCaseFileName) const;
 
     inline const QString &pattern() const { return m_pattern; }
     inline unsigned weight() const { return m_weight; }
@@ -86,6 +99,9 @@ private:
     int m_weight;
     Qt::CaseSensitivity m_caseSensitivity;
     PatternType m_patternType;
+#if QT_CONFIG(regularexpression)
+    QRegularExpression m_regExp;
+#endif
 };
 Q_DECLARE_SHARED(QMimeGlobPattern)
 
@@ -114,7 +130,7 @@ public:
     }
 
     void match(QMimeGlobMatchResult &result, const QString &fileName,
-               const AddMatchFilterFunc &filterFunc) const;
+               const QString &lowerCaseFileName, const AddMatchFilterFunc &filterFunc) const;
 };
 
 /*!
@@ -302,6 +302,54 @@ QByteArray QMimeMagicRule::mask() const
     return result;
 }
 
+template <typename T>
+static bool fixedFirstNumberByte(quint32 number, quint32 numberMask, uchar *byte)
+{
+    // the first byte in memory of what matchNumber() compares against
+    uchar value[sizeof(T)];
+    uchar mask[sizeof(T)];
+    qToUnaligned(T(number), value);
+    qToUnaligned(T(numberMask), mask);
+    if (mask[0] != 0xff)
+        return false;
+    *byte = value[0];
+    return true;
+}
+
+/*!
+    \internal
+
+    Returns \c true if all data this rule matches, not taking sub-rules into
+    account, has the same byte at startPos(), and sets \a byte to it. This
+    allows skipping most rules after looking at a single byte.
+*/
+bool QMimeMagicRule::fixedFirstByte(uchar *byte) const
+{
+    if (!m_matchFunction || m_startPos != m_endPos)
+        return false;
+
+    switch (m_type) {
+    case String:
+        if (m_pattern.isEmpty() || uchar(m_mask.at(0)) != 0xff)
+            return false;
+        *byte = uchar(m_pattern.at(0));
+        return true;
+    case Byte:
+        return fixedFirstNumberByte<quint8>(m_number, m_numberMask, byte);
+    case Host16:
+    case Big16:
+    case Little16:
+        return fixedFirstNumberByte<quint16>(m_number, m_numberMask, byte);
+    case Host32:
+    case Big32:
+    case Little32:
+        return fixedFirstNumberByte<quint32>(m_number, m_numberMask, byte);
+    case Invalid:
+        break;
+    }
+    return false;
+}
+
 bool QMimeMagicRule::matches(const QByteArray &data) const
 {
     const bool ok = m_matchFunction && (this->*m_matchFunction)(data);
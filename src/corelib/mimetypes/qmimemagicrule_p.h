@@ -57,6 +57,7 @@ public:
     bool isValid() const { return m_matchFunction != nullptr; }
 
     bool matches(const QByteArray &data) const;
+    bool fixedFirstByte(uchar *byte) const;
 
     QList<QMimeMagicRule> m_subMatches;
 
@@ -7,6 +7,9 @@
 
 #include "qmimetype_p.h"
 
+#include <algorithm>
+#include <map>
+
 QT_BEGIN_NAMESPACE
 
 /*!
@@ -67,4 +70,105 @@ unsigned QMimeMagicRuleMatcher::priority() const
     return m_priority;
 }
 
+/*!
+    \internal
+    \class QMimeMagicRuleMatcherIndex
+    \inmodule QtCore
+
+    \brief The QMimeMagicRuleMatcherIndex class finds the magic rule matchers
+    that can possibly match some data.
+
+    Most magic rules look for a string or number at a fixed offset, so a single
+    byte of the data at that offset rules out nearly all of them. The index
+    maps (offset, byte) to the matchers that only have such rules, so that
+    matching data against the whole database only evaluates a handful of
+    matchers instead of all of them.
+*/
+
+/*!
+    \internal
+
+    Sorts \a matchers by descending priority, keeping the order of matchers
+    with the same priority, and indexes them. The indexes returned by
+    candidates() refer to the sorted list, so that the first candidate that
+    matches is the best match.
+*/
+void QMimeMagicRuleMatcherIndex::build(QList<QMimeMagicRuleMatcher> &matchers)
+{
+    clear();
+    std::stable_sort(matchers.begin(), matchers.end(),
+                     [](const QMimeMagicRuleMatcher &lhs, const QMimeMagicRuleMatcher &rhs) {
+        return lhs.priority() > rhs.priority();
+    });
+
+    std::map<int, QList<std::pair<uchar, quint32>>> byOffset;
+    for (quint32 i = 0; i < quint32(matchers.size()); ++i) {
+        const QList<QMimeMagicRule> rules = matchers.at(i).magicRules();
+        if (rules.isEmpty())
+            continue;   // never matches
+
+        QVarLengthArray<std::pair<int, uchar>, 8> anchors;
+        for (const QMimeMagicRule &rule : rules) {
+            uchar byte;
+            if (!rule.fixedFirstByte(&byte)) {
+                anchors.clear();
+                break;
+            }
+            anchors.emplace_back(rule.startPos(), byte);
+        }
+        if (anchors.isEmpty()) {
+            m_unanchored.append(i);
+            continue;
+        }
+        for (const auto &[offset, byte] : anchors)
+            byOffset[offset].emplace_back(byte, i);
+    }
+
+    m_anchors.reserve(byOffset.size());
+    for (auto &[offset, entries] : byOffset) {
+        std::sort(entries.begin(), entries.end());
+        Anchor &anchor = m_anchors.emplace_back();
+        anchor.offset = offset;
+        anchor.matchers.reserve(entries.size());
+        qsizetype e = 0;
+        for (int byte = 0; byte < 256; ++byte) {
+            anchor.begin[byte] = quint32(e);
+            for (; e < entries.size() && entries.at(e).first == byte; ++e)
+                anchor.matchers.append(entries.at(e).second);
+        }
+        anchor.begin[256] = quint32(e);
+    }
+    m_built = true;
+}
+
+void QMimeMagicRuleMatcherIndex::clear()
+{
+    m_anchors.clear();
+    m_unanchored.clear();
+    m_built = false;
+}
+
+/*!
+    \internal
+
+    Returns the indexes, in ascending order, of the matchers that may match
+    \a data. All others certainly do not.
+*/
+QMimeMagicRuleMatcherIndex::Candidates
+QMimeMagicRuleMatcherIndex::candidates(const QByteArray &data) const
+{
+    Q_ASSERT(m_built);
+    Candidates result(m_unanchored.cbegin(), m_unanchored.cend());
+    for (const Anchor &anchor : m_anchors) {
+        if (anchor.offset >= data.size())
+            break;
+        const uchar byte = uchar(data.at(anchor.offset));
+        result.append(anchor.matchers.constData() + anchor.begin[byte],
+                      anchor.begin[byte + 1] - anchor.begin[byte]);
+    }
+    std::sort(result.begin(), result.end());
+    result.erase(std::unique(result.begin(), result.end()), result.end());
+    return result;
+}
+
 QT_END_NAMESPACE
@@ -22,6 +22,9 @@ QT_REQUIRE_CONFIG(mimetype);
 #include <QtCore/qbytearray.h>
 #include <QtCore/qlist.h>
 #include <QtCore/qstring.h>
+#include <QtCore/qvarlengtharray.h>
+
+#include <array>
 
 QT_BEGIN_NAMESPACE
 
@@ -56,6 +59,30 @@ private:
 };
 Q_DECLARE_SHARED(QMimeMagicRuleMatcher)
 
+class QMimeMagicRuleMatcherIndex
+{
+public:
+    using Candidates = QVarLengthArray<quint32, 64>;
+
+    void build(QList<QMimeMagicRuleMatcher> &matchers);
+    void clear();
+    bool isBuilt() const { return m_built; }
+
+    Candidates candidates(const QByteArray &data) const;
+
+private:
+    // matchers whose rules all need a given byte at this offset
+    struct Anchor
+    {
+        int offset;
+        std::array<quint32, 257> begin;     // into matchers, by byte
+        QList<quint32> matchers;
+    };
+    QList<Anchor> m_anchors;                // sorted by offset
+    QList<quint32> m_unanchored;
+    bool m_built = false;
+};
+
 QT_END_NAMESPACE
 
 #endif // QMIMEMAGICRULEMATCHER_P_H
@@ -714,13 +714,20 @@ void QMimeXMLProvider::addFileNameMatches(const QString &fileName, QMimeGlobMatc
 
 void QMimeXMLProvider::findByMagic(const QByteArray &data, QMimeMagicResult &result)
 {
-    for (const QMimeMagicRuleMatcher &matcher : std::as_const(m_magicMatchers)) {
+    if (!m_magicIndex.isBuilt())
+        m_magicIndex.build(m_magicMatchers);
+
+    // The candidates are sorted by descending priority, so the first one
+    // that matches is the best match, like in mime.cache.
+    for (quint32 i : m_magicIndex.candidates(data)) {
+        const QMimeMagicRuleMatcher &matcher = m_magicMatchers.at(i);
+        const int priority = matcher.priority();
+        if (priority <= result.accuracy)
+            return;
         if (matcher.matches(data)) {
-            const int priority = matcher.priority();
-            if (priority > result.accuracy) {
-                result.accuracy = priority;
-                result.candidate = matcher.mimetype();
-            }
+            result.accuracy = priority;
+            result.candidate = matcher.mimetype();
+            return;
         }
     }
 }
@@ -741,6 +748,7 @@ void QMimeXMLProvider::ensureLoaded()
     m_parents.clear();
     m_mimeTypeGlobs.clear();
     m_magicMatchers.clear();
+    m_magicIndex.clear();
 
     //qDebug() << "Loading" << m_allFiles;
 
@@ -871,6 +879,7 @@ void QMimeXMLProvider::addAllMimeTypes(QList<QMimeType> &result)
 void QMimeXMLProvider::addMagicMatcher(const QMimeMagicRuleMatcher &matcher)
 {
     m_magicMatchers.append(matcher);
+    m_magicIndex.clear();
 }
 
 QT_END_NAMESPACE
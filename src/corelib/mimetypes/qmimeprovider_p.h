@@ -21,6 +21,7 @@
 QT_REQUIRE_CONFIG(mimetype);
 
 #include "qmimeglobpattern_p.h"
+#include "qmimemagicrulematcher_p.h"
 #include <QtCore/qdatetime.h>
 #include <QtCore/qset.h>
 
@@ -186,6 +187,7 @@ private:
     QMimeAllGlobPatterns m_mimeTypeGlobs;
 
     QList<QMimeMagicRuleMatcher> m_magicMatchers;
+    QMimeMagicRuleMatcherIndex m_magicIndex;
     QStringList m_allFiles;
 };
 
@@ -25,11 +25,15 @@
 
 #if QT_CONFIG(library)
 #  include "qlibrary_p.h"
+#  ifdef Q_OS_UNIX
+#    include "qpluginmetadatacache_p.h"
+#  endif
 #endif
 
 #include <qtcore_tracepoints_p.h>
 
 #include <map>
+#include <optional>
 #include <vector>
 
 QT_BEGIN_NAMESPACE
@@ -311,6 +315,13 @@ inline void QFactoryLoaderPrivate::updateSinglePath(const QString &path)
 #endif
                 QDirListing::IteratorFlag::FilesOnly);
 
+#ifdef Q_OS_UNIX
+    // saves itself when it goes out of scope
+    std::optional<QPluginMetaDataCache> cache;
+    if (QPluginMetaDataCache::isEnabled())
+        cache.emplace(path);
+#endif
+
     for (const auto &dirEntry : plugins) {
         const QString &fileName = dirEntry.fileName();
 #if defined(Q_PROCESSOR_X86)
@@ -325,7 +336,11 @@ inline void QFactoryLoaderPrivate::updateSinglePath(const QString &path)
 
         QLibraryPrivate::UniquePtr library;
         library.reset(QLibraryPrivate::findOrCreate(dirEntry.canonicalFilePath()));
+#ifdef Q_OS_UNIX
+        if (!library->isPlugin(cache ? &*cache : nullptr)) {
+#else
         if (!library->isPlugin()) {
+#endif
             qCDebug(lcFactoryLoader) << library->errorString << Qt::endl
                                      << "         not a plugin";
             continue;
@@ -26,6 +26,9 @@
 #include "qelfparser_p.h"
 #include "qfactoryloader_p.h"
 #include "qmachparser_p.h"
+#ifdef Q_OS_UNIX
+#  include "qpluginmetadatacache_p.h"
+#endif
 
 #include <qtcore_tracepoints_p.h>
 
@@ -210,8 +213,15 @@ static QLibraryScanResult qt_find_pattern(const char *s, qsizetype s_len, QStrin
   Returns \c false if version information is not present, or if the
                 information could not be read.
   Returns  true if version information is present and successfully read.
+
+  If \a rawMetaData is not null, it is set to the metadata as found in the
+  file, for the plugin metadata cache. If \a scanned is not null, it is set
+  to whether the contents of the file were searched, as opposed to failing
+  to open or map it.
 */
-static QLibraryScanResult findPatternUnloaded(const QString &library, QLibraryPrivate *lib)
+static QLibraryScanResult findPatternUnloaded(const QString &library, QLibraryPrivate *lib,
+                                              QByteArray *rawMetaData = nullptr,
+                                              bool *scanned = nullptr)
 {
     QFile file(library);
     if (!file.open(QIODevice::ReadOnly)) {
@@ -250,6 +260,8 @@ static QLibraryScanResult findPatternUnloaded(const QString &library, QLibraryPr
     }
 #endif
 
+    if (scanned)
+        *scanned = true;
     QString errMsg = library;
     QLibraryScanResult r = qt_find_pattern(filedata, fdlen, &errMsg);
     if (r.length) {
@@ -265,6 +277,8 @@ static QLibraryScanResult findPatternUnloaded(const QString &library, QLibraryPr
             qCDebug(qt_lcDebugPlugins, "Found metadata in lib %ls, metadata=\n%s\n",
                     qUtf16Printable(library),
                     QJsonDocument(lib->metaData.toJson()).toJson().constData());
+            if (rawMetaData)
+                *rawMetaData = QByteArray(filedata + r.pos, r.length);
             return r;
         }
     } else {
@@ -277,6 +291,48 @@ static QLibraryScanResult findPatternUnloaded(const QString &library, QLibraryPr
     return {};
 }
 
+#ifdef Q_OS_UNIX
+/*
+  Like findPatternUnloaded(), but first asks \a cache whether it already knows
+  the metadata of \a library, and tells the cache what it found otherwise.
+  Only what the contents of the file say is remembered; a file that can't be
+  opened right now may well be a plugin the next time.
+*/
+static QLibraryScanResult findPatternCached(const QString &library, QLibraryPrivate *lib,
+                                            QPluginMetaDataCache *cache)
+{
+    QByteArrayView cached;
+    switch (cache->find(library, &cached)) {
+    case QPluginMetaDataCache::Result::Plugin:
+        if (lib->metaData.parse(cached)) {
+            qCDebug(qt_lcDebugPlugins, "Found cached metadata for lib %ls",
+                    qUtf16Printable(library));
+            return { 0, cached.size() };
+        }
+        break;      // shouldn't happen, fall back to scanning the file
+    case QPluginMetaDataCache::Result::NotAPlugin:
+        lib->errorString = QString::fromUtf8(cached);
+        qCDebug(qt_lcDebugPlugins, "Cached: %ls", qUtf16Printable(lib->errorString));
+        return {};
+    case QPluginMetaDataCache::Result::Miss:
+        break;
+    }
+
+    QByteArray rawMetaData;
+    bool scanned = false;
+    QLibraryScanResult r = findPatternUnloaded(library, lib, &rawMetaData, &scanned);
+#if defined(Q_OF_MACH_O)
+    if (r.isEncrypted)
+        return r;       // the metadata can only be read after loading
+#endif
+    if (r.length)
+        cache->insert(library, QPluginMetaDataCache::Result::Plugin, rawMetaData);
+    else if (scanned && !lib->errorString.isEmpty())
+        cache->insert(library, QPluginMetaDataCache::Result::NotAPlugin, lib->errorString.toUtf8());
+    return r;
+}
+#endif
+
 static void installCoverageTool(QLibraryPrivate *libPrivate)
 {
 #ifdef __COVERAGESCANNER__
@@ -711,15 +767,21 @@ static bool qt_get_metadata(QLibraryPrivate *priv, QString *errMsg)
     return false;
 }
 
-bool QLibraryPrivate::isPlugin()
+/*!
+    \internal
+
+    Returns whether the library is a plugin that can be loaded. If \a cache is
+    not null, it is used to avoid scanning the file for its metadata.
+*/
+bool QLibraryPrivate::isPlugin(QPluginMetaDataCache *cache)
 {
     if (pluginState == MightBeAPlugin)
-        updatePluginState();
+        updatePluginState(cache);
 
     return pluginState == IsAPlugin;
 }
 
-void QLibraryPrivate::updatePluginState()
+void QLibraryPrivate::updatePluginState(QPluginMetaDataCache *cache)
 {
     QMutexLocker locker(&mutex);
     errorString.clear();
@@ -744,7 +806,13 @@ void QLibraryPrivate::updatePluginState()
 
     if (!pHnd.loadRelaxed()) {
         // scan for the plugin metadata without loading
+#ifdef Q_OS_UNIX
+        QLibraryScanResult result = cache ? findPatternCached(fileName, this, cache)
+                                          : findPatternUnloaded(fileName, this);
+#else
+        Q_UNUSED(cache);
         QLibraryScanResult result = findPatternUnloaded(fileName, this);
+#endif
 #if defined(Q_OF_MACH_O)
         if (result.length && result.isEncrypted) {
             // We found the .qtmetadata section, but since the library is encrypted
@@ -0,0 +1,301 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qpluginmetadatacache_p.h"
+
+#include <QtCore/qcryptographichash.h>
+#include <QtCore/qdir.h>
+#include <QtCore/qendian.h>
+#include <QtCore/qloggingcategory.h>
+#if QT_CONFIG(temporaryfile)
+#  include <QtCore/qsavefile.h>
+#endif
+#include <QtCore/qstandardpaths.h>
+#include <QtCore/qsysinfo.h>
+#include <QtCore/private/qlibrary_p.h>
+
+#include <qplatformdefs.h>
+
+#include <algorithm>
+
+QT_BEGIN_NAMESPACE
+
+using namespace Qt::StringLiterals;
+
+/*
+    The cache file is meant to be mapped and used in place, in native byte
+    order:
+
+        Header
+        Entry[count]     sorted by file name
+        file names       UTF-16
+        metadata         8-byte aligned
+
+    All offsets are from the start of the file.
+*/
+namespace {
+struct Header
+{
+    char magic[4];
+    quint32 byteOrder;
+    quint32 version;
+    quint32 count;
+};
+struct Entry
+{
+    quint64 device;
+    quint64 inode;
+    qint64 size;
+    qint64 changeTime;
+    quint32 nameOffset;
+    quint32 nameSize;           // in UTF-16 code units
+    quint32 metaDataOffset;
+    quint32 metaDataSize;
+    quint32 result;
+    quint32 padding;
+};
+static_assert(sizeof(Header) == 16);
+static_assert(sizeof(Entry) == 56);
+
+constexpr char Magic[4] = { 'Q', 'P', 'M', 'C' };
+constexpr quint32 ByteOrder = 0x01020304;
+constexpr quint32 Version = 1;
+} // unnamed namespace
+
+static QStringView entryName(const uchar *mapped, const Entry &entry)
+{
+    return QStringView(reinterpret_cast<const char16_t *>(mapped + entry.nameOffset),
+                       entry.nameSize);
+}
+
+QPluginMetaDataCache::QPluginMetaDataCache(const QString &pluginDirectory)
+    : cacheFile(cacheFilePath(pluginDirectory))
+{
+    if (cacheFile.isEmpty())
+        return;
+
+    mappedFile.setFileName(cacheFile);
+    if (!mappedFile.open(QIODevice::ReadOnly))
+        return;
+    const qint64 size = mappedFile.size();
+    if (size < qint64(sizeof(Header)) || size > std::numeric_limits<quint32>::max())
+        return;
+    const uchar *data = mappedFile.map(0, size);
+    if (!data)
+        return;
+
+    const Header header = qFromUnaligned<Header>(data);
+    if (memcmp(header.magic, Magic, sizeof(Magic)) != 0 || header.byteOrder != ByteOrder
+        || header.version != Version
+        || header.count > (size - sizeof(Header)) / sizeof(Entry)) {
+        qCDebug(qt_lcDebugPlugins, "Ignoring invalid plugin metadata cache %ls",
+                qUtf16Printable(cacheFile));
+        return;
+    }
+
+    // check the bounds once, so that find() does not have to
+    const auto *entries = reinterpret_cast<const Entry *>(data + sizeof(Header));
+    for (quint32 i = 0; i < header.count; ++i) {
+        const Entry &e = entries[i];
+        if (e.nameOffset % 2 || e.nameOffset > size || e.nameSize > (size - e.nameOffset) / 2
+            || e.metaDataOffset > size || e.metaDataSize > size - e.metaDataOffset
+            || e.result > quint32(Result::NotAPlugin)) {
+            qCDebug(qt_lcDebugPlugins, "Ignoring corrupt plugin metadata cache %ls",
+                    qUtf16Printable(cacheFile));
+            return;
+        }
+    }
+
+    mapped = data;
+    mappedSize = size;
+    mappedCount = header.count;
+}
+
+QPluginMetaDataCache::~QPluginMetaDataCache()
+{
+    save();
+}
+
+/*!
+    \internal
+
+    Returns whether plugin metadata should be cached. Setting the
+    environment variable \c QT_DISABLE_PLUGIN_METADATA_CACHE turns caching off.
+*/
+bool QPluginMetaDataCache::isEnabled()
+{
+#if defined(Q_OS_UNIX) && QT_CONFIG(temporaryfile)
+    static const bool disabled = qEnvironmentVariableIsSet("QT_DISABLE_PLUGIN_METADATA_CACHE");
+    return !disabled;
+#else
+    return false;
+#endif
+}
+
+/*!
+    \internal
+
+    Returns the file that caches the plugin metadata of \a pluginDirectory.
+    It is in the user's cache directory, as plugin directories are usually
+    not writable. Whether a file is a plugin depends on who asks, too: a
+    plugin for another architecture is not one, and neither is one with
+    metadata that this version of Qt can't parse. So each ABI and Qt version
+    has a cache of its own.
+*/
+QString QPluginMetaDataCache::cacheFilePath(const QString &pluginDirectory)
+{
+    const QString cacheDir = QStandardPaths::writableLocation(QStandardPaths::GenericCacheLocation);
+    if (cacheDir.isEmpty())
+        return QString();
+    QCryptographicHash hash(QCryptographicHash::Sha1);
+    hash.addData(QDir::cleanPath(pluginDirectory).toUtf8());
+    hash.addData(QByteArrayView("", 1));
+    hash.addData(QSysInfo::buildAbi().toLatin1());
+    hash.addData(QByteArrayView("", 1));
+    hash.addData(QByteArrayView(QT_VERSION_STR));
+    const QByteArray key = hash.result().toHex();
+    return cacheDir + "/qtplugins/"_L1 + QLatin1StringView(key) + "-v"_L1
+            + QString::number(Version) + ".cache"_L1;
+}
+
+QPluginMetaDataCache::FileId QPluginMetaDataCache::fileId(const QString &fileName)
+{
+    FileId id;
+#ifdef Q_OS_UNIX
+    QT_STATBUF st;
+    if (QT_STAT(QFile::encodeName(fileName).constData(), &st) != 0)
+        return id;
+    id.device = quint64(st.st_dev);
+    id.inode = quint64(st.st_ino);
+    id.size = qint64(st.st_size);
+#  if defined(Q_OS_DARWIN)
+    id.changeTime = st.st_ctimespec.tv_sec * Q_INT64_C(1000000000) + st.st_ctimespec.tv_nsec;
+#  elif defined(_POSIX_VERSION) && _POSIX_VERSION >= 200809L
+    id.changeTime = st.st_ctim.tv_sec * Q_INT64_C(1000000000) + st.st_ctim.tv_nsec;
+#  else
+    id.changeTime = st.st_ctime * Q_INT64_C(1000000000);
+#  endif
+#else
+    Q_UNUSED(fileName);
+#endif
+    return id;
+}
+
+/*!
+    \internal
+
+    Looks up \a fileName. If the cache knows the file and it did not change,
+    returns whether it is a plugin and sets \a metaData, which stays valid for
+    the lifetime of the cache. Otherwise returns Result::Miss and expects the
+    caller to insert() what it finds out about the file.
+*/
+QPluginMetaDataCache::Result QPluginMetaDataCache::find(const QString &fileName,
+                                                        QByteArrayView *metaData)
+{
+    const FileId id = fileId(fileName);
+    if (id.size < 0)
+        return Result::Miss;
+
+    const auto *begin = mapped ? reinterpret_cast<const Entry *>(mapped + sizeof(Header)) : nullptr;
+    const auto *end = begin ? begin + mappedCount : nullptr;
+    const auto *it = std::lower_bound(begin, end, fileName, [this](const Entry &e, const QString &name) {
+        return entryName(mapped, e).compare(name) < 0;
+    });
+    if (it != end && entryName(mapped, *it) == fileName) {
+        const FileId cachedId{ it->device, it->inode, it->size, it->changeTime };
+        if (cachedId == id) {
+            const auto result = Result(it->result);
+            *metaData = QByteArrayView(mapped + it->metaDataOffset, it->metaDataSize);
+            records.insert(fileName, { id, result, QByteArray::fromRawData(metaData->data(),
+                                                                          metaData->size()) });
+            return result;
+        }
+    }
+
+    pendingFileName = fileName;
+    pendingId = id;
+    return Result::Miss;
+}
+
+/*!
+    \internal
+
+    Records \a result and \a metaData for \a fileName, which find() just
+    reported as a miss.
+*/
+void QPluginMetaDataCache::insert(const QString &fileName, Result result, QByteArrayView metaData)
+{
+    if (fileName != pendingFileName || result == Result::Miss)
+        return;
+    records.insert(fileName, { pendingId, result, metaData.toByteArray() });
+    pendingFileName.clear();
+    dirty = true;
+}
+
+/*!
+    \internal
+
+    Writes the cache file, if anything changed. Files that were not looked up
+    since the cache was opened are dropped from it.
+*/
+bool QPluginMetaDataCache::save()
+{
+#if QT_CONFIG(temporaryfile)
+    if (cacheFile.isEmpty() || (!dirty && records.size() == mappedCount))
+        return true;
+
+    QByteArray names;
+    QByteArray metaData;
+    QList<Entry> entries;
+    entries.reserve(records.size());
+    const quint32 namesOffset = sizeof(Header) + records.size() * sizeof(Entry);
+    for (auto it = records.cbegin(); it != records.cend(); ++it) {
+        Entry e = {};
+        e.device = it->id.device;
+        e.inode = it->id.inode;
+        e.size = it->id.size;
+        e.changeTime = it->id.changeTime;
+        e.nameOffset = namesOffset + names.size();
+        e.nameSize = it.key().size();
+        e.metaDataOffset = metaData.size();     // relative for now
+        e.metaDataSize = it->metaData.size();
+        e.result = quint32(it->result);
+        entries.append(e);
+
+        names.append(reinterpret_cast<const char *>(it.key().utf16()), it.key().size() * 2);
+        metaData.append(it->metaData);
+        metaData.append((8 - metaData.size() % 8) % 8, '\0');
+    }
+    names.append((8 - (namesOffset + names.size()) % 8) % 8, '\0');
+    for (Entry &e : entries)
+        e.metaDataOffset += namesOffset + names.size();
+
+    Header header = {};
+    memcpy(header.magic, Magic, sizeof(Magic));
+    header.byteOrder = ByteOrder;
+    header.version = Version;
+    header.count = quint32(entries.size());
+
+    if (!QDir().mkpath(QFileInfo(cacheFile).absolutePath()))
+        return false;
+    QSaveFile file(cacheFile);
+    if (!file.open(QIODevice::WriteOnly))
+        return false;
+    file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char *>(entries.constData()), entries.size() * sizeof(Entry));
+    file.write(names);
+    file.write(metaData);
+    if (!file.commit()) {
+        qCDebug(qt_lcDebugPlugins, "Could not write plugin metadata cache %ls: %ls",
+                qUtf16Printable(cacheFile), qUtf16Printable(file.errorString()));
+        return false;
+    }
+    dirty = false;
+    mappedCount = records.size();   // nothing to save until something changes again
+    return true;
+#else
+    return false;
+#endif
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,86 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QPLUGINMETADATACACHE_P_H
+#define QPLUGINMETADATACACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qbytearray.h>
+#include <QtCore/qfile.h>
+#include <QtCore/qmap.h>
+#include <QtCore/qstring.h>
+
+QT_REQUIRE_CONFIG(library);
+
+QT_BEGIN_NAMESPACE
+
+// Remembers the plugin metadata of the files in one plugin directory, so that
+// files that did not change since do not have to be opened and parsed again.
+// Only available on Unix, where files can be identified cheaply.
+class Q_CORE_EXPORT QPluginMetaDataCache
+{
+    Q_DISABLE_COPY_MOVE(QPluginMetaDataCache)
+public:
+    enum class Result {
+        Miss,
+        Plugin,         // metaData is the raw plugin metadata
+        NotAPlugin,     // metaData is the UTF-8 error message
+    };
+
+    explicit QPluginMetaDataCache(const QString &pluginDirectory);
+    ~QPluginMetaDataCache();
+
+    static bool isEnabled();
+    static QString cacheFilePath(const QString &pluginDirectory);
+
+    Result find(const QString &fileName, QByteArrayView *metaData);
+    void insert(const QString &fileName, Result result, QByteArrayView metaData);
+    bool save();
+
+private:
+    struct FileId {
+        quint64 device = 0;
+        quint64 inode = 0;
+        qint64 size = -1;
+        qint64 changeTime = 0;         // of the inode, in ns since the epoch
+
+        friend bool operator==(const FileId &lhs, const FileId &rhs) noexcept
+        {
+            return lhs.device == rhs.device && lhs.inode == rhs.inode
+                    && lhs.size == rhs.size && lhs.changeTime == rhs.changeTime;
+        }
+    };
+    struct Record {
+        FileId id;
+        Result result;
+        QByteArray metaData;
+    };
+    static FileId fileId(const QString &fileName);
+
+    QString cacheFile;
+    QFile mappedFile;
+    const uchar *mapped = nullptr;
+    qsizetype mappedSize = 0;
+    qsizetype mappedCount = 0;
+
+    // what the cache file is going to contain
+    QMap<QString, Record> records;
+    QString pendingFileName;
+    FileId pendingId;
+    bool dirty = false;
+};
+
+QT_END_NAMESPACE
+
+#endif // QPLUGINMETADATACACHE_P_H
@@ -4080,6 +4080,145 @@ auto QtPrivate::toFloat(QByteArrayView a) noexcept -> ParsedNumber<float>
     return {};
 }
 
+#ifdef __SSE2__
+// Returns a mask of the bytes of \a v that are between \a first and \a last
+// (inclusive). Bytes above 0x7f are negative, so they are never in range.
+static inline __m128i mm_in_range_epi8(__m128i v, char first, char last) noexcept
+{
+    return _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8(char(first - 1))),
+                         _mm_cmplt_epi8(v, _mm_set1_epi8(char(last + 1))));
+}
+
+// Decodes 32 hex digits into 16 bytes at \a output, unless there is a
+// character among them that is not a hex digit.
+static bool fromHex_sse2(const char *input, uchar *output) noexcept
+{
+    __m128i values[2];
+    for (int i = 0; i < 2; ++i) {
+        const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + 16 * i));
+        const __m128i lowerCase = _mm_or_si128(in, _mm_set1_epi8(0x20));
+        const __m128i digit = mm_in_range_epi8(in, '0', '9');
+        const __m128i letter = mm_in_range_epi8(lowerCase, 'a', 'f');
+        if (_mm_movemask_epi8(_mm_or_si128(digit, letter)) != 0xffff)
+            return false;
+        values[i] = _mm_or_si128(_mm_and_si128(digit, _mm_sub_epi8(in, _mm_set1_epi8('0'))),
+                                 _mm_and_si128(letter, _mm_sub_epi8(lowerCase, _mm_set1_epi8('a' - 10))));
+        // combine the high nibble in the even bytes with the low one in the odd bytes
+        values[i] = _mm_and_si128(_mm_or_si128(_mm_slli_epi16(values[i], 4), _mm_srli_epi16(values[i], 8)),
+                                  _mm_set1_epi16(0x00ff));
+    }
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output), _mm_packus_epi16(values[0], values[1]));
+    return true;
+}
+#if defined(Q_PROCESSOR_X86) && QT_COMPILER_SUPPORTS_HERE(SSSE3)
+#  define QT_BYTEARRAY_CODECS_SSSE3
+// Vectorized Base64 coding, based on the algorithms described by Wojciech
+// Muła and Daniel Lemire in "Faster Base64 Encoding and Decoding using AVX2
+// Instructions". The functions process the input in whole blocks and return
+// how much of it they consumed; the scalar code takes care of the rest.
+
+// Encodes blocks of 12 bytes from \a input into 16 characters each in \a output
+static QT_FUNCTION_TARGET(SSSE3)
+qsizetype toBase64_ssse3(const uchar *input, qsizetype size, char *output, bool url) noexcept
+{
+    // places the three bytes of each group in the 32-bit lanes as [b1 b0 b2 b1]
+    const __m128i spread = _mm_setr_epi8(1, 0, 2, 1, 4, 3, 5, 4, 7, 6, 8, 7, 10, 9, 11, 10);
+    const char char62 = url ? '-' : '+';
+    const char char63 = url ? '_' : '/';
+
+    qsizetype i = 0;
+    // each iteration loads 16 bytes, of which it uses 12
+    for ( ; i + 16 <= size; i += 12, output += 16) {
+        __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+        in = _mm_shuffle_epi8(in, spread);
+
+        // extract the four sextets of each lane into its own byte
+        const __m128i ac = _mm_mulhi_epu16(_mm_and_si128(in, _mm_set1_epi32(0x0fc0fc00)),
+                                           _mm_set1_epi32(0x04000040));
+        const __m128i bd = _mm_mullo_epi16(_mm_and_si128(in, _mm_set1_epi32(0x003f03f0)),
+                                           _mm_set1_epi32(0x01000010));
+        const __m128i indices = _mm_or_si128(ac, bd);
+
+        // map 0..25 to 'A'..'Z', 26..51 to 'a'..'z', 52..61 to '0'..'9' and
+        // the last two to the alphabet-specific characters
+        __m128i offset = _mm_set1_epi8('A');
+        offset = _mm_add_epi8(offset, _mm_and_si128(_mm_cmpgt_epi8(indices, _mm_set1_epi8(25)),
+                                                    _mm_set1_epi8('a' - 26 - 'A')));
+        offset = _mm_add_epi8(offset, _mm_and_si128(_mm_cmpgt_epi8(indices, _mm_set1_epi8(51)),
+                                                    _mm_set1_epi8('0' - 52 - ('a' - 26))));
+        offset = _mm_add_epi8(offset, _mm_and_si128(_mm_cmpeq_epi8(indices, _mm_set1_epi8(62)),
+                                                    _mm_set1_epi8(char(char62 - 62 - ('0' - 52)))));
+        offset = _mm_add_epi8(offset, _mm_and_si128(_mm_cmpeq_epi8(indices, _mm_set1_epi8(63)),
+                                                    _mm_set1_epi8(char(char63 - 63 - ('0' - 52)))));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(output), _mm_add_epi8(indices, offset));
+    }
+    return i;
+}
+
+// Decodes blocks of 16 characters from \a input into 12 bytes each in \a
+// output, stopping at the first block that contains anything but characters
+// of the alphabet (like padding, whitespace or invalid characters). \a output
+// may alias \a input.
+static QT_FUNCTION_TARGET(SSSE3)
+qsizetype fromBase64_ssse3(const char *input, qsizetype size, char *output, bool url) noexcept
+{
+    const char char62 = url ? '-' : '+';
+    const char char63 = url ? '_' : '/';
+    const __m128i gather = _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1);
+
+    qsizetype i = 0;
+    for ( ; i + 16 <= size; i += 16, output += 12) {
+        const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+        const __m128i upper = mm_in_range_epi8(in, 'A', 'Z');
+        const __m128i lower = mm_in_range_epi8(in, 'a', 'z');
+        const __m128i digit = mm_in_range_epi8(in, '0', '9');
+        const __m128i is62 = _mm_cmpeq_epi8(in, _mm_set1_epi8(char62));
+        const __m128i is63 = _mm_cmpeq_epi8(in, _mm_set1_epi8(char63));
+        const __m128i valid = _mm_or_si128(_mm_or_si128(upper, lower),
+                                           _mm_or_si128(digit, _mm_or_si128(is62, is63)));
+        if (_mm_movemask_epi8(valid) != 0xffff)
+            break;
+
+        __m128i offset = _mm_and_si128(upper, _mm_set1_epi8(char(-'A')));
+        offset = _mm_or_si128(offset, _mm_and_si128(lower, _mm_set1_epi8(char(26 - 'a'))));
+        offset = _mm_or_si128(offset, _mm_and_si128(digit, _mm_set1_epi8(char(52 - '0'))));
+        offset = _mm_or_si128(offset, _mm_and_si128(is62, _mm_set1_epi8(char(62 - char62))));
+        offset = _mm_or_si128(offset, _mm_and_si128(is63, _mm_set1_epi8(char(63 - char63))));
+        const __m128i sextets = _mm_add_epi8(in, offset);
+
+        // merge the four sextets of each 32-bit lane into three bytes
+        const __m128i pairs = _mm_maddubs_epi16(sextets, _mm_set1_epi32(0x01400140));
+        const __m128i triplets = _mm_madd_epi16(pairs, _mm_set1_epi32(0x00011000));
+        const __m128i out = _mm_shuffle_epi8(triplets, gather);
+
+        // store only 12 bytes, the output buffer may not have room for more
+        _mm_storel_epi64(reinterpret_cast<__m128i *>(output), out);
+        const int last = _mm_cvtsi128_si32(_mm_srli_si128(out, 8));
+        memcpy(output + 8, &last, sizeof(last));
+    }
+    return i;
+}
+// Encodes blocks of 16 bytes from \a input into 32 hex digits each in \a output
+static QT_FUNCTION_TARGET(SSSE3)
+qsizetype toHex_ssse3(const uchar *input, qsizetype size, char *output) noexcept
+{
+    const __m128i digits = _mm_setr_epi8('0', '1', '2', '3', '4', '5', '6', '7',
+                                         '8', '9', 'a', 'b', 'c', 'd', 'e', 'f');
+    const __m128i nibbleMask = _mm_set1_epi8(0x0f);
+
+    qsizetype i = 0;
+    for ( ; i + 16 <= size; i += 16, output += 32) {
+        const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+        const __m128i high = _mm_shuffle_epi8(digits, _mm_and_si128(_mm_srli_epi16(in, 4), nibbleMask));
+        const __m128i low = _mm_shuffle_epi8(digits, _mm_and_si128(in, nibbleMask));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(output), _mm_unpacklo_epi8(high, low));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(output + 16), _mm_unpackhi_epi8(high, low));
+    }
+    return i;
+}
+#endif // QT_BYTEARRAY_CODECS_SSSE3
+#endif // __SSE2__
+
 /*!
     \since 5.2
 
@@ -4107,6 +4246,13 @@ QByteArray QByteArray::toBase64(Base64Options options) const
 
     qsizetype i = 0;
     char *out = tmp.data();
+#ifdef QT_BYTEARRAY_CODECS_SSSE3
+    if (qCpuHasFeature(SSSE3)) {
+        i = toBase64_ssse3(reinterpret_cast<const uchar *>(data()), sz, out,
+                           options.testFlag(Base64UrlEncoding));
+        out += i / 3 * 4;
+    }
+#endif
     while (i < sz) {
         // encode 3 bytes at a time
         int chunk = 0;
@@ -4463,7 +4609,17 @@ fromBase64_helper_result fromBase64_helper(const char *input, qsizetype inputSiz
     int nbits = 0;
 
     qsizetype offset = 0;
-    for (qsizetype i = 0; i < inputSize; ++i) {
+    qsizetype i = 0;
+#ifdef QT_BYTEARRAY_CODECS_SSSE3
+    // decodes only whole blocks of valid characters, leaving the scalar code
+    // below in its initial state
+    if (qCpuHasFeature(SSSE3)) {
+        i = fromBase64_ssse3(input, inputSize, output,
+                             options.testFlag(QByteArray::Base64UrlEncoding));
+        offset = i / 4 * 3;
+    }
+#endif
+    for ( ; i < inputSize; ++i) {
         int ch = input[i];
         int d;
 
@@ -4626,7 +4782,17 @@ QByteArray QByteArray::fromHex(const QByteArray &hexEncoded)
     uchar *result = (uchar *)res.data() + res.size();
 
     bool odd_digit = true;
-    for (qsizetype i = hexEncoded.size() - 1; i >= 0; --i) {
+    qsizetype i = hexEncoded.size() - 1;
+#ifdef __SSE2__
+    // The scalar loop below runs backwards, so trailing blocks of valid digits
+    // can be decoded first: each of them leaves odd_digit unchanged.
+    for ( ; i >= 31; i -= 32) {
+        if (!fromHex_sse2(hexEncoded.constData() + i - 31, result - 16))
+            break;
+        result -= 16;
+    }
+#endif
+    for ( ; i >= 0; --i) {
         uchar ch = uchar(hexEncoded.at(i));
         int tmp = QtMiscUtils::fromHex(ch);
         if (tmp == -1)
@@ -4668,7 +4834,15 @@ QByteArray QByteArray::toHex(char separator) const
     QByteArray hex(length, Qt::Uninitialized);
     char *hexData = hex.data();
     const uchar *data = (const uchar *)this->data();
-    for (qsizetype i = 0, o = 0; i < size(); ++i) {
+    qsizetype i = 0;
+    qsizetype o = 0;
+#ifdef QT_BYTEARRAY_CODECS_SSSE3
+    if (!separator && qCpuHasFeature(SSSE3)) {
+        i = toHex_ssse3(data, size(), hexData);
+        o = i * 2;
+    }
+#endif
+    for ( ; i < size(); ++i) {
         hexData[o++] = QtMiscUtils::toHexLower(data[i] >> 4);
         hexData[o++] = QtMiscUtils::toHexLower(data[i] & 0xf);
 
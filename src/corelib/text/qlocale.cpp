@@ -4247,6 +4247,35 @@ char NumericTokenizer::nextToken()
 
     return 0;
 }
+
+/*
+    Fast path of numberToCLocale() for the C locale: a number that consists
+    only of ASCII digits, signs, decimal point and exponent needs no checks
+    beyond those the parsers do anyway, so it is just copied. Returns false,
+    without touching *result, if \a s needs the full treatment: for group
+    separators, Inf and NaN, or any other characters.
+*/
+bool plainAsciiToCLocale(QStringView s, QLocaleData::NumberMode mode, CharBuff *result)
+{
+    constexpr qsizetype MaxLength = 64; // anything longer is unusual enough
+    if (s.size() > MaxLength)
+        return false;
+    char buffer[MaxLength + 1];
+    for (qsizetype i = 0; i < s.size(); ++i) {
+        char16_t ch = s.utf16()[i];
+        if (ch == u'E' && mode == QLocaleData::DoubleScientificMode)
+            ch = u'e';
+        if (!(isAsciiDigit(ch) || ch == u'-' || ch == u'+'
+              || (ch == u'.' && mode != QLocaleData::IntegerMode)
+              || (ch == u'e' && mode == QLocaleData::DoubleScientificMode))) {
+            return false;
+        }
+        buffer[i] = char(ch);
+    }
+    buffer[s.size()] = '\0';
+    result->append(buffer, s.size() + 1);
+    return true;
+}
 } // namespace with no name
 
 /*
@@ -4273,6 +4302,10 @@ bool QLocaleData::numberToCLocale(QStringView s, QLocale::NumberOptions number_o
     s = s.trimmed();
     if (s.size() < 1)
         return false;
+    constexpr QLocale::NumberOptions DigitChecks
+            = QLocale::RejectLeadingZeroInExponent | QLocale::RejectTrailingZeroesAfterDot;
+    if (this == c() && !(number_options & DigitChecks) && plainAsciiToCLocale(s, mode, result))
+        return true;
     NumericTokenizer tokens(s, numericData(mode), mode);
 
     // Digit-grouping details (all modes):
@@ -87,6 +87,36 @@ void qt_doubleToAscii(double d, QLocaleData::DoubleForm form, int precision,
         precision = 1; // 0 significant digits is silently converted to 1
 
 #if !defined(QT_NO_DOUBLECONVERSION) && !defined(QT_BOOTSTRAPPED)
+#if defined(__cpp_lib_to_chars)
+    // std::to_chars() finds the shortest representation that round-trips a
+    // lot faster than libdouble-conversion does (the common implementations
+    // use Ryu), and both pick the same digits. It formats the number, though,
+    // so take the digits and the exponent apart again.
+    if (precision == QLocale::FloatingPointShortest
+            && bufSize >= std::numeric_limits<double>::max_digits10) {
+        char text[32]; // "-d.dddddddddddddddde-ddd"
+        const auto [end, ec] = std::to_chars(text, text + sizeof text, d,
+                                             std::chars_format::scientific);
+        Q_ASSERT(ec == std::errc());
+        const char *p = text;
+        sign = *p == '-';
+        if (sign)
+            ++p;
+        length = 0;
+        buf[length++] = *p++;
+        if (*p == '.') {
+            while (*++p != 'e')
+                buf[length++] = *p;
+        }
+        Q_ASSERT(*p == 'e' && length <= std::numeric_limits<double>::max_digits10);
+        const bool negativeExponent = *++p == '-';
+        int exponent = 0;
+        while (++p != end)
+            exponent = exponent * 10 + (*p - '0');
+        decpt = (negativeExponent ? -exponent : exponent) + 1;
+        return;
+    }
+#endif
     // one digit before the decimal dot, counts as significant digit for DoubleToStringConverter
     if (form == QLocaleData::DFExponent && precision >= 0)
         ++precision;
@@ -252,6 +282,21 @@ void qt_doubleToAscii(double d, QLocaleData::DoubleForm form, int precision,
         --length;
 }
 
+// Tells whether a zero parsed from the first \a processed characters of \a num
+// is the result of underflow.
+static bool isUnderflow(const char *num, qsizetype processed)
+{
+    for (qsizetype i = 0; i < processed; ++i) {
+        if (num[i] >= '1' && num[i] <= '9') {
+            // if a digit before any 'e' is not 0, then a non-zero number was intended.
+            return true;
+        } else if (num[i] == 'e' || num[i] == 'E') {
+            break;
+        }
+    }
+    return false;
+}
+
 QSimpleParsedNumber<double> qt_asciiToDouble(const char *num, qsizetype numLen,
                                              StrayCharacterMode strayCharMode)
 {
@@ -297,6 +342,28 @@ QSimpleParsedNumber<double> qt_asciiToDouble(const char *num, qsizetype numLen,
     double d = 0.0;
     int processed;
 #if !defined(QT_NO_DOUBLECONVERSION) && !defined(QT_BOOTSTRAPPED)
+#if defined(__cpp_lib_to_chars)
+    // std::from_chars() is considerably faster than libdouble-conversion in
+    // the common implementations (Eisel-Lemire with a correct fallback), but
+    // knows nothing of a leading '+' or of surrounding spaces, and reports
+    // overflow and underflow without giving a value. So only use it if the
+    // whole input is a number in range, and leave anything else to the
+    // converter below; both round correctly, so they agree where both apply.
+    {
+        const char *begin = num;
+        const char *const end = num + numLen;
+        if (numLen > 1 && *begin == '+' && (isAsciiDigit(begin[1]) || begin[1] == '.'))
+            ++begin;
+        const auto [ptr, ec] = std::from_chars(begin, end, d, std::chars_format::general);
+        if (ec == std::errc() && ptr == end && qt_is_finite(d)) {
+            // Check if underflow has occurred.
+            if (isZero(d) && isUnderflow(num, numLen))
+                return { d, -numLen };
+            return { d, numLen };
+        }
+        d = 0.0;
+    }
+#endif
     int conv_flags = double_conversion::StringToDoubleConverter::NO_FLAGS;
     if (strayCharMode == TrailingJunkAllowed) {
         conv_flags = double_conversion::StringToDoubleConverter::ALLOW_TRAILING_JUNK;
@@ -356,16 +423,8 @@ QSimpleParsedNumber<double> qt_asciiToDouble(const char *num, qsizetype numLen,
     Q_ASSERT(strayCharMode == TrailingJunkAllowed || processed == numLen);
 
     // Check if underflow has occurred.
-    if (isZero(d)) {
-        for (int i = 0; i < processed; ++i) {
-            if (num[i] >= '1' && num[i] <= '9') {
-                // if a digit before any 'e' is not 0, then a non-zero number was intended.
-                return {d, -processed};
-            } else if (num[i] == 'e' || num[i] == 'E') {
-                break;
-            }
-        }
-    }
+    if (isZero(d) && isUnderflow(num, processed))
+        return { d, -processed };
     return { d, processed };
 }
 
@@ -0,0 +1,403 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qmultistringmatcher_p.h"
+
+#include <QtCore/private/qsimd_p.h>
+#include <QtCore/private/qtools_p.h>
+
+#include <array>
+#include <string>
+#include <vector>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \internal
+    \class QMultiMatcherBase
+    \inmodule QtCore
+
+    QMultiByteArrayMatcher and QMultiStringMatcher search for many patterns at
+    once. The patterns are compiled into an Aho-Corasick automaton, so a
+    single pass over the data finds all occurrences of all patterns, instead
+    of one pass per pattern with QByteArrayMatcher or QStringMatcher.
+
+    The automaton is a DFA with one row of transitions per state. To keep
+    the rows short, the code units are first mapped to classes: all units
+    that don't occur in any pattern share class 0, and for case insensitive
+    matching, the case variants of a unit share its class. Case folding is
+    done per code unit, like QStringMatcher does; QMultiByteArrayMatcher only
+    folds ASCII letters.
+
+    While the automaton is in its start state, the data is skipped quickly
+    (with SSE2 where available) as long as there are at most four code units
+    a match can start with.
+
+    Matches are reported in the order in which they end; of matches ending
+    at the same position, the longest comes first. Matches may overlap.
+    Empty patterns never match. Copies share the automaton.
+*/
+
+namespace {
+constexpr int MaxStartUnits = 4;
+}
+
+struct QMultiMatcherAutomaton
+{
+    using ClassPage = std::array<qint32, 256>;
+
+    // the class of a code unit, looked up through its high byte; page 0 maps
+    // every unit to class 0
+    QList<ClassPage> pages = QList<ClassPage>(1, ClassPage{});
+    std::array<quint16, 256> pageIndex = {};
+    qint32 classCount = 1;
+
+    QList<qint32> transitions;          // classCount entries per state
+    QList<qint32> firstPattern;         // per state, or -1
+    QList<qint32> nextOutput;           // per state, the next state on the suffix chain with a pattern
+    QList<qint32> nextSamePattern;      // per pattern, for duplicate patterns
+    QList<qsizetype> patternLengths;
+
+    char16_t startUnits[MaxStartUnits] = {};
+    int startUnitCount = -1;            // -1 if there are too many to skip for them
+    Qt::CaseSensitivity cs = Qt::CaseSensitive;
+
+    qint32 classOf(char16_t unit) const noexcept
+    {
+        return pages.constData()[pageIndex[unit >> 8]][unit & 0xff];
+    }
+
+    qint32 &classSlot(char16_t unit)
+    {
+        quint16 &page = pageIndex[unit >> 8];
+        if (!page) {
+            page = quint16(pages.size());
+            pages.append(ClassPage{});
+        }
+        return pages[page][unit & 0xff];
+    }
+};
+
+// patterns are given with their code units case folded already
+template <typename Fold>
+static std::shared_ptr<QMultiMatcherAutomaton>
+buildAutomaton(const std::vector<std::u16string> &patterns, Qt::CaseSensitivity cs,
+               char16_t maxUnit, Fold fold)
+{
+    auto a = std::make_shared<QMultiMatcherAutomaton>();
+    a->cs = cs;
+
+    for (const std::u16string &pattern : patterns) {
+        for (char16_t unit : pattern) {
+            qint32 &cls = a->classSlot(unit);
+            if (!cls)
+                cls = a->classCount++;
+        }
+    }
+    const qsizetype classCount = a->classCount;
+
+    // build the trie; go through the patterns backwards, so that duplicates
+    // end up chained in ascending order
+    a->transitions.resize(classCount);
+    a->firstPattern.append(-1);
+    a->nextSamePattern.resize(qsizetype(patterns.size()), -1);
+    a->patternLengths.resize(qsizetype(patterns.size()));
+    for (qsizetype i = qsizetype(patterns.size()) - 1; i >= 0; --i) {
+        const std::u16string &pattern = patterns[size_t(i)];
+        a->patternLengths[i] = qsizetype(pattern.size());
+        if (pattern.empty())
+            continue;
+        qint32 state = 0;
+        for (char16_t unit : pattern) {
+            const qsizetype slot = state * classCount + a->classOf(unit);
+            qint32 next = a->transitions.at(slot);
+            if (!next) {
+                next = qint32(a->firstPattern.size());
+                a->firstPattern.append(-1);
+                a->transitions.resize(a->transitions.size() + classCount);
+                a->transitions[slot] = next;
+            }
+            state = next;
+        }
+        a->nextSamePattern[i] = a->firstPattern.at(state);
+        a->firstPattern[state] = qint32(i);
+    }
+
+    // turn the trie into a DFA, breadth first, so that the failure state of
+    // every state is complete when the state is visited
+    const qsizetype stateCount = a->firstPattern.size();
+    QList<qint32> failure(stateCount, 0);
+    a->nextOutput.resize(stateCount, 0);
+    QList<qint32> queue;
+    queue.reserve(stateCount);
+    for (qsizetype c = 0; c < classCount; ++c) {
+        if (const qint32 child = a->transitions.at(c))
+            queue.append(child);
+    }
+    qint32 *transitions = a->transitions.data();
+    for (qsizetype head = 0; head < queue.size(); ++head) {
+        const qint32 state = queue.at(head);
+        const qint32 fail = failure.at(state);
+        for (qsizetype c = 0; c < classCount; ++c) {
+            qint32 &next = transitions[state * classCount + c];
+            const qint32 fallback = transitions[fail * classCount + c];
+            if (!next) {
+                next = fallback;
+                continue;
+            }
+            failure[next] = fallback;
+            a->nextOutput[next] = a->firstPattern.at(fallback) >= 0
+                    ? fallback : a->nextOutput.at(fallback);
+            queue.append(next);
+        }
+    }
+
+    if (cs == Qt::CaseInsensitive) {
+        for (char32_t unit = 0; unit <= maxUnit; ++unit) {
+            const char16_t folded = fold(char16_t(unit));
+            if (folded == unit)
+                continue;
+            if (const qint32 cls = a->classOf(folded); cls && !a->classOf(char16_t(unit)))
+                a->classSlot(char16_t(unit)) = cls;
+        }
+    }
+
+    int startUnitCount = 0;
+    for (char32_t high = 0; high <= char32_t(maxUnit >> 8) && startUnitCount <= MaxStartUnits; ++high) {
+        if (!a->pageIndex[high])
+            continue;
+        for (char32_t low = 0; low < 256; ++low) {
+            const char16_t unit = char16_t(high << 8 | low);
+            if (!transitions[a->classOf(unit)])
+                continue;
+            if (startUnitCount < MaxStartUnits)
+                a->startUnits[startUnitCount] = unit;
+            if (++startUnitCount > MaxStartUnits)
+                break;
+        }
+    }
+    a->startUnitCount = startUnitCount <= MaxStartUnits ? startUnitCount : -1;
+    return a;
+}
+
+template <typename Char>
+static qsizetype skipToStartUnit(const QMultiMatcherAutomaton &a, const Char *data,
+                                 qsizetype i, qsizetype size) noexcept
+{
+    const int count = a.startUnitCount;
+    if (count == 0)
+        return size;
+#ifdef __SSE2__
+    constexpr qsizetype Step = 16 / sizeof(Char);
+    const auto splat = [](char16_t unit) {
+        if constexpr (sizeof(Char) == 1)
+            return _mm_set1_epi8(char(unit));
+        else
+            return _mm_set1_epi16(short(unit));
+    };
+    const auto compare = [](__m128i lhs, __m128i rhs) {
+        if constexpr (sizeof(Char) == 1)
+            return _mm_cmpeq_epi8(lhs, rhs);
+        else
+            return _mm_cmpeq_epi16(lhs, rhs);
+    };
+    // repeat the last unit if there are fewer than four
+    const __m128i u0 = splat(a.startUnits[0]);
+    const __m128i u1 = splat(a.startUnits[qMin(1, count - 1)]);
+    const __m128i u2 = splat(a.startUnits[qMin(2, count - 1)]);
+    const __m128i u3 = splat(a.startUnits[qMin(3, count - 1)]);
+    for (; i + Step <= size; i += Step) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        const __m128i found = _mm_or_si128(_mm_or_si128(compare(v, u0), compare(v, u1)),
+                                           _mm_or_si128(compare(v, u2), compare(v, u3)));
+        if (const uint mask = _mm_movemask_epi8(found))
+            return i + qCountTrailingZeroBits(mask) / sizeof(Char);
+    }
+#endif
+    for (; i < size; ++i) {
+        for (int k = 0; k < count; ++k) {
+            if (data[i] == a.startUnits[k])
+                return i;
+        }
+    }
+    return size;
+}
+
+// Calls callback for every match; stops when it returns false.
+template <typename Char, typename Callback>
+static void scan(const QMultiMatcherAutomaton &a, const Char *data, qsizetype size,
+                 qsizetype from, Callback callback)
+{
+    const qint32 *transitions = a.transitions.constData();
+    const qint32 *firstPattern = a.firstPattern.constData();
+    const qint32 *nextOutput = a.nextOutput.constData();
+    const qsizetype classCount = a.classCount;
+    const bool prefilter = a.startUnitCount >= 0;
+
+    qint32 state = 0;
+    for (qsizetype i = qMax(from, qsizetype(0)); i < size; ++i) {
+        if (state == 0 && prefilter) {
+            i = skipToStartUnit(a, data, i, size);
+            if (i == size)
+                break;
+        }
+        state = transitions[state * classCount + a.classOf(data[i])];
+        for (qint32 s = firstPattern[state] >= 0 ? state : nextOutput[state]; s; s = nextOutput[s]) {
+            for (qint32 p = firstPattern[s]; p >= 0; p = a.nextSamePattern.at(p)) {
+                const qsizetype length = a.patternLengths.at(p);
+                if (!callback(QMultiMatcherBase::Match{ i + 1 - length, length, p }))
+                    return;
+            }
+        }
+    }
+}
+
+template <typename Char>
+static QMultiMatcherBase::Match firstMatch(const QMultiMatcherAutomaton *a, const Char *data,
+                                           qsizetype size, qsizetype from)
+{
+    QMultiMatcherBase::Match result;
+    if (a) {
+        scan(*a, data, size, from, [&result](const QMultiMatcherBase::Match &m) {
+            result = m;
+            return false;
+        });
+    }
+    return result;
+}
+
+template <typename Char>
+static QList<QMultiMatcherBase::Match> allMatches(const QMultiMatcherAutomaton *a,
+                                                  const Char *data, qsizetype size,
+                                                  qsizetype from)
+{
+    QList<QMultiMatcherBase::Match> result;
+    if (a) {
+        scan(*a, data, size, from, [&result](const QMultiMatcherBase::Match &m) {
+            result.append(m);
+            return true;
+        });
+    }
+    return result;
+}
+
+/*!
+    \internal
+    Returns the number of patterns the matcher was created with.
+*/
+qsizetype QMultiMatcherBase::patternCount() const noexcept
+{
+    return d ? d->patternLengths.size() : 0;
+}
+
+/*!
+    \internal
+    Returns the case sensitivity the matcher was created with.
+*/
+Qt::CaseSensitivity QMultiMatcherBase::caseSensitivity() const noexcept
+{
+    return d ? d->cs : Qt::CaseSensitive;
+}
+
+/*!
+    \internal
+    \class QMultiByteArrayMatcher
+    \inmodule QtCore
+
+    Searches byte arrays for many patterns at once. See QMultiMatcherBase.
+*/
+
+/*!
+    \internal
+    Creates a matcher for \a patterns, with case sensitivity \a cs. The
+    pattern member of a Match is an index into \a patterns.
+*/
+QMultiByteArrayMatcher::QMultiByteArrayMatcher(const QByteArrayList &patterns,
+                                               Qt::CaseSensitivity cs)
+{
+    using QtMiscUtils::toAsciiLower;
+    const auto fold = [cs](char16_t unit) {
+        return cs == Qt::CaseSensitive ? unit : char16_t(uchar(toAsciiLower(char(unit))));
+    };
+    std::vector<std::u16string> units;
+    units.reserve(size_t(patterns.size()));
+    for (const QByteArray &pattern : patterns) {
+        std::u16string &u = units.emplace_back();
+        u.reserve(size_t(pattern.size()));
+        for (char ch : pattern)
+            u.push_back(fold(uchar(ch)));
+    }
+    d = buildAutomaton(units, cs, 0xff, fold);
+}
+
+/*!
+    \internal
+    Returns the first match in \a data, starting the search at position
+    \a from, or an invalid Match if there is none. The first match is the one
+    that ends first.
+*/
+QMultiMatcherBase::Match QMultiByteArrayMatcher::indexIn(QByteArrayView data, qsizetype from) const
+{
+    return firstMatch(d.get(), reinterpret_cast<const uchar *>(data.data()), data.size(), from);
+}
+
+/*!
+    \internal
+    Returns all matches in \a data, starting the search at position \a from.
+*/
+QList<QMultiMatcherBase::Match> QMultiByteArrayMatcher::findAll(QByteArrayView data,
+                                                                qsizetype from) const
+{
+    return allMatches(d.get(), reinterpret_cast<const uchar *>(data.data()), data.size(), from);
+}
+
+/*!
+    \internal
+    \class QMultiStringMatcher
+    \inmodule QtCore
+
+    Searches strings for many patterns at once. See QMultiMatcherBase.
+*/
+
+/*!
+    \internal
+    Creates a matcher for \a patterns, with case sensitivity \a cs. The
+    pattern member of a Match is an index into \a patterns.
+*/
+QMultiStringMatcher::QMultiStringMatcher(const QStringList &patterns, Qt::CaseSensitivity cs)
+{
+    const auto fold = [cs](char16_t unit) {
+        return cs == Qt::CaseSensitive ? unit : char16_t(QChar::toCaseFolded(unit));
+    };
+    std::vector<std::u16string> units;
+    units.reserve(size_t(patterns.size()));
+    for (const QString &pattern : patterns) {
+        std::u16string &u = units.emplace_back();
+        u.reserve(size_t(pattern.size()));
+        for (QChar ch : pattern)
+            u.push_back(fold(ch.unicode()));
+    }
+    d = buildAutomaton(units, cs, 0xffff, fold);
+}
+
+/*!
+    \internal
+    Returns the first match in \a str, starting the search at position
+    \a from, or an invalid Match if there is none. The first match is the one
+    that ends first.
+*/
+QMultiMatcherBase::Match QMultiStringMatcher::indexIn(QStringView str, qsizetype from) const
+{
+    return firstMatch(d.get(), str.utf16(), str.size(), from);
+}
+
+/*!
+    \internal
+    Returns all matches in \a str, starting the search at position \a from.
+*/
+QList<QMultiMatcherBase::Match> QMultiStringMatcher::findAll(QStringView str, qsizetype from) const
+{
+    return allMatches(d.get(), str.utf16(), str.size(), from);
+}
+
+QT_END_NAMESPACE
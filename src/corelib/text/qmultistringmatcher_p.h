@@ -0,0 +1,89 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QMULTISTRINGMATCHER_P_H
+#define QMULTISTRINGMATCHER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qbytearraylist.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qstringlist.h>
+
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+struct QMultiMatcherAutomaton;
+
+class Q_CORE_EXPORT QMultiMatcherBase
+{
+public:
+    struct Match
+    {
+        qsizetype position = -1;
+        qsizetype length = 0;
+        qsizetype pattern = -1;
+
+        bool isValid() const noexcept { return position >= 0; }
+
+        friend bool operator==(const Match &lhs, const Match &rhs) noexcept
+        {
+            return lhs.position == rhs.position && lhs.length == rhs.length
+                    && lhs.pattern == rhs.pattern;
+        }
+        friend bool operator!=(const Match &lhs, const Match &rhs) noexcept
+        {
+            return !(lhs == rhs);
+        }
+    };
+
+    qsizetype patternCount() const noexcept;
+    Qt::CaseSensitivity caseSensitivity() const noexcept;
+
+protected:
+    QMultiMatcherBase() noexcept = default;
+    ~QMultiMatcherBase() = default;
+    QMultiMatcherBase(const QMultiMatcherBase &) = default;
+    QMultiMatcherBase(QMultiMatcherBase &&) noexcept = default;
+    QMultiMatcherBase &operator=(const QMultiMatcherBase &) = default;
+    QMultiMatcherBase &operator=(QMultiMatcherBase &&) noexcept = default;
+
+    std::shared_ptr<const QMultiMatcherAutomaton> d;
+};
+
+class Q_CORE_EXPORT QMultiByteArrayMatcher : public QMultiMatcherBase
+{
+public:
+    QMultiByteArrayMatcher() noexcept = default;
+    explicit QMultiByteArrayMatcher(const QByteArrayList &patterns,
+                                    Qt::CaseSensitivity cs = Qt::CaseSensitive);
+
+    Match indexIn(QByteArrayView data, qsizetype from = 0) const;
+    QList<Match> findAll(QByteArrayView data, qsizetype from = 0) const;
+};
+
+class Q_CORE_EXPORT QMultiStringMatcher : public QMultiMatcherBase
+{
+public:
+    QMultiStringMatcher() noexcept = default;
+    explicit QMultiStringMatcher(const QStringList &patterns,
+                                 Qt::CaseSensitivity cs = Qt::CaseSensitive);
+
+    Match indexIn(QStringView str, qsizetype from = 0) const;
+    QList<Match> findAll(QStringView str, qsizetype from = 0) const;
+};
+
+QT_END_NAMESPACE
+
+#endif // QMULTISTRINGMATCHER_P_H
@@ -14,15 +14,25 @@
 #include <QtCore/qglobal.h>
 #include <QtCore/qatomic.h>
 #include <QtCore/qdatastream.h>
+#include <QtCore/qsharedpointer.h>
+#include <QtCore/qvarlengtharray.h>
 
 #if defined(Q_OS_MACOS)
 #include <QtCore/private/qcore_mac_p.h>
 #endif
 
+#ifndef QT_BOOTSTRAPPED
+#include <QtCore/qglobalstatic.h>
+#include <QtCore/private/qconcurrentcache_p.h>
+#include <QtCore/private/qregularexpressionset_p.h>
+#endif
+
 #define PCRE2_CODE_UNIT_WIDTH 16
 
 #include <pcre2.h>
 
+#include <algorithm>
+
 QT_BEGIN_NAMESPACE
 
 using namespace Qt::StringLiterals;
@@ -704,6 +714,29 @@ static int convertToPcreOptions(QRegularExpression::MatchOptions matchOptions)
     return options;
 }
 
+/*
+    The result of compiling a pattern. It is immutable once created, so it can
+    be shared by all QRegularExpression objects with the same pattern and
+    options, in any thread.
+*/
+struct QRegularExpressionCompiledPattern
+{
+    Q_DISABLE_COPY_MOVE(QRegularExpressionCompiledPattern)
+    QRegularExpressionCompiledPattern() = default;
+    ~QRegularExpressionCompiledPattern() { pcre2_code_free_16(code); }
+
+    void getPatternInfo();
+    void optimizePattern();
+    qsizetype cost() const;
+
+    pcre2_code_16 *code = nullptr;
+    int errorCode = 0;
+    qsizetype errorOffset = -1;
+    int capturingCount = 0;
+    bool usingCrLfNewlines = false;
+    bool usingJOption = false;
+};
+
 struct QRegularExpressionPrivate : QSharedData
 {
     QRegularExpressionPrivate();
@@ -712,8 +745,6 @@ struct QRegularExpressionPrivate : QSharedData
 
     void cleanCompiledPattern();
     void compilePattern();
-    void getPatternInfo();
-    void optimizePattern();
 
     enum CheckSubjectStringOption {
         CheckSubjectString,
@@ -736,9 +767,11 @@ struct QRegularExpressionPrivate : QSharedData
     // (right after a detach happened).
     mutable QMutex mutex;
 
-    // The PCRE code pointer is reference-counted by the QRegularExpressionPrivate
-    // objects themselves; when the private is copied (i.e. a detach happened)
-    // it is set to nullptr
+    // The compiled pattern is shared with the cache of compiled patterns and
+    // with other QRegularExpressionPrivate objects using the same pattern;
+    // when the private is copied (i.e. a detach happened) it is set to nullptr.
+    // compiledPattern is a shortcut to compiled->code.
+    QSharedPointer<QRegularExpressionCompiledPattern> compiled;
     pcre2_code_16 *compiledPattern;
     int errorCode;
     qsizetype errorOffset;
@@ -872,7 +905,7 @@ QRegularExpressionPrivate::QRegularExpressionPrivate(const QRegularExpressionPri
 */
 void QRegularExpressionPrivate::cleanCompiledPattern()
 {
-    pcre2_code_free_16(compiledPattern);
+    compiled.reset();
     compiledPattern = nullptr;
     errorCode = 0;
     errorOffset = -1;
@@ -882,6 +915,60 @@ void QRegularExpressionPrivate::cleanCompiledPattern()
 
 /*!
     \internal
+
+    Compiles \a pattern with the given \a patternOptions. The result is
+    returned even if compiling failed, so that the error is cached as well.
+*/
+static QSharedPointer<QRegularExpressionCompiledPattern>
+compileRegularExpression(const QString &pattern, QRegularExpression::PatternOptions patternOptions)
+{
+    auto result = QSharedPointer<QRegularExpressionCompiledPattern>::create();
+
+    int options = convertToPcreOptions(patternOptions);
+    options |= PCRE2_UTF;
+
+    PCRE2_SIZE patternErrorOffset;
+    result->code = pcre2_compile_16(reinterpret_cast<PCRE2_SPTR16>(pattern.constData()),
+                                    pattern.size(),
+                                    options,
+                                    &result->errorCode,
+                                    &patternErrorOffset,
+                                    nullptr);
+
+    if (!result->code) {
+        result->errorOffset = qsizetype(patternErrorOffset);
+        return result;
+    } else {
+        // ignore whatever PCRE2 wrote into errorCode -- leave it to 0 to mean "no error"
+        result->errorCode = 0;
+    }
+
+    result->optimizePattern();
+    result->getPatternInfo();
+    return result;
+}
+
+#ifndef QT_BOOTSTRAPPED
+namespace {
+using CompiledPatternKey = std::pair<QString, int>;
+
+// Compiled patterns, and errors, by pattern and options. The cost is the
+// memory used by the compiled and JIT-compiled code.
+struct CompiledPatternCache : QConcurrentCache<CompiledPatternKey, QRegularExpressionCompiledPattern>
+{
+    CompiledPatternCache() : QConcurrentCache(4 * 1024 * 1024) {}
+};
+}
+Q_GLOBAL_STATIC(CompiledPatternCache, compiledPatternCache)
+#endif
+
+/*!
+    \internal
+
+    Looks the pattern up in the process-wide cache of compiled patterns, and
+    compiles it if it is not there, so that the same pattern is only
+    compiled (and JIT-compiled) once no matter how many QRegularExpression
+    objects, in how many threads, use it.
 */
 void QRegularExpressionPrivate::compilePattern()
 {
@@ -893,41 +980,44 @@ void QRegularExpressionPrivate::compilePattern()
     isDirty = false;
     cleanCompiledPattern();
 
-    int options = convertToPcreOptions(patternOptions);
-    options |= PCRE2_UTF;
-
-    PCRE2_SIZE patternErrorOffset;
-    compiledPattern = pcre2_compile_16(reinterpret_cast<PCRE2_SPTR16>(pattern.constData()),
-                                       pattern.size(),
-                                       options,
-                                       &errorCode,
-                                       &patternErrorOffset,
-                                       nullptr);
-
-    if (!compiledPattern) {
-        errorOffset = qsizetype(patternErrorOffset);
-        return;
-    } else {
-        // ignore whatever PCRE2 wrote into errorCode -- leave it to 0 to mean "no error"
-        errorCode = 0;
+#ifndef QT_BOOTSTRAPPED
+    const CompiledPatternKey key(pattern, patternOptions.toInt());
+    CompiledPatternCache *cache = compiledPatternCache();
+    if (cache)
+        compiled = cache->object(key);
+    if (!compiled) {
+        compiled = compileRegularExpression(pattern, patternOptions);
+        if (cache)
+            cache->insert(key, compiled, compiled->cost());
     }
+#else
+    compiled = compileRegularExpression(pattern, patternOptions);
+#endif
 
-    optimizePattern();
-    getPatternInfo();
+    compiledPattern = compiled->code;
+    errorCode = compiled->errorCode;
+    errorOffset = compiled->errorOffset;
+    capturingCount = compiled->capturingCount;
+    usingCrLfNewlines = compiled->usingCrLfNewlines;
+
+    if (Q_UNLIKELY(compiled->usingJOption)) {
+        qWarning("QRegularExpressionPrivate::getPatternInfo(): the pattern '%ls'\n    is using the (?J) option; duplicate capturing group names are not supported by Qt",
+                 qUtf16Printable(pattern));
+    }
 }
 
 /*!
     \internal
 */
-void QRegularExpressionPrivate::getPatternInfo()
+void QRegularExpressionCompiledPattern::getPatternInfo()
 {
-    Q_ASSERT(compiledPattern);
+    Q_ASSERT(code);
 
-    pcre2_pattern_info_16(compiledPattern, PCRE2_INFO_CAPTURECOUNT, &capturingCount);
+    pcre2_pattern_info_16(code, PCRE2_INFO_CAPTURECOUNT, &capturingCount);
 
     // detect the settings for the newline
     unsigned int patternNewlineSetting;
-    if (pcre2_pattern_info_16(compiledPattern, PCRE2_INFO_NEWLINE, &patternNewlineSetting) != 0) {
+    if (pcre2_pattern_info_16(code, PCRE2_INFO_NEWLINE, &patternNewlineSetting) != 0) {
         // no option was specified in the regexp, grab PCRE build defaults
         pcre2_config_16(PCRE2_CONFIG_NEWLINE, &patternNewlineSetting);
     }
@@ -937,11 +1027,27 @@ void QRegularExpressionPrivate::getPatternInfo()
             (patternNewlineSetting == PCRE2_NEWLINE_ANYCRLF);
 
     unsigned int hasJOptionChanged;
-    pcre2_pattern_info_16(compiledPattern, PCRE2_INFO_JCHANGED, &hasJOptionChanged);
-    if (Q_UNLIKELY(hasJOptionChanged)) {
-        qWarning("QRegularExpressionPrivate::getPatternInfo(): the pattern '%ls'\n    is using the (?J) option; duplicate capturing group names are not supported by Qt",
-                 qUtf16Printable(pattern));
+    pcre2_pattern_info_16(code, PCRE2_INFO_JCHANGED, &hasJOptionChanged);
+    usingJOption = hasJOptionChanged;
+}
+
+/*!
+    \internal
+
+    Returns the memory used by the compiled pattern, as the cost for the
+    cache of compiled patterns.
+*/
+qsizetype QRegularExpressionCompiledPattern::cost() const
+{
+    size_t size = sizeof(*this);
+    if (code) {
+        size_t codeSize = 0;
+        if (pcre2_pattern_info_16(code, PCRE2_INFO_SIZE, &codeSize) == 0)
+            size += codeSize;
+        if (pcre2_pattern_info_16(code, PCRE2_INFO_JITSIZE, &codeSize) == 0)
+            size += codeSize;
     }
+    return qsizetype(size);
 }
 
 
@@ -996,19 +1102,19 @@ static bool isJitEnabled()
     The purpose of the function is to call pcre2_jit_compile_16, which
     JIT-compiles the pattern.
 
-    It gets called when a pattern is recompiled by us (in compilePattern()),
-    under mutex protection.
+    It gets called when a pattern is compiled by us, before the compiled
+    pattern is shared with other objects.
 */
-void QRegularExpressionPrivate::optimizePattern()
+void QRegularExpressionCompiledPattern::optimizePattern()
 {
-    Q_ASSERT(compiledPattern);
+    Q_ASSERT(code);
 
     static const bool enableJit = isJitEnabled();
 
     if (!enableJit)
         return;
 
-    pcre2_jit_compile_16(compiledPattern, PCRE2_JIT_COMPLETE | PCRE2_JIT_PARTIAL_SOFT | PCRE2_JIT_PARTIAL_HARD);
+    pcre2_jit_compile_16(code, PCRE2_JIT_COMPLETE | PCRE2_JIT_PARTIAL_SOFT | PCRE2_JIT_PARTIAL_HARD);
 }
 
 /*!
@@ -2881,6 +2987,250 @@ QDebug operator<<(QDebug debug, const QRegularExpressionMatch &match)
 }
 #endif
 
+#ifndef QT_BOOTSTRAPPED
+/*!
+    \internal
+    \class QRegularExpressionSet
+    \inmodule QtCore
+
+    QRegularExpressionSet tests a subject string against many regular
+    expressions, and reports which of them match somewhere in the subject.
+
+    Instead of running one match per pattern, the patterns are combined into
+    one pattern of alternatives, each of which is wrapped into an atomic
+    group and followed by a callout. The callout records that the pattern
+    matched and then fails, which makes PCRE2 continue with the remaining
+    alternatives and start positions. Patterns that have already matched are
+    skipped by a callout in front of their alternative. Like this, a single
+    call to pcre2_match() checks all patterns, and PCRE2's start-of-match
+    optimizations work on the union of all patterns.
+
+    Patterns that use back references, recursion, backtracking control verbs
+    or callouts of their own would interfere with the combined pattern; they
+    are matched one by one instead. So are all the patterns that hadn't
+    matched yet when the combined match fails with an error, such as
+    exceeding the match limit. Invalid patterns never match.
+*/
+
+struct QRegularExpressionSetPrivate
+{
+    Q_DISABLE_COPY_MOVE(QRegularExpressionSetPrivate)
+    QRegularExpressionSetPrivate() = default;
+    ~QRegularExpressionSetPrivate() { pcre2_code_free_16(combined); }
+
+    QList<QRegularExpression> expressions;
+    QList<qsizetype> combinedIndexes;   // alternative in the combined pattern -> index
+    QList<qsizetype> separateIndexes;
+    pcre2_code_16 *combined = nullptr;
+};
+
+namespace {
+struct SetMatchState
+{
+    QVarLengthArray<bool, 64> matched;
+    qsizetype remaining;
+    bool stopAtFirstMatch;
+};
+}
+
+/*!
+    \internal
+
+    Callout for the combined pattern of a QRegularExpressionSet. The callout
+    strings are "<n" in front of alternative n and ">n" behind it.
+*/
+static int regularExpressionSetCallout(pcre2_callout_block_16 *block, void *data)
+{
+    auto state = static_cast<SetMatchState *>(data);
+    const auto text = reinterpret_cast<const char16_t *>(block->callout_string);
+    qsizetype n = 0;
+    for (PCRE2_SIZE i = 1; i < block->callout_string_length; ++i)
+        n = n * 10 + (text[i] - u'0');
+
+    if (state->matched[n])
+        return 1;               // nothing left to find in this alternative
+    if (text[0] == u'<')
+        return 0;
+
+    state->matched[n] = true;
+    if (--state->remaining == 0 || state->stopAtFirstMatch)
+        return PCRE2_ERROR_NOMATCH; // abandon the match, we are done
+    return 1;                   // backtrack, to find the other patterns
+}
+
+/*!
+    \internal
+    Creates a set of the regular expressions \a patterns, compiled with the
+    given \a options.
+*/
+QRegularExpressionSet::QRegularExpressionSet(const QStringList &patterns,
+                                             QRegularExpression::PatternOptions options)
+{
+    // constructs that refer to other parts of the pattern, control the
+    // backtracking, or could extend beyond the alternative
+    static const QRegularExpression needsSeparateMatch(
+            uR"(\(\*|\(\?(?:C|R|&|P>|[+-]?\d|[a-zA-Z^-]*x)|\\[gk])"_s);
+
+    auto d = std::make_shared<QRegularExpressionSetPrivate>();
+    d->expressions.reserve(patterns.size());
+    QString combinedPattern;
+    for (qsizetype i = 0; i < patterns.size(); ++i) {
+        const QRegularExpression &re = d->expressions.emplace_back(patterns.at(i), options);
+        if (!re.isValid())
+            continue;
+        uint backReferenceMax = 0;
+        pcre2_pattern_info_16(re.d->compiledPattern, PCRE2_INFO_BACKREFMAX, &backReferenceMax);
+        if (backReferenceMax || patterns.at(i).contains(needsSeparateMatch)) {
+            d->separateIndexes.append(i);
+            continue;
+        }
+
+        const QString n = QString::number(d->combinedIndexes.size());
+        combinedPattern += (combinedPattern.isEmpty() ? u"(?:"_s : u"|"_s)
+                + u"(?C\"<" + n + u"\")(?>" + patterns.at(i)
+                // end an unterminated \Q, and a comment in extended syntax
+                + u"\\E" + (options.testFlag(QRegularExpression::ExtendedPatternSyntaxOption)
+                            ? u"\n"_s : QString())
+                + u")(?C\">" + n + u"\")";
+        d->combinedIndexes.append(i);
+    }
+
+    if (!d->combinedIndexes.isEmpty()) {
+        combinedPattern += u')';
+        int errorCode;
+        PCRE2_SIZE errorOffset;
+        d->combined = pcre2_compile_16(reinterpret_cast<PCRE2_SPTR16>(combinedPattern.constData()),
+                                       combinedPattern.size(),
+                                       convertToPcreOptions(options) | PCRE2_UTF | PCRE2_DUPNAMES,
+                                       &errorCode, &errorOffset, nullptr);
+        if (d->combined) {
+            static const bool enableJit = isJitEnabled();
+            if (enableJit)
+                pcre2_jit_compile_16(d->combined, PCRE2_JIT_COMPLETE);
+        } else {
+            // shouldn't happen; fall back to matching every pattern on its own
+            d->separateIndexes += d->combinedIndexes;
+            d->combinedIndexes.clear();
+            std::sort(d->separateIndexes.begin(), d->separateIndexes.end());
+        }
+    }
+    this->d = std::move(d);
+}
+
+/*!
+    \internal
+    Returns the number of patterns in the set.
+*/
+qsizetype QRegularExpressionSet::size() const noexcept
+{
+    return d ? d->expressions.size() : 0;
+}
+
+/*!
+    \internal
+    Returns \c true if all patterns in the set are valid.
+*/
+bool QRegularExpressionSet::isValid() const
+{
+    if (d) {
+        for (const QRegularExpression &re : d->expressions) {
+            if (!re.isValid())
+                return false;
+        }
+    }
+    return true;
+}
+
+/*!
+    \internal
+    Returns the regular expression for the pattern at index \a i, for
+    instance to find out why it isn't valid.
+*/
+QRegularExpression QRegularExpressionSet::regularExpression(qsizetype i) const
+{
+    Q_ASSERT(d && i >= 0 && i < d->expressions.size());
+    return d->expressions.at(i);
+}
+
+static QList<qsizetype> matchSet(const QRegularExpressionSetPrivate *d, QStringView subject,
+                                 bool stopAtFirstMatch)
+{
+    QList<qsizetype> result;
+    if (!d)
+        return result;
+
+    if (d->combined) {
+        SetMatchState state;
+        state.matched.resize(d->combinedIndexes.size(), false);
+        state.remaining = d->combinedIndexes.size();
+        state.stopAtFirstMatch = stopAtFirstMatch;
+
+        pcre2_match_context_16 *matchContext = pcre2_match_context_create_16(nullptr);
+        pcre2_jit_stack_assign_16(matchContext, &qtPcreCallback, nullptr);
+        pcre2_set_callout_16(matchContext, &regularExpressionSetCallout, &state);
+        pcre2_match_data_16 *matchData = pcre2_match_data_create_16(1, nullptr);
+
+        // see QRegularExpressionPrivate::doMatch()
+        const char16_t dummySubject = 0;
+        const char16_t *subjectUtf16 = subject.utf16() ? subject.utf16() : &dummySubject;
+        const int rc = safe_pcre2_match_16(d->combined, reinterpret_cast<PCRE2_SPTR16>(subjectUtf16),
+                                           subject.size(), 0, 0, matchData, matchContext);
+
+        pcre2_match_data_free_16(matchData);
+        pcre2_match_context_free_16(matchContext);
+
+        // If the combined match ran into one of PCRE2's limits, the
+        // alternatives it didn't get to may still match on their own: the
+        // limits apply to all of them together, and start-of-match
+        // optimizations that rule out a single pattern don't apply to the
+        // combined one.
+        const bool incomplete = rc < 0 && rc != PCRE2_ERROR_NOMATCH;
+        for (qsizetype n = 0; n < d->combinedIndexes.size(); ++n) {
+            const qsizetype i = d->combinedIndexes.at(n);
+            if (state.matched[n]
+                    || (incomplete && d->expressions.at(i).matchView(subject).hasMatch())) {
+                result.append(i);
+                if (incomplete && stopAtFirstMatch)
+                    break;
+            }
+        }
+        if (stopAtFirstMatch && !result.isEmpty())
+            return result;
+    }
+
+    const qsizetype combinedMatches = result.size();
+    for (qsizetype i : d->separateIndexes) {
+        if (d->expressions.at(i).matchView(subject).hasMatch()) {
+            result.append(i);
+            if (stopAtFirstMatch)
+                break;
+        }
+    }
+    if (combinedMatches && combinedMatches != result.size())
+        std::inplace_merge(result.begin(), result.begin() + combinedMatches, result.end());
+    return result;
+}
+
+/*!
+    \internal
+    Returns the indexes of the patterns that match somewhere in \a subject,
+    in ascending order.
+*/
+QList<qsizetype> QRegularExpressionSet::match(QStringView subject) const
+{
+    return matchSet(d.get(), subject, false);
+}
+
+/*!
+    \internal
+    Returns \c true if any of the patterns matches somewhere in \a subject.
+*/
+bool QRegularExpressionSet::hasMatch(QStringView subject) const
+{
+    return !matchSet(d.get(), subject, true).isEmpty();
+}
+#endif // QT_BOOTSTRAPPED
+
 // fool lupdate: make it extract those strings for translation, but don't put them
 // inside Qt -- they're already inside libpcre (cf. man 3 pcreapi, pcre_compile.c).
 #if 0
@@ -170,6 +170,7 @@ private:
     friend class QRegularExpressionMatch;
     friend struct QRegularExpressionMatchPrivate;
     friend class QRegularExpressionMatchIterator;
+    friend class QRegularExpressionSet;
     friend Q_CORE_EXPORT size_t qHash(const QRegularExpression &key, size_t seed) noexcept;
 
     QRegularExpression(QRegularExpressionPrivate &dd);
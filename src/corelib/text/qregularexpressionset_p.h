@@ -0,0 +1,52 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QREGULAREXPRESSIONSET_P_H
+#define QREGULAREXPRESSIONSET_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qregularexpression.h>
+#include <QtCore/qstringlist.h>
+
+#include <memory>
+
+QT_REQUIRE_CONFIG(regularexpression);
+
+QT_BEGIN_NAMESPACE
+
+struct QRegularExpressionSetPrivate;
+
+class Q_CORE_EXPORT QRegularExpressionSet
+{
+public:
+    QRegularExpressionSet() noexcept = default;
+    explicit QRegularExpressionSet(const QStringList &patterns,
+                                   QRegularExpression::PatternOptions options
+                                   = QRegularExpression::NoPatternOption);
+
+    qsizetype size() const noexcept;
+    bool isValid() const;
+    QRegularExpression regularExpression(qsizetype i) const;
+
+    QList<qsizetype> match(QStringView subject) const;
+    bool hasMatch(QStringView subject) const;
+
+private:
+    std::shared_ptr<const QRegularExpressionSetPrivate> d;
+};
+
+QT_END_NAMESPACE
+
+#endif // QREGULAREXPRESSIONSET_P_H
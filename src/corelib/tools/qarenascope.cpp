@@ -0,0 +1,190 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qarenascope_p.h"
+
+#include <QtCore/qatomic.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/private/qlocking_p.h>
+
+QT_BEGIN_NAMESPACE
+
+/*!
+    \internal
+    \class QArenaScope
+    \inmodule QtCore
+
+    QArenaScope is a bump allocator for building large temporary structures:
+    allocating is just a pointer increment, and freeing is just a decrement of
+    the counter of the block the memory came from. Containers use it through
+    QArenaAllocator, for instance as
+    \c{std::vector<QString, QArenaAllocator<QString>>}.
+
+    The scope is deliberately not hooked into QArrayData, the storage of
+    QString, QByteArray and QList: that memory is freed by inline code
+    compiled into applications, which calls free() on it directly. Routing it
+    through the scope would need that code to call into QtCore instead, which
+    applications built against older headers don't do, so their containers
+    would free() arena memory. QHash nodes are likewise allocated and freed
+    inline. Qt containers therefore always allocate on the heap, also inside
+    a scope.
+
+    Memory may outlive the scope and may be freed from any thread: a block is
+    only reused once all the allocations made from it have been freed. The
+    price is that a single long-lived allocation keeps its whole block
+    (64 kB) alive, so the scope is meant for temporary data. Allocating from a
+    scope is only allowed on the thread that created it, while it exists.
+
+    Scopes may be nested; current() returns the innermost one of the calling
+    thread. Allocations that are too large to fit comfortably into a block
+    are made on the heap.
+*/
+
+/*!
+    \internal
+    \class QArenaAllocator
+    \inmodule QtCore
+
+    An allocator for standard containers that allocates from a QArenaScope,
+    by default the current scope of the thread that creates the allocator.
+    If there is none, it allocates on the heap.
+
+    Copies of a container allocate from the current scope of the thread that
+    makes the copy, not from the scope of the original.
+*/
+
+namespace {
+constexpr size_t BlockSize = 64 * 1024;
+constexpr size_t MaxAllocationSize = BlockSize / 4;
+constexpr size_t AllocationAlignment = alignof(std::max_align_t);
+// Blocks kept for reuse after all their allocations are gone; the rest go
+// back to the heap.
+constexpr int MaxCachedBlocks = 16;
+}
+
+struct alignas(AllocationAlignment) QArenaBlock
+{
+    // one for every allocation that hasn't been freed, plus one while the
+    // block is the current block of a scope
+    QAtomicInteger<size_t> ref;
+};
+
+namespace {
+struct BlockCache
+{
+    QBasicMutex mutex;
+    int count = 0;
+    QArenaBlock *blocks[MaxCachedBlocks] = {};
+};
+}
+
+// trivially destructible, so blocks may still be freed during static
+// destruction
+Q_CONSTINIT static BlockCache blockCache;
+Q_CONSTINIT static thread_local QArenaScope *currentScope = nullptr;
+
+static QArenaBlock *acquireBlock()
+{
+    QArenaBlock *block = nullptr;
+    {
+        const auto locker = qt_scoped_lock(blockCache.mutex);
+        if (blockCache.count)
+            block = blockCache.blocks[--blockCache.count];
+    }
+    if (!block) {
+        // aligned to its size, so a block can be found from the addresses of
+        // the allocations in it
+        void *ptr = ::operator new(BlockSize, std::align_val_t(BlockSize));
+        block = new (ptr) QArenaBlock;
+    }
+    block->ref.storeRelaxed(1);
+    return block;
+}
+
+static void derefBlock(QArenaBlock *block) noexcept
+{
+    if (block->ref.deref())
+        return;
+    {
+        const auto locker = qt_scoped_lock(blockCache.mutex);
+        if (blockCache.count < MaxCachedBlocks) {
+            blockCache.blocks[blockCache.count++] = block;
+            return;
+        }
+    }
+    block->~QArenaBlock();
+    ::operator delete(static_cast<void *>(block), std::align_val_t(BlockSize));
+}
+
+/*!
+    \internal
+    Makes this scope the current scope of the calling thread.
+*/
+QArenaScope::QArenaScope() noexcept
+    : previous(currentScope)
+{
+    currentScope = this;
+}
+
+/*!
+    \internal
+    Makes the enclosing scope, if any, the current scope of the calling thread
+    again. Memory allocated from this scope stays valid.
+*/
+QArenaScope::~QArenaScope()
+{
+    Q_ASSERT_X(currentScope == this, "QArenaScope", "scopes must be destroyed in reverse order");
+    currentScope = previous;
+    if (block)
+        derefBlock(block);
+}
+
+/*!
+    \internal
+    Returns the innermost scope of the calling thread, or \nullptr if there
+    is none.
+*/
+QArenaScope *QArenaScope::current() noexcept
+{
+    return currentScope;
+}
+
+/*!
+    \internal
+    Allocates \a size bytes, suitably aligned for any fundamental type.
+    Throws std::bad_alloc if there is not enough memory.
+*/
+void *QArenaScope::allocate(size_t size)
+{
+    if (size > MaxAllocationSize)
+        return ::operator new(size);
+
+    size = (qMax(size, size_t(1)) + AllocationAlignment - 1) & ~(AllocationAlignment - 1);
+    if (size_t(end - cursor) < size) {
+        QArenaBlock *newBlock = acquireBlock();
+        if (block)
+            derefBlock(block);
+        block = newBlock;
+        cursor = reinterpret_cast<char *>(block + 1);
+        end = reinterpret_cast<char *>(block) + BlockSize;
+    }
+    void *ptr = cursor;
+    cursor += size;
+    block->ref.ref();
+    return ptr;
+}
+
+/*!
+    \internal
+    Frees \a ptr of \a size bytes, which must have been returned by
+    allocate() for the same size. This may be called from any thread, also
+    after the scope has been destroyed.
+*/
+void QArenaScope::deallocate(void *ptr, size_t size) noexcept
+{
+    if (size > MaxAllocationSize)
+        return ::operator delete(ptr);
+    derefBlock(reinterpret_cast<QArenaBlock *>(quintptr(ptr) & ~quintptr(BlockSize - 1)));
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,95 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QARENASCOPE_P_H
+#define QARENASCOPE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+
+#include <cstddef>
+#include <new>
+#include <type_traits>
+
+QT_BEGIN_NAMESPACE
+
+struct QArenaBlock;
+
+class Q_CORE_EXPORT QArenaScope
+{
+    Q_DISABLE_COPY_MOVE(QArenaScope)
+public:
+    QArenaScope() noexcept;
+    ~QArenaScope();
+
+    static QArenaScope *current() noexcept;
+
+    void *allocate(size_t size);
+    static void deallocate(void *ptr, size_t size) noexcept;
+
+private:
+    QArenaScope *previous;
+    QArenaBlock *block = nullptr;
+    char *cursor = nullptr;
+    char *end = nullptr;
+};
+
+template <typename T>
+class QArenaAllocator
+{
+    static_assert(alignof(T) <= alignof(std::max_align_t),
+                  "QArenaAllocator does not support over-aligned types");
+public:
+    using value_type = T;
+
+    QArenaAllocator() noexcept : scope(QArenaScope::current()) {}
+    explicit QArenaAllocator(QArenaScope *scope) noexcept : scope(scope) {}
+    template <typename U>
+    QArenaAllocator(const QArenaAllocator<U> &other) noexcept : scope(other.scope) {}
+
+    T *allocate(size_t n)
+    {
+        if (n > size_t(-1) / sizeof(T))
+            qBadAlloc();
+        if (!scope)
+            return static_cast<T *>(::operator new(n * sizeof(T)));
+        return static_cast<T *>(scope->allocate(n * sizeof(T)));
+    }
+
+    void deallocate(T *ptr, size_t n) noexcept
+    {
+        if (!scope)
+            ::operator delete(ptr);
+        else
+            QArenaScope::deallocate(ptr, n * sizeof(T));
+    }
+
+    // copies of a container don't inherit the scope, which may be gone by now
+    QArenaAllocator select_on_container_copy_construction() const noexcept
+    { return QArenaAllocator(); }
+
+    QArenaScope *arenaScope() const noexcept { return scope; }
+
+    friend bool operator==(const QArenaAllocator &lhs, const QArenaAllocator &rhs) noexcept
+    { return lhs.scope == rhs.scope; }
+    friend bool operator!=(const QArenaAllocator &lhs, const QArenaAllocator &rhs) noexcept
+    { return lhs.scope != rhs.scope; }
+
+private:
+    template <typename U> friend class QArenaAllocator;
+    QArenaScope *scope;
+};
+
+QT_END_NAMESPACE
+
+#endif // QARENASCOPE_P_H
@@ -0,0 +1,304 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QCONCURRENTCACHE_P_H
+#define QCONCURRENTCACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API.  It exists purely as an
+// implementation detail.  This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtCore/private/qglobal_p.h>
+#include <QtCore/qatomic.h>
+#include <QtCore/qcache.h>
+#include <QtCore/qhashfunctions.h>
+#include <QtCore/qmath.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qsharedpointer.h>
+
+#include <memory>
+
+QT_BEGIN_NAMESPACE
+
+/*
+    QConcurrentCache is a QCache that can be shared between threads.
+
+    The cache is split into a number of shards, each of which is a QCache
+    protected by its own mutex; a key always maps to the same shard. Threads
+    working on different keys therefore rarely contend for the same lock.
+    The maximum cost applies to the cache as a whole, so any object that fits
+    into the cache can be inserted, whichever shard it maps to. When the
+    total cost is exceeded, every shard evicts its least recently used
+    objects in proportion to its share of the total cost; an excess too small
+    to share out is taken from one shard picked at random, weighted by cost.
+    The object just inserted is never part of the eviction. The eviction
+    order is thus only approximately LRU for the cache as a whole.
+
+    Because another thread may evict an object at any time, objects are
+    handed out as QSharedPointer: an object that has been evicted stays alive
+    until the last user drops its reference.
+
+    The cache keeps counters of hits and misses, which are meant for tuning
+    the cache size; they are updated with relaxed atomics.
+*/
+template <class Key, class T>
+class QConcurrentCache
+{
+    using Object = QSharedPointer<T>;
+
+    struct alignas(64) Shard
+    {
+        mutable QMutex mutex;
+        QCache<Key, Object> cache;
+        QAtomicInteger<qsizetype> cost;     // cache.totalCost(), for trim()
+        mutable QAtomicInteger<quint64> hits;
+        mutable QAtomicInteger<quint64> misses;
+    };
+
+public:
+    static constexpr qsizetype DefaultShardCount = 16;
+
+    struct Statistics
+    {
+        quint64 hits = 0;
+        quint64 misses = 0;
+    };
+
+    explicit QConcurrentCache(qsizetype maxCost = 100, qsizetype shardCount = DefaultShardCount)
+        : shardCount(qNextPowerOfTwo(quint64(qMax(shardCount, qsizetype(1)) - 1))),
+          shards(new Shard[size_t(this->shardCount)]),
+          seed(size_t(QHashSeed::globalSeed()))
+    {
+        setMaxCost(maxCost);
+    }
+
+    qsizetype maxCost() const noexcept { return mx.loadRelaxed(); }
+    void setMaxCost(qsizetype m)
+    {
+        mx.storeRelaxed(m);
+        // every shard may use up all of the cost; trim() keeps the sum in
+        // bounds
+        for (qsizetype i = 0; i < shardCount; ++i) {
+            Shard &s = shards[i];
+            QMutexLocker locker(&s.mutex);
+            const qsizetype before = s.cache.totalCost();
+            s.cache.setMaxCost(m);
+            account(s, before);
+        }
+        trim(nullptr, 0);
+    }
+
+    qsizetype totalCost() const
+    {
+        return accumulate([](const QCache<Key, Object> &c) { return c.totalCost(); });
+    }
+    qsizetype size() const
+    {
+        return accumulate([](const QCache<Key, Object> &c) { return c.size(); });
+    }
+    bool isEmpty() const { return size() == 0; }
+
+    void clear()
+    {
+        for (qsizetype i = 0; i < shardCount; ++i) {
+            Shard &s = shards[i];
+            QMutexLocker locker(&s.mutex);
+            const qsizetype before = s.cache.totalCost();
+            s.cache.clear();
+            account(s, before);
+        }
+    }
+
+    // Takes ownership of \a object; returns false and deletes it if \a cost
+    // exceeds maxCost().
+    bool insert(const Key &key, T *object, qsizetype cost = 1)
+    {
+        return insert(key, Object(object), cost);
+    }
+    bool insert(const Key &key, Object object, qsizetype cost = 1)
+    {
+        // allocate outside of the lock
+        auto value = std::make_unique<Object>(std::move(object));
+        Shard &s = shardFor(key);
+        bool inserted;
+        {
+            QMutexLocker locker(&s.mutex);
+            const qsizetype before = s.cache.totalCost();
+            inserted = s.cache.insert(key, value.release(), cost);
+            account(s, before);
+        }
+        trim(&s, inserted ? cost : 0);
+        return inserted;
+    }
+
+    Object object(const Key &key) const
+    {
+        Shard &s = shardFor(key);
+        Object result;
+        {
+            QMutexLocker locker(&s.mutex);
+            if (const Object *o = s.cache.object(key))
+                result = *o;
+        }
+        (result ? s.hits : s.misses).fetchAndAddRelaxed(1);
+        return result;
+    }
+
+    bool contains(const Key &key) const
+    {
+        Shard &s = shardFor(key);
+        QMutexLocker locker(&s.mutex);
+        return s.cache.contains(key);
+    }
+
+    bool remove(const Key &key)
+    {
+        Shard &s = shardFor(key);
+        QMutexLocker locker(&s.mutex);
+        const qsizetype before = s.cache.totalCost();
+        const bool removed = s.cache.remove(key);
+        account(s, before);
+        return removed;
+    }
+
+    Object take(const Key &key)
+    {
+        Shard &s = shardFor(key);
+        std::unique_ptr<Object> o;
+        {
+            QMutexLocker locker(&s.mutex);
+            const qsizetype before = s.cache.totalCost();
+            o.reset(s.cache.take(key));
+            account(s, before);
+        }
+        return o ? std::move(*o) : Object();
+    }
+
+    Statistics statistics() const noexcept
+    {
+        Statistics stats;
+        for (qsizetype i = 0; i < shardCount; ++i) {
+            stats.hits += shards[i].hits.loadRelaxed();
+            stats.misses += shards[i].misses.loadRelaxed();
+        }
+        return stats;
+    }
+    void resetStatistics() noexcept
+    {
+        for (qsizetype i = 0; i < shardCount; ++i) {
+            shards[i].hits.storeRelaxed(0);
+            shards[i].misses.storeRelaxed(0);
+        }
+    }
+
+private:
+    Q_DISABLE_COPY_MOVE(QConcurrentCache)
+
+    Shard &shardFor(const Key &key) const
+    {
+        // QCache hashes the key again with the same seed; mix the bits so
+        // that the shard doesn't select the same bits as the bucket does
+        const size_t h = qHash(key, seed);
+        return shards[(h ^ (h >> 17) ^ (h >> 31)) & size_t(shardCount - 1)];
+    }
+
+    // Updates the cost counters after the cost of \a s changed from
+    // \a before; the caller holds the lock of \a s.
+    void account(Shard &s, qsizetype before)
+    {
+        const qsizetype cost = s.cache.totalCost();
+        s.cost.storeRelaxed(cost);
+        used.fetchAndAddRelaxed(cost - before);
+    }
+
+    // Evicts the least recently used objects of \a s worth at least
+    // \a amount; returns the cost that was freed.
+    qsizetype evict(Shard &s, qsizetype amount)
+    {
+        QMutexLocker locker(&s.mutex);
+        const qsizetype before = s.cache.totalCost();
+        if (before == 0)
+            return 0;
+        // QCache has no way to evict a given cost, but lowering the maximum
+        // cost evicts the least recently used objects
+        s.cache.setMaxCost(qMax(before - amount, qsizetype(0)));
+        s.cache.setMaxCost(mx.loadRelaxed());
+        account(s, before);
+        return before - s.cache.totalCost();
+    }
+
+    // Evicts objects until the total cost is within maxCost() again. Every
+    // shard gives up its share of the excess in proportion to its cost; what
+    // rounding leaves over is taken from a shard picked at random, weighted
+    // by cost. \a insertedCost of the shard \a inserted belongs to the object
+    // just inserted there, which, being its most recently used one, is
+    // spared by not counting it.
+    void trim(const Shard *inserted, qsizetype insertedCost)
+    {
+        const auto weight = [&](const Shard &s) {
+            const qsizetype cost = s.cost.loadRelaxed();
+            return qMax(&s == inserted ? cost - insertedCost : cost, qsizetype(0));
+        };
+        for (qsizetype attempts = 0; attempts <= shardCount; ) {
+            const qsizetype excess = used.loadRelaxed() - mx.loadRelaxed();
+            if (excess <= 0)
+                return;
+            qsizetype total = 0;
+            for (qsizetype i = 0; i < shardCount; ++i)
+                total += weight(shards[i]);
+            if (total == 0)
+                return;
+
+            qsizetype freed = 0;
+            for (qsizetype i = 0; i < shardCount; ++i) {
+                const qsizetype share = qsizetype(qreal(excess) * weight(shards[i]) / total);
+                if (share > 0)
+                    freed += evict(shards[i], qMin(share, weight(shards[i])));
+            }
+            if (freed == 0) {
+                qsizetype position = qsizetype(qHash(evictions.fetchAndAddRelaxed(1), seed)
+                                               % size_t(total));
+                for (qsizetype i = 0; i < shardCount; ++i) {
+                    const qsizetype w = weight(shards[i]);
+                    if (position < w) {
+                        freed = evict(shards[i], qMin(excess, w));
+                        break;
+                    }
+                    position -= w;
+                }
+            }
+            // other threads may have emptied the shards meanwhile
+            if (freed == 0)
+                ++attempts;
+        }
+    }
+
+    template <typename F>
+    qsizetype accumulate(F f) const
+    {
+        qsizetype result = 0;
+        for (qsizetype i = 0; i < shardCount; ++i) {
+            QMutexLocker locker(&shards[i].mutex);
+            result += f(shards[i].cache);
+        }
+        return result;
+    }
+
+    const qsizetype shardCount;
+    const std::unique_ptr<Shard[]> shards;
+    const size_t seed;
+    QAtomicInteger<qsizetype> mx = 0;
+    QAtomicInteger<qsizetype> used = 0;     // the sum of the shards' total costs
+    QAtomicInteger<quint64> evictions = 0;  // picks the shard for small excesses
+};
+
+QT_END_NAMESPACE
+
+#endif // QCONCURRENTCACHE_P_H
@@ -6,10 +6,16 @@
 #include <qcryptographichash.h>
 #include <qmessageauthenticationcode.h>
 
+#include <qbytearraylist.h>
 #include <qiodevice.h>
 #include <qmutex.h>
+#if QT_CONFIG(thread) && !defined(QT_BOOTSTRAPPED)
+#include <qsemaphore.h>
+#include <qthreadpool.h>
+#endif
 #include <qvarlengtharray.h>
 #include <private/qlocking_p.h>
+#include <private/qsimd_p.h>
 
 #include <array>
 #include <climits>
@@ -124,6 +130,239 @@ static inline int SHA384_512AddLength(SHA512Context *context, unsigned int lengt
 
 QT_BEGIN_NAMESPACE
 
+#ifndef USING_OPENSSL30
+#if !defined(QT_BOOTSTRAPPED) && defined(Q_PROCESSOR_X86) && QT_COMPILER_SUPPORTS_HERE(SHA)
+#  define QT_CRYPTOGRAPHICHASH_SHANI
+// The SHA extensions are always accompanied by SSE4.1, whose shuffles we need too
+#  define QT_FUNCTION_TARGET_STRING_SHANI   QT_FUNCTION_TARGET_STRING_SHA "," QT_FUNCTION_TARGET_STRING_SSE4_1
+
+static bool hasShaNi() noexcept
+{
+    return qCpuHasFeature(SHA) && qCpuHasFeature(SSE4_1);
+}
+
+// Runs four rounds with the round function \c Function and prepares \a e for
+// the next four, adding the message words \a w to it
+template <int Function> static QT_FUNCTION_TARGET(SHANI)
+inline void sha1FourRoundsShaNi(__m128i &abcd, __m128i &e, __m128i w) noexcept
+{
+    const __m128i previous = abcd;
+    abcd = _mm_sha1rnds4_epu32(abcd, e, Function);
+    e = _mm_sha1nexte_epu32(previous, w);
+}
+
+// Processes \a blocks 64-byte blocks of \a data using the SHA-1 instructions.
+// Adapted from the description in Intel's "New Instructions Supporting the
+// Secure Hash Algorithm on Intel Architecture Processors".
+static QT_FUNCTION_TARGET(SHANI)
+void sha1ProcessChunksShaNi(Sha1State *state, const unsigned char *data, qsizetype blocks) noexcept
+{
+    // reverses the byte order of the whole register: the first message word
+    // ends up in the most significant lane, where the instructions expect it
+    const __m128i byteSwapMask = _mm_set_epi64x(0x0001020304050607ULL, 0x08090a0b0c0d0e0fULL);
+    const quint32 abcdIn[4] = { state->h0, state->h1, state->h2, state->h3 };
+    __m128i abcd = _mm_shuffle_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i *>(abcdIn)), 0x1b);
+    __m128i e0 = _mm_set_epi32(int(state->h4), 0, 0, 0);
+
+    for ( ; blocks; --blocks, data += 64) {
+        const __m128i abcdSaved = abcd;
+        const __m128i eSaved = e0;
+
+        // message schedule, four words per register
+        __m128i w[20];
+        for (int i = 0; i < 4; ++i) {
+            w[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 16 * i)),
+                                    byteSwapMask);
+        }
+        for (int i = 4; i < 20; ++i) {
+            w[i] = _mm_sha1msg2_epu32(_mm_xor_si128(_mm_sha1msg1_epu32(w[i - 4], w[i - 3]), w[i - 2]),
+                                      w[i - 1]);
+        }
+
+        // 20 groups of four rounds; the round function selector must be an immediate
+        __m128i e = _mm_add_epi32(e0, w[0]);
+        for (int i = 0; i < 5; ++i)
+            sha1FourRoundsShaNi<0>(abcd, e, w[i + 1]);
+        for (int i = 5; i < 10; ++i)
+            sha1FourRoundsShaNi<1>(abcd, e, w[i + 1]);
+        for (int i = 10; i < 15; ++i)
+            sha1FourRoundsShaNi<2>(abcd, e, w[i + 1]);
+        for (int i = 15; i < 19; ++i)
+            sha1FourRoundsShaNi<3>(abcd, e, w[i + 1]);
+        sha1FourRoundsShaNi<3>(abcd, e, eSaved);
+
+        e0 = e;
+        abcd = _mm_add_epi32(abcd, abcdSaved);
+    }
+
+    quint32 abcdOut[4];
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(abcdOut), _mm_shuffle_epi32(abcd, 0x1b));
+    state->h0 = abcdOut[0];
+    state->h1 = abcdOut[1];
+    state->h2 = abcdOut[2];
+    state->h3 = abcdOut[3];
+    state->h4 = quint32(_mm_extract_epi32(e0, 3));
+}
+
+// Same as sha1Update(), but processes full blocks with the SHA instructions
+static void sha1UpdateShaNi(Sha1State *state, const unsigned char *data, qint64 len) noexcept
+{
+    const quint32 rest = quint32(state->messageSize & Q_UINT64_C(63));
+    state->messageSize += len;
+
+    if (rest) {
+        const qint64 fill = qMin(len, qint64(64 - rest));
+        memcpy(&state->buffer[rest], data, fill);
+        if (rest + fill < 64)
+            return;
+        sha1ProcessChunksShaNi(state, state->buffer, 1);
+        data += fill;
+        len -= fill;
+    }
+
+    const qint64 blocks = len / 64;
+    if (blocks)
+        sha1ProcessChunksShaNi(state, data, blocks);
+    memcpy(state->buffer, data + blocks * 64, len - blocks * 64);
+}
+#endif // QT_CRYPTOGRAPHICHASH_SHANI
+
+static void sha1AddData(Sha1State *state, const unsigned char *data, qint64 len) noexcept
+{
+#ifdef QT_CRYPTOGRAPHICHASH_SHANI
+    if (hasShaNi())
+        return sha1UpdateShaNi(state, data, len);
+#endif
+    sha1Update(state, data, len);
+}
+
+#ifndef QT_CRYPTOGRAPHICHASH_ONLY_SHA1
+#ifdef QT_CRYPTOGRAPHICHASH_SHANI
+// Processes \a blocks 64-byte blocks of \a data using the SHA-256 instructions
+static QT_FUNCTION_TARGET(SHANI)
+void sha224_256ProcessBlocksShaNi(uint32_t *hash, const unsigned char *data, qsizetype blocks) noexcept
+{
+    alignas(16) static const quint32 roundConstants[64] = {
+        0x428a2f98, 0x71374491, 0xb5c0fbcf, 0xe9b5dba5, 0x3956c25b, 0x59f111f1, 0x923f82a4, 0xab1c5ed5,
+        0xd807aa98, 0x12835b01, 0x243185be, 0x550c7dc3, 0x72be5d74, 0x80deb1fe, 0x9bdc06a7, 0xc19bf174,
+        0xe49b69c1, 0xefbe4786, 0x0fc19dc6, 0x240ca1cc, 0x2de92c6f, 0x4a7484aa, 0x5cb0a9dc, 0x76f988da,
+        0x983e5152, 0xa831c66d, 0xb00327c8, 0xbf597fc7, 0xc6e00bf3, 0xd5a79147, 0x06ca6351, 0x14292967,
+        0x27b70a85, 0x2e1b2138, 0x4d2c6dfc, 0x53380d13, 0x650a7354, 0x766a0abb, 0x81c2c92e, 0x92722c85,
+        0xa2bfe8a1, 0xa81a664b, 0xc24b8b70, 0xc76c51a3, 0xd192e819, 0xd6990624, 0xf40e3585, 0x106aa070,
+        0x19a4c116, 0x1e376c08, 0x2748774c, 0x34b0bcb5, 0x391c0cb3, 0x4ed8aa4a, 0x5b9cca4f, 0x682e6ff3,
+        0x748f82ee, 0x78a5636f, 0x84c87814, 0x8cc70208, 0x90befffa, 0xa4506ceb, 0xbef9a3f7, 0xc67178f2,
+    };
+    // converts each big-endian message word to host order
+    const __m128i byteSwapMask = _mm_set_epi64x(0x0c0d0e0f08090a0bULL, 0x0405060700010203ULL);
+
+    // the instructions operate on the state as { A, B, E, F } and { C, D, G, H }
+    __m128i dcba = _mm_loadu_si128(reinterpret_cast<const __m128i *>(hash));
+    __m128i hgfe = _mm_loadu_si128(reinterpret_cast<const __m128i *>(hash + 4));
+    const __m128i cdab = _mm_shuffle_epi32(dcba, 0xb1);
+    const __m128i efgh = _mm_shuffle_epi32(hgfe, 0x1b);
+    __m128i abef = _mm_alignr_epi8(cdab, efgh, 8);
+    __m128i cdgh = _mm_blend_epi16(efgh, cdab, 0xf0);
+
+    for ( ; blocks; --blocks, data += 64) {
+        const __m128i abefSaved = abef;
+        const __m128i cdghSaved = cdgh;
+
+        __m128i w[4];
+        for (int i = 0; i < 4; ++i) {
+            w[i] = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + 16 * i)),
+                                    byteSwapMask);
+        }
+
+        // 16 groups of four rounds; w[i % 4] holds the message words of group i
+        for (int i = 0; i < 16; ++i) {
+            const __m128i &current = w[i % 4];
+            const __m128i wk = _mm_add_epi32(current,
+                    _mm_load_si128(reinterpret_cast<const __m128i *>(roundConstants + 4 * i)));
+            cdgh = _mm_sha256rnds2_epu32(cdgh, abef, wk);
+            abef = _mm_sha256rnds2_epu32(abef, cdgh, _mm_shuffle_epi32(wk, 0x0e));
+
+            if (i < 12) {
+                // calculate the words of group i + 4, which replace those of group i
+                __m128i next = _mm_sha256msg1_epu32(w[i % 4], w[(i + 1) % 4]);
+                next = _mm_add_epi32(next, _mm_alignr_epi8(w[(i + 3) % 4], w[(i + 2) % 4], 4));
+                w[i % 4] = _mm_sha256msg2_epu32(next, w[(i + 3) % 4]);
+            }
+        }
+
+        abef = _mm_add_epi32(abef, abefSaved);
+        cdgh = _mm_add_epi32(cdgh, cdghSaved);
+    }
+
+    const __m128i feba = _mm_shuffle_epi32(abef, 0x1b);
+    const __m128i dchg = _mm_shuffle_epi32(cdgh, 0xb1);
+    dcba = _mm_blend_epi16(feba, dchg, 0xf0);
+    hgfe = _mm_alignr_epi8(dchg, feba, 8);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(hash), dcba);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(hash + 4), hgfe);
+}
+#endif // QT_CRYPTOGRAPHICHASH_SHANI
+
+static void sha224_256ProcessBlocks(SHA256Context *context, const unsigned char *data,
+                                    qsizetype blocks) noexcept
+{
+#ifdef QT_CRYPTOGRAPHICHASH_SHANI
+    if (hasShaNi()) {
+        sha224_256ProcessBlocksShaNi(context->Intermediate_Hash, data, blocks);
+        context->Message_Block_Index = 0;
+        return;
+    }
+#endif
+    for ( ; blocks; --blocks, data += SHA256_Message_Block_Size) {
+        if (data != context->Message_Block)
+            memcpy(context->Message_Block, data, SHA256_Message_Block_Size);
+        SHA224_256ProcessMessageBlock(context);
+    }
+}
+
+/*
+    Replacement for SHA224Input() and SHA256Input(), which copy the data into
+    the message block one byte at a time, updating the message length for
+    each of them. This one processes whole blocks straight from \a data.
+*/
+static void sha224_256AddData(SHA256Context *context, const unsigned char *data,
+                              uint length) noexcept
+{
+    if (!length)
+        return;
+    if (context->Computed || context->Corrupted) {
+        SHA256Input(context, data, length); // sets the error state
+        return;
+    }
+
+    const quint64 oldBitLength = (quint64(context->Length_High) << 32) | context->Length_Low;
+    const quint64 bitLength = oldBitLength + quint64(length) * 8;
+    if (bitLength < oldBitLength) {
+        context->Corrupted = shaInputTooLong;
+        return;
+    }
+    context->Length_High = uint32_t(bitLength >> 32);
+    context->Length_Low = uint32_t(bitLength);
+
+    if (context->Message_Block_Index) {
+        const uint fill = qMin(length, uint(SHA256_Message_Block_Size - context->Message_Block_Index));
+        memcpy(context->Message_Block + context->Message_Block_Index, data, fill);
+        context->Message_Block_Index += fill;
+        if (context->Message_Block_Index < SHA256_Message_Block_Size)
+            return;
+        sha224_256ProcessBlocks(context, context->Message_Block, 1);
+        data += fill;
+        length -= fill;
+    }
+
+    const uint blocks = length / SHA256_Message_Block_Size;
+    sha224_256ProcessBlocks(context, data, blocks);
+    const uint rest = length % SHA256_Message_Block_Size;
+    memcpy(context->Message_Block, data + blocks * SHA256_Message_Block_Size, rest);
+    context->Message_Block_Index = int_least16_t(rest);
+}
+#endif // !QT_CRYPTOGRAPHICHASH_ONLY_SHA1
+#endif // !USING_OPENSSL30
+
 template <size_t N>
 class QSmallByteArray
 {
@@ -877,7 +1116,7 @@ void QCryptographicHashPrivate::State::addData(QCryptographicHash::Algorithm met
 #endif
         switch (method) {
         case QCryptographicHash::Sha1:
-            sha1Update(&sha1Context, (const unsigned char *)data, length);
+            sha1AddData(&sha1Context, (const unsigned char *)data, length);
             break;
 #ifdef QT_CRYPTOGRAPHICHASH_ONLY_SHA1
         default:
@@ -892,10 +1131,10 @@ void QCryptographicHashPrivate::State::addData(QCryptographicHash::Algorithm met
             MD5Update(&md5Context, (const unsigned char *)data, length);
             break;
         case QCryptographicHash::Sha224:
-            SHA224Input(&sha224Context, reinterpret_cast<const unsigned char *>(data), length);
+            sha224_256AddData(&sha224Context, reinterpret_cast<const unsigned char *>(data), length);
             break;
         case QCryptographicHash::Sha256:
-            SHA256Input(&sha256Context, reinterpret_cast<const unsigned char *>(data), length);
+            sha224_256AddData(&sha256Context, reinterpret_cast<const unsigned char *>(data), length);
             break;
         case QCryptographicHash::Sha384:
             SHA384Input(&sha384Context, reinterpret_cast<const unsigned char *>(data), length);
@@ -1198,6 +1437,78 @@ QByteArrayView QCryptographicHash::hashInto(QSpan<std::byte> buffer,
     return buffer.first(result.size());
 }
 
+/*!
+    \since 6.9
+
+    Returns the hashes of each of the byte array views in \a data, computed
+    independently using \a method, in the same order.
+
+    This is equivalent to calling hash() for each element of \a data, but
+    more efficient when hashing many buffers: the hashing state is set up only
+    once, and large batches are distributed over the threads of
+    QThreadPool::globalInstance(). The result does not depend on the number of
+    threads used.
+
+    \sa hash(), hashInto()
+*/
+QByteArrayList QCryptographicHash::hashMany(QSpan<const QByteArrayView> data, Algorithm method)
+{
+    const qsizetype count = data.size();
+    const qsizetype length = hashLengthInternal(method);
+    QByteArrayList results;
+    results.reserve(count);
+    for (qsizetype i = 0; i < count; ++i)
+        results.emplace_back(length, Qt::Uninitialized);
+
+    // Items are handed out in batches, so that hashing many small buffers
+    // does not turn into a contest for the counter.
+    constexpr qsizetype BatchSize = 64;
+    QAtomicInteger<qsizetype> next = 0;
+    auto work = [&] {
+        QCryptographicHashPrivate hash(method);
+        for (qsizetype begin = next.fetchAndAddRelaxed(BatchSize); begin < count;
+             begin = next.fetchAndAddRelaxed(BatchSize)) {
+            const qsizetype end = qMin(begin + BatchSize, count);
+            for (qsizetype i = begin; i < end; ++i) {
+                hash.reset();
+                hash.addData(data[i]);
+                hash.finalizeUnchecked(); // no mutex needed: 'hash' is local to this thread
+                const QByteArrayView result = hash.resultView();
+                Q_ASSERT(result.size() == length);
+                // each element is written by exactly one thread
+                memcpy(results[i].data(), result.data(), result.size());
+            }
+        }
+    };
+
+#if QT_CONFIG(thread) && !defined(QT_BOOTSTRAPPED)
+    // Only bother other threads when there is enough work for them, which is
+    // when each of them gets at least a batch and a good amount of data.
+    constexpr qint64 MinimumBytesPerThread = 256 * 1024;
+    const qint64 totalSize = std::accumulate(data.begin(), data.end(), qint64(0),
+                                             [](qint64 sum, QByteArrayView v) {
+                                                 return sum + v.size();
+                                             });
+    qsizetype helpers = qMin(totalSize / MinimumBytesPerThread, (count - 1) / BatchSize);
+    QThreadPool *pool = helpers > 0 ? QThreadPool::globalInstance() : nullptr;
+    if (pool)
+        helpers = qMin(helpers, qsizetype(pool->maxThreadCount()) - 1);
+
+    QSemaphore finished;
+    int started = 0;
+    for ( ; started < helpers; ++started) {
+        // don't wait for busy threads, we can do their share ourselves
+        if (!pool->tryStart([&] { work(); finished.release(); }))
+            break;
+    }
+    work();
+    finished.acquire(started);
+#else
+    work();
+#endif
+    return results;
+}
+
 /*!
   Returns the size of the output of the selected hash \a method in bytes.
 
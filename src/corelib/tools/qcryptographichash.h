@@ -105,6 +105,8 @@ public:
     { return hashInto(as_writable_bytes(buffer), data, method); }
     static QByteArrayView hashInto(QSpan<std::byte> buffer, QSpan<const QByteArrayView> data, Algorithm method) noexcept;
 
+    static QByteArrayList hashMany(QSpan<const QByteArrayView> data, Algorithm method);
+
     static int hashLength(Algorithm method);
     static bool supportsAlgorithm(Algorithm method);
 private:
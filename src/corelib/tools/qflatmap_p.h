@@ -804,13 +804,13 @@ public:
 
     const_iterator lower_bound(const Key &key) const
     {
-        return fromKeysIterator(std::lower_bound(c.keys.begin(), c.keys.end(), key, key_comp()));
+        return fromKeysIterator(keysLowerBound(key));
     }
 
     template <class X, class Y = Compare, is_marked_transparent<Y> = nullptr>
     const_iterator lower_bound(const X &key) const
     {
-        return fromKeysIterator(std::lower_bound(c.keys.begin(), c.keys.end(), key, key_comp()));
+        return fromKeysIterator(keysLowerBound(key));
     }
 
     iterator find(const Key &key)
@@ -1030,8 +1030,34 @@ private:
         makeUnique();
     }
 
+    template <class X>
+    auto keysLowerBound(const X &key) const
+    {
+        // Same as std::lower_bound, but the position is updated with a
+        // conditional move instead of a branch, which the CPU cannot
+        // mispredict. Once the keys no longer fit into the cache, this also
+        // lets it fetch both possible next probes in parallel.
+        auto first = c.keys.begin();
+        auto length = c.keys.size();
+        if (length == 0)
+            return first;
+        while (length > 1) {
+            const auto half = length / 2;
+            first += key_compare::operator()(first[half], key) ? half : 0;
+            length -= half;
+        }
+        return first + (key_compare::operator()(*first, key) ? 1 : 0);
+    }
+
     void ensureOrderedUnique()
     {
+        // Bulk construction is commonly done from data that is already
+        // sorted, which needs no permutation.
+        if (std::is_sorted(c.keys.begin(), c.keys.end(), key_comp())) {
+            makeUnique();
+            return;
+        }
+
         std::vector<size_type> p(size_t(c.keys.size()));
         std::iota(p.begin(), p.end(), 0);
         std::stable_sort(p.begin(), p.end(), IndexedKeyComparator(this));
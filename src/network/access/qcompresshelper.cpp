@@ -0,0 +1,356 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qcompresshelper_p.h"
+
+#include <QtCore/qcoreapplication.h>
+
+#include <limits>
+#include <zlib.h>
+
+#if QT_CONFIG(zstd)
+#    include <zstd.h>
+#endif
+
+QT_BEGIN_NAMESPACE
+namespace {
+struct ContentEncodingMapping
+{
+    QByteArrayView name;
+    QCompressHelper::ContentEncoding encoding;
+};
+
+constexpr ContentEncodingMapping contentEncodingMapping[] {
+#if QT_CONFIG(zstd)
+    { "zstd", QCompressHelper::Zstandard },
+#endif
+    { "gzip", QCompressHelper::GZip },
+    { "deflate", QCompressHelper::Deflate },
+};
+
+QCompressHelper::ContentEncoding encodingFromByteArray(QByteArrayView ce) noexcept
+{
+    for (const auto &mapping : contentEncodingMapping) {
+        if (ce.compare(mapping.name, Qt::CaseInsensitive) == 0)
+            return mapping.encoding;
+    }
+    return QCompressHelper::None;
+}
+
+// Size by which the output grows while the encoder still has data for us
+constexpr qsizetype OutputChunkSize = 16 * 1024;
+
+z_stream *toZlibPointer(void *ptr)
+{
+    return static_cast<z_stream_s *>(ptr);
+}
+
+#if QT_CONFIG(zstd)
+ZSTD_CCtx *toZstandardPointer(void *ptr)
+{
+    return static_cast<ZSTD_CCtx *>(ptr);
+}
+#endif
+}
+
+/*!
+    \internal
+    \class QCompressHelper
+
+    QCompressHelper is the counterpart of QDecompressHelper: it encodes a
+    stream of data with one of the HTTP content codings. Data is passed in
+    pieces with compress(), and the stream is terminated with finish(). Both
+    return the encoded data that became available.
+*/
+
+bool QCompressHelper::isSupportedEncoding(QByteArrayView encoding)
+{
+    return encodingFromByteArray(encoding) != QCompressHelper::None;
+}
+
+QByteArrayList QCompressHelper::supportedEncodings()
+{
+    QByteArrayList list;
+    list.reserve(std::size(contentEncodingMapping));
+    for (const auto &mapping : contentEncodingMapping)
+        list << mapping.name.toByteArray();
+    return list;
+}
+
+QCompressHelper::~QCompressHelper()
+{
+    clear();
+}
+
+bool QCompressHelper::setEncoding(QByteArrayView encoding)
+{
+    Q_ASSERT(contentEncoding == QCompressHelper::None);
+    if (contentEncoding != QCompressHelper::None) {
+        qWarning("Encoding is already set.");
+        return false;
+    }
+    ContentEncoding ce = encodingFromByteArray(encoding);
+    if (ce == None) {
+        errorStr = QCoreApplication::translate("QHttp", "Unsupported content encoding: %1")
+                           .arg(QLatin1String(encoding));
+        return false;
+    }
+    errorStr = QString(); // clear error
+    contentEncoding = ce;
+    return true;
+}
+
+/*!
+    \internal
+    Sets the compression \a level passed to the encoder. The range depends on
+    the encoding: 0 to 9 for deflate and gzip, and 1 to 22 (or negative values
+    for faster modes) for zstd. DefaultCompressionLevel selects the default of
+    the respective library.
+
+    Must be called before the first call to compress().
+*/
+void QCompressHelper::setCompressionLevel(int level)
+{
+    Q_ASSERT(!encoderPointer);
+    this->level = level;
+}
+
+/*!
+    \internal
+    Sets a \a dictionary to prime the encoder with. Only supported for the
+    \c deflate and \c zstd encodings; the receiver has to use the same
+    dictionary for decoding.
+
+    Must be called after setEncoding() and before the first call to compress().
+*/
+bool QCompressHelper::setDictionary(const QByteArray &dictionary)
+{
+    Q_ASSERT(!encoderPointer);
+    if (contentEncoding != Deflate && contentEncoding != Zstandard) {
+        errorStr = QCoreApplication::translate("QHttp",
+                                               "The content encoding does not support dictionaries.");
+        return false;
+    }
+    this->dictionary = dictionary;
+    return true;
+}
+
+bool QCompressHelper::initEncoder()
+{
+    Q_ASSERT(!encoderPointer);
+    switch (contentEncoding) {
+    case None:
+        Q_UNREACHABLE();
+        break;
+    case Deflate:
+    case GZip: {
+        z_stream *deflateStream = new z_stream;
+        memset(deflateStream, 0, sizeof(z_stream));
+        // "Add 16 to windowBits to write a simple gzip header and trailer around the
+        // compressed data instead of a zlib wrapper."
+        // http://www.zlib.net/manual.html
+        const int windowBits = contentEncoding == GZip ? MAX_WBITS + 16 : MAX_WBITS;
+        const int zlibLevel = level == DefaultCompressionLevel ? Z_DEFAULT_COMPRESSION : level;
+        if (deflateInit2(deflateStream, zlibLevel, Z_DEFLATED, windowBits, 8,
+                         Z_DEFAULT_STRATEGY) != Z_OK) {
+            delete deflateStream;
+            deflateStream = nullptr;
+        } else if (!dictionary.isEmpty()
+                   && deflateSetDictionary(deflateStream,
+                                           reinterpret_cast<const Bytef *>(dictionary.constData()),
+                                           uInt(dictionary.size())) != Z_OK) {
+            deflateEnd(deflateStream);
+            delete deflateStream;
+            deflateStream = nullptr;
+        }
+        encoderPointer = deflateStream;
+        break;
+    }
+    case Zstandard:
+#if QT_CONFIG(zstd)
+    {
+        ZSTD_CCtx *cctx = ZSTD_createCCtx();
+        if (cctx && level != DefaultCompressionLevel
+            && ZSTD_isError(ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, level))) {
+            ZSTD_freeCCtx(cctx);
+            cctx = nullptr;
+        }
+        if (cctx && !dictionary.isEmpty()
+            && ZSTD_isError(ZSTD_CCtx_loadDictionary(cctx, dictionary.constData(),
+                                                     size_t(dictionary.size())))) {
+            ZSTD_freeCCtx(cctx);
+            cctx = nullptr;
+        }
+        encoderPointer = cctx;
+    }
+#else
+        Q_UNREACHABLE();
+#endif
+        break;
+    }
+    if (!encoderPointer) {
+        errorStr = QCoreApplication::translate("QHttp",
+                                               "Failed to initialize the compression encoder.");
+        return false;
+    }
+    return true;
+}
+
+/*!
+    \internal
+    Feeds \a data to the encoder and returns the encoded output that is
+    available so far, which may be empty since encoders buffer their input.
+    Returns an empty QByteArray and sets errorString() on failure.
+*/
+QByteArray QCompressHelper::compress(QByteArrayView data)
+{
+    return compressInternal(data, false);
+}
+
+/*!
+    \internal
+    Terminates the stream and returns the remaining encoded output. No more
+    data can be compressed afterwards, until clear() and setEncoding() are
+    called again.
+*/
+QByteArray QCompressHelper::finish()
+{
+    return compressInternal({}, true);
+}
+
+QByteArray QCompressHelper::compressInternal(QByteArrayView data, bool finish)
+{
+    if (!isValid())
+        return {};
+    if (finished) {
+        qWarning("QCompressHelper: the stream has already been finished.");
+        return {};
+    }
+    if (!encoderPointer && !initEncoder())
+        return {};
+
+    QByteArray output;
+    switch (contentEncoding) {
+    case None:
+        Q_UNREACHABLE();
+        break;
+    case Deflate:
+    case GZip:
+        output = compressZLib(data, finish);
+        break;
+    case Zstandard:
+        output = compressZstandard(data, finish);
+        break;
+    }
+    if (!errorStr.isEmpty())
+        return {};
+    finished = finish;
+    return output;
+}
+
+QByteArray QCompressHelper::compressZLib(QByteArrayView data, bool finish)
+{
+    z_stream *deflateStream = toZlibPointer(encoderPointer);
+    QByteArray output;
+    do {
+        // zlib takes the input size as uInt
+        const qsizetype inputSize = qMin(data.size(),
+                                         qsizetype(std::numeric_limits<uInt>::max()));
+        deflateStream->next_in = reinterpret_cast<Bytef *>(const_cast<char *>(data.data()));
+        deflateStream->avail_in = uInt(inputSize);
+        data = data.sliced(inputSize);
+        const int flush = finish && data.isEmpty() ? Z_FINISH : Z_NO_FLUSH;
+
+        do {
+            const qsizetype offset = output.size();
+            output.resize(offset + OutputChunkSize);
+            deflateStream->next_out = reinterpret_cast<Bytef *>(output.data() + offset);
+            deflateStream->avail_out = uInt(OutputChunkSize);
+            const int ret = deflate(deflateStream, flush);
+            output.resize(output.size() - deflateStream->avail_out);
+            if (ret == Z_STREAM_ERROR) {
+                errorStr = QCoreApplication::translate("QHttp",
+                                                       "Failed to compress the data (%1).")
+                                   .arg(QLatin1StringView(deflateStream->msg));
+                return {};
+            }
+        } while (deflateStream->avail_out == 0);
+        Q_ASSERT(deflateStream->avail_in == 0);
+    } while (!data.isEmpty());
+    return output;
+}
+
+QByteArray QCompressHelper::compressZstandard(QByteArrayView data, bool finish)
+{
+#if QT_CONFIG(zstd)
+    ZSTD_CCtx *cctx = toZstandardPointer(encoderPointer);
+    QByteArray output;
+    ZSTD_inBuffer inBuf { data.data(), size_t(data.size()), 0 };
+    const ZSTD_EndDirective mode = finish ? ZSTD_e_end : ZSTD_e_continue;
+    bool done = false;
+    do {
+        const qsizetype offset = output.size();
+        output.resize(offset + OutputChunkSize);
+        ZSTD_outBuffer outBuf { output.data() + offset, size_t(OutputChunkSize), 0 };
+        const size_t remaining = ZSTD_compressStream2(cctx, &outBuf, &inBuf, mode);
+        output.resize(offset + qsizetype(outBuf.pos));
+        if (ZSTD_isError(remaining)) {
+            errorStr = QCoreApplication::translate("QHttp",
+                                                   "Failed to compress the data (%1).")
+                               .arg(QLatin1StringView(ZSTD_getErrorName(remaining)));
+            return {};
+        }
+        // When finishing, the return value is the amount still left to flush,
+        // otherwise we are done once all input has been consumed.
+        done = finish ? remaining == 0 : inBuf.pos == inBuf.size;
+    } while (!done);
+    return output;
+#else
+    Q_UNUSED(data);
+    Q_UNUSED(finish);
+    Q_UNREACHABLE_RETURN(QByteArray());
+#endif
+}
+
+bool QCompressHelper::isValid() const
+{
+    return contentEncoding != None && errorStr.isEmpty();
+}
+
+void QCompressHelper::clear()
+{
+    switch (contentEncoding) {
+    case None:
+        break;
+    case Deflate:
+    case GZip: {
+        z_stream *deflateStream = toZlibPointer(encoderPointer);
+        if (deflateStream)
+            deflateEnd(deflateStream);
+        delete deflateStream;
+        break;
+    }
+    case Zstandard: {
+#if QT_CONFIG(zstd)
+        ZSTD_CCtx *cctx = toZstandardPointer(encoderPointer);
+        if (cctx)
+            ZSTD_freeCCtx(cctx);
+#endif
+        break;
+    }
+    }
+    encoderPointer = nullptr;
+    contentEncoding = None;
+    level = DefaultCompressionLevel;
+    finished = false;
+    dictionary.clear();
+
+    errorStr.clear();
+}
+
+QString QCompressHelper::errorString() const
+{
+    return errorStr;
+}
+
+QT_END_NAMESPACE
@@ -0,0 +1,79 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef COMPRESS_HELPER_P_H
+#define COMPRESS_HELPER_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists for the convenience
+// of the Network Access API. This header file may change from
+// version to version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtNetwork/private/qtnetworkglobal_p.h>
+#include <QtCore/qbytearray.h>
+#include <QtCore/qbytearraylist.h>
+#include <QtCore/qstring.h>
+
+QT_BEGIN_NAMESPACE
+
+class Q_AUTOTEST_EXPORT QCompressHelper
+{
+public:
+    enum ContentEncoding {
+        None,
+        Deflate,
+        GZip,
+        Zstandard,
+    };
+
+    static constexpr int DefaultCompressionLevel = -1;
+
+    QCompressHelper() = default;
+    ~QCompressHelper();
+
+    bool setEncoding(QByteArrayView contentEncoding);
+    ContentEncoding encoding() const { return contentEncoding; }
+
+    void setCompressionLevel(int level);
+    int compressionLevel() const { return level; }
+
+    bool setDictionary(const QByteArray &dictionary);
+
+    QByteArray compress(QByteArrayView data);
+    QByteArray finish();
+
+    bool isValid() const;
+    bool isFinished() const { return finished; }
+
+    void clear();
+
+    static bool isSupportedEncoding(QByteArrayView encoding);
+    static QByteArrayList supportedEncodings();
+
+    QString errorString() const;
+
+private:
+    bool initEncoder();
+    QByteArray compressInternal(QByteArrayView data, bool finish);
+    QByteArray compressZLib(QByteArrayView data, bool finish);
+    QByteArray compressZstandard(QByteArrayView data, bool finish);
+
+    QString errorStr;
+    QByteArray dictionary;
+
+    ContentEncoding contentEncoding = None;
+    int level = DefaultCompressionLevel;
+    bool finished = false;
+
+    void *encoderPointer = nullptr;
+};
+
+QT_END_NAMESPACE
+
+#endif // COMPRESS_HELPER_P_H
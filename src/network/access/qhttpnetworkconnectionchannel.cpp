@@ -16,6 +16,7 @@
 
 #ifndef QT_NO_SSL
 #    include <private/qsslsocket_p.h>
+#    include <private/qsslsessioncache_p.h>
 #    include <QtNetwork/qsslkey.h>
 #    include <QtNetwork/qsslcipher.h>
 #endif
@@ -144,6 +145,10 @@ void QHttpNetworkConnectionChannel::init()
         QObject::connect(sslSocket, &QSslSocket::encryptedBytesWritten,
                          this, &QHttpNetworkConnectionChannel::_q_encryptedBytesWritten,
                          Qt::DirectConnection);
+        // with TLS 1.3, session tickets arrive after the handshake
+        QObject::connect(sslSocket, &QSslSocket::newSessionTicketReceived,
+                         this, &QHttpNetworkConnectionChannel::cacheSslSession,
+                         Qt::DirectConnection);
 
         if (ignoreAllSslErrors)
             sslSocket->ignoreSslErrors();
@@ -393,6 +398,8 @@ bool QHttpNetworkConnectionChannel::ensureConnection()
             // performed a full handshake)
             if (auto ctx = connection->sslContext())
                 QSslSocketPrivate::checkSettingSslContext(sslSocket, std::move(ctx));
+            else
+                resumeCachedSslSession();
 
             sslSocket->setPeerVerifyName(connection->d_func()->peerVerifyName);
             sslSocket->connectToHostEncrypted(connectHost, connectPort, QIODevice::ReadWrite, networkLayerPreference);
@@ -1204,11 +1211,58 @@ void QHttpNetworkConnectionChannel::emitFinishedWithError(QNetworkReply::Network
 }
 
 #ifndef QT_NO_SSL
+/*
+    If this is the first socket of the connection and the application allows
+    session persistence, try to resume a session that another connection
+    (possibly of a different QNetworkAccessManager) established to the host.
+*/
+void QHttpNetworkConnectionChannel::resumeCachedSslSession()
+{
+    QSslSocket *sslSocket = qobject_cast<QSslSocket *>(socket);
+    Q_ASSERT(sslSocket);
+    QSslSessionCache *cache = QSslSessionCache::instance();
+    QSslConfiguration configuration = sslSocket->sslConfiguration();
+    if (!cache || configuration.testSslOption(QSsl::SslOptionDisableSessionPersistence)
+        || !configuration.sessionTicket().isEmpty()) {
+        return;
+    }
+
+    const auto *connectionPrivate = connection->d_func();
+    const QByteArray ticket = cache->sessionTicket(connectionPrivate->hostName,
+                                                   connectionPrivate->port,
+                                                   connectionPrivate->peerVerifyName,
+                                                   configuration);
+    if (ticket.isEmpty())
+        return;
+    configuration.setSessionTicket(ticket);
+    sslSocket->setSslConfiguration(configuration);
+}
+
+void QHttpNetworkConnectionChannel::cacheSslSession()
+{
+    QSslSocket *sslSocket = qobject_cast<QSslSocket *>(socket);
+    Q_ASSERT(sslSocket);
+    QSslSessionCache *cache = QSslSessionCache::instance();
+    const QSslConfiguration configuration = sslSocket->sslConfiguration();
+    if (!cache || configuration.testSslOption(QSsl::SslOptionDisableSessionPersistence))
+        return;
+    // The handshake only completed because errors were ignored, which another
+    // connection must not inherit by resuming the session.
+    if (!sslSocket->sslHandshakeErrors().isEmpty())
+        return;
+
+    const auto *connectionPrivate = connection->d_func();
+    cache->insert(connectionPrivate->hostName, connectionPrivate->port,
+                  connectionPrivate->peerVerifyName, configuration);
+}
+
 void QHttpNetworkConnectionChannel::_q_encrypted()
 {
     QSslSocket *sslSocket = qobject_cast<QSslSocket *>(socket);
     Q_ASSERT(sslSocket);
 
+    cacheSslSession();
+
     if (!protocolHandler && connection->connectionType() != QHttpNetworkConnection::ConnectionTypeHTTP2Direct) {
         // ConnectionTypeHTTP2Direct does not rely on ALPN/NPN to negotiate HTTP/2,
         // after establishing a secure connection we immediately start sending
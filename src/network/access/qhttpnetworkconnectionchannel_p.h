@@ -158,6 +158,11 @@ public:
     bool isSocketWaiting() const;
     bool isSocketReading() const;
 
+#ifndef QT_NO_SSL
+    void resumeCachedSslSession();
+    void cacheSslSession();
+#endif
+
     protected slots:
     void _q_receiveReply();
     void _q_bytesWritten(qint64 bytes); // proceed sending
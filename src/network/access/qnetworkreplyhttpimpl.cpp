@@ -180,6 +180,8 @@ QNetworkReplyHttpImpl::QNetworkReplyHttpImpl(QNetworkAccessManager* const manage
                 previousDataSize = d->outgoingDataBuffer->size();
                 d->outgoingDataBuffer->append(d->outgoingData->readAll());
             } while (d->outgoingDataBuffer->size() != previousDataSize);
+            if (d->setupUploadCompression())
+                d->compressOutgoingData();
             d->_q_startOperation();
             return;
         }
@@ -189,7 +191,12 @@ QNetworkReplyHttpImpl::QNetworkReplyHttpImpl(QNetworkAccessManager* const manage
     if (outgoingData) {
         // there is data to be uploaded, e.g. HTTP POST.
 
-        if (!d->outgoingData->isSequential()) {
+        if (d->setupUploadCompression()) {
+            // the data is compressed while it is buffered, so that the size
+            // is known before sending and redirects can resend it
+            d->state = d->Buffering;
+            QMetaObject::invokeMethod(this, "_q_bufferOutgoingData", Qt::QueuedConnection);
+        } else if (!d->outgoingData->isSequential()) {
             // fixed size non-sequential (random-access)
             // just start the operation
             QMetaObject::invokeMethod(this, "_q_startOperation", Qt::QueuedConnection);
@@ -773,6 +780,15 @@ void QNetworkReplyHttpImplPrivate::postRequest(const QNetworkRequest &newHttpReq
         }
     }
 
+    if (!uploadContentEncoding.isEmpty() && outgoingDataBuffer) {
+        // the sizes the user or QNetworkAccessManager gave are of the
+        // uncompressed data
+        newRequestHeaders.replaceOrAppend(QHttpHeaders::WellKnownHeader::ContentEncoding,
+                                          uploadContentEncoding);
+        newRequestHeaders.replaceOrAppend(QHttpHeaders::WellKnownHeader::ContentLength,
+                                          QByteArray::number(outgoingDataBuffer->size()));
+    }
+
     for (int i = 0; i < newRequestHeaders.size(); i++) {
         const auto name = newRequestHeaders.nameAt(i);
         const auto value = newRequestHeaders.valueAt(i);
@@ -1991,6 +2007,13 @@ void QNetworkReplyHttpImplPrivate::_q_bufferOutgoingDataFinished()
     QObject::disconnect(outgoingData, SIGNAL(readyRead()), q, SLOT(_q_bufferOutgoingData()));
     QObject::disconnect(outgoingData, SIGNAL(readChannelFinished()), q, SLOT(_q_bufferOutgoingDataFinished()));
 
+    if (!uploadContentEncoding.isEmpty()) {
+        // readChannelFinished() can come before read() has seen the end of
+        // the data, so take the rest, then terminate the compressed stream
+        compressAvailableOutgoingData();
+        outgoingDataBuffer->append(compressHelper.finish());
+    }
+
     // finally, start the request
     QMetaObject::invokeMethod(q, "_q_startOperation", Qt::QueuedConnection);
 }
@@ -2014,6 +2037,11 @@ void QNetworkReplyHttpImplPrivate::_q_bufferOutgoingData()
         QObject::connect(outgoingData, SIGNAL(readChannelFinished()), q, SLOT(_q_bufferOutgoingDataFinished()));
     }
 
+    if (!uploadContentEncoding.isEmpty()) {
+        compressOutgoingData();
+        return;
+    }
+
     qint64 bytesBuffered = 0;
     qint64 bytesToBuffer = 0;
 
@@ -2045,6 +2073,83 @@ void QNetworkReplyHttpImplPrivate::_q_bufferOutgoingData()
     }
 }
 
+/*!
+    \internal
+
+    Sets up compressing the upload data if UploadContentEncodingAttribute
+    asks for it. Returns whether the data is to be compressed.
+*/
+bool QNetworkReplyHttpImplPrivate::setupUploadCompression()
+{
+    const QByteArray encoding =
+            request.attribute(QNetworkRequest::UploadContentEncodingAttribute).toByteArray();
+    if (encoding.isEmpty())
+        return false;
+    if (!compressHelper.setEncoding(encoding)) {
+        qWarning("QNetworkReply: %ls, sending the request body uncompressed",
+                 qUtf16Printable(compressHelper.errorString()));
+        compressHelper.clear();
+        return false;
+    }
+    uploadContentEncoding = encoding;
+    return true;
+}
+
+/*!
+    \internal
+
+    Compresses what outgoingData has to offer into outgoingDataBuffer. In the
+    synchronous case, the uncompressed data was read into outgoingDataBuffer
+    already, and is compressed in place.
+*/
+void QNetworkReplyHttpImplPrivate::compressOutgoingData()
+{
+    if (synchronous) {
+        QRingBuffer compressed;
+        while (!outgoingDataBuffer->isEmpty()) {
+            const qint64 blockSize = outgoingDataBuffer->nextDataBlockSize();
+            const QByteArray data = compressHelper.compress(
+                    QByteArrayView(outgoingDataBuffer->readPointer(), blockSize));
+            if (!data.isEmpty())
+                compressed.append(data);
+            outgoingDataBuffer->free(blockSize);
+        }
+        compressed.append(compressHelper.finish());
+        *outgoingDataBuffer = std::move(compressed);
+        return;
+    }
+
+    const qint64 bytesRead = compressAvailableOutgoingData();
+    // Random-access devices report the end by reading nothing, sequential
+    // ones by failing to read or by readChannelFinished(). The stream is
+    // terminated in _q_bufferOutgoingDataFinished().
+    if (bytesRead < 0 || (!outgoingData->isSequential() && outgoingData->atEnd()))
+        _q_bufferOutgoingDataFinished();
+}
+
+/*!
+    \internal
+
+    Reads and compresses the data outgoingData has available right now into
+    outgoingDataBuffer. Returns the result of the last read(): 0 if there is
+    nothing to read at the moment, -1 at the end of a sequential device.
+*/
+qint64 QNetworkReplyHttpImplPrivate::compressAvailableOutgoingData()
+{
+    constexpr qint64 ChunkSize = 64 * 1024;
+
+    QByteArray chunk(ChunkSize, Qt::Uninitialized);
+    forever {
+        const qint64 bytesRead = outgoingData->read(chunk.data(), chunk.size());
+        if (bytesRead <= 0)
+            return bytesRead;
+        const QByteArray compressed =
+                compressHelper.compress(QByteArrayView(chunk.constData(), bytesRead));
+        if (!compressed.isEmpty())
+            outgoingDataBuffer->append(compressed);
+    }
+}
+
 void QNetworkReplyHttpImplPrivate::_q_transferTimedOut()
 {
     Q_Q(QNetworkReplyHttpImpl);
@@ -37,6 +37,7 @@
 
 Q_MOC_INCLUDE(<QtNetwork/QAuthenticator>)
 
+#include <private/qcompresshelper_p.h>
 #include <private/qdecompresshelper_p.h>
 
 #include <memory>
@@ -228,6 +229,11 @@ public:
     QNetworkRequest redirectRequest;
 
     QDecompressHelper decompressHelper;
+    QCompressHelper compressHelper; // for UploadContentEncodingAttribute
+    QByteArray uploadContentEncoding;
+    bool setupUploadCompression();
+    void compressOutgoingData();
+    qint64 compressAvailableOutgoingData();
 
     bool loadFromCacheIfAllowed(QHttpNetworkRequest &httpRequest);
     void invalidateCache();
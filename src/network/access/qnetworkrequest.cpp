@@ -335,6 +335,17 @@ QT_IMPL_METATYPE_EXTERN_TAGGED(QNetworkRequest::RedirectPolicy, QNetworkRequest_
         be used for the Host header in the HTTP request.
         (This value was introduced in 6.8.)
 
+    \value UploadContentEncodingAttribute
+        Requests only, type: QMetaType::QByteArray (default: empty)
+        Holds the content coding, \c{"gzip"}, \c{"deflate"} or, if Qt was
+        built with zstd support, \c{"zstd"}, with which QNetworkAccessManager
+        compresses the body of an HTTP request before sending it. The
+        \c{Content-Encoding} and \c{Content-Length} headers are set
+        accordingly. The body is buffered in compressed form, so that it can
+        be resent on redirects. Unsupported codings are ignored with a
+        warning.
+        (This value was introduced in 6.10.)
+
     \value User
         Special type. Additional information can be passed in
         QVariants with types ranging from User to UserMax. The default
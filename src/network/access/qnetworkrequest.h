@@ -71,6 +71,7 @@ public:
         Http2CleartextAllowedAttribute,
         UseCredentialsAttribute,
         FullLocalServerNameAttribute,
+        UploadContentEncodingAttribute,
 
         User = 1000,
         UserMax = 32767
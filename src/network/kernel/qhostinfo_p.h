@@ -113,6 +113,7 @@ class QHostInfoCache
 public:
     QHostInfoCache();
     const int max_age; // seconds
+    const int negative_max_age; // seconds, for names that do not exist
 
     QHostInfo get(const QString &name, bool *valid);
     void put(const QString &name, const QHostInfo &info);
@@ -453,6 +453,9 @@
 
 #include <time.h>
 
+#include <algorithm>
+#include <utility>
+
 #define Q_CHECK_SOCKETENGINE(returnValue) do { \
     if (!d->socketEngine) { \
         return returnValue; \
@@ -472,6 +475,9 @@ QT_IMPL_METATYPE_EXTERN_TAGGED(QAbstractSocket::SocketState, QAbstractSocket__So
 QT_IMPL_METATYPE_EXTERN_TAGGED(QAbstractSocket::SocketError, QAbstractSocket__SocketError)
 
 static constexpr auto DefaultConnectTimeout = 30s;
+// How long a connection attempt may stall before the other address family
+// gets its chance in parallel; the value recommended by RFC 8305, section 5.
+static constexpr auto ConnectionAttemptDelay = 250ms;
 
 static bool isProxyError(QAbstractSocket::SocketError error)
 {
@@ -517,6 +523,7 @@ void QAbstractSocketPrivate::resetSocketLayer()
 #endif
 
     hasPendingData = false;
+    resetRacingConnection();
     if (socketEngine) {
         socketEngine->close();
         socketEngine->disconnect();
@@ -954,6 +961,9 @@ void QAbstractSocketPrivate::_q_startConnecting(const QHostInfo &hostInfo)
     qDebug("QAbstractSocketPrivate::_q_startConnecting(hostInfo == %s)", s.toLatin1().constData());
 #endif
 
+    // Don't try all addresses of one family before moving on to the other.
+    interleaveAddressFamilies(addresses);
+
     // Try all addresses twice.
     addresses += addresses;
 
@@ -1073,6 +1083,7 @@ void QAbstractSocketPrivate::_q_connectToNextAddress()
         // Wait for a write notification that will eventually call
         // _q_testConnection().
         socketEngine->setWriteNotificationEnabled(true);
+        scheduleRacingConnection();
         break;
     } while (state != QAbstractSocket::ConnectedState);
 }
@@ -1089,6 +1100,7 @@ void QAbstractSocketPrivate::_q_testConnection()
 
     if (socketEngine) {
         if (socketEngine->state() == QAbstractSocket::ConnectedState) {
+            resetRacingConnection();
             // Fetch the parameters if our connection is completed;
             // otherwise, fall out and try the next address.
             fetchConnectionParameters();
@@ -1108,7 +1120,8 @@ void QAbstractSocketPrivate::_q_testConnection()
     qDebug("QAbstractSocketPrivate::_q_testConnection() connection failed,"
            " checking for alternative addresses");
 #endif
-    _q_connectToNextAddress();
+    if (!promoteRacingConnection())
+        _q_connectToNextAddress();
 }
 
 /*! \internal
@@ -1129,6 +1142,9 @@ void QAbstractSocketPrivate::_q_abortConnectionAttempt()
 
     connectTimer->stop();
 
+    if (promoteRacingConnection())
+        return;
+
     if (addresses.isEmpty()) {
         state = QAbstractSocket::UnconnectedState;
         setError(QAbstractSocket::SocketTimeoutError,
@@ -1140,6 +1156,196 @@ void QAbstractSocketPrivate::_q_abortConnectionAttempt()
     }
 }
 
+/*! \internal
+
+    Reorders \a addresses so that the address families alternate, starting
+    with the family of the first (most preferred) address, as recommended by
+    RFC 8305, section 4. The relative order of addresses within each family is
+    preserved.
+*/
+void QAbstractSocketPrivate::interleaveAddressFamilies(QList<QHostAddress> &addresses)
+{
+    if (addresses.size() < 3)
+        return;
+
+    const QAbstractSocket::NetworkLayerProtocol firstFamily = addresses.constFirst().protocol();
+    QList<QHostAddress> preferred;
+    QList<QHostAddress> others;
+    for (const QHostAddress &address : std::as_const(addresses))
+        (address.protocol() == firstFamily ? preferred : others).append(address);
+    if (others.isEmpty())
+        return;
+
+    addresses.clear();
+    for (qsizetype i = 0; i < preferred.size() || i < others.size(); ++i) {
+        if (i < preferred.size())
+            addresses.append(preferred.at(i));
+        if (i < others.size())
+            addresses.append(others.at(i));
+    }
+}
+
+/*! \internal
+
+    Called when a connection attempt is in progress. If the remaining
+    addresses include one of the other address family, starts a timer that
+    races a connection to it against the current attempt, so that a stalling
+    address family does not delay the connection by a full connect timeout
+    (RFC 8305, section 5). Connections through a proxy are not raced.
+*/
+void QAbstractSocketPrivate::scheduleRacingConnection()
+{
+    Q_Q(QAbstractSocket);
+    if (racingEngine || cachedSocketDescriptor != -1 || q->socketType() != QAbstractSocket::TcpSocket
+        || !threadData.loadRelaxed()->hasEventDispatcher()) {
+        return;
+    }
+#ifndef QT_NO_NETWORKPROXY
+    if (proxyInUse.type() != QNetworkProxy::NoProxy)
+        return;
+#endif
+    const auto otherFamily = [this](const QHostAddress &a) { return a.protocol() != host.protocol(); };
+    if (std::none_of(addresses.cbegin(), addresses.cend(), otherFamily))
+        return;
+
+    if (!connectionAttemptTimer) {
+        connectionAttemptTimer = new QTimer(q);
+        connectionAttemptTimer->setSingleShot(true);
+        QObject::connect(connectionAttemptTimer, &QTimer::timeout, q,
+                         [this] { startRacingConnection(); }, Qt::DirectConnection);
+    }
+    connectionAttemptTimer->start(ConnectionAttemptDelay);
+}
+
+/*! \internal
+
+    Starts connecting to the next address of the other address family on a
+    second socket engine, while the attempt on socketEngine goes on. Whichever
+    connects first wins.
+*/
+void QAbstractSocketPrivate::startRacingConnection()
+{
+#ifdef QT_NO_NETWORKPROXY
+    static const QNetworkProxy &proxyInUse = *(QNetworkProxy *)0;
+#endif
+    Q_Q(QAbstractSocket);
+    if (state != QAbstractSocket::ConnectingState || racingEngine || !socketEngine
+        || socketEngine->state() != QAbstractSocket::ConnectingState) {
+        return;
+    }
+
+    const auto it = std::find_if(addresses.cbegin(), addresses.cend(), [this](const QHostAddress &a) {
+        return a.protocol() != host.protocol();
+    });
+    if (it == addresses.cend())
+        return;
+    racingHost = *it;
+    addresses.erase(it);
+
+#if defined(QABSTRACTSOCKET_DEBUG)
+    qDebug("QAbstractSocketPrivate::startRacingConnection(), connecting to %s:%i",
+           racingHost.toString().toLatin1().constData(), port);
+#endif
+
+    racingEngine = QAbstractSocketEngine::createSocketEngine(q->socketType(), proxyInUse, q);
+    if (!racingEngine || !racingEngine->initialize(q->socketType(), racingHost.protocol())) {
+        resetRacingConnection();
+        return;
+    }
+    if (racingEngine->connectToHost(racingHost, port)) {
+        adoptRacingConnection();
+        _q_testConnection();
+        return;
+    }
+    if (racingEngine->state() != QAbstractSocket::ConnectingState) {
+        resetRacingConnection();
+        return;
+    }
+    racingEngine->setReceiver(&racingReceiver);
+    racingEngine->setWriteNotificationEnabled(true);
+}
+
+/*! \internal
+
+    The racing connection attempt finished. If it succeeded, it replaces the
+    one in progress on socketEngine; otherwise it is dropped and the attempt
+    on socketEngine goes on.
+*/
+void QAbstractSocketPrivate::racingConnectionNotification()
+{
+    if (state != QAbstractSocket::ConnectingState || !racingEngine)
+        return;
+
+    if (racingEngine->state() == QAbstractSocket::ConnectedState) {
+        adoptRacingConnection();
+        _q_testConnection();
+    } else {
+#if defined(QABSTRACTSOCKET_DEBUG)
+        qDebug("QAbstractSocketPrivate::racingConnectionNotification(), connection to %s failed (%s)",
+               racingHost.toString().toLatin1().constData(),
+               racingEngine->errorString().toLatin1().constData());
+#endif
+        resetRacingConnection();
+    }
+}
+
+/*! \internal
+
+    Replaces socketEngine with the racing engine.
+*/
+void QAbstractSocketPrivate::adoptRacingConnection()
+{
+    Q_ASSERT(racingEngine);
+    if (connectionAttemptTimer)
+        connectionAttemptTimer->stop();
+    if (socketEngine) {
+        socketEngine->close();
+        socketEngine->disconnect();
+        delete socketEngine;
+    }
+    socketEngine = std::exchange(racingEngine, nullptr);
+    host = racingHost;
+    socketEngine->setReceiver(this);
+}
+
+/*! \internal
+
+    Called when the connection attempt on socketEngine failed or timed out.
+    If a racing attempt is still in progress, it takes over and the function
+    returns \c true.
+*/
+bool QAbstractSocketPrivate::promoteRacingConnection()
+{
+    if (!racingEngine)
+        return false;
+
+#if defined(QABSTRACTSOCKET_DEBUG)
+    qDebug("QAbstractSocketPrivate::promoteRacingConnection(), continuing with %s",
+           racingHost.toString().toLatin1().constData());
+#endif
+    adoptRacingConnection();
+    if (connectTimer)
+        connectTimer->start(DefaultConnectTimeout);
+    socketEngine->setWriteNotificationEnabled(true);
+    scheduleRacingConnection();
+    return true;
+}
+
+/*! \internal
+
+    Aborts the racing connection attempt, if any.
+*/
+void QAbstractSocketPrivate::resetRacingConnection()
+{
+    if (connectionAttemptTimer)
+        connectionAttemptTimer->stop();
+    if (racingEngine) {
+        racingEngine->close();
+        racingEngine->disconnect();
+        delete std::exchange(racingEngine, nullptr);
+    }
+}
+
 /*! \internal
 
     Reads data from the socket layer into the read buffer. Returns
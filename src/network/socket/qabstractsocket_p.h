@@ -60,6 +60,31 @@ public:
     void _q_testConnection();
     void _q_abortConnectionAttempt();
 
+    // RFC 8305 connection racing
+    class RacingReceiver : public QAbstractSocketEngineReceiver
+    {
+    public:
+        explicit RacingReceiver(QAbstractSocketPrivate *d) : d(d) {}
+        void readNotification() override {}
+        void writeNotification() override {}
+        void closeNotification() override {}
+        void exceptionNotification() override {}
+        void connectionNotification() override { d->racingConnectionNotification(); }
+#ifndef QT_NO_NETWORKPROXY
+        void proxyAuthenticationRequired(const QNetworkProxy &, QAuthenticator *) override {}
+#endif
+    private:
+        QAbstractSocketPrivate *d;
+    };
+
+    Q_AUTOTEST_EXPORT static void interleaveAddressFamilies(QList<QHostAddress> &addresses);
+    void scheduleRacingConnection();
+    void startRacingConnection();
+    void racingConnectionNotification();
+    void adoptRacingConnection();
+    bool promoteRacingConnection();
+    void resetRacingConnection();
+
     bool emittedReadyRead = false;
     bool emittedBytesWritten = false;
 
@@ -114,6 +139,11 @@ public:
 
     QTimer *connectTimer = nullptr;
 
+    QAbstractSocketEngine *racingEngine = nullptr;
+    QHostAddress racingHost;
+    RacingReceiver racingReceiver{this};
+    QTimer *connectionAttemptTimer = nullptr;
+
     int hostLookupId = -1;
 
     QAbstractSocket::SocketType socketType = QAbstractSocket::UnknownSocketType;
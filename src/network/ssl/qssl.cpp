@@ -121,7 +121,9 @@ Q_LOGGING_CATEGORY(lcSsl, "qt.network.ssl");
     \value SslOptionDisableSessionPersistence Disables storing the SSL session
     in ASN.1 format as returned by QSslConfiguration::sessionTicket(). Enabling
     this feature adds memory overhead of approximately 1K per used session
-    ticket.
+    ticket. With session persistence enabled, QNetworkAccessManager also
+    shares session tickets between connections to the same host made by
+    different QNetworkAccessManager instances of the application.
     \value SslOptionDisableServerCipherPreference Disables selecting the cipher
     chosen based on the servers preferences rather than the order ciphers were
     sent by the client. This option is only relevant to server sockets, and is
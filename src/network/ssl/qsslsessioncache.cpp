@@ -0,0 +1,153 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#include "qsslsessioncache_p.h"
+
+#include <QtCore/qcryptographichash.h>
+#include <QtNetwork/qsslcertificate.h>
+#include <QtNetwork/qsslconfiguration.h>
+
+QT_BEGIN_NAMESPACE
+
+using namespace std::chrono_literals;
+
+// Used when the server does not send a lifetime hint (RFC 5077, 3.3)
+static constexpr auto DefaultSessionLifetime = 300s;
+
+Q_GLOBAL_STATIC(QSslSessionCache, globalSessionCache)
+
+/*!
+    \internal
+    \class QSslSessionCache
+
+    QSslSessionCache keeps the most recently used TLS session tickets of a
+    process, so that connections made by unrelated objects (for example
+    different QNetworkAccessManager instances) to the same server can resume
+    a session instead of performing a full handshake.
+
+    Tickets are only available if the QSslConfiguration they come from has
+    QSsl::SslOptionDisableSessionPersistence turned off. Entries expire
+    according to the lifetime hint sent by the server.
+*/
+
+QSslSessionCache::QSslSessionCache(qsizetype maxEntries)
+    : cache(maxEntries)
+{
+}
+
+/*!
+    \internal
+    Returns the process-wide session cache, or \nullptr during shutdown.
+*/
+QSslSessionCache *QSslSessionCache::instance()
+{
+    return globalSessionCache();
+}
+
+// A resumed session skips the verification of the server's certificate
+// chain, so a session may only be resumed by connections that would have
+// accepted the original handshake: everything that affects the verification
+// is part of the key. Sessions must not be resumed with a different client
+// identity either, so the local certificate is part of it too.
+QString QSslSessionCache::cacheKey(const QString &host, quint16 port,
+                                   const QString &peerVerifyName,
+                                   const QSslConfiguration &configuration)
+{
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    hash.addData(peerVerifyName.toLower().toUtf8());
+    const int verification[] = { int(configuration.peerVerifyMode()),
+                                 configuration.peerVerifyDepth() };
+    hash.addData(QByteArrayView(reinterpret_cast<const char *>(verification), sizeof(verification)));
+    hash.addData(caCertificatesDigest(configuration.caCertificates()));
+    const QSslCertificate localCertificate = configuration.localCertificate();
+    if (!localCertificate.isNull())
+        hash.addData(localCertificate.digest(QCryptographicHash::Sha256));
+
+    return host.toLower() + u':' + QString::number(port) + u'/'
+            + QString::fromLatin1(hash.result().toHex());
+}
+
+// Digesting the CA certificates costs more than resuming a session saves
+// when they are the system's, and every connection would do so twice. The
+// list is implicitly shared and almost always the same one, so the digest of
+// the last list is kept.
+QByteArray QSslSessionCache::caCertificatesDigest(const QList<QSslCertificate> &caCertificates)
+{
+    {
+        QMutexLocker locker(&mutex);
+        if (caCertificates.constData() == digestedCaCertificates.constData()
+            && caCertificates.size() == digestedCaCertificates.size() && !caDigest.isEmpty()) {
+            return caDigest;
+        }
+    }
+
+    QCryptographicHash hash(QCryptographicHash::Sha256);
+    for (const QSslCertificate &certificate : caCertificates)
+        hash.addData(certificate.digest(QCryptographicHash::Sha256));
+    const QByteArray digest = hash.result();
+
+    QMutexLocker locker(&mutex);
+    digestedCaCertificates = caCertificates;
+    caDigest = digest;
+    return digest;
+}
+
+/*!
+    \internal
+    Returns the cached session ticket for \a host and \a port that can be used
+    by a socket verifying the server as \a peerVerifyName with
+    \a configuration, or an empty QByteArray if there is none or if it has
+    expired.
+*/
+QByteArray QSslSessionCache::sessionTicket(const QString &host, quint16 port,
+                                           const QString &peerVerifyName,
+                                           const QSslConfiguration &configuration)
+{
+    const QString key = cacheKey(host, port, peerVerifyName, configuration);
+    QMutexLocker locker(&mutex);
+    const Entry *entry = cache.object(key);
+    if (!entry)
+        return {};
+    if (entry->expiry.hasExpired()) {
+        cache.remove(key);
+        return {};
+    }
+    return entry->sessionTicket;
+}
+
+/*!
+    \internal
+    Stores the session ticket of \a configuration, as obtained from an
+    encrypted QSslSocket connected to \a host and \a port, which verified
+    the server as \a peerVerifyName. The caller must not store sessions of
+    handshakes with ignored errors.
+*/
+void QSslSessionCache::insert(const QString &host, quint16 port, const QString &peerVerifyName,
+                              const QSslConfiguration &configuration)
+{
+    const QByteArray ticket = configuration.sessionTicket();
+    if (ticket.isEmpty())
+        return;
+
+    const int lifetimeHint = configuration.sessionTicketLifeTimeHint();
+    Entry *entry = new Entry{ticket, QDeadlineTimer(lifetimeHint > 0
+                                                    ? std::chrono::seconds(lifetimeHint)
+                                                    : DefaultSessionLifetime)};
+    const QString key = cacheKey(host, port, peerVerifyName, configuration);
+    QMutexLocker locker(&mutex);
+    cache.insert(key, entry); // cache will take ownership
+}
+
+void QSslSessionCache::clear()
+{
+    QMutexLocker locker(&mutex);
+    cache.clear();
+}
+
+qsizetype QSslSessionCache::size() const
+{
+    QMutexLocker locker(&mutex);
+    return cache.size();
+}
+
+QT_END_NAMESPACE
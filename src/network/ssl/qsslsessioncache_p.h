@@ -0,0 +1,67 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR LGPL-3.0-only OR GPL-2.0-only OR GPL-3.0-only
+
+#ifndef QSSLSESSIONCACHE_P_H
+#define QSSLSESSIONCACHE_P_H
+
+//
+//  W A R N I N G
+//  -------------
+//
+// This file is not part of the Qt API. It exists purely as an
+// implementation detail. This header file may change from version to
+// version without notice, or even be removed.
+//
+// We mean it.
+//
+
+#include <QtNetwork/private/qtnetworkglobal_p.h>
+#include <QtNetwork/qsslcertificate.h>
+
+#include <QtCore/qbytearray.h>
+#include <QtCore/qcache.h>
+#include <QtCore/qdeadlinetimer.h>
+#include <QtCore/qlist.h>
+#include <QtCore/qmutex.h>
+#include <QtCore/qstring.h>
+
+QT_REQUIRE_CONFIG(ssl);
+
+QT_BEGIN_NAMESPACE
+
+class QSslConfiguration;
+
+class Q_AUTOTEST_EXPORT QSslSessionCache
+{
+public:
+    explicit QSslSessionCache(qsizetype maxEntries = 128);
+
+    static QSslSessionCache *instance();
+
+    QByteArray sessionTicket(const QString &host, quint16 port, const QString &peerVerifyName,
+                             const QSslConfiguration &configuration);
+    void insert(const QString &host, quint16 port, const QString &peerVerifyName,
+                const QSslConfiguration &configuration);
+    void clear();
+    qsizetype size() const;
+
+private:
+    QString cacheKey(const QString &host, quint16 port, const QString &peerVerifyName,
+                     const QSslConfiguration &configuration);
+    QByteArray caCertificatesDigest(const QList<QSslCertificate> &caCertificates);
+
+    struct Entry {
+        QByteArray sessionTicket;
+        QDeadlineTimer expiry;
+    };
+    mutable QMutex mutex;
+    QCache<QString, Entry> cache;
+    // the digest of the last CA certificate list seen; holding on to the
+    // list keeps its data from being reused by a different one
+    QList<QSslCertificate> digestedCaCertificates;
+    QByteArray caDigest;
+};
+
+QT_END_NAMESPACE
+
+#endif // QSSLSESSIONCACHE_P_H
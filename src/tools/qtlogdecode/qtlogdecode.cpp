@@ -0,0 +1,91 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only WITH Qt-GPL-exception-1.0
+
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QFile>
+
+#include <QtCore/private/qbinarylog_p.h>
+
+#include <stdio.h>
+#include <stdlib.h>
+
+QT_USE_NAMESPACE
+
+/**
+ * Writes error message and exits 1
+ * \param message to write
+ */
+Q_NORETURN static void error(const QString &message)
+{
+    fprintf(stderr, "%s\n", qPrintable(message));
+    ::exit(EXIT_FAILURE);
+}
+
+int main(int argc, char **argv)
+{
+    // Print our own messages instead of writing a binary log of them.
+    qunsetenv("QT_LOGGING_BINARY");
+
+    QCoreApplication app(argc, argv);
+    app.setApplicationVersion(QStringLiteral(QTLOGDECODE_VERSION_STR));
+
+    QCommandLineParser parser;
+    parser.setApplicationDescription(QStringLiteral(
+            "Prints the messages recorded in a binary log file, as written by a Qt "
+            "application run with QT_LOGGING_BINARY set."));
+    parser.addHelpOption();
+    parser.addVersionOption();
+
+    QCommandLineOption pattern(QStringLiteral("pattern"),
+                               QStringLiteral("Formats messages like QT_MESSAGE_PATTERN does. "
+                                              "The %{pid}, %{threadid} and %{time} placeholders "
+                                              "refer to this tool, not to the application."),
+                               QStringLiteral("pattern"));
+    parser.addOption(pattern);
+
+    QCommandLineOption noPrefix(QStringLiteral("no-prefix"),
+                                QStringLiteral("Does not print the time and the thread of each "
+                                               "message in front of it."));
+    parser.addOption(noPrefix);
+
+    parser.addPositionalArgument(QStringLiteral("file"), QStringLiteral("The binary log file."));
+    parser.process(app);
+
+    const QStringList files = parser.positionalArguments();
+    if (files.size() != 1)
+        parser.showHelp(EXIT_FAILURE);
+
+    QFile file(files.first());
+    if (!file.open(QIODevice::ReadOnly))
+        error(QStringLiteral("Cannot open %1: %2").arg(file.fileName(), file.errorString()));
+
+    const QBinaryLogReader reader(file.readAll());
+    if (!reader.isValid())
+        error(QStringLiteral("%1 is not a binary log file").arg(file.fileName()));
+
+    if (parser.isSet(pattern))
+        qSetMessagePattern(parser.value(pattern));
+    const bool prefix = !parser.isSet(noPrefix);
+
+    for (const QBinaryLogReader::Entry &entry : reader.entries()) {
+        QMessageLogContext context(entry.file.constData(), entry.line, entry.function.constData(),
+                                   entry.category.constData());
+        const QString text = qFormatLogMessage(entry.type, context, entry.message);
+        if (text.isNull())
+            continue;   // the pattern doesn't apply to this message
+        if (prefix) {
+            const QDateTime time = QDateTime::fromMSecsSinceEpoch(
+                    reader.startTime() + entry.time / 1000000);
+            fprintf(stdout, "%s %llu ", qPrintable(time.toString(Qt::ISODateWithMs)),
+                    static_cast<unsigned long long>(entry.threadId));
+        }
+        fprintf(stdout, "%s\n", qPrintable(text));
+    }
+
+    if (reader.dropped())
+        fprintf(stderr, "%llu messages did not fit into the file\n",
+                static_cast<unsigned long long>(reader.dropped()));
+    return EXIT_SUCCESS;
+}
@@ -160,6 +160,9 @@ int runRcc(int argc, char *argv[])
     QCommandLineOption noZstdOption(QStringLiteral("no-zstd"), QStringLiteral("Disable usage of zstd compression."));
     parser.addOption(noZstdOption);
 
+    QCommandLineOption zstdDictionaryOption(QStringLiteral("zstd-dictionary"), QStringLiteral("Compress input files with a zstd dictionary trained on all of them. Requires format version 4."));
+    parser.addOption(zstdDictionaryOption);
+
     QCommandLineOption thresholdOption(QStringLiteral("threshold"), QStringLiteral("Threshold to consider compressing files."), QStringLiteral("level"));
     parser.addOption(thresholdOption);
 
@@ -211,7 +214,7 @@ int runRcc(int argc, char *argv[])
         formatVersion = parser.value(formatVersionOption).toUInt(&ok);
         if (!ok) {
             errorMsg = "Invalid format version specified"_L1;
-        } else if (formatVersion < 1 || formatVersion > 3) {
+        } else if (formatVersion < 1 || formatVersion > 4) {
             errorMsg = "Unsupported format version specified"_L1;
         }
     }
@@ -235,6 +238,15 @@ int runRcc(int argc, char *argv[])
         if (library.noZstd())
             errorMsg = "--compression-algo=zstd and --no-zstd both specified."_L1;
     }
+    if (parser.isSet(zstdDictionaryOption)) {
+#if QT_CONFIG(zstd)
+        if (formatVersion < 4)
+            errorMsg = "A Zstandard dictionary requires format version 4 or higher"_L1;
+        library.setZstdDictionary(true);
+#else
+        errorMsg = "Zstandard support not compiled in"_L1;
+#endif
+    }
     if (parser.isSet(nocompressOption))
         library.setCompressionAlgorithm(RCCResourceLibrary::CompressionAlgorithm::None);
     if (parser.isSet(compressOption) && errorMsg.isEmpty()) {
@@ -14,13 +14,23 @@
 #include <qfile.h>
 #include <qiodevice.h>
 #include <qlocale.h>
+#include <qset.h>
+#include <qspan.h>
 #include <qstack.h>
 #include <qxmlstream.h>
 
 #include <algorithm>
+#include <memory>
+#include <numeric>
+#include <vector>
+
+#if QT_CONFIG(thread)
+#  include <qthreadpool.h>
+#endif
 
 #if QT_CONFIG(zstd)
 #  include <zstd.h>
+#  include <zdict.h>
 #endif
 
 // Note: A copy of this file is used in Qt Widgets Designer (qttools/src/designer/src/lib/shared/rcc.cpp)
@@ -34,7 +44,10 @@ enum {
     CONSTANT_COMPRESSLEVEL_DEFAULT = -1,
     CONSTANT_ZSTDCOMPRESSLEVEL_CHECK = 1,   // Zstd level to check if compressing is a good idea
     CONSTANT_ZSTDCOMPRESSLEVEL_STORE = 14,  // Zstd level to actually store the data
-    CONSTANT_COMPRESSTHRESHOLD_DEFAULT = 70
+    CONSTANT_COMPRESSTHRESHOLD_DEFAULT = 70,
+    CONSTANT_ZSTDDICTIONARYSIZE = 112640,   // the default of the zstd command line tool
+    CONSTANT_BATCHFILES = 1024,             // files read ahead to compress them in parallel
+    CONSTANT_BATCHBYTES = 64 * 1024 * 1024  // and at most that much of their content
 };
 
 void RCCResourceLibrary::write(const char *str, int len)
@@ -110,10 +123,14 @@ public:
     typedef QMultiHash<DeduplicationKey, RCCFileInfo*> DeduplicationMultiHash;
 
 public:
-    qint64 writeDataBlob(RCCResourceLibrary &lib,
-                         qint64 offset,
-                         DeduplicationMultiHash &dedupByContent,
-                         QString *errorMessage);
+    bool readData(DeduplicationMultiHash &dedupByContent, QString *errorMessage);
+    void compressData(const RCCResourceLibrary &lib);
+#if QT_CONFIG(zstd)
+    void compressDataWithDictionary(const QByteArray &dictionary);
+#endif
+    qint64 writeDataBlob(RCCResourceLibrary &lib, qint64 offset);
+    static qint64 writeData(RCCResourceLibrary &lib, qint64 offset, const QByteArray &data,
+                            const QString &description);
     qint64 writeDataName(RCCResourceLibrary &, qint64 offset);
     void writeDataInfo(RCCResourceLibrary &lib);
 
@@ -134,6 +151,13 @@ public:
     qint64 m_nameOffset = 0;
     qint64 m_dataOffset = 0;
     qint64 m_childOffset = 0;
+
+    // set by readData() and compressData() before writeDataBlob()
+    QByteArray m_data;
+    QByteArray m_uncompressedData;  // only kept while a zstd dictionary may be used
+    QByteArray m_dictionaryCompressedData;
+    const RCCFileInfo *m_duplicateOf = nullptr;
+    QString m_compressionLog;
 };
 
 static size_t qHash(const RCCFileInfo::DeduplicationKey &key, size_t seed) noexcept
@@ -141,6 +165,17 @@ static size_t qHash(const RCCFileInfo::DeduplicationKey &key, size_t seed) noexc
     return qHashMulti(seed, key.compressAlgo, key.compressLevel, key.compressThreshold, key.hash);
 }
 
+#if QT_CONFIG(zstd)
+// Files are compressed on the threads of a pool; every thread keeps one
+// context for all the files it compresses.
+static ZSTD_CCtx *zstdCompressionContext()
+{
+    static thread_local std::unique_ptr<ZSTD_CCtx, decltype(&ZSTD_freeCCtx)>
+            cctx(ZSTD_createCCtx(), &ZSTD_freeCCtx);
+    return cctx.get();
+}
+#endif
+
 RCCFileInfo::RCCFileInfo(const QString &name, const QFileInfo &fileInfo, QLocale::Language language,
                          QLocale::Territory territory, uint flags,
                          RCCResourceLibrary::CompressionAlgorithm compressAlgo, int compressLevel,
@@ -236,6 +271,8 @@ void RCCFileInfo::writeDataInfo(RCCResourceLibrary &lib)
         static const quint64 sourceDate2 = 1000 * qgetenv("SOURCE_DATE_EPOCH").toULongLong();
         if (sourceDate2 != 0)
             lastmod = sourceDate2;
+        if (!m_parent && lib.formatVersion() >= 4)
+            lastmod = m_dataOffset; // the root has none, it locates the zstd dictionary instead
         lib.writeNumber8(lastmod);
         if (text || pass1)
             lib.writeChar('\n');
@@ -244,55 +281,48 @@ void RCCFileInfo::writeDataInfo(RCCResourceLibrary &lib)
     }
 }
 
-qint64 RCCFileInfo::writeDataBlob(RCCResourceLibrary &lib,
-                                  qint64 offset,
-                                  DeduplicationMultiHash &dedupByContent,
-                                  QString *errorMessage)
+bool RCCFileInfo::readData(DeduplicationMultiHash &dedupByContent, QString *errorMessage)
 {
-    const bool text = lib.m_format == RCCResourceLibrary::C_Code;
-    const bool pass1 = lib.m_format == RCCResourceLibrary::Pass1;
-    const bool pass2 = lib.m_format == RCCResourceLibrary::Pass2;
-    const bool binary = lib.m_format == RCCResourceLibrary::Binary;
-    const bool python = lib.m_format == RCCResourceLibrary::Python_Code;
+    if (m_isEmpty)
+        return true;
 
-    //capture the offset
-    m_dataOffset = offset;
-    QByteArray data;
-
-    if (!m_isEmpty) {
-        // find the data to be written
-        const QString absoluteFilePath = m_fileInfo.absoluteFilePath();
-        QFile file(absoluteFilePath);
-        if (!file.open(QFile::ReadOnly)) {
-            *errorMessage = msgOpenReadFailed(absoluteFilePath, file.errorString());
-            return 0;
-        }
-        data = file.readAll();
-
-        // de-duplicate the same file content, we can re-use already written data
-        // we only do that if we have the same compression settings
-        const QByteArray hash = QCryptographicHash::hash(data, QCryptographicHash::Sha256);
-        const DeduplicationKey key{m_compressAlgo, m_compressLevel, m_compressThreshold, hash};
-        const QList<RCCFileInfo *> potentialCandidates = dedupByContent.values(key);
-        for (const RCCFileInfo *candidate : potentialCandidates) {
-            // check real content, we can have collisions
-            QFile candidateFile(candidate->m_fileInfo.absoluteFilePath());
-            if (!candidateFile.open(QFile::ReadOnly)) {
-                *errorMessage = msgOpenReadFailed(candidate->m_fileInfo.absoluteFilePath(),
-                                                  candidateFile.errorString());
-                return 0;
-            }
-            if (data != candidateFile.readAll()) {
-                continue;
-            }
-            // just remember the offset & flags with final compression state
-            // of the already written data and be done
-            m_dataOffset = candidate->m_dataOffset;
-            m_flags = candidate->m_flags;
-            return offset;
+    // find the data to be written
+    const QString absoluteFilePath = m_fileInfo.absoluteFilePath();
+    QFile file(absoluteFilePath);
+    if (!file.open(QFile::ReadOnly)) {
+        *errorMessage = msgOpenReadFailed(absoluteFilePath, file.errorString());
+        return false;
+    }
+    m_data = file.readAll();
+
+    // de-duplicate the same file content, we can re-use already written data
+    // we only do that if we have the same compression settings
+    const QByteArray hash = QCryptographicHash::hash(m_data, QCryptographicHash::Sha256);
+    const DeduplicationKey key{m_compressAlgo, m_compressLevel, m_compressThreshold, hash};
+    const QList<RCCFileInfo *> potentialCandidates = dedupByContent.values(key);
+    for (const RCCFileInfo *candidate : potentialCandidates) {
+        // check real content, we can have collisions
+        QFile candidateFile(candidate->m_fileInfo.absoluteFilePath());
+        if (!candidateFile.open(QFile::ReadOnly)) {
+            *errorMessage = msgOpenReadFailed(candidate->m_fileInfo.absoluteFilePath(),
+                                              candidateFile.errorString());
+            return false;
         }
-        dedupByContent.insert(key, this);
+        if (m_data != candidateFile.readAll())
+            continue;
+        // just remember the candidate, its offset & flags are only known once written
+        m_duplicateOf = candidate;
+        m_data.clear();
+        return true;
     }
+    dedupByContent.insert(key, this);
+    return true;
+}
+
+// Called for many files at once from different threads, so only touches this file
+void RCCFileInfo::compressData(const RCCResourceLibrary &lib)
+{
+    QByteArray &data = m_data;
 
     // Check if compression is useful for this file
     if (data.size() != 0) {
@@ -302,8 +332,10 @@ qint64 RCCFileInfo::writeDataBlob(RCCResourceLibrary &lib,
             m_compressLevel = 19;   // not ZSTD_maxCLevel(), as 20+ are experimental
         }
         if (m_compressAlgo == RCCResourceLibrary::CompressionAlgorithm::Zstd && !m_noZstd) {
-            if (lib.m_zstdCCtx == nullptr)
-                lib.m_zstdCCtx = ZSTD_createCCtx();
+            if (lib.m_zstdDictionary)
+                m_uncompressedData = data;
+
+            ZSTD_CCtx *cctx = zstdCompressionContext();
             qsizetype size = data.size();
             size = ZSTD_COMPRESSBOUND(size);
 
@@ -313,34 +345,30 @@ qint64 RCCFileInfo::writeDataBlob(RCCResourceLibrary &lib,
 
             QByteArray compressed(size, Qt::Uninitialized);
             char *dst = const_cast<char *>(compressed.constData());
-            size_t n = ZSTD_compressCCtx(lib.m_zstdCCtx, dst, size,
+            size_t n = ZSTD_compressCCtx(cctx, dst, size,
                                          data.constData(), data.size(),
                                          compressLevel);
             if (n * 100.0 < data.size() * 1.0 * (100 - m_compressThreshold) ) {
                 // compressing is worth it
                 if (m_compressLevel < 0) {
                     // heuristic compression, so recompress
-                    n = ZSTD_compressCCtx(lib.m_zstdCCtx, dst, size,
+                    n = ZSTD_compressCCtx(cctx, dst, size,
                                           data.constData(), data.size(),
                                           CONSTANT_ZSTDCOMPRESSLEVEL_STORE);
                 }
                 if (ZSTD_isError(n)) {
-                    QString msg = QString::fromLatin1("%1: error: compression with zstd failed: %2\n")
+                    m_compressionLog = QString::fromLatin1("%1: error: compression with zstd failed: %2\n")
                             .arg(m_name, QString::fromUtf8(ZSTD_getErrorName(n)));
-                    lib.m_errorDevice->write(msg.toUtf8());
                 } else if (lib.verbose()) {
-                    QString msg = QString::fromLatin1("%1: note: compressed using zstd (%2 -> %3)\n")
+                    m_compressionLog = QString::fromLatin1("%1: note: compressed using zstd (%2 -> %3)\n")
                             .arg(m_name).arg(data.size()).arg(n);
-                    lib.m_errorDevice->write(msg.toUtf8());
                 }
 
-                lib.m_overallFlags |= CompressedZstd;
                 m_flags |= CompressedZstd;
                 data = std::move(compressed);
                 data.truncate(n);
             } else if (lib.verbose()) {
-                QString msg = QString::fromLatin1("%1: note: not compressed\n").arg(m_name);
-                lib.m_errorDevice->write(msg.toUtf8());
+                m_compressionLog = QString::fromLatin1("%1: note: not compressed\n").arg(m_name);
             }
         }
 #endif
@@ -356,25 +384,76 @@ qint64 RCCFileInfo::writeDataBlob(RCCResourceLibrary &lib,
             int compressRatio = int(100.0 * (data.size() - compressed.size()) / data.size());
             if (compressRatio >= m_compressThreshold) {
                 if (lib.verbose()) {
-                    QString msg = QString::fromLatin1("%1: note: compressed using zlib (%2 -> %3)\n")
+                    m_compressionLog = QString::fromLatin1("%1: note: compressed using zlib (%2 -> %3)\n")
                             .arg(m_name).arg(data.size()).arg(compressed.size());
-                    lib.m_errorDevice->write(msg.toUtf8());
                 }
                 data = compressed;
-                lib.m_overallFlags |= Compressed;
                 m_flags |= Compressed;
             } else if (lib.verbose()) {
-                QString msg = QString::fromLatin1("%1: note: not compressed\n").arg(m_name);
-                lib.m_errorDevice->write(msg.toUtf8());
+                m_compressionLog = QString::fromLatin1("%1: note: not compressed\n").arg(m_name);
             }
         }
 #endif // QT_NO_COMPRESS
     }
+}
+
+#if QT_CONFIG(zstd)
+// Compresses the file again, with \a dictionary. The result is kept if it is
+// smaller, and only used if the dictionary pays off for all files together.
+void RCCFileInfo::compressDataWithDictionary(const QByteArray &dictionary)
+{
+    const QByteArray &data = m_uncompressedData;
+    const qsizetype size = ZSTD_COMPRESSBOUND(data.size());
+    const int compressLevel = m_compressLevel < 0 ? int(CONSTANT_ZSTDCOMPRESSLEVEL_STORE)
+                                                  : m_compressLevel;
+
+    QByteArray compressed(size, Qt::Uninitialized);
+    const size_t n = ZSTD_compress_usingDict(zstdCompressionContext(), compressed.data(), size,
+                                             data.constData(), data.size(),
+                                             dictionary.constData(), dictionary.size(),
+                                             compressLevel);
+    if (ZSTD_isError(n) || qsizetype(n) >= m_data.size()
+        || n * 100.0 >= data.size() * 1.0 * (100 - m_compressThreshold)) {
+        return;
+    }
+    compressed.truncate(n);
+    m_dictionaryCompressedData = std::move(compressed);
+}
+#endif
+
+qint64 RCCFileInfo::writeDataBlob(RCCResourceLibrary &lib, qint64 offset)
+{
+    if (m_duplicateOf) {
+        // just remember the offset & flags with final compression state
+        // of the already written data and be done
+        m_dataOffset = m_duplicateOf->m_dataOffset;
+        m_flags = m_duplicateOf->m_flags;
+        return offset;
+    }
+
+    //capture the offset
+    m_dataOffset = offset;
+
+    if (!m_compressionLog.isEmpty())
+        lib.m_errorDevice->write(m_compressionLog.toUtf8());
+    lib.m_overallFlags |= m_flags & (Compressed | CompressedZstd);
+
+    return writeData(lib, offset, std::exchange(m_data, {}), m_fileInfo.fileName());
+}
+
+qint64 RCCFileInfo::writeData(RCCResourceLibrary &lib, qint64 offset, const QByteArray &data,
+                              const QString &description)
+{
+    const bool text = lib.m_format == RCCResourceLibrary::C_Code;
+    const bool pass1 = lib.m_format == RCCResourceLibrary::Pass1;
+    const bool pass2 = lib.m_format == RCCResourceLibrary::Pass2;
+    const bool binary = lib.m_format == RCCResourceLibrary::Binary;
+    const bool python = lib.m_format == RCCResourceLibrary::Python_Code;
 
     // some info
     if (text || pass1) {
         lib.writeString("  // ");
-        lib.writeByteArray(m_fileInfo.fileName().toLocal8Bit());
+        lib.writeByteArray(description.toLocal8Bit());
         lib.writeString("\n  ");
     }
 
@@ -502,20 +581,15 @@ RCCResourceLibrary::RCCResourceLibrary(quint8 formatVersion)
     m_errorDevice(nullptr),
     m_outDevice(nullptr),
     m_formatVersion(formatVersion),
-    m_noZstd(false)
+    m_noZstd(false),
+    m_zstdDictionary(false)
 {
     m_out.reserve(30 * 1000 * 1000);
-#if QT_CONFIG(zstd)
-    m_zstdCCtx = nullptr;
-#endif
 }
 
 RCCResourceLibrary::~RCCResourceLibrary()
 {
     delete m_root;
-#if QT_CONFIG(zstd)
-    ZSTD_freeCCtx(m_zstdCCtx);
-#endif
 }
 
 enum RCCXmlTag {
@@ -1198,6 +1272,96 @@ bool RCCResourceLibrary::writeHeader()
     return true;
 }
 
+template <typename Function>
+static void forEachFile(QSpan<RCCFileInfo * const> files, Function function)
+{
+#if QT_CONFIG(thread)
+    QThreadPool pool;
+    for (RCCFileInfo *file : files)
+        pool.start([file, &function] { function(file); });
+    pool.waitForDone();
+#else
+    for (RCCFileInfo *file : files)
+        function(file);
+#endif
+}
+
+#if QT_CONFIG(zstd)
+/*
+    Trains a zstd dictionary over the files compressed with zstd and recompresses
+    them with it. Small files that look alike, like icons or QML, compress much
+    better that way. Returns the dictionary, or an empty QByteArray if the files
+    do not get smaller by more than the size of the dictionary itself.
+*/
+QByteArray RCCResourceLibrary::compressWithZstdDictionary(const QList<RCCFileInfo *> &files)
+{
+    QList<RCCFileInfo *> candidates;
+    QByteArray samples;
+    std::vector<size_t> sampleSizes;
+    for (RCCFileInfo *file : files) {
+        if (!file->m_uncompressedData.isEmpty()) {
+            candidates.append(file);
+            samples += file->m_uncompressedData;
+            sampleSizes.push_back(file->m_uncompressedData.size());
+        }
+    }
+
+    QByteArray dictionary;
+    const qsizetype capacity = std::min<qsizetype>(CONSTANT_ZSTDDICTIONARYSIZE, samples.size() / 10);
+    if (capacity >= 1024) {
+        dictionary.resize(capacity);
+        const size_t n = ZDICT_trainFromBuffer(dictionary.data(), dictionary.size(),
+                                               samples.constData(), sampleSizes.data(),
+                                               unsigned(sampleSizes.size()));
+        if (ZDICT_isError(n)) {
+            if (m_verbose) {
+                m_errorDevice->write(QString::fromLatin1("note: no zstd dictionary trained: %1\n")
+                                     .arg(QString::fromUtf8(ZDICT_getErrorName(n))).toUtf8());
+            }
+            dictionary.clear();
+        } else {
+            dictionary.truncate(n);
+        }
+    }
+    samples.clear();
+
+    qsizetype saved = 0;
+    if (!dictionary.isEmpty()) {
+        forEachFile(candidates, [&dictionary](RCCFileInfo *file) {
+            file->compressDataWithDictionary(dictionary);
+        });
+        for (const RCCFileInfo *file : std::as_const(candidates)) {
+            if (!file->m_dictionaryCompressedData.isEmpty())
+                saved += file->m_data.size() - file->m_dictionaryCompressedData.size();
+        }
+    }
+
+    const bool useDictionary = saved > dictionary.size() + 4;
+    if (m_verbose && !dictionary.isEmpty()) {
+        m_errorDevice->write(QString::fromLatin1("note: zstd dictionary of %1 bytes %2 %3 bytes\n")
+                             .arg(dictionary.size())
+                             .arg(useDictionary ? "saves"_L1 : "only saves"_L1)
+                             .arg(saved).toUtf8());
+    }
+    for (RCCFileInfo *file : std::as_const(candidates)) {
+        if (useDictionary && !file->m_dictionaryCompressedData.isEmpty()) {
+            if (m_verbose) {
+                file->m_compressionLog = QString::fromLatin1("%1: note: compressed using zstd with dictionary (%2 -> %3)\n")
+                        .arg(file->m_name).arg(file->m_uncompressedData.size())
+                        .arg(file->m_dictionaryCompressedData.size());
+            }
+            file->m_data = std::move(file->m_dictionaryCompressedData);
+            file->m_flags |= RCCFileInfo::CompressedZstd;
+        }
+        file->m_uncompressedData.clear();
+        file->m_dictionaryCompressedData.clear();
+    }
+    if (!useDictionary)
+        dictionary.clear();
+    return dictionary;
+}
+#endif
+
 bool RCCResourceLibrary::writeDataBlobs()
 {
     Q_ASSERT(m_errorDevice);
@@ -1218,26 +1382,57 @@ bool RCCResourceLibrary::writeDataBlobs()
     if (!m_root)
         return false;
 
+    QList<RCCFileInfo *> files;
     QStack<RCCFileInfo*> pending;
     pending.push(m_root);
-    qint64 offset = 0;
-    RCCFileInfo::DeduplicationMultiHash dedupByContent;
-    QString errorMessage;
     while (!pending.isEmpty()) {
         RCCFileInfo *file = pending.pop();
         for (auto it = file->m_children.cbegin(); it != file->m_children.cend(); ++it) {
             RCCFileInfo *child = it.value();
             if (child->m_flags & RCCFileInfo::Directory)
                 pending.push(child);
-            else {
-                offset = child->writeDataBlob(*this, offset,
-                                              dedupByContent, &errorMessage);
-                if (offset == 0) {
-                    m_errorDevice->write(errorMessage.toUtf8());
-                    return false;
-                }
+            else
+                files.append(child);
+        }
+    }
+
+    // Files are read, compressed in parallel and written in batches, so only
+    // a batch of them is in memory at a time. Every file is compressed on its
+    // own, so the output does not depend on the batches or the threads. A zstd
+    // dictionary is trained on all files though, so then there is one batch.
+    RCCFileInfo::DeduplicationMultiHash dedupByContent;
+    QString errorMessage;
+    qint64 offset = 0;
+    for (qsizetype first = 0; first < files.size(); ) {
+        qsizetype last = first;
+        qint64 bytes = 0;
+        while (last < files.size()
+               && (m_zstdDictionary
+                   || (last - first < CONSTANT_BATCHFILES && bytes < CONSTANT_BATCHBYTES))) {
+            RCCFileInfo *file = files.at(last++);
+            if (!file->readData(dedupByContent, &errorMessage)) {
+                m_errorDevice->write(errorMessage.toUtf8());
+                return false;
             }
+            bytes += file->m_data.size();
         }
+
+        const auto batch = QSpan(std::as_const(files)).subspan(first, last - first);
+        forEachFile(batch, [this](RCCFileInfo *file) { file->compressData(*this); });
+
+#if QT_CONFIG(zstd)
+        if (m_zstdDictionary) {
+            const QByteArray dictionary = compressWithZstdDictionary(files);
+            if (!dictionary.isEmpty()) {
+                m_root->m_dataOffset = offset;
+                offset = RCCFileInfo::writeData(*this, offset, dictionary, u"zstd dictionary"_s);
+            }
+        }
+#endif
+
+        for (RCCFileInfo *file : batch)
+            offset = file->writeDataBlob(*this, offset);
+        first = last;
     }
     switch (m_format) {
     case C_Code:
@@ -1312,6 +1507,99 @@ bool RCCResourceLibrary::writeDataNames()
     return true;
 }
 
+// must match qresource.cpp
+static quint64 resourcePathHash(QStringView path, quint32 seed)
+{
+    quint64 h = Q_UINT64_C(14695981039346656037) ^ seed;
+    for (QChar c : path) {
+        h ^= c.unicode();
+        h *= Q_UINT64_C(1099511628211);
+    }
+    return h;
+}
+
+/*
+    Builds the index that format version 4 appends to the tree: a perfect hash
+    over the full path of every node, found by hash and displace. Locale
+    variants of a file share one entry. Returns an empty list if none of the
+    seeds tried yields a perfect hash.
+*/
+static QList<quint32> buildPathIndex(const QList<RCCFileInfo *> &nodes, const QList<quint32> &parents)
+{
+    // parents are numbered before their children
+    QStringList paths(nodes.size());
+    QList<quint32> keys;
+    QSet<QString> seen;
+    for (qsizetype n = 1; n < nodes.size(); ++n) {
+        paths[n] = paths.at(parents.at(n)) + u'/' + nodes.at(n)->m_name;
+        if (!seen.contains(paths.at(n))) {
+            seen.insert(paths.at(n));
+            keys.append(quint32(n));
+        }
+    }
+
+    quint32 slotCount = 1;
+    while (slotCount < keys.size() + keys.size() / 4)
+        slotCount *= 2;
+    const quint32 bucketCount = std::max(slotCount / 4, 1u);
+
+    for (quint32 seed = 0; seed < 16; ++seed) {
+        QList<quint64> hashes(keys.size());
+        QList<QList<qsizetype>> buckets(bucketCount);
+        for (qsizetype i = 0; i < keys.size(); ++i) {
+            hashes[i] = resourcePathHash(paths.at(keys.at(i)), seed);
+            buckets[quint32(hashes.at(i) >> 32) % bucketCount].append(i);
+        }
+
+        // place the largest buckets first, while there is most room
+        QList<quint32> order(bucketCount);
+        std::iota(order.begin(), order.end(), 0u);
+        std::stable_sort(order.begin(), order.end(), [&](quint32 left, quint32 right) {
+            return buckets.at(left).size() > buckets.at(right).size();
+        });
+
+        QList<quint32> displacements(bucketCount, 0);
+        QList<quint32> slotNodes(slotCount, 0);
+        QList<quint32> positions;
+        bool ok = true;
+        for (quint32 b : std::as_const(order)) {
+            const QList<qsizetype> &bucket = buckets.at(b);
+            if (bucket.isEmpty())
+                break;
+            quint32 d = 0;
+            for (; d < slotCount; ++d) {
+                positions.clear();
+                for (qsizetype i : bucket) {
+                    const quint32 lo = quint32(hashes.at(i));
+                    const quint32 hi = quint32(hashes.at(i) >> 32);
+                    const quint32 slot = (lo + d * (hi | 1)) & (slotCount - 1);
+                    if (slotNodes.at(slot) || positions.contains(slot))
+                        break;
+                    positions.append(slot);
+                }
+                if (positions.size() == bucket.size())
+                    break;
+            }
+            if (d == slotCount) {
+                ok = false;
+                break;
+            }
+            displacements[b] = d;
+            for (qsizetype i = 0; i < bucket.size(); ++i)
+                slotNodes[positions.at(i)] = keys.at(bucket.at(i));
+        }
+        if (!ok)
+            continue;
+
+        QList<quint32> index = { seed, slotCount, bucketCount, quint32(nodes.size()) };
+        index += displacements;
+        index += slotNodes;
+        index += parents;
+        return index;
+    }
+    return {};
+}
+
 struct qt_rcc_compare_hash
 {
     typedef bool result_type;
@@ -1338,47 +1626,48 @@ bool RCCResourceLibrary::writeDataStructure()
         break;
     }
 
-    QStack<RCCFileInfo*> pending;
-
     if (!m_root)
         return false;
 
-    //calculate the child offsets (flat)
-    pending.push(m_root);
-    int offset = 1;
+    //calculate the child offsets (flat), numbering the nodes in the order they are written
+    QList<RCCFileInfo *> nodes = { m_root };
+    QList<quint32> parents = { 0 };
+    QStack<quint32> pending;
+    pending.push(0);
     while (!pending.isEmpty()) {
-        RCCFileInfo *file = pending.pop();
-        file->m_childOffset = offset;
+        const quint32 parent = pending.pop();
+        RCCFileInfo *file = nodes.at(parent);
+        file->m_childOffset = nodes.size();
 
         //sort by hash value for binary lookup
         QList<RCCFileInfo*> m_children = file->m_children.values();
         std::sort(m_children.begin(), m_children.end(), qt_rcc_compare_hash());
 
-        //write out the actual data now
-        for (int i = 0; i < m_children.size(); ++i) {
-            RCCFileInfo *child = m_children.at(i);
-            ++offset;
+        for (RCCFileInfo *child : std::as_const(m_children)) {
             if (child->m_flags & RCCFileInfo::Directory)
-                pending.push(child);
+                pending.push(quint32(nodes.size()));
+            nodes.append(child);
+            parents.append(parent);
         }
     }
 
-    //write out the structure (ie iterate again!)
-    pending.push(m_root);
-    m_root->writeDataInfo(*this);
-    while (!pending.isEmpty()) {
-        RCCFileInfo *file = pending.pop();
-
-        //sort by hash value for binary lookup
-        QList<RCCFileInfo*> m_children = file->m_children.values();
-        std::sort(m_children.begin(), m_children.end(), qt_rcc_compare_hash());
+    QList<quint32> index;
+    if (m_formatVersion >= 4) {
+        index = buildPathIndex(nodes, parents);
+        // the root has no name, so its name offset locates the index instead
+        m_root->m_nameOffset = index.isEmpty() ? 0 : nodes.size() * (14 + 8);
+    }
 
-        //write out the actual data now
-        for (int i = 0; i < m_children.size(); ++i) {
-            RCCFileInfo *child = m_children.at(i);
-            child->writeDataInfo(*this);
-            if (child->m_flags & RCCFileInfo::Directory)
-                pending.push(child);
+    //write out the structure
+    for (RCCFileInfo *node : std::as_const(nodes))
+        node->writeDataInfo(*this);
+    for (qsizetype i = 0; i < index.size(); ++i) {
+        writeNumber4(index.at(i));
+        if (i % 4 == 3 || i == index.size() - 1) {
+            if (m_format == C_Code || m_format == Pass1)
+                writeChar('\n');
+            else if (m_format == Python_Code)
+                writeString("\\\n");
         }
     }
     switch (m_format) {
@@ -11,8 +11,6 @@
 #include <qhash.h>
 #include <qstring.h>
 
-typedef struct ZSTD_CCtx_s ZSTD_CCtx;
-
 QT_BEGIN_NAMESPACE
 
 class RCCFileInfo;
@@ -87,6 +85,9 @@ public:
     void setNoZstd(bool v) { m_noZstd = v; }
     bool noZstd() const { return m_noZstd; }
 
+    void setZstdDictionary(bool v) { m_zstdDictionary = v; }
+    bool zstdDictionary() const { return m_zstdDictionary; }
+
 private:
     struct Strings {
         Strings();
@@ -126,7 +127,7 @@ private:
     void writeString(const char *s) { write(s, static_cast<int>(strlen(s))); }
 
 #if QT_CONFIG(zstd)
-    ZSTD_CCtx *m_zstdCCtx;
+    QByteArray compressWithZstdDictionary(const QList<RCCFileInfo *> &files);
 #endif
 
     const Strings m_strings;
@@ -152,6 +153,7 @@ private:
     QByteArray m_out;
     quint8 m_formatVersion;
     bool m_noZstd;
+    bool m_zstdDictionary;
 };
 
 QT_END_NAMESPACE
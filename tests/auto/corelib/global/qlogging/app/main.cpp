@@ -4,6 +4,11 @@
 #include <QCoreApplication>
 #include <QLoggingCategory>
 
+#ifdef Q_OS_UNIX
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
 #ifdef Q_CC_GNU
 #define NEVER_INLINE __attribute__((__noinline__))
 #else
@@ -50,6 +55,19 @@ int main(int argc, char **argv)
     QLoggingCategory cat("category");
     qCWarning(cat) << "qDebug with category";
 
+#ifdef Q_OS_UNIX
+    if (app.arguments().contains(QLatin1String("fork"))) {
+        const pid_t pid = fork();
+        if (pid == 0) {
+            qWarning("child");
+            qSetMessagePattern(QString());
+            exit(0);
+        }
+        waitpid(pid, nullptr, 0);
+        qWarning("parent");
+    }
+#endif
+
     qSetMessagePattern(QString());
 
     qDebug("qDebug2");
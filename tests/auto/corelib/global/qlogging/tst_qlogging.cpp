@@ -11,6 +11,14 @@
 #include <QtTest/QTest>
 #include <QList>
 #include <QMap>
+#include <QDir>
+#include <QTemporaryDir>
+
+#include <QtCore/private/qbinarylog_p.h>
+
+#include <algorithm>
+
+using namespace Qt::StringLiterals;
 
 class tst_qmessagehandler : public QObject
 {
@@ -37,6 +45,11 @@ private slots:
     void qMessagePattern_data();
     void qMessagePattern();
     void setMessagePattern();
+    void asyncOutput_data();
+    void asyncOutput();
+    void asyncOutputAfterFork();
+    void binaryLog();
+    void binaryLogReusedStrings();
 
     void formatLogMessage_data();
     void formatLogMessage();
@@ -721,16 +734,16 @@ void tst_qmessagehandler::qMessagePattern_data()
 
     // %{file} is tricky because of shadow builds
     QTest::newRow("basic") << "%{type} %{appname} %{line} %{function} %{message}" << true << (QList<QByteArray>()
-            << "debug  14 T::T static constructor"
+            << "debug  19 T::T static constructor"
             //  we can't be sure whether the QT_MESSAGE_PATTERN is already destructed
             << "static destructor"
-            << "debug tst_qlogging 35 MyClass::myFunction from_a_function 34"
-            << "debug tst_qlogging 45 main qDebug"
-            << "info tst_qlogging 46 main qInfo"
-            << "warning tst_qlogging 47 main qWarning"
-            << "critical tst_qlogging 48 main qCritical"
-            << "warning tst_qlogging 51 main qDebug with category"
-            << "debug tst_qlogging 55 main qDebug2");
+            << "debug tst_qlogging 40 MyClass::myFunction from_a_function 34"
+            << "debug tst_qlogging 50 main qDebug"
+            << "info tst_qlogging 51 main qInfo"
+            << "warning tst_qlogging 52 main qWarning"
+            << "critical tst_qlogging 53 main qCritical"
+            << "warning tst_qlogging 56 main qDebug with category"
+            << "debug tst_qlogging 73 main qDebug2");
 
 
     QTest::newRow("invalid") << "PREFIX: %{unknown} %{message}" << false << (QList<QByteArray>()
@@ -917,6 +930,193 @@ void tst_qmessagehandler::setMessagePattern()
 #endif // QT_CONFIG(process)
 }
 
+void tst_qmessagehandler::asyncOutput_data()
+{
+    QTest::addColumn<QByteArray>("policy");
+
+    QTest::newRow("block") << QByteArray("block");
+    QTest::newRow("drop") << QByteArray("drop");
+}
+
+void tst_qmessagehandler::asyncOutput()
+{
+#if !QT_CONFIG(process)
+    QSKIP("This test requires QProcess support");
+#else
+#ifdef Q_OS_ANDROID
+    QSKIP("This test crashes on Android");
+#endif
+    QFETCH(QByteArray, policy);
+
+    // The output must be the same as in setMessagePattern(), just written by
+    // another thread; in particular, nothing queued may get lost on exit.
+    QProcess process;
+    const QString appExe(backtraceHelperPath());
+
+    QProcessEnvironment environment = m_baseEnvironment;
+    environment.insert("QT_LOGGING_ASYNC", QString::fromLatin1(policy));
+    process.setProcessEnvironment(environment);
+
+    process.start(appExe);
+    QVERIFY2(process.waitForStarted(), qPrintable(
+        QString::fromLatin1("Could not start %1: %2").arg(appExe, process.errorString())));
+    process.waitForFinished();
+
+    QByteArray output = process.readAllStandardError();
+    QByteArray expected = "static constructor\n"
+            "[debug] qDebug\n"
+            "[info] qInfo\n"
+            "[warning] qWarning\n"
+            "[critical] qCritical\n"
+            "[warning] qDebug with category\n";
+#ifdef Q_OS_WIN
+    output.replace("\r\n", "\n");
+#endif
+    QCOMPARE(QString::fromLatin1(output), QString::fromLatin1(expected));
+#endif // QT_CONFIG(process)
+}
+
+void tst_qmessagehandler::asyncOutputAfterFork()
+{
+#if !QT_CONFIG(process) || !defined(Q_OS_UNIX) || defined(Q_OS_ANDROID)
+    QSKIP("This test requires QProcess and fork() support");
+#else
+    // The child has no writer thread: it must neither hang on exit waiting
+    // for it, nor lose its messages, nor repeat those queued by the parent.
+    QProcess process;
+    const QString appExe(backtraceHelperPath());
+
+    QProcessEnvironment environment = m_baseEnvironment;
+    environment.insert("QT_LOGGING_ASYNC", "block");
+    process.setProcessEnvironment(environment);
+
+    process.start(appExe, { u"fork"_s });
+    QVERIFY2(process.waitForStarted(), qPrintable(
+        QString::fromLatin1("Could not start %1: %2").arg(appExe, process.errorString())));
+    QVERIFY(process.waitForFinished());
+    QCOMPARE(process.exitStatus(), QProcess::NormalExit);
+    QCOMPARE(process.exitCode(), 0);
+
+    // the child and the parent's writer thread may write in any order
+    QList<QByteArray> output = process.readAllStandardError().split('\n');
+    std::sort(output.begin(), output.end());
+    const QList<QByteArray> expected = { "",
+                                         "[critical] qCritical",
+                                         "[debug] qDebug",
+                                         "[info] qInfo",
+                                         "[warning] child",
+                                         "[warning] parent",
+                                         "[warning] qDebug with category",
+                                         "[warning] qWarning",
+                                         "static constructor" };
+    QCOMPARE(output, expected);
+#endif
+}
+
+void tst_qmessagehandler::binaryLog()
+{
+#if !QT_CONFIG(process)
+    QSKIP("This test requires QProcess support");
+#else
+#ifdef Q_OS_ANDROID
+    QSKIP("This test crashes on Android");
+#endif
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), qPrintable(dir.errorString()));
+    // every process writes a file of its own
+    const QString logFile = dir.filePath(u"log-%p.bin"_s);
+
+    QProcess process;
+    const QString appExe(backtraceHelperPath());
+
+    QProcessEnvironment environment = m_baseEnvironment;
+    environment.insert("QT_LOGGING_BINARY", logFile);
+    environment.insert("QT_LOGGING_BINARY_SIZE", "1");
+    process.setProcessEnvironment(environment);
+
+    process.start(appExe);
+    QVERIFY2(process.waitForStarted(), qPrintable(
+        QString::fromLatin1("Could not start %1: %2").arg(appExe, process.errorString())));
+    const qint64 pid = process.processId();
+    process.waitForFinished();
+
+    // Nothing is printed, and nothing is formatted: not even the messages
+    // the pattern would suppress are missing.
+    QCOMPARE(process.readAllStandardError(), QByteArray());
+
+    QCOMPARE(QDir(dir.path()).entryList(QDir::Files), QStringList(u"log-%1.bin"_s.arg(pid)));
+    QFile file(dir.filePath(u"log-%1.bin"_s.arg(pid)));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray data = file.readAll();
+    QCOMPARE_LT(data.size(), 1 << 20); // truncated to the size used
+
+    const QBinaryLogReader reader(data);
+    QVERIFY(reader.isValid());
+    QCOMPARE(reader.processId(), pid);
+    QCOMPARE(reader.dropped(), 0u);
+
+    // Qt itself may have something to say, too; only look at the helper's messages
+    QList<QBinaryLogReader::Entry> entries;
+    qint64 lastTime = -1;
+    for (const QBinaryLogReader::Entry &entry : reader.entries()) {
+        QCOMPARE_GE(entry.time, lastTime);
+        lastTime = entry.time;
+        QVERIFY(entry.threadId);
+        if (entry.file.endsWith("main.cpp"))
+            entries << entry;
+    }
+    QStringList messages;
+    for (const QBinaryLogReader::Entry &entry : std::as_const(entries))
+        messages << entry.message;
+    QCOMPARE(messages, QStringList({ u"static constructor"_s, u"qDebug"_s, u"qInfo"_s,
+                                     u"qWarning"_s, u"qCritical"_s, u"qDebug with category"_s,
+                                     u"qDebug2"_s, u"from_a_function 34"_s,
+                                     u"static destructor"_s }));
+
+    QCOMPARE(entries.at(1).category, "default");
+    QCOMPARE(entries.at(4).type, QtCriticalMsg);
+    const QBinaryLogReader::Entry &categorized = entries.at(5);
+    QCOMPARE(categorized.type, QtWarningMsg);
+    QCOMPARE(categorized.category, "category");
+    QVERIFY(categorized.function.contains("main"));
+    QCOMPARE(categorized.line, 56);
+#endif // QT_CONFIG(process)
+}
+
+void tst_qmessagehandler::binaryLogReusedStrings()
+{
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), qPrintable(dir.errorString()));
+    const QString logFile = dir.filePath(u"log.bin"_s);
+
+    {
+        QBinaryLogWriter writer(logFile, 1 << 20);
+        QVERIFY2(writer.isOpen(), qPrintable(writer.errorString()));
+
+        // a category name that isn't a literal: the same address holds
+        // different names over time
+        char category[16];
+        for (const char *name : { "first", "second", "first", "third" }) {
+            qstrcpy(category, name);
+            const QMessageLogContext context("file.cpp", 1, "function", category);
+            writer.write(QtDebugMsg, context, QString::fromLatin1(name), 1);
+        }
+
+        // messages written after finishing are dropped, and don't crash
+        writer.finish();
+        writer.write(QtDebugMsg, QMessageLogContext(), u"late", 1);
+        QCOMPARE(writer.dropped(), 1u);
+    }
+
+    QFile file(logFile);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QBinaryLogReader reader(file.readAll());
+    QVERIFY(reader.isValid());
+    QCOMPARE(reader.entries().size(), 4);
+    for (const QBinaryLogReader::Entry &entry : reader.entries())
+        QCOMPARE(entry.category, entry.message.toLatin1());
+}
+
 Q_DECLARE_METATYPE(QtMsgType)
 
 void tst_qmessagehandler::formatLogMessage_data()
@@ -8,9 +8,14 @@
 #include <qdirlisting.h>
 #include <qfileinfo.h>
 #include <qstringlist.h>
+#include <QMutex>
+#include <QSemaphore>
 #include <QSet>
 #include <QString>
+#include <QTemporaryDir>
+#include <QThreadPool>
 
+#include <QtCore/private/qdirlisting_p.h>
 #include <QtCore/private/qfsfileengine_p.h>
 
 #if defined(Q_OS_VXWORKS)
@@ -90,6 +95,11 @@ private slots:
 
     void withStdAlgorithms();
 
+    void parallel_data() { iterateRelativeDirectory_data(); }
+    void parallel();
+    void parallelManyDirectories();
+    void parallelFromBusyPool();
+
 private:
     QSharedPointer<QTemporaryDir> m_dataDir;
 };
@@ -726,6 +736,112 @@ void tst_QDirListing::withStdAlgorithms()
     QCOMPARE(it->fileName(), fileName);
 }
 
+void tst_QDirListing::parallel()
+{
+    QFETCH(QString, dirName);
+    QFETCH(QDirListing::IteratorFlags, flags);
+    QFETCH(QStringList, nameFilters);
+
+    QStringList expected;
+    for (const auto &dirEntry : QDirListing(dirName, nameFilters, flags))
+        expected.emplace_back(dirEntry.absoluteFilePath());
+    expected.sort();
+
+    QMutex mutex;
+    QStringList list;
+    QtPrivate::forEachDirEntryParallel(dirName, nameFilters, flags,
+                                       [&](const QDirListing::DirEntry &dirEntry) {
+        const QString filePath = dirEntry.absoluteFilePath();
+        QMutexLocker locker(&mutex);
+        list.emplace_back(filePath);
+    });
+    list.sort();
+
+    QCOMPARE_EQ(list, expected);
+}
+
+void tst_QDirListing::parallelManyDirectories()
+{
+    QTemporaryDir tempDir;
+    QVERIFY2(tempDir.isValid(), qPrintable(tempDir.errorString()));
+
+    QStringList expected;
+    for (int i = 0; i < 20; ++i) {
+        const QString dir = tempDir.filePath(u"dir%1"_s.arg(i));
+        QVERIFY(QDir().mkdir(dir));
+        expected << dir;
+        for (int j = 0; j < 3; ++j) {
+            const QString subDir = dir + u"/sub%1"_s.arg(j);
+            QVERIFY(QDir().mkdir(subDir));
+            expected << subDir;
+            for (int k = 0; k < 10; ++k) {
+                const QString file = subDir + u"/file%1.txt"_s.arg(k);
+                QVERIFY(createFile(file));
+                expected << file;
+            }
+        }
+    }
+    expected.sort();
+
+    QThreadPool pool;
+    pool.setMaxThreadCount(4);
+    QMutex mutex;
+    QStringList list;
+    QtPrivate::forEachDirEntryParallel(tempDir.path(), {}, ItFlag::Recursive,
+                                       [&](const QDirListing::DirEntry &dirEntry) {
+        const QString filePath = dirEntry.filePath();
+        QMutexLocker locker(&mutex);
+        list.emplace_back(filePath);
+    }, &pool);
+    list.sort();
+    QCOMPARE_EQ(list, expected);
+
+    // Filters apply as usual, and don't stop the recursion
+    list.clear();
+    QtPrivate::forEachDirEntryParallel(tempDir.path(), { u"file1.*"_s },
+                                       ItFlag::Recursive | ItFlag::FilesOnly,
+                                       [&](const QDirListing::DirEntry &dirEntry) {
+        const QString fileName = dirEntry.fileName();
+        QMutexLocker locker(&mutex);
+        list.emplace_back(fileName);
+    }, &pool);
+    QCOMPARE(list.size(), 20 * 3);
+    QCOMPARE(QSet<QString>(list.cbegin(), list.cend()), QSet<QString>{ u"file1.txt"_s });
+}
+
+void tst_QDirListing::parallelFromBusyPool()
+{
+    QTemporaryDir tempDir;
+    QVERIFY2(tempDir.isValid(), qPrintable(tempDir.errorString()));
+    for (int i = 0; i < 10; ++i) {
+        const QString dir = tempDir.filePath(u"dir%1"_s.arg(i));
+        QVERIFY(QDir().mkdir(dir));
+        QVERIFY(QDir().mkdir(dir + u"/sub"_s));
+        QVERIFY(createFile(dir + u"/sub/file.txt"_s));
+    }
+
+    // Every thread of the pool lists, and there is none left to help out:
+    // the listings must not wait for threads that can't start.
+    constexpr int ThreadCount = 2;
+    QThreadPool pool;
+    pool.setMaxThreadCount(ThreadCount);
+    QSemaphore started;
+    QAtomicInt entries;
+    for (int i = 0; i < ThreadCount; ++i) {
+        pool.start([&] {
+            started.release();
+            started.acquire(ThreadCount);
+            started.release(ThreadCount);
+            QtPrivate::forEachDirEntryParallel(tempDir.path(), {}, ItFlag::Recursive,
+                                               [&](const QDirListing::DirEntry &) {
+                entries.ref();
+            }, &pool);
+        });
+    }
+    QVERIFY(pool.waitForDone(30000));
+    QCOMPARE(entries.loadRelaxed(), ThreadCount * 10 * 3);
+}
+
 QTEST_MAIN(tst_QDirListing)
 
 #include "tst_qdirlisting.moc"
@@ -15,6 +15,11 @@
 #include <QSignalSpy>
 #include <QTimer>
 #include <QTemporaryFile>
+#include <QThreadPool>
+#include <QSemaphore>
+
+#include <QtCore/private/qrecursivefilesystemwatcher_p.h>
+
 #if defined(Q_OS_WIN)
 #include <qt_windows.h>
 #endif
@@ -24,6 +29,9 @@
 #endif
 
 using namespace std::chrono_literals;
+using namespace Qt::StringLiterals;
+
+Q_DECLARE_METATYPE(QRecursiveFileSystemWatcher::Backend)
 
 #if defined(Q_OS_QNX)
 constexpr bool isQNX = true;
@@ -88,6 +96,13 @@ private slots:
     void watchDirectoryAttributeChanges();
 #endif
 
+    void recursiveWatcher_data();
+    void recursiveWatcher();
+    void recursiveWatcherWithBusyPool_data() { recursiveWatcher_data(); }
+    void recursiveWatcherWithBusyPool();
+    void recursiveWatcherNestedRoots_data() { recursiveWatcher_data(); }
+    void recursiveWatcherNestedRoots();
+
 private:
     QString m_tempDirPattern;
 };
@@ -864,5 +879,164 @@ void tst_QFileSystemWatcher::watchDirectoryAttributeChanges()
 }
 #endif
 
+static bool createFile(const QString &fileName)
+{
+    QFile file(fileName);
+    return file.open(QIODevice::WriteOnly);
+}
+
+void tst_QFileSystemWatcher::recursiveWatcher_data()
+{
+    using Backend = QRecursiveFileSystemWatcher::Backend;
+    QTest::addColumn<Backend>("backend");
+    QTest::newRow("default") << Backend::Fanotify;
+#ifdef Q_OS_LINUX
+    QTest::newRow("inotify") << Backend::Inotify;
+#endif
+    QTest::newRow("generic") << Backend::Generic;
+}
+
+void tst_QFileSystemWatcher::recursiveWatcher()
+{
+    using Backend = QRecursiveFileSystemWatcher::Backend;
+    QFETCH(Backend, backend);
+
+    QTemporaryDir temporaryDirectory(m_tempDirPattern);
+    QVERIFY2(temporaryDirectory.isValid(), qPrintable(temporaryDirectory.errorString()));
+    QDir testDir(temporaryDirectory.path());
+    QVERIFY(testDir.mkpath("a/b/c"));
+    const QString root = QFileInfo(testDir.path()).canonicalFilePath();
+
+    QRecursiveFileSystemWatcher watcher(backend);
+    watcher.setInterval(50ms);
+    QVERIFY(watcher.addPath(testDir.path()));
+    QVERIFY(!watcher.addPath(testDir.path()));
+    QCOMPARE(watcher.paths(), QStringList{ root });
+    if (watcher.backend() != Backend::Fanotify)
+        QCOMPARE(watcher.watchCount(), 4);
+
+    // The generic backend only knows which directory changed
+    const bool generic = watcher.backend() == Backend::Generic;
+
+    QStringList changed;
+    int batches = 0;
+    connect(&watcher, &QRecursiveFileSystemWatcher::pathsChanged,
+            this, [&](const QStringList &paths) {
+        ++batches;
+        changed += paths;
+    });
+
+    // A change deep down
+    QVERIFY(createFile(testDir.filePath("a/b/c/file.txt")));
+    QTRY_VERIFY(changed.contains(root + (generic ? u"/a/b/c"_s : u"/a/b/c/file.txt"_s)));
+
+    // In a new directory
+    changed.clear();
+    QVERIFY(testDir.mkdir("a/new"));
+    QVERIFY(createFile(testDir.filePath("a/new/inner.txt")));
+    QTRY_VERIFY(changed.contains(root + u"/a/new/inner.txt"_s)
+                || (generic && changed.contains(root + u"/a/new"_s)));
+    QVERIFY(createFile(testDir.filePath("a/new/later.txt")));
+    QTRY_VERIFY(changed.contains(root + (generic ? u"/a/new"_s : u"/a/new/later.txt"_s)));
+
+    // Changes next to the tree are not reported
+    QTemporaryDir otherDirectory(m_tempDirPattern);
+    QVERIFY2(otherDirectory.isValid(), qPrintable(otherDirectory.errorString()));
+    QVERIFY(createFile(QDir(otherDirectory.path()).filePath("outside.txt")));
+    QVERIFY(createFile(testDir.filePath("a/marker.txt")));
+    QTRY_VERIFY(changed.contains(root + (generic ? u"/a"_s : u"/a/marker.txt"_s)));
+    QVERIFY(changed.filter(u"outside"_s).isEmpty());
+
+    // Many changes come in few batches: at most one per interval
+    QTest::qWait(100ms);
+    changed.clear();
+    batches = 0;
+    constexpr int Count = 100;
+    QElapsedTimer timer;
+    timer.start();
+    for (int i = 0; i < Count; ++i)
+        QVERIFY(createFile(testDir.filePath(u"a/b/bulk%1"_s.arg(i))));
+    if (generic) {
+        QTRY_VERIFY(changed.contains(root + u"/a/b"_s));
+    } else {
+        QTRY_COMPARE(changed.filter(u"/bulk"_s).size(), Count);
+        QCOMPARE_LE(batches, timer.elapsed() / 50 + 1);
+    }
+
+    QVERIFY(watcher.removePath(testDir.path()));
+    QVERIFY(!watcher.removePath(testDir.path()));
+    QCOMPARE(watcher.watchCount(), 0);
+}
+
+void tst_QFileSystemWatcher::recursiveWatcherWithBusyPool()
+{
+    using Backend = QRecursiveFileSystemWatcher::Backend;
+    QFETCH(Backend, backend);
+
+    QTemporaryDir temporaryDirectory(m_tempDirPattern);
+    QVERIFY2(temporaryDirectory.isValid(), qPrintable(temporaryDirectory.errorString()));
+    QDir testDir(temporaryDirectory.path());
+    for (int i = 0; i < 10; ++i)
+        QVERIFY(testDir.mkpath(u"d%1/e/f"_s.arg(i)));
+
+    // Scanning the tree must not wait for pool threads that are all taken
+    QThreadPool *pool = QThreadPool::globalInstance();
+    QSemaphore started, release;
+    const int threads = pool->maxThreadCount();
+    for (int i = 0; i < threads; ++i) {
+        pool->start([&] {
+            started.release();
+            release.acquire();
+        });
+    }
+    started.acquire(threads);
+
+    QRecursiveFileSystemWatcher watcher(backend);
+    const bool added = watcher.addPath(testDir.path());
+    release.release(threads);
+    pool->waitForDone();
+    QVERIFY(added);
+    if (watcher.backend() != Backend::Fanotify)
+        QCOMPARE(watcher.watchCount(), 31);
+}
+
+void tst_QFileSystemWatcher::recursiveWatcherNestedRoots()
+{
+    using Backend = QRecursiveFileSystemWatcher::Backend;
+    QFETCH(Backend, backend);
+
+    QTemporaryDir temporaryDirectory(m_tempDirPattern);
+    QVERIFY2(temporaryDirectory.isValid(), qPrintable(temporaryDirectory.errorString()));
+    QDir testDir(temporaryDirectory.path());
+    QVERIFY(testDir.mkpath("a/b/c"));
+    const QString root = QFileInfo(testDir.path()).canonicalFilePath();
+
+    QRecursiveFileSystemWatcher watcher(backend);
+    watcher.setInterval(50ms);
+    QVERIFY(watcher.addPath(testDir.filePath("a")));
+    QVERIFY(watcher.addPath(testDir.filePath("a/b")));
+    const bool generic = watcher.backend() == Backend::Generic;
+
+    QStringList changed;
+    connect(&watcher, &QRecursiveFileSystemWatcher::pathsChanged,
+            this, [&](const QStringList &paths) { changed += paths; });
+
+    // The tree of the remaining directory is still watched
+    QVERIFY(watcher.removePath(testDir.filePath("a")));
+    QCOMPARE(watcher.paths(), QStringList{ root + u"/a/b"_s });
+    if (watcher.backend() != Backend::Fanotify)
+        QCOMPARE(watcher.watchCount(), 2);
+    QVERIFY(createFile(testDir.filePath("a/b/c/file.txt")));
+    QTRY_VERIFY(changed.contains(root + (generic ? u"/a/b/c"_s : u"/a/b/c/file.txt"_s)));
+
+    // What is only in the removed one is not
+    changed.clear();
+    QVERIFY(createFile(testDir.filePath("a/outside.txt")));
+    QVERIFY(createFile(testDir.filePath("a/b/marker.txt")));
+    QTRY_VERIFY(changed.contains(root + (generic ? u"/a/b"_s : u"/a/b/marker.txt"_s)));
+    QVERIFY(changed.filter(u"outside"_s).isEmpty());
+    QVERIFY(!changed.contains(root + u"/a"_s));
+}
+
 QTEST_MAIN(tst_QFileSystemWatcher)
 #include "tst_qfilesystemwatcher.moc"
@@ -29,6 +29,7 @@ private slots:
     void readLine2();
 
     void readAllKeepPosition();
+    void readAllPendingSequential();
     void writeInTextMode();
     void skip_data();
     void skip();
@@ -581,6 +582,47 @@ void tst_QIODevice::readAllKeepPosition()
     QCOMPARE(resultArray, buffer.buffer());
 }
 
+// Sequential device that keeps its data in a backend buffer, like QLocalSocket
+class PendingDataDevice : public QIODevice
+{
+public:
+    PendingDataDevice(const QByteArray &data) : QIODevice(), pending(data) { }
+
+    bool isSequential() const override { return true; }
+    qint64 bytesAvailable() const override
+    { return QIODevice::bytesAvailable() + pending.size(); }
+
+    int readDataCalls = 0;
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override
+    {
+        ++readDataCalls;
+        maxSize = qMin(maxSize, qint64(pending.size()));
+        memcpy(data, pending.constData(), maxSize);
+        pending.remove(0, maxSize);
+        return maxSize;
+    }
+    qint64 writeData(const char *, qint64) override { return -1; }
+
+private:
+    QByteArray pending;
+};
+
+// Test that readAll() sizes its first read by what the device reports as pending
+void tst_QIODevice::readAllPendingSequential()
+{
+    const QByteArray data(1024 * 1024, 'q');
+    PendingDataDevice device(data);
+    QVERIFY(device.open(QIODevice::ReadOnly));
+    QCOMPARE(device.bytesAvailable(), data.size());
+
+    QCOMPARE(device.readAll(), data);
+    // One read for the payload and one to detect that nothing more is pending
+    QCOMPARE(device.readDataCalls, 2);
+    QCOMPARE(device.bytesAvailable(), 0);
+}
+
 class RandomAccessBuffer : public QIODevice
 {
 public:
@@ -201,6 +201,9 @@ private slots:
     void testReadKeys_data();
     void testReadKeys();
 
+    void binaryFormat();
+    void binaryFormatRecovery();
+
 private:
     void cleanupTestFiles();
 
@@ -3730,5 +3733,117 @@ void tst_QSettings::testReadKeys()
     QCOMPARE(readValues, expectedValues);
 }
 
+void tst_QSettings::binaryFormat()
+{
+    const QSettings::Format format = QtPrivate::binarySettingsFormat();
+    QVERIFY(format != QSettings::InvalidFormat);
+    QCOMPARE(QtPrivate::binarySettingsFormat(), format);
+
+    const QString fileName = settingsPath("binary.qsbin");
+    {
+        QSettings settings(fileName, format);
+        QCOMPARE(settings.format(), format);
+        QVERIFY(settings.isWritable());
+        settings.setValue("alpha", 1);
+        settings.setValue("beta/gamma", "text");
+        settings.setValue("beta/delta", QStringList{ "a", "b" });
+        settings.setValue("beta/epsilon/zeta", QByteArray("\0\1\2", 3));
+
+        // visible to other objects before it is written
+        QSettings other(fileName, format);
+        QCOMPARE(other.value("beta/gamma").toString(), "text");
+    }
+    {
+        QSettings settings(fileName, format);
+        QCOMPARE(settings.status(), QSettings::NoError);
+        QCOMPARE(settings.value("alpha").toInt(), 1);
+        QCOMPARE(settings.value("beta/gamma").toString(), "text");
+        QCOMPARE(settings.value("beta/delta").toStringList(), QStringList({ "a", "b" }));
+        QCOMPARE(settings.value("beta/epsilon/zeta").toByteArray(), QByteArray("\0\1\2", 3));
+        QCOMPARE(settings.allKeys(),
+                 QStringList({ "alpha", "beta/delta", "beta/epsilon/zeta", "beta/gamma" }));
+        settings.beginGroup("beta");
+        QCOMPARE(settings.childKeys(), QStringList({ "delta", "gamma" }));
+        QCOMPARE(settings.childGroups(), QStringList{ "epsilon" });
+        settings.endGroup();
+
+        // small changes are appended rather than rewriting the file
+        const qint64 size = QFileInfo(fileName).size();
+        settings.setValue("alpha", 2);
+        settings.remove("beta");
+        settings.sync();
+        QCOMPARE(settings.status(), QSettings::NoError);
+        QVERIFY(QFileInfo(fileName).size() > size);
+        QCOMPARE(settings.allKeys(), QStringList{ "alpha" });
+    }
+    {
+        QSettings settings(fileName, format);
+        QCOMPARE(settings.value("alpha").toInt(), 2);
+        QVERIFY(!settings.contains("beta/gamma"));
+
+        // compaction keeps the log from growing forever
+        for (int i = 0; i < 1000; ++i) {
+            settings.setValue("blob", QByteArray(1024, char('a' + i % 26)));
+            settings.sync();
+        }
+        QCOMPARE(settings.status(), QSettings::NoError);
+        QVERIFY(QFileInfo(fileName).size() < 256 * 1024);
+        QCOMPARE(settings.value("blob").toByteArray(), QByteArray(1024, char('a' + 999 % 26)));
+        QCOMPARE(settings.value("alpha").toInt(), 2);
+
+        settings.clear();
+        settings.sync();
+        QVERIFY(settings.allKeys().isEmpty());
+    }
+    {
+        QSettings org(format, QSettings::UserScope, "software.org");
+        org.setValue("shared", "org");
+        QSettings app(format, QSettings::UserScope, "software.org", "KillerAPP");
+        QVERIFY(app.fileName().endsWith(".qsbin"));
+        QCOMPARE(app.value("shared").toString(), "org");
+        app.setFallbacksEnabled(false);
+        QVERIFY(!app.contains("shared"));
+    }
+}
+
+void tst_QSettings::binaryFormatRecovery()
+{
+    const QSettings::Format format = QtPrivate::binarySettingsFormat();
+    const QString fileName = settingsPath("recovery.qsbin");
+    {
+        QSettings settings(fileName, format);
+        settings.setValue("kept", 1);
+        settings.sync();
+        settings.setValue("torn", 2);
+    }
+
+    // simulate a crash while the last record was being appended
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadWrite));
+    QVERIFY(file.resize(file.size() - 5));
+    file.close();
+
+    {
+        QSettings settings(fileName, format);
+        QCOMPARE(settings.status(), QSettings::NoError);
+        QCOMPARE(settings.value("kept").toInt(), 1);
+        QVERIFY(!settings.contains("torn"));
+        settings.setValue("after", 3);
+    }
+    {
+        QSettings settings(fileName, format);
+        QCOMPARE(settings.status(), QSettings::NoError);
+        QCOMPARE(settings.value("kept").toInt(), 1);
+        QCOMPARE(settings.value("after").toInt(), 3);
+    }
+
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("[General]\nkey=value\n");
+    file.close();
+    QSettings settings(fileName, format);
+    QCOMPARE(settings.status(), QSettings::FormatError);
+    QVERIFY(settings.allKeys().isEmpty());
+}
+
 QTEST_MAIN(tst_QSettings)
 #include "tst_qsettings.moc"
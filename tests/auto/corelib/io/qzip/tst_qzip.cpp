@@ -4,10 +4,15 @@
 #include <QTest>
 #include <QDebug>
 #include <QBuffer>
+#include <QRandomGenerator>
+#include <QRegularExpression>
+#include <QtEndian>
 
 #include <private/qzipwriter_p.h>
 #include <private/qzipreader_p.h>
 
+#include <QtCore/private/qglobal_p.h>
+
 class tst_QZip : public QObject
 {
     Q_OBJECT
@@ -17,8 +22,50 @@ private slots:
     void symlinks();
     void readTest();
     void createArchive();
+    void openFile();
+    void zip64();
+    void wrongSize();
+    void parallelCompression();
+    void sequentialSource();
+    void sequentialSourceAutoCompress();
+    void zstd();
+};
+
+// Serves data that cannot be seeked in, like a pipe or a socket
+class SequentialDevice : public QIODevice
+{
+public:
+    explicit SequentialDevice(const QByteArray &data) : data(data) { open(QIODevice::ReadOnly); }
+
+    bool isSequential() const override { return true; }
+    qint64 bytesAvailable() const override
+    { return data.size() - offset + QIODevice::bytesAvailable(); }
+
+protected:
+    qint64 readData(char *dest, qint64 maxSize) override
+    {
+        const qsizetype n = qMin<qsizetype>(maxSize, data.size() - offset);
+        memcpy(dest, data.constData() + offset, n);
+        offset += n;
+        return n;
+    }
+    qint64 writeData(const char *, qint64) override { return -1; }
+
+private:
+    QByteArray data;
+    qsizetype offset = 0;
 };
 
+static QByteArray testContents(int size, int seed)
+{
+    QByteArray data;
+    data.reserve(size);
+    for (int i = 0; data.size() < size; ++i)
+        data += QByteArray::number(i * seed) + ' ';
+    data.truncate(size);
+    return data;
+}
+
 void tst_QZip::basicUnpack()
 {
     QZipReader zip(QFINDTESTDATA("/testdata/test.zip"), QIODevice::ReadOnly);
@@ -112,5 +159,222 @@ void tst_QZip::createArchive()
     QCOMPARE(zip2.fileData("My Filename"), fileContents);
 }
 
+void tst_QZip::openFile()
+{
+    const QByteArray contents = testContents(300000, 7);
+    QBuffer buffer;
+    {
+        QZipWriter zip(&buffer);
+        zip.addFile("stored", "not compressed");
+        zip.addFile("large", contents);
+    }
+    QBuffer buffer2(&buffer.buffer());
+    QZipReader zip(&buffer2);
+    QVERIFY(!zip.openFile("missing"));
+
+    // interleaving reads of two entries must not confuse them
+    const std::unique_ptr<QIODevice> large = zip.openFile("large");
+    const std::unique_ptr<QIODevice> stored = zip.openFile("stored");
+    QVERIFY(large);
+    QVERIFY(stored);
+    QVERIFY(large->isSequential());
+    QCOMPARE_GT(large->bytesAvailable(), 0);
+    QCOMPARE_LE(large->bytesAvailable(), contents.size());
+    QByteArray read;
+    char chunk[1000];
+    qint64 n;
+    while ((n = large->read(chunk, sizeof(chunk))) > 0) {
+        read.append(chunk, n);
+        if (read.size() == 3000)
+            QCOMPARE(stored->readAll(), QByteArray("not compressed"));
+    }
+    QCOMPARE(n, 0);
+    QCOMPARE(read, contents);
+    QVERIFY(large->atEnd());
+
+    // a corrupt entry is reported, not silently truncated
+    QByteArray corrupt = buffer.buffer();
+    const qsizetype dataStart = corrupt.indexOf("large") + 5 + 1000;
+    corrupt[dataStart] = char(corrupt[dataStart] ^ 0x55);
+    QBuffer buffer3(&corrupt);
+    QZipReader zip3(&buffer3);
+    const std::unique_ptr<QIODevice> broken = zip3.openFile("large");
+    QVERIFY(broken);
+    QTest::ignoreMessage(QtWarningMsg, QRegularExpression("^QZip: "));
+    while (broken->read(chunk, sizeof(chunk)) > 0)
+        ;
+    QVERIFY(!broken->errorString().isEmpty());
+}
+
+void tst_QZip::zip64()
+{
+    // all sizes, offsets and counts are in the ZIP64 fields
+    QZipReader zip(QFINDTESTDATA("/testdata/zip64.zip"), QIODevice::ReadOnly);
+    const QList<QZipReader::FileInfo> files = zip.fileInfoList();
+    QCOMPARE(files.size(), 2);
+    QCOMPARE(files.at(0).filePath, QString("zip64.txt"));
+    QCOMPARE(files.at(0).size, 160);
+    QCOMPARE(files.at(1).filePath, QString("stored.txt"));
+    QCOMPARE(files.at(1).size, 23);
+    QCOMPARE(zip.fileData("zip64.txt"), QByteArray("This archive uses the ZIP64 extensions.\n").repeated(4));
+    QCOMPARE(zip.fileData("stored.txt"), QByteArray("stored, not compressed\n"));
+
+    // more entries than the original format can count
+    QBuffer buffer;
+    {
+        QZipWriter writer(&buffer);
+        writer.setCompressionPolicy(QZipWriter::NeverCompress);
+        for (int i = 0; i < 0x10000; ++i)
+            writer.addFile(QString::number(i), QByteArray());
+        writer.addFile("last", "the end");
+    }
+    QBuffer buffer2(&buffer.buffer());
+    QZipReader reader(&buffer2);
+    QCOMPARE(reader.count(), 0x10001);
+    QCOMPARE(reader.fileData("last"), QByteArray("the end"));
+}
+
+void tst_QZip::wrongSize()
+{
+    QFile file(QFINDTESTDATA("/testdata/zip64.zip"));
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray archive = file.readAll();
+    const QByteArray contents = QByteArray("This archive uses the ZIP64 extensions.\n").repeated(4);
+
+    // the uncompressed size of zip64.txt, in the ZIP64 extra field of its central header
+    const qsizetype centralHeader = archive.indexOf("PK\x01\x02");
+    QVERIFY(centralHeader > 0);
+    const qsizetype sizeOffset = archive.indexOf(QByteArrayView("\x01\x00\x18\x00", 4),
+                                                 centralHeader) + 4;
+    QCOMPARE_GT(sizeOffset, centralHeader);
+
+    // neither a much too big size nor a too small one are trusted
+    for (const quint64 size : { Q_UINT64_C(1) << 40, quint64(100) }) {
+        QByteArray wrong = archive;
+        qToLittleEndian(size, wrong.data() + sizeOffset);
+        QBuffer buffer(&wrong);
+        QZipReader zip(&buffer);
+        QCOMPARE(quint64(zip.entryInfoAt(0).size), size);
+
+        const std::unique_ptr<QIODevice> entry = zip.openFile("zip64.txt");
+        QVERIFY(entry);
+        QCOMPARE_LE(entry->bytesAvailable(), 64 * 1024);
+        QTest::ignoreMessage(QtWarningMsg, "QZip: The checksum or the size of the entry does not match");
+        QCOMPARE(entry->readAll(), contents);
+        QVERIFY(!entry->errorString().isEmpty());
+
+        QTest::ignoreMessage(QtWarningMsg, "QZip: The checksum or the size of the entry does not match");
+        QCOMPARE(zip.fileData("zip64.txt"), contents);
+    }
+}
+
+void tst_QZip::parallelCompression()
+{
+    QList<QByteArray> contents;
+    QBuffer buffer;
+    {
+        QZipWriter zip(&buffer);
+        zip.setCompressionPolicy(QZipWriter::AutoCompress);
+        for (int i = 0; i < 40; ++i) {
+            // mix entries that are compressed on other threads with small ones
+            contents.append(testContents(i % 3 ? 100000 + i : 10, i + 1));
+            zip.addFile(QString::number(i), contents.last());
+        }
+        // incompressible, so it is stored
+        QByteArray random(100000, Qt::Uninitialized);
+        for (char &c : random)
+            c = char(QRandomGenerator::global()->generate());
+        contents.append(random);
+        zip.addFile("random", random);
+    }
+
+    QBuffer buffer2(&buffer.buffer());
+    QZipReader zip(&buffer2);
+    const QList<QZipReader::FileInfo> files = zip.fileInfoList();
+    QCOMPARE(files.size(), contents.size());
+    for (int i = 0; i < 40; ++i) {
+        QCOMPARE(files.at(i).filePath, QString::number(i));
+        QCOMPARE(zip.fileData(QString::number(i)), contents.at(i));
+    }
+    QCOMPARE(zip.fileData("random"), contents.last());
+    QVERIFY(buffer.size() < 40 * 100000);
+}
+
+void tst_QZip::sequentialSource()
+{
+    const QByteArray contents = testContents(500000, 3);
+    SequentialDevice source(contents);
+    QBuffer buffer;
+    {
+        QZipWriter zip(&buffer);
+        zip.addFile("before", "first");
+        zip.addFile("streamed", &source);
+        zip.addFile("after", "last");
+    }
+    QCOMPARE(buffer.buffer().indexOf(contents.left(100)), -1);
+
+    QBuffer buffer2(&buffer.buffer());
+    QZipReader zip(&buffer2);
+    const QList<QZipReader::FileInfo> files = zip.fileInfoList();
+    QCOMPARE(files.size(), 3);
+    QCOMPARE(files.at(1).filePath, QString("streamed"));
+    QCOMPARE(files.at(1).size, contents.size());
+    QCOMPARE(zip.fileData("before"), QByteArray("first"));
+    QCOMPARE(zip.fileData("streamed"), contents);
+    QCOMPARE(zip.fileData("after"), QByteArray("last"));
+}
+
+void tst_QZip::sequentialSourceAutoCompress()
+{
+    QByteArray random(200000, Qt::Uninitialized);
+    QRandomGenerator(42).fillRange(reinterpret_cast<quint32 *>(random.data()),
+                                   random.size() / sizeof(quint32));
+    const QByteArray compressible = testContents(200000, 3);
+    SequentialDevice smallSource("tiny");
+    SequentialDevice randomSource(random);
+    SequentialDevice compressibleSource(compressible);
+    QBuffer buffer;
+    {
+        QZipWriter zip(&buffer);
+        zip.setCompressionPolicy(QZipWriter::AutoCompress);
+        zip.addFile("small", &smallSource);
+        zip.addFile("random", &randomSource);
+        zip.addFile("compressible", &compressibleSource);
+    }
+    // stored entries appear verbatim in the archive
+    QVERIFY(buffer.buffer().contains("tiny"));
+    QVERIFY(buffer.buffer().contains(random));
+    QCOMPARE(buffer.buffer().indexOf(compressible.left(100)), -1);
+
+    QBuffer buffer2(&buffer.buffer());
+    QZipReader zip(&buffer2);
+    QCOMPARE(zip.fileData("small"), QByteArray("tiny"));
+    QCOMPARE(zip.fileData("random"), random);
+    QCOMPARE(zip.fileData("compressible"), compressible);
+}
+
+void tst_QZip::zstd()
+{
+#if !QT_CONFIG(zstd)
+    QSKIP("Zstandard support is disabled");
+#else
+    const QByteArray contents = testContents(200000, 5);
+    const QByteArray streamed = testContents(100000, 11);
+    SequentialDevice source(streamed);
+    QBuffer buffer;
+    {
+        QZipWriter zip(&buffer);
+        zip.setCompressionAlgorithm(QZipWriter::Zstandard);
+        QCOMPARE(zip.compressionAlgorithm(), QZipWriter::Zstandard);
+        zip.addFile("file", contents);
+        zip.addFile("streamed", &source);
+    }
+    QBuffer buffer2(&buffer.buffer());
+    QZipReader zip(&buffer2);
+    QCOMPARE(zip.fileData("file"), contents);
+    QCOMPARE(zip.fileData("streamed"), streamed);
+#endif
+}
+
 QTEST_MAIN(tst_QZip)
 #include "tst_qzip.moc"
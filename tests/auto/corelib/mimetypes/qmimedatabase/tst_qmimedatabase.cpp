@@ -48,6 +48,7 @@ static const std::array additionalLocalMimeFiles = {
     "invalid-magic2.xml",
     "invalid-magic3.xml",
     "magic-and-hierarchy.xml",
+    "magic-index.xml",
     "circular-inheritance.xml",
     "webm-glob-deleteall.xml",
 };
@@ -1274,6 +1275,29 @@ void tst_QMimeDatabase::installNewLocalMimeType_data()
     QTest::newRow("without_binary_cache") << false;
 }
 
+// See magic-index.xml
+static void checkMagicRules(const QMimeDatabase &db)
+{
+    const std::pair<QByteArray, QLatin1StringView> dataAndMimeType[] = {
+        { "QTMAGICEQUAL", "application/x-magic-equal-a"_L1 },
+        { "12345678QTMAGICOFFSET", "application/x-magic-offset"_L1 },
+        { "QTMAGICOFFSET", "text/plain"_L1 },
+        { "QTMAGICRANGE", "application/x-magic-range"_L1 },
+        { "abcdeQTMAGICRANGE", "application/x-magic-range"_L1 },
+        { "xTMAGICMASK", "application/x-magic-mask"_L1 },
+        { "ZTMAGICMASK", "application/x-magic-mask"_L1 },
+        { "QTMAGICPRIORITY", "application/x-magic-priority-high"_L1 },
+        { "QM31", "application/x-magic-big32"_L1 },
+        { "QM32", "application/x-magic-little32"_L1 },
+        { "abcdQ6", "application/x-magic-big16"_L1 },
+        { "abcdQ7", "application/x-magic-little16"_L1 },
+        { "QM34", "application/x-magic-masked32"_L1 },
+        { "ZM34", "application/x-magic-masked32"_L1 },
+    };
+    for (const auto &[data, mimeType] : dataAndMimeType)
+        QCOMPARE(db.mimeTypeForData(data).name(), mimeType);
+}
+
 void tst_QMimeDatabase::installNewLocalMimeType()
 {
 #if !QT_CONFIG(process)
@@ -1350,6 +1374,10 @@ void tst_QMimeDatabase::installNewLocalMimeType()
             : QStringList{ "*.jpg", "*.jpeg", "*.jpe", "*.jif", "*.jfif", "*.jfi", "*.jnewext" };
     QCOMPARE(db.mimeTypeForName(QStringLiteral("image/jpeg")).globPatterns(), expectedJpegPatterns);
 
+    checkMagicRules(db);
+    if (QTest::currentTestFailed())
+        return;
+
     // Now that we have two directories with mime definitions, check that everything still works
     inheritance();
     if (QTest::currentTestFailed())
@@ -1387,6 +1415,9 @@ void tst_QMimeDatabase::installNewLocalMimeType()
     QFile::remove(m_localMimeDir + QString::fromLatin1("/mime.cache"));
     QVERIFY(!db.mimeTypeForName(QLatin1String("text/invalid-magic1")).isValid()); // deleted
     QVERIFY(db.mimeTypeForName(QLatin1String("text/x-suse-ymp")).isValid()); // still present
+    checkMagicRules(db);
+    if (QTest::currentTestFailed())
+        return;
 
     // Finally, the user deletes the whole local dir
     QVERIFY2(QDir(m_localMimeDir).removeRecursively(), qPrintable(m_localMimeDir + ": " + qt_error_string()));
@@ -5,9 +5,14 @@
 #include <QtCore/qdir.h>
 #include <QtCore/qfileinfo.h>
 #include <QtCore/qplugin.h>
+#include <QtCore/qstandardpaths.h>
+#include <QtCore/qtemporarydir.h>
 #include <QtCore/qversionnumber.h>
 #include <private/qfactoryloader_p.h>
 #include <private/qlibrary_p.h>
+#if QT_CONFIG(library) && defined(Q_OS_UNIX)
+#  include <private/qpluginmetadatacache_p.h>
+#endif
 #include "plugin1/plugininterface1.h"
 #include "plugin2/plugininterface2.h"
 
@@ -21,6 +26,10 @@ class tst_QFactoryLoader : public QObject
     Q_OBJECT
 
     QString binFolder;
+public:
+    // keep the plugin metadata cache out of the user's cache directory
+    static void initMain() { QStandardPaths::setTestModeEnabled(true); }
+
 public slots:
     void initTestCase();
 
@@ -28,6 +37,7 @@ private slots:
     void usingTwoFactoriesFromSameDir();
     void extraSearchPath();
     void multiplePaths();
+    void metaDataCache();
     void staticPlugin_data();
     void staticPlugin();
 };
@@ -173,6 +183,86 @@ void tst_QFactoryLoader::multiplePaths()
 #endif
 }
 
+void tst_QFactoryLoader::metaDataCache()
+{
+#if !QT_CONFIG(library) || !defined(Q_OS_UNIX) || defined(Q_OS_ANDROID)
+    QSKIP("Test not applicable in this configuration.");
+#else
+    QVERIFY(QStandardPaths::isTestModeEnabled());
+    QTemporaryDir dir;
+    QVERIFY(dir.isValid());
+
+    const QStringList plugins = QDir(binFolder).entryList({ "*plugin1*" }, QDir::Files);
+    QVERIFY(!plugins.isEmpty());
+    const QString pluginFile = dir.filePath(plugins.constFirst());
+    QVERIFY(QFile::copy(QDir(binFolder).filePath(plugins.constFirst()), pluginFile));
+    const QString otherFile = dir.filePath("notaplugin.so");
+    {
+        QFile file(otherFile);
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write("This is not a plugin");
+    }
+
+    const QString cacheFile = QPluginMetaDataCache::cacheFilePath(dir.path());
+    QVERIFY(!cacheFile.isEmpty());
+    QFile::remove(cacheFile);
+
+    // scans the directory, through the cache
+    auto scan = [&dir] {
+        QFactoryLoader loader(PluginInterface1_iid, "/nonexistent");
+        loader.setExtraSearchPath(dir.path());
+        const QFactoryLoader::MetaDataList list = loader.metaData();
+        return list.size() == 1
+                && list.constFirst().value(QtPluginMetaDataKeys::IID) == PluginInterface1_iid;
+    };
+
+    QByteArrayView metaData;
+    {
+        // nothing cached yet
+        QPluginMetaDataCache cache(dir.path());
+        QCOMPARE(cache.find(pluginFile, &metaData), QPluginMetaDataCache::Result::Miss);
+    }
+    QVERIFY(scan());
+    QVERIFY(QFile::exists(cacheFile));
+
+    {
+        QPluginMetaDataCache cache(dir.path());
+        QCOMPARE(cache.find(pluginFile, &metaData), QPluginMetaDataCache::Result::Plugin);
+        QVERIFY(!metaData.isEmpty());
+        QCOMPARE(cache.find(otherFile, &metaData), QPluginMetaDataCache::Result::NotAPlugin);
+        QVERIFY(!metaData.isEmpty());
+    }
+    // answered from the cache
+    QVERIFY(scan());
+
+    // a file that changed is scanned again
+    {
+        QFile file(otherFile);
+        QVERIFY(file.open(QIODevice::Append));
+        file.write(", still not");
+    }
+    {
+        QPluginMetaDataCache cache(dir.path());
+        QCOMPARE(cache.find(otherFile, &metaData), QPluginMetaDataCache::Result::Miss);
+        QCOMPARE(cache.find(pluginFile, &metaData), QPluginMetaDataCache::Result::Plugin);
+    }
+
+    // a file that can't be read now is not remembered as not being a plugin
+    const QString unreadableFile = dir.filePath("unreadable.so");
+    QVERIFY(QFile::copy(otherFile, unreadableFile));
+    QVERIFY(QFile::setPermissions(unreadableFile, {}));
+    if (QFile file(unreadableFile); file.open(QIODevice::ReadOnly)) {
+        qInfo("Can't make a file unreadable, skipping part of the test");
+    } else {
+        QVERIFY(scan());
+        QPluginMetaDataCache cache(dir.path());
+        QCOMPARE(cache.find(unreadableFile, &metaData), QPluginMetaDataCache::Result::Miss);
+        QCOMPARE(cache.find(otherFile, &metaData), QPluginMetaDataCache::Result::NotAPlugin);
+    }
+    QFile::remove(cacheFile);
+#endif
+}
+
 Q_IMPORT_PLUGIN(StaticPlugin1)
 Q_IMPORT_PLUGIN(StaticPlugin2)
 constexpr bool IsDebug =
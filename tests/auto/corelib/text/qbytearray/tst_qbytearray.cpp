@@ -44,6 +44,9 @@ private slots:
     void base64();
     void fromBase64_data();
     void fromBase64();
+    void base64BlockBoundaries();
+    void fromBase64InvalidInsideBlock_data();
+    void fromBase64InvalidInsideBlock();
 #if QT_DEPRECATED_SINCE(6, 9)
     void qvsnprintf();
 #endif
@@ -88,6 +91,8 @@ private slots:
     void resizeAfterFromRawData();
     void toFromHex_data();
     void toFromHex();
+    void hexBlockBoundaries();
+    void fromHexInvalidInsideBlock();
     void toFromPercentEncoding();
     void fromPercentEncoding_data();
     void fromPercentEncoding();
@@ -685,6 +690,129 @@ void tst_QByteArray::fromBase64()
     }
 }
 
+// Byte-at-a-time reference implementations, to check the vectorized codecs
+// against. The SIMD paths work on blocks of 12 or 16 bytes (Base64) and 16 or
+// 32 characters (hex), so the interesting sizes are those around multiples of
+// these.
+static QByteArray referenceBase64(const QByteArray &data, bool url)
+{
+    const char *alphabet = url
+            ? "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789-_"
+            : "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+    QByteArray result;
+    for (qsizetype i = 0; i < data.size(); i += 3) {
+        uint chunk = uchar(data.at(i)) << 16;
+        if (i + 1 < data.size())
+            chunk |= uchar(data.at(i + 1)) << 8;
+        if (i + 2 < data.size())
+            chunk |= uchar(data.at(i + 2));
+        result += alphabet[(chunk >> 18) & 0x3f];
+        result += alphabet[(chunk >> 12) & 0x3f];
+        result += i + 1 < data.size() ? alphabet[(chunk >> 6) & 0x3f] : '=';
+        result += i + 2 < data.size() ? alphabet[chunk & 0x3f] : '=';
+    }
+    return result;
+}
+
+static QByteArray blockTestData(qsizetype size)
+{
+    QByteArray data(size, Qt::Uninitialized);
+    for (qsizetype i = 0; i < size; ++i)
+        data[i] = char(i * 37 + 11);
+    return data;
+}
+
+void tst_QByteArray::base64BlockBoundaries()
+{
+    for (qsizetype size = 0; size <= 100; ++size) {
+        const QByteArray data = blockTestData(size);
+        for (bool url : { false, true }) {
+            const auto encoding = url ? QByteArray::Base64UrlEncoding
+                                      : QByteArray::Base64Encoding;
+            const QByteArray expected = referenceBase64(data, url);
+            const QByteArray encoded = data.toBase64(encoding);
+            QVERIFY2(encoded == expected,
+                     qPrintable(u"size %1, url %2"_s.arg(size).arg(url)));
+
+            auto result = QByteArray::fromBase64Encoding(
+                        encoded, encoding | QByteArray::AbortOnBase64DecodingErrors);
+            QVERIFY2(result, qPrintable(u"size %1, url %2"_s.arg(size).arg(url)));
+            QCOMPARE(result.decoded, data);
+
+            // the other alphabet's characters must not be accepted
+            if (encoded.contains(url ? '-' : '+') || encoded.contains(url ? '_' : '/')) {
+                const auto other = url ? QByteArray::Base64Encoding
+                                       : QByteArray::Base64UrlEncoding;
+                result = QByteArray::fromBase64Encoding(
+                            encoded, other | QByteArray::AbortOnBase64DecodingErrors);
+                QVERIFY(!result);
+                QCOMPARE(result.decodingStatus, QByteArray::Base64DecodingStatus::IllegalCharacter);
+            }
+        }
+    }
+}
+
+void tst_QByteArray::fromBase64InvalidInsideBlock_data()
+{
+    QTest::addColumn<char>("invalid");
+    QTest::addColumn<qsizetype>("position");
+    QTest::addColumn<QByteArray::Base64DecodingStatus>("status");
+
+    // 48 bytes encode to 64 characters: four full 16-character blocks
+    for (qsizetype position : { 0, 1, 7, 14, 15, 16, 17, 31, 32, 40, 47, 48, 62 }) {
+        QTest::addRow("character-at-%lld", qlonglong(position))
+                << '!' << position << QByteArray::Base64DecodingStatus::IllegalCharacter;
+        QTest::addRow("newline-at-%lld", qlonglong(position))
+                << '\n' << position << QByteArray::Base64DecodingStatus::IllegalCharacter;
+        QTest::addRow("high-bit-at-%lld", qlonglong(position))
+                << '\xc3' << position << QByteArray::Base64DecodingStatus::IllegalCharacter;
+        QTest::addRow("padding-at-%lld", qlonglong(position))
+                << '=' << position << QByteArray::Base64DecodingStatus::IllegalPadding;
+    }
+}
+
+void tst_QByteArray::fromBase64InvalidInsideBlock()
+{
+    QFETCH(char, invalid);
+    QFETCH(qsizetype, position);
+    QFETCH(QByteArray::Base64DecodingStatus, status);
+
+    const QByteArray data = blockTestData(48);
+    QByteArray encoded = data.toBase64();
+    QCOMPARE(encoded.size(), 64);
+    const char replaced = encoded.at(position);
+    encoded[position] = invalid;
+
+    auto result = QByteArray::fromBase64Encoding(
+                encoded, QByteArray::Base64Encoding | QByteArray::AbortOnBase64DecodingErrors);
+    QVERIFY(!result);
+    QCOMPARE(result.decodingStatus, status);
+    QVERIFY(result.decoded.isEmpty());
+
+    // in-place decoding must not leave partially decoded blocks behind either
+    QByteArray copy = encoded;
+    copy.detach();
+    result = QByteArray::fromBase64Encoding(
+                std::move(copy), QByteArray::Base64Encoding | QByteArray::AbortOnBase64DecodingErrors);
+    QVERIFY(!result);
+    QCOMPARE(result.decodingStatus, status);
+    QVERIFY(result.decoded.isEmpty());
+
+    // Without AbortOnBase64DecodingErrors, the invalid character is skipped,
+    // which is the same as decoding the input without it.
+    QByteArray skipped = encoded;
+    skipped.remove(position, 1);
+    const QByteArray expected = QByteArray::fromBase64(skipped);
+    result = QByteArray::fromBase64Encoding(encoded);
+    QVERIFY(result);
+    QCOMPARE(result.decoded, expected);
+    QCOMPARE(QByteArray::fromBase64(encoded), expected);
+
+    // and putting the character back in an extra position decodes the original
+    encoded.insert(position, replaced);
+    QCOMPARE(QByteArray::fromBase64(encoded), data);
+}
+
 #if QT_DEPRECATED_SINCE(6, 9)
 QT_WARNING_PUSH
 QT_WARNING_DISABLE_DEPRECATED
@@ -1868,6 +1996,61 @@ void tst_QByteArray::toFromHex()
     QCOMPARE(QByteArray::fromHex(hex_alt1), str);
 }
 
+static QByteArray referenceFromHex(const QByteArray &hex)
+{
+    QByteArray digits;
+    for (char ch : hex) {
+        if (QtMiscUtils::fromHex(uchar(ch)) != -1)
+            digits += ch;
+    }
+    if (digits.size() % 2)
+        digits.prepend('0');
+    QByteArray result;
+    for (qsizetype i = 0; i < digits.size(); i += 2) {
+        result += char(QtMiscUtils::fromHex(uchar(digits.at(i))) << 4
+                       | QtMiscUtils::fromHex(uchar(digits.at(i + 1))));
+    }
+    return result;
+}
+
+void tst_QByteArray::hexBlockBoundaries()
+{
+    for (qsizetype size = 0; size <= 70; ++size) {
+        const QByteArray data = blockTestData(size);
+        QByteArray expected;
+        for (char ch : data) {
+            expected += QtMiscUtils::toHexLower(uchar(ch) >> 4);
+            expected += QtMiscUtils::toHexLower(uchar(ch) & 0xf);
+        }
+        const QByteArray hex = data.toHex();
+        QVERIFY2(hex == expected, qPrintable(u"size %1"_s.arg(size)));
+        QCOMPARE(QByteArray::fromHex(hex), data);
+        QCOMPARE(QByteArray::fromHex(hex.toUpper()), data);
+
+        // an odd number of digits: the first one stands on its own
+        QCOMPARE(QByteArray::fromHex('f' + hex), referenceFromHex('f' + hex));
+    }
+}
+
+void tst_QByteArray::fromHexInvalidInsideBlock()
+{
+    // 48 bytes encode to 96 digits: three full 32-digit blocks
+    const QByteArray hex = blockTestData(48).toHex();
+    for (char invalid : { 'g', 'G', ' ', '/', ':', '@', '`', '\xc3' }) {
+        for (qsizetype position = 0; position < hex.size(); ++position) {
+            QByteArray replaced = hex;
+            replaced[position] = invalid;
+            QVERIFY2(QByteArray::fromHex(replaced) == referenceFromHex(replaced),
+                     qPrintable(u"character 0x%1 at %2"_s.arg(uchar(invalid), 0, 16).arg(position)));
+
+            QByteArray inserted = hex;
+            inserted.insert(position, invalid);
+            QVERIFY2(QByteArray::fromHex(inserted) == referenceFromHex(hex),
+                     qPrintable(u"character 0x%1 before %2"_s.arg(uchar(invalid), 0, 16).arg(position)));
+        }
+    }
+}
+
 void tst_QByteArray::toFromPercentEncoding()
 {
     QByteArray arr("Qt is great!");
@@ -9,6 +9,7 @@
 #include <QDebug>
 #include <QDir>
 #include <QFileInfo>
+#include <QRandomGenerator>
 #include <qnumeric.h>
 #if QT_CONFIG(process)
 #  include <QProcess>
@@ -91,6 +92,7 @@ private slots:
 
     void doubleRoundTrip_data();
     void doubleRoundTrip();
+    void doubleShortestRoundTrip();
     void integerRoundTrip_data();
     void integerRoundTrip();
     void negativeNumbers();
@@ -2655,6 +2657,59 @@ void tst_QLocale::doubleRoundTrip()
     QCOMPARE(locale.toString(number, numberFormat), numberText);
 }
 
+void tst_QLocale::doubleShortestRoundTrip()
+{
+    // Exercises both the fast paths and the fallbacks of parsing and of
+    // shortest formatting, which must agree.
+    const QLocale c = QLocale::c();
+    QRandomGenerator rng(4711);
+    for (int i = 0; i < 20000; ++i) {
+        const quint64 bits = rng.generate64();
+        double number;
+        memcpy(&number, &bits, sizeof number);
+        if (!qIsFinite(number))
+            continue;
+
+        const QString shortest = QString::number(number, 'g', QLocale::FloatingPointShortest);
+        bool ok = false;
+        QCOMPARE(shortest.toDouble(&ok), number);
+        QVERIFY(ok);
+        QCOMPARE(c.toDouble(shortest, &ok), number);
+        QVERIFY(ok);
+        if (!shortest.startsWith(u'-')) {
+            QCOMPARE(c.toDouble(u'+' + shortest, &ok), number);
+            QVERIFY(ok);
+        }
+        QCOMPARE(c.toDouble(u' ' + shortest.toUpper() + u' ', &ok), number);
+        QVERIFY(ok);
+
+        const QString exponent = QString::number(number, 'e', QLocale::FloatingPointShortest);
+        QCOMPARE(exponent.toDouble(&ok), number);
+        QVERIFY(ok);
+        QCOMPARE(QByteArray::number(number, 'g', QLocale::FloatingPointShortest), shortest.toLatin1());
+    }
+
+    bool ok = true;
+    QCOMPARE(c.toDouble(u"1e-400", &ok), 0.0);
+    QVERIFY(!ok);
+    QCOMPARE(c.toDouble(u"-1e400", &ok), -qInf());
+    QVERIFY(!ok);
+    QCOMPARE(c.toDouble(u"0e-400", &ok), 0.0);
+    QVERIFY(ok);
+    QCOMPARE(c.toDouble(u"1.2.3", &ok), 0.0);
+    QVERIFY(!ok);
+    QCOMPARE(c.toDouble(u"1e2e3", &ok), 0.0);
+    QVERIFY(!ok);
+    QCOMPARE(c.toDouble(u"+-1", &ok), 0.0);
+    QVERIFY(!ok);
+    QCOMPARE(c.toLongLong(u"1.0", &ok), 0);
+    QVERIFY(!ok);
+    QCOMPARE(c.toLongLong(u"-1234", &ok), -1234);
+    QVERIFY(ok);
+    QCOMPARE(QString::number(-0.0, 'g', QLocale::FloatingPointShortest), u"0");
+    QCOMPARE(QString::number(5e-324, 'g', QLocale::FloatingPointShortest), u"5e-324");
+}
+
 void tst_QLocale::integerRoundTrip_data()
 {
     QTest::addColumn<QString>("localeName");
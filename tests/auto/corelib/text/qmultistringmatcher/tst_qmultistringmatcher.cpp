@@ -0,0 +1,224 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QTest>
+#include <QRandomGenerator>
+
+#include <QtCore/private/qmultistringmatcher_p.h>
+
+using namespace Qt::StringLiterals;
+
+using Match = QMultiMatcherBase::Match;
+
+QT_BEGIN_NAMESPACE
+namespace QTest {
+template <>
+char *toString(const Match &m)
+{
+    return qstrdup(QByteArray("Match(" + QByteArray::number(m.position) + ", "
+                              + QByteArray::number(m.length) + ", "
+                              + QByteArray::number(m.pattern) + ')').constData());
+}
+}
+QT_END_NAMESPACE
+
+class tst_QMultiStringMatcher : public QObject
+{
+    Q_OBJECT
+private slots:
+    void byteArray_data();
+    void byteArray();
+    void string_data();
+    void string();
+    void overlapsAndDuplicates();
+    void indexIn();
+    void empty();
+    void compareWithIndexOf_data();
+    void compareWithIndexOf();
+};
+
+void tst_QMultiStringMatcher::byteArray_data()
+{
+    QTest::addColumn<QByteArrayList>("patterns");
+    QTest::addColumn<Qt::CaseSensitivity>("cs");
+    QTest::addColumn<QByteArray>("haystack");
+    QTest::addColumn<QList<Match>>("matches");
+
+    const QByteArrayList keywords = { "error", "warn", "fatal" };
+    QTest::newRow("none") << keywords << Qt::CaseSensitive << QByteArray("all is fine")
+                          << QList<Match>();
+    QTest::newRow("one") << keywords << Qt::CaseSensitive << QByteArray("an error occurred")
+                         << QList<Match>{ { 3, 5, 0 } };
+    QTest::newRow("several") << keywords << Qt::CaseSensitive
+                             << QByteArray("warn: fatal error, more warnings")
+                             << QList<Match>{ { 0, 4, 1 }, { 6, 5, 2 }, { 12, 5, 0 },
+                                              { 24, 4, 1 } };
+    QTest::newRow("case-sensitive") << keywords << Qt::CaseSensitive
+                                    << QByteArray("ERROR Error error")
+                                    << QList<Match>{ { 12, 5, 0 } };
+    QTest::newRow("case-insensitive") << keywords << Qt::CaseInsensitive
+                                      << QByteArray("ERROR Error error")
+                                      << QList<Match>{ { 0, 5, 0 }, { 6, 5, 0 }, { 12, 5, 0 } };
+    // only ASCII letters are folded
+    QTest::newRow("latin1") << QByteArrayList{ "\xe9t\xe9" } << Qt::CaseInsensitive
+                            << QByteArray("\xc9T\xc9 \xe9T\xe9")
+                            << QList<Match>{ { 4, 3, 0 } };
+    QTest::newRow("binary") << QByteArrayList{ QByteArray("\0\1", 2), "\xff" }
+                            << Qt::CaseSensitive << QByteArray("a\0\1\xff", 4)
+                            << QList<Match>{ { 1, 2, 0 }, { 3, 1, 1 } };
+
+    // many start bytes, so there is no prefilter
+    QByteArrayList many;
+    for (char c = 'a'; c <= 'z'; ++c)
+        many << QByteArray(2, c);
+    QTest::newRow("many") << many << Qt::CaseSensitive << QByteArray("xaazzz")
+                          << QList<Match>{ { 1, 2, 0 }, { 3, 2, 25 }, { 4, 2, 25 } };
+    // a long haystack, so the prefilter is used for more than one block
+    QTest::newRow("long") << keywords << Qt::CaseSensitive
+                          << QByteArray(100, '.') + "fatal" + QByteArray(37, ' ') + "error"
+                          << QList<Match>{ { 100, 5, 2 }, { 142, 5, 0 } };
+}
+
+void tst_QMultiStringMatcher::byteArray()
+{
+    QFETCH(QByteArrayList, patterns);
+    QFETCH(Qt::CaseSensitivity, cs);
+    QFETCH(QByteArray, haystack);
+    QFETCH(QList<Match>, matches);
+
+    const QMultiByteArrayMatcher matcher(patterns, cs);
+    QCOMPARE(matcher.patternCount(), patterns.size());
+    QCOMPARE(matcher.caseSensitivity(), cs);
+    QCOMPARE(matcher.findAll(haystack), matches);
+    QCOMPARE(matcher.indexIn(haystack), matches.value(0));
+}
+
+void tst_QMultiStringMatcher::string_data()
+{
+    QTest::addColumn<QStringList>("patterns");
+    QTest::addColumn<Qt::CaseSensitivity>("cs");
+    QTest::addColumn<QString>("haystack");
+    QTest::addColumn<QList<Match>>("matches");
+
+    const QStringList keywords = { u"Fehler"_s, u"Größe"_s, u"ошибка"_s };
+    QTest::newRow("none") << keywords << Qt::CaseSensitive << u"alles gut"_s << QList<Match>();
+    QTest::newRow("case-sensitive") << keywords << Qt::CaseSensitive
+                                    << u"FEHLER, Fehler; GRÖßE Größe"_s
+                                    << QList<Match>{ { 8, 6, 0 }, { 22, 5, 1 } };
+    QTest::newRow("case-insensitive") << keywords << Qt::CaseInsensitive
+                                      << u"FEHLER, GRÖßE, ОШИБКА"_s
+                                      << QList<Match>{ { 0, 6, 0 }, { 8, 5, 1 }, { 15, 6, 2 } };
+    QTest::newRow("surrogates") << QStringList{ u"\U0001F600"_s } << Qt::CaseSensitive
+                                << u"a\U0001F600b\U0001F601"_s
+                                << QList<Match>{ { 1, 2, 0 } };
+}
+
+void tst_QMultiStringMatcher::string()
+{
+    QFETCH(QStringList, patterns);
+    QFETCH(Qt::CaseSensitivity, cs);
+    QFETCH(QString, haystack);
+    QFETCH(QList<Match>, matches);
+
+    const QMultiStringMatcher matcher(patterns, cs);
+    QCOMPARE(matcher.findAll(haystack), matches);
+    QCOMPARE(matcher.indexIn(haystack), matches.value(0));
+}
+
+void tst_QMultiStringMatcher::overlapsAndDuplicates()
+{
+    const QMultiByteArrayMatcher matcher({ "he", "she", "his", "hers", "she" });
+    QCOMPARE(matcher.findAll("ushers"),
+             (QList<Match>{ { 1, 3, 1 }, { 1, 3, 4 }, { 2, 2, 0 }, { 2, 4, 3 } }));
+
+    const QMultiStringMatcher stringMatcher({ u"aa"_s, u"a"_s });
+    QCOMPARE(stringMatcher.findAll(u"aaa"),
+             (QList<Match>{ { 0, 1, 1 }, { 0, 2, 0 }, { 1, 1, 1 }, { 1, 2, 0 }, { 2, 1, 1 } }));
+}
+
+void tst_QMultiStringMatcher::indexIn()
+{
+    const QMultiByteArrayMatcher matcher({ "abcd", "bc" });
+    // the match that ends first wins
+    QCOMPARE(matcher.indexIn("abcd"), (Match{ 1, 2, 1 }));
+    QCOMPARE(matcher.indexIn("abcd", 2), Match());
+    QCOMPARE(matcher.indexIn("abcd bc", 2), (Match{ 5, 2, 1 }));
+    QCOMPARE(matcher.indexIn("abcd", -3), (Match{ 1, 2, 1 }));
+    QCOMPARE(matcher.indexIn("abcd", 10), Match());
+    QCOMPARE(matcher.findAll("abcdbc", 1), (QList<Match>{ { 1, 2, 1 }, { 4, 2, 1 } }));
+}
+
+void tst_QMultiStringMatcher::empty()
+{
+    const QMultiByteArrayMatcher defaultConstructed;
+    QCOMPARE(defaultConstructed.patternCount(), 0);
+    QVERIFY(!defaultConstructed.indexIn("abc").isValid());
+    QVERIFY(defaultConstructed.findAll("abc").isEmpty());
+
+    const QMultiStringMatcher noPatterns(QStringList{});
+    QVERIFY(!noPatterns.indexIn(u"abc").isValid());
+
+    const QMultiByteArrayMatcher emptyPattern({ "", "b" });
+    QCOMPARE(emptyPattern.patternCount(), 2);
+    QCOMPARE(emptyPattern.findAll("abc"), (QList<Match>{ { 1, 1, 1 } }));
+    QVERIFY(!emptyPattern.indexIn("").isValid());
+}
+
+void tst_QMultiStringMatcher::compareWithIndexOf_data()
+{
+    QTest::addColumn<int>("patternCount");
+    QTest::addColumn<int>("alphabetSize");
+    QTest::addColumn<Qt::CaseSensitivity>("cs");
+
+    QTest::newRow("few") << 3 << 4 << Qt::CaseSensitive;
+    QTest::newRow("few-ci") << 3 << 4 << Qt::CaseInsensitive;
+    QTest::newRow("many") << 200 << 26 << Qt::CaseSensitive;
+    QTest::newRow("many-ci") << 200 << 26 << Qt::CaseInsensitive;
+}
+
+void tst_QMultiStringMatcher::compareWithIndexOf()
+{
+    QFETCH(int, patternCount);
+    QFETCH(int, alphabetSize);
+    QFETCH(Qt::CaseSensitivity, cs);
+
+    QRandomGenerator rng(patternCount);
+    const auto randomText = [&](int length) {
+        QString s;
+        for (int i = 0; i < length; ++i) {
+            const QChar c = QChar(u'a' + rng.bounded(alphabetSize));
+            s += rng.bounded(2) ? c.toUpper() : c;
+        }
+        return s;
+    };
+
+    QStringList patterns;
+    for (int i = 0; i < patternCount; ++i)
+        patterns << randomText(1 + rng.bounded(5));
+    const QString haystack = randomText(5000);
+
+    const QMultiStringMatcher matcher(patterns, cs);
+    const QMultiByteArrayMatcher byteMatcher(QStringList(patterns).join(u'\n').toLatin1().split('\n'),
+                                             cs);
+    QList<Match> found = matcher.findAll(haystack);
+    QCOMPARE(byteMatcher.findAll(haystack.toLatin1()), found);
+
+    // every pattern match must be found, and nothing else
+    QList<Match> expected;
+    for (qsizetype p = 0; p < patterns.size(); ++p) {
+        for (qsizetype i = haystack.indexOf(patterns.at(p), 0, cs); i >= 0;
+             i = haystack.indexOf(patterns.at(p), i + 1, cs)) {
+            expected.append({ i, patterns.at(p).size(), p });
+        }
+    }
+    const auto order = [](const Match &lhs, const Match &rhs) {
+        return std::tie(lhs.position, lhs.length, lhs.pattern)
+                < std::tie(rhs.position, rhs.length, rhs.pattern);
+    };
+    std::sort(expected.begin(), expected.end(), order);
+    std::sort(found.begin(), found.end(), order);
+    QCOMPARE(found, expected);
+}
+
+QTEST_APPLESS_MAIN(tst_QMultiStringMatcher)
+#include "tst_qmultistringmatcher.moc"
@@ -12,7 +12,10 @@
 #include <qobject.h>
 #include <qregularexpression.h>
 #include <qthread.h>
+#include <qrandom.h>
+#include <QtCore/private/qregularexpressionset_p.h>
 
+#include <atomic>
 #include <iostream>
 #include <optional>
 
@@ -24,6 +27,8 @@ Q_DECLARE_METATYPE(QRegularExpression::PatternOptions)
 Q_DECLARE_METATYPE(QRegularExpression::MatchType)
 Q_DECLARE_METATYPE(QRegularExpression::MatchOptions)
 
+using namespace Qt::StringLiterals;
+
 class tst_QRegularExpression : public QObject
 {
     Q_OBJECT
@@ -75,6 +80,9 @@ private slots:
     void wildcard();
     void testInvalidWildcard_data();
     void testInvalidWildcard();
+    void sharedCompiledPattern();
+    void regularExpressionSet_data();
+    void regularExpressionSet();
 
 private:
     void provideRegularExpressions();
@@ -2582,6 +2590,139 @@ void tst_QRegularExpression::testInvalidWildcard()
     QCOMPARE(re.isValid(), isValid);
 }
 
+void tst_QRegularExpression::sharedCompiledPattern()
+{
+    // compiled patterns are cached and shared; objects with the same pattern
+    // must still behave independently
+    QRegularExpression re1(u"(?<word>\\w+) (\\d+)"_s);
+    QRegularExpression re2(u"(?<word>\\w+) (\\d+)"_s);
+    QVERIFY(re1.isValid());
+    QVERIFY(re2.isValid());
+    QCOMPARE(re2.captureCount(), 2);
+    QCOMPARE(re2.namedCaptureGroups(), QStringList({ QString(), u"word"_s, QString() }));
+
+    re1.setPatternOptions(QRegularExpression::CaseInsensitiveOption);
+    re2.setPattern(u"[a-z]+"_s);
+    QCOMPARE(re1.match(u"abc 42"_s).captured(u"word"), u"abc");
+    QCOMPARE(re2.match(u"ABC abc"_s).capturedStart(), 4);
+    QCOMPARE(re2.captureCount(), 0);
+
+    // errors are cached as well
+    QRegularExpression invalid1(u"a(b"_s);
+    QRegularExpression invalid2(u"a(b"_s);
+    QVERIFY(!invalid1.isValid());
+    QVERIFY(!invalid2.isValid());
+    QCOMPARE(invalid2.errorString(), invalid1.errorString());
+    QCOMPARE(invalid2.patternErrorOffset(), invalid1.patternErrorOffset());
+
+    // compiling the same pattern in many threads at once
+    const QString pattern = u"shared-(\\d+)-%1"_s.arg(QRandomGenerator::global()->generate());
+    const QString subject = u"x shared-123-"_s + pattern.section(u'-', -1);
+    std::atomic<int> failures = 0;
+    QList<QThread *> threads;
+    for (int i = 0; i < 8; ++i) {
+        threads.append(QThread::create([&] {
+            for (int j = 0; j < 100; ++j) {
+                QRegularExpression re(pattern);
+                if (re.match(subject).captured(1) != u"123")
+                    ++failures;
+            }
+        }));
+        threads.last()->start();
+    }
+    for (QThread *thread : std::as_const(threads))
+        thread->wait();
+    qDeleteAll(threads);
+    QCOMPARE(failures.load(), 0);
+}
+
+void tst_QRegularExpression::regularExpressionSet_data()
+{
+    QTest::addColumn<QStringList>("patterns");
+    QTest::addColumn<QRegularExpression::PatternOptions>("options");
+    QTest::addColumn<QString>("subject");
+    QTest::addColumn<QList<qsizetype>>("matches");
+
+    const QStringList levels = { u"\\berror\\b"_s, u"warn(ing)?"_s, u"^fatal:"_s, u"\\d{3}"_s };
+    QTest::newRow("none") << levels << QRegularExpression::PatternOptions() << u"all fine"_s
+                          << QList<qsizetype>();
+    QTest::newRow("one") << levels << QRegularExpression::PatternOptions()
+                         << u"an error occurred"_s << QList<qsizetype>{ 0 };
+    QTest::newRow("several") << levels << QRegularExpression::PatternOptions()
+                             << u"warning: error 404"_s << QList<qsizetype>{ 0, 1, 3 };
+    QTest::newRow("anchors") << levels << QRegularExpression::PatternOptions()
+                             << u"not fatal: errors"_s << QList<qsizetype>();
+    QTest::newRow("options") << levels << QRegularExpression::PatternOptions(
+                                          QRegularExpression::CaseInsensitiveOption)
+                             << u"FATAL: ERROR"_s << QList<qsizetype>{ 0, 2 };
+    QTest::newRow("multiline") << levels << QRegularExpression::PatternOptions(
+                                            QRegularExpression::MultilineOption)
+                               << u"ok\nfatal: x"_s << QList<qsizetype>{ 2 };
+    QTest::newRow("overlapping") << QStringList{ u"ab"_s, u"bc"_s, u"abc"_s, u"c$"_s }
+                                 << QRegularExpression::PatternOptions() << u"xabc"_s
+                                 << QList<qsizetype>{ 0, 1, 2, 3 };
+    // must not swallow the following alternatives
+    QTest::newRow("unterminated-quote") << QStringList{ u"\\Q(a"_s, u"b"_s }
+                                        << QRegularExpression::PatternOptions() << u"b"_s
+                                        << QList<qsizetype>{ 1 };
+    QTest::newRow("extended-comment") << QStringList{ u"a # comment"_s, u"b"_s }
+                                      << QRegularExpression::PatternOptions(
+                                                 QRegularExpression::ExtendedPatternSyntaxOption)
+                                      << u"xb"_s << QList<qsizetype>{ 1 };
+    QTest::newRow("inline-options") << QStringList{ u"(?i)a"_s, u"b"_s }
+                                    << QRegularExpression::PatternOptions() << u"AB"_s
+                                    << QList<qsizetype>{ 0 };
+    QTest::newRow("same-group-names") << QStringList{ u"(?<x>a)"_s, u"(?<x>b)"_s }
+                                      << QRegularExpression::PatternOptions() << u"b"_s
+                                      << QList<qsizetype>{ 1 };
+    // matched one by one
+    QTest::newRow("backreference") << QStringList{ u"(a)\\1"_s, u"(b)\\1"_s, u"c"_s }
+                                   << QRegularExpression::PatternOptions() << u"abbc"_s
+                                   << QList<qsizetype>{ 1, 2 };
+    QTest::newRow("recursion") << QStringList{ u"x"_s, u"\\((?:[^()]|(?R))*\\)"_s }
+                               << QRegularExpression::PatternOptions() << u"(a(b))"_s
+                               << QList<qsizetype>{ 1 };
+    QTest::newRow("verbs") << QStringList{ u"a(*ACCEPT)b"_s, u"(*UCP)\\w"_s, u"z"_s }
+                           << QRegularExpression::PatternOptions() << u"aé"_s
+                           << QList<qsizetype>{ 0, 1 };
+    QTest::newRow("invalid") << QStringList{ u"a("_s, u"b"_s }
+                             << QRegularExpression::PatternOptions() << u"ab"_s
+                             << QList<qsizetype>{ 1 };
+    QTest::newRow("empty-subject") << QStringList{ u"^$"_s, u"a"_s }
+                                   << QRegularExpression::PatternOptions() << QString()
+                                   << QList<qsizetype>{ 0 };
+    // On its own, the first pattern fails right away, since the subject
+    // contains no 'b'. In the combined pattern, that check doesn't apply, so
+    // it backtracks until it hits the match limit, before the second pattern
+    // is ever tried.
+    QTest::newRow("match-limit") << QStringList{ u"(?:a|a)+b"_s, u"z"_s }
+                                 << QRegularExpression::PatternOptions()
+                                 << QString(u"a"_s.repeated(40) + u'z')
+                                 << QList<qsizetype>{ 1 };
+}
+
+void tst_QRegularExpression::regularExpressionSet()
+{
+    QFETCH(QStringList, patterns);
+    QFETCH(QRegularExpression::PatternOptions, options);
+    QFETCH(QString, subject);
+    QFETCH(QList<qsizetype>, matches);
+
+    const QRegularExpressionSet set(patterns, options);
+    QCOMPARE(set.size(), patterns.size());
+    QCOMPARE(set.match(subject), matches);
+    QCOMPARE(set.hasMatch(subject), !matches.isEmpty());
+
+    bool allValid = true;
+    for (qsizetype i = 0; i < patterns.size(); ++i) {
+        const QRegularExpression re(patterns.at(i), options);
+        QCOMPARE(set.regularExpression(i), re);
+        QCOMPARE(re.match(subject).hasMatch(), matches.contains(i));
+        allValid = allValid && re.isValid();
+    }
+    QCOMPARE(set.isValid(), allValid);
+}
+
 QTEST_APPLESS_MAIN(tst_QRegularExpression)
 
 #include "tst_qregularexpression.moc"
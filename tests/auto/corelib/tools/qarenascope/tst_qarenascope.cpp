@@ -0,0 +1,143 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QTest>
+#include <QtCore/QList>
+#include <QtCore/QString>
+#include <QtCore/private/qarenascope_p.h>
+
+#include <algorithm>
+#include <cstring>
+#include <map>
+#include <optional>
+#include <thread>
+#include <vector>
+
+class tst_QArenaScope : public QObject
+{
+    Q_OBJECT
+private slots:
+    void currentScope();
+    void allocations();
+    void escapingData();
+    void copiesLeaveTheScope();
+    void qtContainersUseTheHeap();
+};
+
+template <typename T>
+using ArenaVector = std::vector<T, QArenaAllocator<T>>;
+
+void tst_QArenaScope::currentScope()
+{
+    QCOMPARE(QArenaScope::current(), nullptr);
+    QCOMPARE(QArenaAllocator<int>().arenaScope(), nullptr);
+    {
+        QArenaScope outer;
+        QCOMPARE(QArenaScope::current(), &outer);
+        {
+            QArenaScope inner;
+            QCOMPARE(QArenaScope::current(), &inner);
+            QCOMPARE(QArenaAllocator<int>().arenaScope(), &inner);
+        }
+        QCOMPARE(QArenaScope::current(), &outer);
+
+        // other threads don't see the scope
+        QArenaScope *otherThreadsScope = &outer;
+        std::thread([&] { otherThreadsScope = QArenaScope::current(); }).join();
+        QCOMPARE(otherThreadsScope, nullptr);
+    }
+    QCOMPARE(QArenaScope::current(), nullptr);
+}
+
+void tst_QArenaScope::allocations()
+{
+    QArenaScope scope;
+    std::vector<void *> pointers;
+    for (size_t size : { 0, 1, 7, 16, 100, 1000, 16 * 1024, 16 * 1024 + 1, 1024 * 1024 }) {
+        void *ptr = scope.allocate(size);
+        QVERIFY(ptr);
+        QCOMPARE(quintptr(ptr) % alignof(std::max_align_t), quintptr(0));
+        memset(ptr, 0x55, size);
+        QVERIFY(std::find(pointers.begin(), pointers.end(), ptr) == pointers.end());
+        pointers.push_back(ptr);
+        QArenaScope::deallocate(ptr, size);
+    }
+
+    // fill several blocks
+    ArenaVector<QString> strings;
+    std::map<int, int, std::less<int>, QArenaAllocator<std::pair<const int, int>>> map;
+    for (int i = 0; i < 10000; ++i) {
+        strings.push_back(QString::number(i));
+        map.emplace(i, -i);
+    }
+    QCOMPARE(map.size(), size_t(10000));
+    for (int i = 0; i < 10000; ++i) {
+        QCOMPARE(strings[i], QString::number(i));
+        QCOMPARE(map.at(i), -i);
+    }
+}
+
+void tst_QArenaScope::escapingData()
+{
+    std::optional<ArenaVector<int>> escaped;
+    std::optional<ArenaVector<QString>> otherThread;
+    {
+        QArenaScope scope;
+        escaped.emplace();
+        for (int i = 0; i < 1000; ++i)
+            escaped->push_back(i);
+        QCOMPARE(escaped->get_allocator().arenaScope(), &scope);
+        otherThread.emplace(100, QStringLiteral("abc"));
+    }
+
+    // memory from the scope stays valid, also when freed elsewhere
+    for (int i = 0; i < 1000; ++i)
+        QCOMPARE(escaped->at(i), i);
+    std::thread([v = std::move(otherThread)] { QCOMPARE(v->back(), u"abc"); }).join();
+    escaped.reset();
+}
+
+void tst_QArenaScope::copiesLeaveTheScope()
+{
+    std::optional<ArenaVector<int>> original;
+    {
+        QArenaScope scope;
+        original.emplace(100, 42);
+        QCOMPARE(original->get_allocator().arenaScope(), &scope);
+        {
+            QArenaScope inner;
+            ArenaVector<int> innerCopy = *original;
+            QCOMPARE(innerCopy.get_allocator().arenaScope(), &inner);
+        }
+    }
+
+    // copies made after the scope is gone don't use it
+    ArenaVector<int> copy = *original;
+    QCOMPARE(copy.get_allocator().arenaScope(), nullptr);
+    copy.resize(10000, 1);
+    QCOMPARE(copy.front(), 42);
+    QCOMPARE(copy.back(), 1);
+}
+
+void tst_QArenaScope::qtContainersUseTheHeap()
+{
+    // QArrayData is freed by inline code with free(), so the scope must not
+    // hand out its storage
+    QString string;
+    QList<int> list;
+    {
+        QArenaScope scope;
+        void *ptr = scope.allocate(16);
+        const quintptr block = quintptr(ptr) & ~quintptr(64 * 1024 - 1);
+        string = QString(100, u'a');
+        list.resize(100);
+        QCOMPARE_NE(quintptr(string.constData()) & ~quintptr(64 * 1024 - 1), block);
+        QCOMPARE_NE(quintptr(list.constData()) & ~quintptr(64 * 1024 - 1), block);
+        QArenaScope::deallocate(ptr, 16);
+    }
+    QCOMPARE(string, QString(100, u'a'));
+    QCOMPARE(list.size(), 100);
+}
+
+QTEST_APPLESS_MAIN(tst_QArenaScope)
+#include "tst_qarenascope.moc"
@@ -0,0 +1,220 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QTest>
+
+#include <QtCore/private/qconcurrentcache_p.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace Qt::StringLiterals;
+
+class tst_QConcurrentCache : public QObject
+{
+    Q_OBJECT
+private slots:
+    void basics();
+    void maxCost();
+    void evictionSparesRecentlyUsed();
+    void take();
+    void statistics();
+    void evictedObjectStaysAlive();
+    void concurrentAccess();
+};
+
+struct Counted
+{
+    static std::atomic<int> count;
+    explicit Counted(int v = 0) : value(v) { ++count; }
+    ~Counted() { --count; }
+    int value;
+};
+std::atomic<int> Counted::count = 0;
+
+void tst_QConcurrentCache::basics()
+{
+    {
+        QConcurrentCache<int, Counted> cache(100, 4);
+        QVERIFY(cache.isEmpty());
+        QCOMPARE(cache.maxCost(), 100);
+
+        for (int i = 0; i < 10; ++i)
+            QVERIFY(cache.insert(i, new Counted(i), 2));
+        QCOMPARE(cache.size(), 10);
+        QCOMPARE(cache.totalCost(), 20);
+        QCOMPARE(Counted::count.load(), 10);
+
+        for (int i = 0; i < 10; ++i) {
+            QVERIFY(cache.contains(i));
+            QCOMPARE(cache.object(i)->value, i);
+        }
+        QVERIFY(!cache.object(10));
+
+        // replacing an object deletes the old one
+        QVERIFY(cache.insert(3, new Counted(33)));
+        QCOMPARE(cache.object(3)->value, 33);
+        QCOMPARE(Counted::count.load(), 10);
+        QCOMPARE(cache.totalCost(), 19);
+
+        QVERIFY(cache.remove(3));
+        QVERIFY(!cache.remove(3));
+        QCOMPARE(Counted::count.load(), 9);
+
+        cache.clear();
+        QVERIFY(cache.isEmpty());
+        QCOMPARE(Counted::count.load(), 0);
+
+        QVERIFY(cache.insert(1, new Counted(1)));
+    }
+    QCOMPARE(Counted::count.load(), 0);
+}
+
+void tst_QConcurrentCache::maxCost()
+{
+    QConcurrentCache<int, Counted> cache(64, 4);
+
+    // too expensive for the cache
+    QVERIFY(!cache.insert(0, new Counted, 65));
+    QCOMPARE(Counted::count.load(), 0);
+    // but not for any single shard: the cost is shared between them
+    for (int i = 0; i < 16; ++i) {
+        QVERIFY(cache.insert(i, new Counted(i), 64));
+        QVERIFY(cache.contains(i));
+        QCOMPARE(cache.size(), 1);
+        QCOMPARE(cache.totalCost(), 64);
+    }
+    QVERIFY(cache.insert(0, new Counted, 48));
+
+    for (int i = 0; i < 1000; ++i) {
+        QVERIFY(cache.insert(i, new Counted(i)));
+        QVERIFY(cache.totalCost() <= cache.maxCost());
+    }
+    QCOMPARE(cache.size(), 64);
+    // the most recently inserted object is never evicted right away
+    QVERIFY(cache.contains(999));
+
+    cache.setMaxCost(8);
+    QVERIFY(cache.totalCost() <= 8);
+    QCOMPARE(Counted::count.load(), int(cache.size()));
+
+    cache.clear();
+    QCOMPARE(Counted::count.load(), 0);
+}
+
+void tst_QConcurrentCache::evictionSparesRecentlyUsed()
+{
+    constexpr int Count = 400;
+    constexpr int Recent = 20;
+    QConcurrentCache<int, Counted> cache(Count, 4);
+    for (int i = 0; i < Count; ++i)
+        QVERIFY(cache.insert(i, new Counted(i)));
+    QCOMPARE(cache.size(), Count);
+
+    // use a few objects, which are spread over all shards
+    for (int i = 0; i < Recent; ++i)
+        QVERIFY(cache.object(i));
+
+    // overflowing the cache by much, and then by little, evicts colder
+    // objects, wherever they are
+    QVERIFY(cache.insert(Count, new Counted(Count), Count / 2));
+    QVERIFY(cache.totalCost() <= cache.maxCost());
+    for (int i = Count + 1; i < Count + 20; ++i) {
+        QVERIFY(cache.insert(i, new Counted(i)));
+        QVERIFY(cache.totalCost() <= cache.maxCost());
+    }
+    QVERIFY(cache.contains(Count));
+    for (int i = 0; i < Recent; ++i)
+        QVERIFY2(cache.contains(i), QByteArray::number(i).constData());
+    QCOMPARE(Counted::count.load(), int(cache.size()));
+
+    cache.clear();
+    QCOMPARE(Counted::count.load(), 0);
+}
+
+void tst_QConcurrentCache::take()
+{
+    QConcurrentCache<QString, Counted> cache;
+    QVERIFY(cache.insert(u"a"_s, new Counted(1)));
+    QSharedPointer<Counted> a = cache.take(u"a"_s);
+    QVERIFY(a);
+    QCOMPARE(a->value, 1);
+    QVERIFY(!cache.contains(u"a"_s));
+    QVERIFY(!cache.take(u"a"_s));
+    QCOMPARE(Counted::count.load(), 1);
+    a.reset();
+    QCOMPARE(Counted::count.load(), 0);
+}
+
+void tst_QConcurrentCache::statistics()
+{
+    QConcurrentCache<int, int> cache;
+    cache.insert(1, new int(1));
+    QVERIFY(cache.object(1));
+    QVERIFY(cache.object(1));
+    QVERIFY(!cache.object(2));
+    // contains() doesn't count
+    QVERIFY(cache.contains(1));
+
+    auto stats = cache.statistics();
+    QCOMPARE(stats.hits, 2u);
+    QCOMPARE(stats.misses, 1u);
+
+    cache.resetStatistics();
+    stats = cache.statistics();
+    QCOMPARE(stats.hits, 0u);
+    QCOMPARE(stats.misses, 0u);
+}
+
+void tst_QConcurrentCache::evictedObjectStaysAlive()
+{
+    QConcurrentCache<int, Counted> cache(1, 1);
+    QVERIFY(cache.insert(1, new Counted(1)));
+    QSharedPointer<Counted> first = cache.object(1);
+    QVERIFY(cache.insert(2, new Counted(2)));
+    QVERIFY(!cache.contains(1));
+    QCOMPARE(Counted::count.load(), 2);
+    QCOMPARE(first->value, 1);
+    first.reset();
+    QCOMPARE(Counted::count.load(), 1);
+}
+
+void tst_QConcurrentCache::concurrentAccess()
+{
+    constexpr int ThreadCount = 8;
+    constexpr int Iterations = 20000;
+    constexpr int KeyCount = 512;
+    {
+        QConcurrentCache<int, Counted> cache(KeyCount / 2);
+        std::atomic<int> wrongValues = 0;
+        std::vector<std::thread> threads;
+        for (int t = 0; t < ThreadCount; ++t) {
+            threads.emplace_back([&, t] {
+                for (int i = 0; i < Iterations; ++i) {
+                    const int key = (i * 7 + t * 13) % KeyCount;
+                    if (auto o = cache.object(key)) {
+                        if (o->value != key)
+                            ++wrongValues;
+                    } else {
+                        cache.insert(key, new Counted(key));
+                    }
+                    if (i % 101 == 0)
+                        cache.remove(key + 1);
+                }
+            });
+        }
+        for (auto &thread : threads)
+            thread.join();
+
+        QCOMPARE(wrongValues.load(), 0);
+        QVERIFY(cache.totalCost() <= cache.maxCost());
+        QCOMPARE(Counted::count.load(), int(cache.size()));
+        const auto stats = cache.statistics();
+        QCOMPARE(stats.hits + stats.misses, quint64(ThreadCount) * Iterations);
+    }
+    QCOMPARE(Counted::count.load(), 0);
+}
+
+QTEST_APPLESS_MAIN(tst_QConcurrentCache)
+#include "tst_qconcurrentcache.moc"
@@ -35,6 +35,8 @@ private slots:
     void hashLength();
     void addDataAcceptsNullByteArrayView_data() { all_methods(false); }
     void addDataAcceptsNullByteArrayView();
+    void hashMany_data() { all_methods(false); }
+    void hashMany();
     void move();
     void swap();
     // keep last
@@ -542,6 +544,27 @@ void tst_QCryptographicHash::addDataAcceptsNullByteArrayView()
     QCOMPARE(hash2.resultView(), expected);
 }
 
+void tst_QCryptographicHash::hashMany()
+{
+    QFETCH(const QCryptographicHash::Algorithm, algorithm);
+
+    if (!QCryptographicHash::supportsAlgorithm(algorithm))
+        QSKIP("QCryptographicHash doesn't support this algorithm");
+
+    QVERIFY(QCryptographicHash::hashMany({}, algorithm).isEmpty());
+
+    // enough data for the work to be distributed over several threads
+    QList<QByteArray> buffers;
+    for (int i = 0; i < 1000; ++i)
+        buffers.emplace_back(i * 7, char('a' + i % 26));
+    const QList<QByteArrayView> views(buffers.cbegin(), buffers.cend());
+
+    const QByteArrayList results = QCryptographicHash::hashMany(views, algorithm);
+    QCOMPARE(results.size(), buffers.size());
+    for (qsizetype i = 0; i < buffers.size(); ++i)
+        QCOMPARE(results.at(i), QCryptographicHash::hash(buffers.at(i), algorithm));
+}
+
 void tst_QCryptographicHash::move()
 {
     QCryptographicHash hash1(QCryptographicHash::Sha1);
@@ -0,0 +1,207 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QTest>
+
+#include <QtNetwork/private/qcompresshelper_p.h>
+#include <QtNetwork/private/qdecompresshelper_p.h>
+
+#include <QtCore/qbytearray.h>
+
+class tst_QCompressHelper : public QObject
+{
+    Q_OBJECT
+
+private:
+    void encodings_data();
+
+private Q_SLOTS:
+    void encodingSupported();
+
+    void roundTrip_data();
+    void roundTrip();
+
+    void streamedRoundTrip_data();
+    void streamedRoundTrip();
+
+    void compressionLevel_data();
+    void compressionLevel();
+
+    void dictionary();
+
+    void invalidUse();
+};
+
+static QByteArray decompress(const QByteArray &encoding, const QByteArray &data)
+{
+    QDecompressHelper helper;
+    if (!helper.setEncoding(encoding))
+        return {};
+    helper.setDecompressedSafetyCheckThreshold(-1);
+    helper.feed(data);
+    QByteArray result;
+    QByteArray buffer(4096, Qt::Uninitialized);
+    while (helper.hasData()) {
+        const qsizetype read = helper.read(buffer.data(), buffer.size());
+        if (read <= 0)
+            break;
+        result.append(buffer.constData(), read);
+    }
+    return result;
+}
+
+static QByteArray sampleData()
+{
+    QByteArray data;
+    for (int i = 0; i < 10000; ++i)
+        data += "line " + QByteArray::number(i) + ": the quick brown fox jumps over the lazy dog\n";
+    return data;
+}
+
+void tst_QCompressHelper::encodingSupported()
+{
+    const QByteArrayList supported = QCompressHelper::supportedEncodings();
+
+    QVERIFY(QCompressHelper::isSupportedEncoding("deflate"));
+    QVERIFY(supported.contains("deflate"));
+    QVERIFY(QCompressHelper::isSupportedEncoding("gzip"));
+    QVERIFY(QCompressHelper::isSupportedEncoding("GZIP"));
+    QVERIFY(supported.contains("gzip"));
+    qsizetype expected = 2;
+
+#if QT_CONFIG(zstd)
+    QVERIFY(QCompressHelper::isSupportedEncoding("zstd"));
+    QVERIFY(supported.contains("zstd"));
+    ++expected;
+#endif
+    QCOMPARE(supported.size(), expected);
+
+    QVERIFY(!QCompressHelper::isSupportedEncoding("identity"));
+    QVERIFY(!QCompressHelper::isSupportedEncoding("something"));
+}
+
+void tst_QCompressHelper::encodings_data()
+{
+    QTest::addColumn<QByteArray>("encoding");
+
+    const QByteArrayList supported = QCompressHelper::supportedEncodings();
+    for (const QByteArray &encoding : supported)
+        QTest::newRow(encoding.constData()) << encoding;
+}
+
+void tst_QCompressHelper::roundTrip_data()
+{
+    encodings_data();
+}
+
+void tst_QCompressHelper::roundTrip()
+{
+    QFETCH(QByteArray, encoding);
+    const QByteArray data = sampleData();
+
+    QCompressHelper helper;
+    QVERIFY(helper.setEncoding(encoding));
+    QVERIFY(helper.isValid());
+
+    QByteArray compressed = helper.compress(data);
+    compressed += helper.finish();
+    QVERIFY2(helper.isValid(), qPrintable(helper.errorString()));
+    QVERIFY(helper.isFinished());
+    QVERIFY(compressed.size() < data.size() / 4);
+
+    QCOMPARE(decompress(encoding, compressed), data);
+}
+
+void tst_QCompressHelper::streamedRoundTrip_data()
+{
+    encodings_data();
+}
+
+// Compress in small pieces, including empty ones
+void tst_QCompressHelper::streamedRoundTrip()
+{
+    QFETCH(QByteArray, encoding);
+    const QByteArray data = sampleData();
+
+    QCompressHelper helper;
+    QVERIFY(helper.setEncoding(encoding));
+
+    QByteArray compressed;
+    for (qsizetype i = 0; i < data.size(); i += 1000) {
+        compressed += helper.compress(QByteArrayView(data).sliced(i, qMin(qsizetype(1000), data.size() - i)));
+        compressed += helper.compress({});
+    }
+    compressed += helper.finish();
+    QVERIFY2(helper.isValid(), qPrintable(helper.errorString()));
+
+    QCOMPARE(decompress(encoding, compressed), data);
+}
+
+void tst_QCompressHelper::compressionLevel_data()
+{
+    encodings_data();
+}
+
+void tst_QCompressHelper::compressionLevel()
+{
+    QFETCH(QByteArray, encoding);
+    const QByteArray data = sampleData();
+
+    QCompressHelper fast;
+    QVERIFY(fast.setEncoding(encoding));
+    fast.setCompressionLevel(1);
+    QCOMPARE(fast.compressionLevel(), 1);
+    const QByteArray fastResult = fast.compress(data) + fast.finish();
+
+    QCompressHelper best;
+    QVERIFY(best.setEncoding(encoding));
+    best.setCompressionLevel(9);
+    const QByteArray bestResult = best.compress(data) + best.finish();
+
+    QVERIFY(fast.isValid());
+    QVERIFY(best.isValid());
+    QVERIFY(bestResult.size() <= fastResult.size());
+    QCOMPARE(decompress(encoding, fastResult), data);
+    QCOMPARE(decompress(encoding, bestResult), data);
+}
+
+void tst_QCompressHelper::dictionary()
+{
+    QCompressHelper gzip;
+    QVERIFY(gzip.setEncoding("gzip"));
+    QVERIFY(!gzip.setDictionary("dictionary"));
+    QVERIFY(!gzip.errorString().isEmpty());
+    QVERIFY(!gzip.isValid());
+
+    const QByteArray data = "the quick brown fox jumps over the lazy dog";
+    QCompressHelper plain;
+    QVERIFY(plain.setEncoding("deflate"));
+    const QByteArray plainResult = plain.compress(data) + plain.finish();
+
+    QCompressHelper primed;
+    QVERIFY(primed.setEncoding("deflate"));
+    QVERIFY(primed.setDictionary(data));
+    const QByteArray primedResult = primed.compress(data) + primed.finish();
+    QVERIFY(primed.isValid());
+    QVERIFY(primedResult.size() < plainResult.size());
+}
+
+void tst_QCompressHelper::invalidUse()
+{
+    QCompressHelper helper;
+    QVERIFY(!helper.isValid());
+    QVERIFY(!helper.setEncoding("identity"));
+    QVERIFY(!helper.errorString().isEmpty());
+
+    helper.clear();
+    QVERIFY(helper.errorString().isEmpty());
+    QVERIFY(helper.setEncoding("gzip"));
+    QVERIFY(!helper.finish().isEmpty());
+
+    QTest::ignoreMessage(QtWarningMsg, "QCompressHelper: the stream has already been finished.");
+    QVERIFY(helper.compress("data").isEmpty());
+}
+
+QTEST_MAIN(tst_QCompressHelper)
+
+#include "tst_qcompresshelper.moc"
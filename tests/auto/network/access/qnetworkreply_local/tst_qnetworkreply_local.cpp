@@ -5,13 +5,62 @@
 
 #include <QtTest/qtest.h>
 
+#include <QtNetwork/qhttpmultipart.h>
 #include <QtNetwork/qnetworkreply.h>
 #include <QtNetwork/qnetworkaccessmanager.h>
 
+#include <QtCore/qendian.h>
+#include <QtCore/qtimer.h>
+
 #include "minihttpserver.h"
 
 using namespace Qt::StringLiterals;
 
+// A sequential device like a pipe: data arrives in pieces, and the end is
+// only announced by readChannelFinished(), while read() keeps returning 0.
+class SequentialDevice : public QIODevice
+{
+public:
+    explicit SequentialDevice(const QByteArray &data) : pending(data)
+    {
+        open(QIODevice::ReadOnly);
+        QTimer::singleShot(0, this, &SequentialDevice::deliver);
+    }
+
+    bool isSequential() const override { return true; }
+    qint64 bytesAvailable() const override
+    {
+        return available.size() + QIODevice::bytesAvailable();
+    }
+
+protected:
+    qint64 readData(char *data, qint64 maxSize) override
+    {
+        const qint64 size = qMin(maxSize, qint64(available.size()));
+        memcpy(data, available.constData(), size);
+        available.remove(0, size);
+        return size;
+    }
+    qint64 writeData(const char *, qint64) override { return -1; }
+
+private:
+    void deliver()
+    {
+        available += pending.first(qMin(pending.size(), 4096));
+        pending.remove(0, 4096);
+        if (!pending.isEmpty()) {
+            emit readyRead();
+            QTimer::singleShot(0, this, &SequentialDevice::deliver);
+        } else {
+            // the last piece is not announced by readyRead()
+            emit readChannelFinished();
+        }
+    }
+
+    QByteArray pending;
+    QByteArray available;
+};
+
 /*
     The tests here are meant to be self-contained, using servers in the same
     process if needed. This enables externals to more easily run the tests too.
@@ -24,6 +73,9 @@ private slots:
 
     void get();
     void post();
+    void postCompressed_data();
+    void postCompressed();
+    void postCompressedSequential();
 
 #if QT_CONFIG(localserver)
     void fullServerName_data();
@@ -49,8 +101,9 @@ static std::unique_ptr<MiniHttpServerV2> getServerForCurrentScheme()
     if (scheme.startsWith("unix"_L1) || scheme.startsWith("local"_L1)) {
 #if QT_CONFIG(localserver)
         QLocalServer *localServer = new QLocalServer(server.get());
+        // the name ends up as the host of the URL, which is lower-cased
         localServer->listen(u"qt_networkreply_test_"_s
-                            % QLatin1StringView(QTest::currentTestFunction())
+                            % QLatin1StringView(QTest::currentTestFunction()).toString().toLower()
                             % QString::number(QCoreApplication::applicationPid()));
         server->bind(localServer);
 #endif
@@ -113,6 +166,97 @@ void tst_QNetworkReply_local::post()
     QCOMPARE(firstRequest.receivedData.last(payload.size() + 4), "\r\n\r\n" + payload);
 }
 
+void tst_QNetworkReply_local::postCompressed_data()
+{
+    QTest::addColumn<bool>("multiPart");
+
+    QTest::newRow("bytearray") << false;
+    QTest::newRow("multipart") << true;
+}
+
+void tst_QNetworkReply_local::postCompressed()
+{
+    QFETCH(bool, multiPart);
+
+    std::unique_ptr<MiniHttpServerV2> server = getServerForCurrentScheme();
+    const QUrl url = getUrlForCurrentScheme(server.get());
+
+    QNetworkAccessManager manager;
+    QByteArray payload;
+    for (int i = 0; i < 1000; ++i)
+        payload += "Hello from the other side, line " + QByteArray::number(i) + '\n';
+    QNetworkRequest req(url);
+    req.setAttribute(QNetworkRequest::UploadContentEncodingAttribute, "deflate"_ba);
+
+    std::unique_ptr<QNetworkReply> reply;
+    QHttpMultiPart parts(QHttpMultiPart::FormDataType);
+    if (multiPart) {
+        QHttpPart part;
+        part.setHeader(QNetworkRequest::ContentDispositionHeader, "form-data; name=\"text\"");
+        part.setBody(payload);
+        parts.append(part);
+        parts.setBoundary("boundary");
+        reply.reset(manager.post(req, &parts));
+    } else {
+        req.setHeader(QNetworkRequest::ContentTypeHeader, "text/plain");
+        reply.reset(manager.post(req, payload));
+    }
+
+    const bool res = QTest::qWaitFor([reply = reply.get()] { return reply->isFinished(); });
+    QVERIFY(res);
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+
+    auto states = server->peerStates();
+    QCOMPARE(states.size(), 1);
+    const auto &request = states.at(0);
+    QVERIFY(request.checkedContentLength);
+    QCOMPARE_LT(request.contentLength, payload.size());
+    QVERIFY(request.receivedData.contains("content-encoding: deflate\r\n"));
+
+    // "deflate" is the zlib format; qUncompress() wants a size hint up front
+    QByteArray body(4, Qt::Uninitialized);
+    qToBigEndian(quint32(payload.size()), body.data());
+    body += request.receivedData.last(request.contentLength);
+    const QByteArray uncompressed = qUncompress(body);
+    if (multiPart) {
+        QVERIFY(uncompressed.startsWith("--boundary\r\n"));
+        QVERIFY(uncompressed.contains("\r\n\r\n" + payload + "\r\n--boundary--\r\n"));
+    } else {
+        QCOMPARE(uncompressed, payload);
+    }
+}
+
+void tst_QNetworkReply_local::postCompressedSequential()
+{
+    std::unique_ptr<MiniHttpServerV2> server = getServerForCurrentScheme();
+    const QUrl url = getUrlForCurrentScheme(server.get());
+
+    QNetworkAccessManager manager;
+    QByteArray payload;
+    for (int i = 0; i < 5000; ++i)
+        payload += "Hello from the other side, line " + QByteArray::number(i) + '\n';
+    QNetworkRequest req(url);
+    req.setAttribute(QNetworkRequest::UploadContentEncodingAttribute, "deflate"_ba);
+    req.setHeader(QNetworkRequest::ContentTypeHeader, "text/plain");
+    SequentialDevice device(payload);
+    std::unique_ptr<QNetworkReply> reply(manager.post(req, &device));
+
+    const bool res = QTest::qWaitFor([reply = reply.get()] { return reply->isFinished(); });
+    QVERIFY(res);
+    QCOMPARE(reply->error(), QNetworkReply::NoError);
+
+    auto states = server->peerStates();
+    QCOMPARE(states.size(), 1);
+    const auto &request = states.at(0);
+    QVERIFY(request.checkedContentLength);
+    QVERIFY(request.receivedData.contains("content-encoding: deflate\r\n"));
+
+    QByteArray body(4, Qt::Uninitialized);
+    qToBigEndian(quint32(payload.size()), body.data());
+    body += request.receivedData.last(request.contentLength);
+    QCOMPARE(qUncompress(body), payload);
+}
+
 #if QT_CONFIG(localserver)
 void tst_QNetworkReply_local::fullServerName_data()
 {
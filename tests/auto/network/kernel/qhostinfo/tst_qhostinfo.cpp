@@ -83,6 +83,7 @@ private slots:
     void multipleDifferentLookups();
 
     void cache();
+    void negativeCache();
 
     void abortHostLookup();
 
@@ -607,6 +608,42 @@ void tst_QHostInfo::cache()
     QCOMPARE(helper.lookupsDoneCounter, 2);
 }
 
+void tst_QHostInfo::negativeCache()
+{
+    QFETCH_GLOBAL(bool, cache);
+    if (!cache)
+        return; // test makes only sense when cache enabled
+
+    tst_QHostInfo_Helper helper("nonexistent.invalid");
+
+    // names that do not exist are cached, so the failure is reported directly
+    QHostInfo notFound;
+    notFound.setHostName(helper.hostname);
+    notFound.setError(QHostInfo::HostNotFound);
+    qt_qhostinfo_cache_inject(helper.hostname, notFound);
+
+    bool valid = false;
+    int id = -1;
+    QHostInfo result = qt_qhostinfo_lookup(helper.hostname, &helper, SLOT(resultsReady(QHostInfo)), &valid, &id);
+    QVERIFY(valid);
+    QCOMPARE(result.error(), QHostInfo::HostNotFound);
+    QVERIFY(result.addresses().isEmpty());
+
+    // other failures may be transient and are not cached
+    qt_qhostinfo_clear_cache();
+    QHostInfo failed;
+    failed.setHostName(helper.hostname);
+    failed.setError(QHostInfo::UnknownError);
+    qt_qhostinfo_cache_inject(helper.hostname, failed);
+
+    valid = true;
+    result = qt_qhostinfo_lookup(helper.hostname, &helper, SLOT(resultsReady(QHostInfo)), &valid, &id);
+    QVERIFY(!valid);
+    QTestEventLoop::instance().enterLoop(5);
+    QVERIFY(!QTestEventLoop::instance().timeout());
+    QCOMPARE(helper.lookupsDoneCounter, 1);
+}
+
 void tst_QHostInfo_Helper::resultsReady(const QHostInfo &hi)
 {
     QVERIFY(QThread::currentThread() == thread());
@@ -7,6 +7,16 @@
 #include <qcoreapplication.h>
 #include <qdebug.h>
 #include <qabstractsocket.h>
+#include <qhostinfo.h>
+#include <qscopeguard.h>
+#include <qtcpserver.h>
+#include <qtcpsocket.h>
+
+#include <private/qabstractsocket_p.h>
+#include <private/qhostinfo_p.h>
+
+using namespace Qt::StringLiterals;
+using namespace std::chrono_literals;
 
 class tst_QAbstractSocket : public QObject
 {
@@ -18,6 +28,12 @@ public:
 
 private slots:
     void getSetCheck();
+#ifdef QT_BUILD_INTERNAL
+    void interleaveAddressFamilies_data();
+    void interleaveAddressFamilies();
+    void connectionRacing_data();
+    void connectionRacing();
+#endif
 };
 
 tst_QAbstractSocket::tst_QAbstractSocket()
@@ -64,5 +80,83 @@ void tst_QAbstractSocket::getSetCheck()
     QCOMPARE(quint16(0xffff), obj1.peerPort());
 }
 
+#ifdef QT_BUILD_INTERNAL
+static QList<QHostAddress> addressList(const QStringList &list)
+{
+    QList<QHostAddress> result;
+    for (const QString &address : list)
+        result.append(QHostAddress(address));
+    return result;
+}
+
+void tst_QAbstractSocket::interleaveAddressFamilies_data()
+{
+    QTest::addColumn<QStringList>("addresses");
+    QTest::addColumn<QStringList>("expected");
+
+    QTest::newRow("empty") << QStringList() << QStringList();
+    QTest::newRow("ipv4-only")
+            << QStringList{ "192.0.2.1", "192.0.2.2", "192.0.2.3" }
+            << QStringList{ "192.0.2.1", "192.0.2.2", "192.0.2.3" };
+    QTest::newRow("two")
+            << QStringList{ "2001:db8::1", "192.0.2.1" }
+            << QStringList{ "2001:db8::1", "192.0.2.1" };
+    QTest::newRow("ipv6-first")
+            << QStringList{ "2001:db8::1", "2001:db8::2", "2001:db8::3", "192.0.2.1", "192.0.2.2" }
+            << QStringList{ "2001:db8::1", "192.0.2.1", "2001:db8::2", "192.0.2.2", "2001:db8::3" };
+    QTest::newRow("ipv4-first")
+            << QStringList{ "192.0.2.1", "192.0.2.2", "2001:db8::1" }
+            << QStringList{ "192.0.2.1", "2001:db8::1", "192.0.2.2" };
+    QTest::newRow("mixed")
+            << QStringList{ "2001:db8::1", "192.0.2.1", "192.0.2.2", "2001:db8::2", "192.0.2.3" }
+            << QStringList{ "2001:db8::1", "192.0.2.1", "2001:db8::2", "192.0.2.2", "192.0.2.3" };
+}
+
+void tst_QAbstractSocket::interleaveAddressFamilies()
+{
+    QFETCH(QStringList, addresses);
+    QFETCH(QStringList, expected);
+
+    QList<QHostAddress> list = addressList(addresses);
+    QAbstractSocketPrivate::interleaveAddressFamilies(list);
+    QCOMPARE(list, addressList(expected));
+}
+
+void tst_QAbstractSocket::connectionRacing_data()
+{
+    QTest::addColumn<QStringList>("addresses");
+
+    // 100::/64 is a discard prefix (RFC 6666): connecting to it either fails
+    // right away or never completes. Either way, the IPv4 address must be
+    // reached long before the 30 second connect timeout.
+    QTest::newRow("first-family-stalls") << QStringList{ "100::1", "100::2", "127.0.0.1" };
+    QTest::newRow("first-family-refused") << QStringList{ "::1", "127.0.0.1" };
+}
+
+void tst_QAbstractSocket::connectionRacing()
+{
+    QFETCH(QStringList, addresses);
+
+    QTcpServer server;
+    QVERIFY2(server.listen(QHostAddress::LocalHost), qPrintable(server.errorString()));
+
+    const QString hostName = u"connection-racing.test"_s;
+    QHostInfo info;
+    info.setHostName(hostName);
+    info.setAddresses(addressList(addresses));
+    qt_qhostinfo_clear_cache();
+    qt_qhostinfo_enable_cache(true);
+    qt_qhostinfo_cache_inject(hostName, info);
+    const auto cleanup = qScopeGuard([] { qt_qhostinfo_clear_cache(); });
+
+    QTcpSocket socket;
+    socket.connectToHost(hostName, server.serverPort());
+    QTRY_COMPARE_WITH_TIMEOUT(socket.state(), QAbstractSocket::ConnectedState, 10s);
+    QCOMPARE(socket.peerAddress(), QHostAddress(QHostAddress::LocalHost));
+    // QTRY_COMPARE ran the event loop, which may have accepted it already
+    QVERIFY(server.hasPendingConnections() || server.waitForNewConnection(5000));
+}
+#endif // QT_BUILD_INTERNAL
+
 QTEST_MAIN(tst_QAbstractSocket)
 #include "tst_qabstractsocket.moc"
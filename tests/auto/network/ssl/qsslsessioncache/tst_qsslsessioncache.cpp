@@ -0,0 +1,169 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QTest>
+
+#include <QtNetwork/qnetworkaccessmanager.h>
+#include <QtNetwork/qnetworkreply.h>
+#include <QtNetwork/qsslconfiguration.h>
+#include <QtNetwork/qsslkey.h>
+#include <QtNetwork/qsslserver.h>
+#include <QtNetwork/private/qsslsessioncache_p.h>
+
+using namespace Qt::StringLiterals;
+
+class tst_QSslSessionCache : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void insertAndLookup();
+    void noTicket();
+    void leastRecentlyUsedIsEvicted();
+    void verificationIsPartOfKey();
+    void globalInstance();
+    void relaxedSessionNotResumedByStrictConnection();
+};
+
+static QSslConfiguration configurationWithTicket(const QByteArray &ticket)
+{
+    QSslConfiguration configuration;
+    configuration.setSslOption(QSsl::SslOptionDisableSessionPersistence, false);
+    configuration.setSessionTicket(ticket);
+    return configuration;
+}
+
+void tst_QSslSessionCache::insertAndLookup()
+{
+    QSslSessionCache cache;
+    const QSslConfiguration empty;
+
+    cache.insert(u"example.com"_s, 443, {}, configurationWithTicket("ticket"));
+    QCOMPARE(cache.size(), 1);
+    QCOMPARE(cache.sessionTicket(u"example.com"_s, 443, {}, empty), "ticket");
+    QCOMPARE(cache.sessionTicket(u"Example.COM"_s, 443, {}, empty), "ticket");
+    QVERIFY(cache.sessionTicket(u"example.com"_s, 8443, {}, empty).isEmpty());
+    QVERIFY(cache.sessionTicket(u"example.org"_s, 443, {}, empty).isEmpty());
+
+    // a newer ticket replaces the old one
+    cache.insert(u"example.com"_s, 443, {}, configurationWithTicket("newer"));
+    QCOMPARE(cache.size(), 1);
+    QCOMPARE(cache.sessionTicket(u"example.com"_s, 443, {}, empty), "newer");
+
+    cache.clear();
+    QCOMPARE(cache.size(), 0);
+    QVERIFY(cache.sessionTicket(u"example.com"_s, 443, {}, empty).isEmpty());
+}
+
+void tst_QSslSessionCache::noTicket()
+{
+    QSslSessionCache cache;
+    cache.insert(u"example.com"_s, 443, {}, QSslConfiguration());
+    QCOMPARE(cache.size(), 0);
+}
+
+void tst_QSslSessionCache::leastRecentlyUsedIsEvicted()
+{
+    QSslSessionCache cache(2);
+    const QSslConfiguration empty;
+
+    cache.insert(u"a.example"_s, 443, {}, configurationWithTicket("a"));
+    cache.insert(u"b.example"_s, 443, {}, configurationWithTicket("b"));
+    QCOMPARE(cache.sessionTicket(u"a.example"_s, 443, {}, empty), "a");
+
+    cache.insert(u"c.example"_s, 443, {}, configurationWithTicket("c"));
+    QCOMPARE(cache.size(), 2);
+    QCOMPARE(cache.sessionTicket(u"a.example"_s, 443, {}, empty), "a");
+    QVERIFY(cache.sessionTicket(u"b.example"_s, 443, {}, empty).isEmpty());
+    QCOMPARE(cache.sessionTicket(u"c.example"_s, 443, {}, empty), "c");
+}
+
+void tst_QSslSessionCache::verificationIsPartOfKey()
+{
+    QSslSessionCache cache;
+    const QSslConfiguration strict;
+    cache.insert(u"example.com"_s, 443, {}, configurationWithTicket("ticket"));
+    QCOMPARE(cache.sessionTicket(u"example.com"_s, 443, {}, strict), "ticket");
+
+    QSslConfiguration noVerification = strict;
+    noVerification.setPeerVerifyMode(QSslSocket::VerifyNone);
+    QVERIFY(cache.sessionTicket(u"example.com"_s, 443, {}, noVerification).isEmpty());
+
+    const auto certificates = QSslCertificate::fromPath(QFINDTESTDATA("certs/selfsigned-server.crt"));
+    QCOMPARE(certificates.size(), 1);
+    QSslConfiguration customCa = strict;
+    customCa.setCaCertificates(strict.caCertificates() + certificates);
+    QVERIFY(cache.sessionTicket(u"example.com"_s, 443, {}, customCa).isEmpty());
+
+    QVERIFY(cache.sessionTicket(u"example.com"_s, 443, u"other.example"_s, strict).isEmpty());
+}
+
+void tst_QSslSessionCache::globalInstance()
+{
+    QSslSessionCache *cache = QSslSessionCache::instance();
+    QVERIFY(cache);
+    QCOMPARE(QSslSessionCache::instance(), cache);
+}
+
+static QSslConfiguration serverConfiguration()
+{
+    QSslConfiguration configuration = QSslConfiguration::defaultConfiguration();
+    QFile keyFile(QFINDTESTDATA("certs/selfsigned-server.key"));
+    if (keyFile.open(QIODevice::ReadOnly))
+        configuration.setPrivateKey(QSslKey(keyFile.readAll(), QSsl::Rsa));
+    const auto certificates = QSslCertificate::fromPath(QFINDTESTDATA("certs/selfsigned-server.crt"));
+    if (!certificates.isEmpty())
+        configuration.setLocalCertificate(certificates.constFirst());
+    return configuration;
+}
+
+// A session set up while ignoring the errors of a self-signed certificate
+// must not let a later, strict connection skip the verification.
+void tst_QSslSessionCache::relaxedSessionNotResumedByStrictConnection()
+{
+    if (!QSslSocket::supportsSsl())
+        QSKIP("No TLS backend");
+
+    const QSslConfiguration configuration = serverConfiguration();
+    if (configuration.privateKey().isNull() || configuration.localCertificate().isNull())
+        QSKIP("Test certificate not found");
+
+    QSslServer server;
+    server.setSslConfiguration(configuration);
+    QObject::connect(&server, &QSslServer::pendingConnectionAvailable, &server, [&server] {
+        while (QTcpSocket *socket = server.nextPendingConnection()) {
+            QObject::connect(socket, &QTcpSocket::readyRead, socket, [socket] {
+                if (socket->readAll().contains("\r\n\r\n"))
+                    socket->write("HTTP/1.1 200 OK\r\nContent-Length: 2\r\n\r\nok");
+            });
+            QObject::connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        }
+    });
+    QVERIFY(server.listen(QHostAddress::LocalHost));
+
+    QSslSessionCache::instance()->clear();
+    const QUrl url(u"https://127.0.0.1:%1/"_s.arg(server.serverPort()));
+    QSslConfiguration clientConfiguration = QSslConfiguration::defaultConfiguration();
+    clientConfiguration.setSslOption(QSsl::SslOptionDisableSessionPersistence, false);
+    QNetworkRequest request(url);
+    request.setSslConfiguration(clientConfiguration);
+
+    {
+        QNetworkAccessManager relaxed;
+        std::unique_ptr<QNetworkReply> reply(relaxed.get(request));
+        QObject::connect(reply.get(), &QNetworkReply::sslErrors, reply.get(),
+                         [reply = reply.get()] { reply->ignoreSslErrors(); });
+        QTRY_VERIFY(reply->isFinished());
+        QCOMPARE(reply->error(), QNetworkReply::NoError);
+        QCOMPARE(reply->readAll(), "ok");
+    }
+    QCOMPARE(QSslSessionCache::instance()->size(), 0);
+
+    QNetworkAccessManager strict;
+    std::unique_ptr<QNetworkReply> reply(strict.get(request));
+    QTRY_VERIFY(reply->isFinished());
+    QCOMPARE(reply->error(), QNetworkReply::SslHandshakeFailedError);
+}
+
+QTEST_MAIN(tst_QSslSessionCache)
+#include "tst_qsslsessioncache.moc"
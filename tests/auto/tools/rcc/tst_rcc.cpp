@@ -16,6 +16,7 @@
 #include <QtCore/QList>
 #include <QtCore/QResource>
 #include <QtCore/QLocale>
+#include <QtCore/QTemporaryDir>
 #include <QtCore/QtGlobal>
 
 #include <algorithm>
@@ -71,6 +72,9 @@ private slots:
 
     void python();
 
+    void manyFiles();
+    void zstdDictionary();
+
     void cleanupTestCase();
 
 private:
@@ -258,51 +262,53 @@ void tst_rcc::binary_data()
     {
         QFileInfo qrcFileInfo = iter.nextFileInfo();
         QString absoluteBaseName = QFileInfo(qrcFileInfo.absolutePath(), qrcFileInfo.baseName()).absoluteFilePath();
-        QString rccFileName = absoluteBaseName + QLatin1String(".rcc");
-
-        // same as above: force no compression
-        QProcess rccProcess;
-        rccProcess.setWorkingDirectory(dataPath);
-        rccProcess.start(m_rcc, { "-binary", "-no-compress", "-o", rccFileName, qrcFileInfo.absoluteFilePath() });
-        QVERIFY2(rccProcess.waitForStarted(), msgProcessStartFailed(rccProcess).constData());
-        if (!rccProcess.waitForFinished()) {
-            rccProcess.kill();
-            QFAIL(msgProcessTimeout(rccProcess).constData());
-        }
-        QVERIFY2(rccProcess.exitStatus() == QProcess::NormalExit,
-                 msgProcessCrashed(rccProcess).constData());
-        QVERIFY2(rccProcess.exitCode() == 0,
-                 msgProcessFailed(rccProcess).constData());
-
-        QByteArray output = rccProcess.readAllStandardOutput();
-        if (!output.isEmpty())
-            qWarning("rcc stdout: %s", output.constData());
-
-        output = rccProcess.readAllStandardError();
-        if (!output.isEmpty())
-            qWarning("rcc stderr: %s", output.constData());
-
-        QString localeFileName = absoluteBaseName + QLatin1String(".locale");
-        QFile localeFile(localeFileName);
-        if (localeFile.exists()) {
-            const QStringList locales = readLinesFromFile(localeFileName, Qt::SkipEmptyParts);
-            for (const QString &locale : locales) {
-                QString expectedFileName = QString::fromLatin1("%1.%2.%3").arg(absoluteBaseName, locale, QLatin1String("expected"));
-                QStringMap expectedFiles = readExpectedFiles(expectedFileName);
-                QTest::newRow(qPrintable(qrcFileInfo.baseName() + QLatin1Char('_') + locale)) << rccFileName
-                                                                                              << QLocale(locale)
-                                                                                              << dataPath
-                                                                                              << expectedFiles;
+
+        // format version 4 adds an index for looking up paths, the results must not change
+        for (const QString &formatVersion : { QStringLiteral("3"), QStringLiteral("4") }) {
+            const QString suffix = formatVersion == QLatin1String("3") ? QString() : QLatin1String("_v") + formatVersion;
+            QString rccFileName = absoluteBaseName + suffix + QLatin1String(".rcc");
+
+            // same as above: force no compression
+            QProcess rccProcess;
+            rccProcess.setWorkingDirectory(dataPath);
+            rccProcess.start(m_rcc, { "-binary", "-no-compress", "--format-version", formatVersion,
+                                      "-o", rccFileName, qrcFileInfo.absoluteFilePath() });
+            QVERIFY2(rccProcess.waitForStarted(), msgProcessStartFailed(rccProcess).constData());
+            if (!rccProcess.waitForFinished()) {
+                rccProcess.kill();
+                QFAIL(msgProcessTimeout(rccProcess).constData());
+            }
+            QVERIFY2(rccProcess.exitStatus() == QProcess::NormalExit,
+                     msgProcessCrashed(rccProcess).constData());
+            QVERIFY2(rccProcess.exitCode() == 0,
+                     msgProcessFailed(rccProcess).constData());
+
+            QByteArray output = rccProcess.readAllStandardOutput();
+            if (!output.isEmpty())
+                qWarning("rcc stdout: %s", output.constData());
+
+            output = rccProcess.readAllStandardError();
+            if (!output.isEmpty())
+                qWarning("rcc stderr: %s", output.constData());
+
+            QString localeFileName = absoluteBaseName + QLatin1String(".locale");
+            QFile localeFile(localeFileName);
+            if (localeFile.exists()) {
+                const QStringList locales = readLinesFromFile(localeFileName, Qt::SkipEmptyParts);
+                for (const QString &locale : locales) {
+                    QString expectedFileName = QString::fromLatin1("%1.%2.%3").arg(absoluteBaseName, locale, QLatin1String("expected"));
+                    QStringMap expectedFiles = readExpectedFiles(expectedFileName);
+                    QTest::newRow(qPrintable(qrcFileInfo.baseName() + QLatin1Char('_') + locale + suffix))
+                            << rccFileName << QLocale(locale) << dataPath << expectedFiles;
+                }
             }
-        }
 
-        // always test for the C locale as well
-        QString expectedFileName = absoluteBaseName + QLatin1String(".expected");
-        QStringMap expectedFiles = readExpectedFiles(expectedFileName);
-        QTest::newRow(qPrintable(qrcFileInfo.baseName() + QLatin1String("_C"))) << rccFileName
-                                                                                << QLocale::c()
-                                                                                << dataPath
-                                                                                << expectedFiles;
+            // always test for the C locale as well
+            QString expectedFileName = absoluteBaseName + QLatin1String(".expected");
+            QStringMap expectedFiles = readExpectedFiles(expectedFileName);
+            QTest::newRow(qPrintable(qrcFileInfo.baseName() + QLatin1String("_C") + suffix))
+                    << rccFileName << QLocale::c() << dataPath << expectedFiles;
+        }
     }
 }
 
@@ -452,7 +458,10 @@ void tst_rcc::python()
     QString expectedFile = testFileRoot + QLatin1String("_python.expected");
     if (sizeof(size_t) == 4)
         expectedFile += QLatin1String("32");
-    const QString actualFile = testFileRoot + QLatin1String(".rcc");
+    // keep the generated file out of the source tree
+    QTemporaryDir outputDir;
+    QVERIFY2(outputDir.isValid(), qPrintable(outputDir.errorString()));
+    const QString actualFile = outputDir.filePath(QLatin1String("size-2-0-35-1.rcc"));
 
     QProcess process;
     process.setWorkingDirectory(path);
@@ -476,6 +485,122 @@ void tst_rcc::python()
         QFAIL(qPrintable(diff));
 }
 
+void tst_rcc::manyFiles()
+{
+    // more files than rcc compresses at once, with duplicates across batches
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), qPrintable(dir.errorString()));
+    constexpr int Count = 2500;
+    constexpr int Distinct = 1000;
+    QByteArray qrc = "<RCC><qresource prefix=\"/\">\n";
+    for (int i = 0; i < Count; ++i) {
+        const QString name = QString::fromLatin1("file%1.txt").arg(i);
+        QFile file(dir.filePath(name));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(QByteArray::number(i % Distinct).repeated(50));
+        qrc += "<file>" + name.toLatin1() + "</file>\n";
+    }
+    qrc += "</qresource></RCC>\n";
+    QFile qrcFile(dir.filePath(QLatin1String("many.qrc")));
+    QVERIFY(qrcFile.open(QIODevice::WriteOnly));
+    qrcFile.write(qrc);
+    qrcFile.close();
+
+    const QStringList compressionOptions[] = { { "-no-compress" }, { "-compress", "9" } };
+    for (const QStringList &compression : compressionOptions) {
+        const QString rccFileName = dir.filePath(QLatin1String("many.rcc"));
+        QProcess process;
+        process.setWorkingDirectory(dir.path());
+        process.start(m_rcc, QStringList{ "-binary" } + compression
+                                     + QStringList{ "-o", rccFileName, qrcFile.fileName() });
+        QVERIFY2(process.waitForStarted(), msgProcessStartFailed(process).constData());
+        if (!process.waitForFinished()) {
+            process.kill();
+            QFAIL(msgProcessTimeout(process).constData());
+        }
+        QVERIFY2(process.exitStatus() == QProcess::NormalExit,
+                 msgProcessCrashed(process).constData());
+        QVERIFY2(process.exitCode() == 0,
+                 msgProcessFailed(process).constData());
+
+        const QString rootPrefix = QLatin1String("/many_files/");
+        QVERIFY(QResource::registerResource(rccFileName, rootPrefix));
+        const auto resource = [&rootPrefix](int i) {
+            return QResource(QLatin1Char(':') + rootPrefix + QString::fromLatin1("file%1.txt").arg(i));
+        };
+        for (int i = 0; i < Count; ++i) {
+            QVERIFY(resource(i).isValid());
+            QCOMPARE(resource(i).uncompressedData(), QByteArray::number(i % Distinct).repeated(50));
+            // stored once
+            if (i >= Distinct)
+                QCOMPARE(resource(i).data(), resource(i % Distinct).data());
+        }
+        QVERIFY(QResource::unregisterResource(rccFileName, rootPrefix));
+    }
+}
+
+void tst_rcc::zstdDictionary()
+{
+#if !QT_CONFIG(zstd)
+    QSKIP("Zstandard support is not compiled in");
+#else
+    // many small files that look alike, as a dictionary is meant for
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), qPrintable(dir.errorString()));
+    QByteArray qrc = "<RCC><qresource prefix=\"/\">\n";
+    QStringMap files;
+    for (int i = 0; i < 500; ++i) {
+        const QString name = QString::fromLatin1("icon%1.svg").arg(i);
+        const QByteArray content = "<svg xmlns=\"http://www.w3.org/2000/svg\" width=\"24\" height=\"24\""
+                                   " viewBox=\"0 0 24 24\"><path fill=\"#" + QByteArray::number(i * 7919 % 0xffffff, 16)
+                + "\" d=\"M" + QByteArray::number(i % 24) + " 2l10 10-10 10L2 12z\"/>"
+                "<circle cx=\"12\" cy=\"12\" r=\"" + QByteArray::number(i % 11) + "\" stroke=\"currentColor\"/></svg>\n";
+        QFile file(dir.filePath(name));
+        QVERIFY(file.open(QIODevice::WriteOnly));
+        file.write(content);
+        qrc += "<file compress-algo=\"zstd\" threshold=\"1\">" + name.toLatin1() + "</file>\n";
+        files.insert(name, QString::fromLatin1(content));
+    }
+    qrc += "</qresource></RCC>\n";
+    QFile qrcFile(dir.filePath(QLatin1String("icons.qrc")));
+    QVERIFY(qrcFile.open(QIODevice::WriteOnly));
+    qrcFile.write(qrc);
+    qrcFile.close();
+
+    const QString rccFileName = dir.filePath(QLatin1String("icons.rcc"));
+    QProcess process;
+    process.setWorkingDirectory(dir.path());
+    process.start(m_rcc, { "-binary", "--format-version", "4", "--zstd-dictionary", "--verbose",
+                           "-o", rccFileName, qrcFile.fileName() });
+    QVERIFY2(process.waitForStarted(), msgProcessStartFailed(process).constData());
+    if (!process.waitForFinished()) {
+        process.kill();
+        QFAIL(msgProcessTimeout(process).constData());
+    }
+    // the msgProcess*() helpers would consume the output checked below
+    const QByteArray errorOutput = process.readAllStandardError();
+    QVERIFY2(process.exitStatus() == QProcess::NormalExit, errorOutput.constData());
+    QVERIFY2(process.exitCode() == 0, errorOutput.constData());
+    QVERIFY(errorOutput.contains("compressed using zstd with dictionary"));
+
+    const QString rootPrefix = QLatin1String("/zstd_dictionary/");
+    QVERIFY(QResource::registerResource(rccFileName, rootPrefix));
+    for (auto it = files.cbegin(); it != files.cend(); ++it) {
+        QResource resource(QLatin1Char(':') + rootPrefix + it.key());
+        QVERIFY(resource.isValid());
+        QCOMPARE(resource.compressionAlgorithm(), QResource::ZstdCompression);
+        QCOMPARE(QString::fromLatin1(resource.uncompressedData()), it.value());
+    }
+    QVERIFY(QResource::unregisterResource(rccFileName, rootPrefix));
+
+    // a format that cannot store the dictionary is refused
+    process.start(m_rcc, { "-binary", "--zstd-dictionary", "-o", rccFileName, qrcFile.fileName() });
+    QVERIFY2(process.waitForStarted(), msgProcessStartFailed(process).constData());
+    QVERIFY(process.waitForFinished());
+    QVERIFY(process.exitCode() != 0);
+#endif
+}
+
 void tst_rcc::cleanupTestCase()
 {
     QDir dataDir(m_dataPath + QLatin1String("/binary"));
@@ -0,0 +1,157 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QTest>
+
+#include <QDir>
+#include <QDirListing>
+#include <QFile>
+#include <QFileSystemWatcher>
+#include <QTemporaryDir>
+
+#include <QtCore/private/qrecursivefilesystemwatcher_p.h>
+
+using namespace std::chrono_literals;
+using namespace Qt::StringLiterals;
+
+Q_DECLARE_METATYPE(QRecursiveFileSystemWatcher::Backend)
+
+class tst_QFileSystemWatcher : public QObject
+{
+    Q_OBJECT
+
+private:
+    // Creates \a count directories in 100 per level
+    static bool createTree(const QString &root, int count);
+
+private slots:
+    void addPath_data();
+    void addPath();
+    void addPathsToQFileSystemWatcher_data();
+    void addPathsToQFileSystemWatcher();
+    void bulkChanges_data();
+    void bulkChanges();
+};
+
+bool tst_QFileSystemWatcher::createTree(const QString &root, int count)
+{
+    QDir dir(root);
+    for (int i = 0; i < count; ++i) {
+        const QString path = i < 100 ? u"%1"_s.arg(i) : u"%1/%2"_s.arg(i % 100).arg(i / 100);
+        if (!dir.mkdir(path))
+            return false;
+    }
+    return true;
+}
+
+void tst_QFileSystemWatcher::addPath_data()
+{
+    using Backend = QRecursiveFileSystemWatcher::Backend;
+    QTest::addColumn<Backend>("backend");
+    QTest::addColumn<int>("count");
+
+    for (int count : { 1000, 10000, 100000 }) {
+        QTest::addRow("default-%d", count) << Backend::Fanotify << count;
+#ifdef Q_OS_LINUX
+        QTest::addRow("inotify-%d", count) << Backend::Inotify << count;
+#endif
+        if (count <= 10000)
+            QTest::addRow("generic-%d", count) << Backend::Generic << count;
+    }
+}
+
+void tst_QFileSystemWatcher::addPath()
+{
+    using Backend = QRecursiveFileSystemWatcher::Backend;
+    QFETCH(Backend, backend);
+    QFETCH(int, count);
+
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), qPrintable(dir.errorString()));
+    QVERIFY(createTree(dir.path(), count));
+
+    QBENCHMARK {
+        QRecursiveFileSystemWatcher watcher(backend);
+        QVERIFY(watcher.addPath(dir.path()));
+        if (watcher.backend() != Backend::Fanotify && watcher.watchCount() <= count)
+            QSKIP("Not enough inotify watches; raise fs.inotify.max_user_watches");
+    }
+}
+
+// For comparison: the same directories, watched one by one
+void tst_QFileSystemWatcher::addPathsToQFileSystemWatcher_data()
+{
+    QTest::addColumn<int>("count");
+    for (int count : { 1000, 10000 })
+        QTest::addRow("%d", count) << count;
+}
+
+void tst_QFileSystemWatcher::addPathsToQFileSystemWatcher()
+{
+    QFETCH(int, count);
+
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), qPrintable(dir.errorString()));
+    QVERIFY(createTree(dir.path(), count));
+
+    QBENCHMARK {
+        QStringList paths = { dir.path() };
+        for (const auto &entry : QDirListing(dir.path(), QDirListing::IteratorFlag::Recursive
+                                                         | QDirListing::IteratorFlag::DirsOnly)) {
+            paths.append(entry.filePath());
+        }
+        QFileSystemWatcher watcher;
+        QVERIFY(watcher.addPaths(paths).isEmpty());
+    }
+}
+
+void tst_QFileSystemWatcher::bulkChanges_data()
+{
+    using Backend = QRecursiveFileSystemWatcher::Backend;
+    QTest::addColumn<Backend>("backend");
+    QTest::newRow("default") << Backend::Fanotify;
+#ifdef Q_OS_LINUX
+    QTest::newRow("inotify") << Backend::Inotify;
+#endif
+}
+
+// How long it takes until 1000 new files are reported
+void tst_QFileSystemWatcher::bulkChanges()
+{
+    using Backend = QRecursiveFileSystemWatcher::Backend;
+    QFETCH(Backend, backend);
+    constexpr int Count = 1000;
+
+    QTemporaryDir dir;
+    QVERIFY2(dir.isValid(), qPrintable(dir.errorString()));
+    QVERIFY(createTree(dir.path(), 1000));
+
+    QRecursiveFileSystemWatcher watcher(backend);
+    watcher.setInterval(10ms);
+    QVERIFY(watcher.addPath(dir.path()));
+
+    qsizetype reported = 0;
+    int batches = 0;
+    connect(&watcher, &QRecursiveFileSystemWatcher::pathsChanged,
+            this, [&](const QStringList &paths) {
+        ++batches;
+        reported += paths.size();
+    });
+
+    int round = 0;
+    QBENCHMARK {
+        reported = 0;
+        batches = 0;
+        for (int i = 0; i < Count; ++i) {
+            QFile file(dir.filePath(u"%1/%2/file%3"_s.arg(i % 100).arg(i / 100 % 9 + 1).arg(round)));
+            QVERIFY(file.open(QIODevice::WriteOnly));
+        }
+        ++round;
+        QTRY_VERIFY(reported >= Count);
+    }
+    qDebug("%d batches", batches);
+}
+
+QTEST_MAIN(tst_QFileSystemWatcher)
+
+#include "tst_bench_qfilesystemwatcher.moc"
@@ -0,0 +1,74 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QTest>
+
+#include <QFile>
+#include <QResource>
+
+using namespace Qt::StringLiterals;
+
+class tst_QResource : public QObject
+{
+    Q_OBJECT
+
+    QStringList paths;
+
+private slots:
+    void initTestCase();
+    void registerAndLookUp_data();
+    void registerAndLookUp();
+    void lookUp_data();
+    void lookUp();
+};
+
+void tst_QResource::initTestCase()
+{
+    // must match CMakeLists.txt
+    for (int dir = 0; dir < 100; ++dir) {
+        for (int file = 0; file < 200; ++file)
+            paths.append(u":/bench/dir%1/file%2.txt"_s.arg(dir).arg(file));
+    }
+}
+
+void tst_QResource::registerAndLookUp_data()
+{
+    QTest::addColumn<QString>("rccFile");
+    QTest::newRow("tree") << QStringLiteral(RESOURCE_DIR "/many_v3.rcc");
+    QTest::newRow("index") << QStringLiteral(RESOURCE_DIR "/many_v4.rcc");
+}
+
+// What an application does at startup: register its resources, then open them
+void tst_QResource::registerAndLookUp()
+{
+    QFETCH(QString, rccFile);
+    QVERIFY(QFile::exists(rccFile));
+
+    QBENCHMARK {
+        QVERIFY(QResource::registerResource(rccFile, u"/bench"_s));
+        for (const QString &path : std::as_const(paths))
+            QVERIFY(QResource(path).isValid());
+        QVERIFY(QResource::unregisterResource(rccFile, u"/bench"_s));
+    }
+}
+
+void tst_QResource::lookUp_data()
+{
+    registerAndLookUp_data();
+}
+
+void tst_QResource::lookUp()
+{
+    QFETCH(QString, rccFile);
+    QVERIFY(QResource::registerResource(rccFile, u"/bench"_s));
+
+    QBENCHMARK {
+        for (const QString &path : std::as_const(paths))
+            QVERIFY(QResource(path).isValid());
+    }
+    QVERIFY(QResource::unregisterResource(rccFile, u"/bench"_s));
+}
+
+QTEST_MAIN(tst_QResource)
+
+#include "tst_bench_qresource.moc"
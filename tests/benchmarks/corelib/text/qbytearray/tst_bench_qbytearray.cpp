@@ -34,6 +34,15 @@ private slots:
 
     void operator_assign_char();
     void operator_assign_char_data();
+
+    void toBase64_data();
+    void toBase64();
+    void fromBase64_data() { toBase64_data(); }
+    void fromBase64();
+    void toHex_data();
+    void toHex();
+    void fromHex_data() { toHex_data(); }
+    void fromHex();
 };
 
 void tst_QByteArray::initTestCase()
@@ -388,6 +397,98 @@ void tst_QByteArray::operator_assign_char_data()
     QTest::newRow("length: 1'000") << data;
 }
 
+static QByteArray binaryData(qsizetype size)
+{
+    QByteArray data(size, Qt::Uninitialized);
+    for (qsizetype i = 0; i < size; ++i)
+        data[i] = char(i * 37 + (i >> 8));
+    return data;
+}
+
+void tst_QByteArray::toBase64_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<QByteArray::Base64Options>("options");
+
+    const struct {
+        const char *name;
+        QByteArray::Base64Options options;
+    } optionSets[] = {
+        { "base64", QByteArray::Base64Encoding },
+        { "base64url", QByteArray::Base64UrlEncoding },
+        { "base64url-omit", QByteArray::Base64UrlEncoding | QByteArray::OmitTrailingEquals },
+        { "base64-abort", QByteArray::Base64Encoding | QByteArray::AbortOnBase64DecodingErrors },
+    };
+    for (qsizetype size : { 64, 4096, 1024 * 1024 }) {
+        const QByteArray data = binaryData(size);
+        for (const auto &set : optionSets)
+            QTest::addRow("%s-%lld", set.name, qlonglong(size)) << data << set.options;
+    }
+}
+
+void tst_QByteArray::toBase64()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(QByteArray::Base64Options, options);
+
+    QByteArray encoded;
+    QBENCHMARK {
+        encoded = data.toBase64(options);
+    }
+    QCOMPARE(QByteArray::fromBase64(encoded, options), data);
+}
+
+void tst_QByteArray::fromBase64()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(QByteArray::Base64Options, options);
+
+    const QByteArray encoded = data.toBase64(options);
+    QByteArray::FromBase64Result decoded;
+    QBENCHMARK {
+        decoded = QByteArray::fromBase64Encoding(encoded, options);
+    }
+    QCOMPARE(decoded.decodingStatus, QByteArray::Base64DecodingStatus::Ok);
+    QCOMPARE(decoded.decoded, data);
+}
+
+void tst_QByteArray::toHex_data()
+{
+    QTest::addColumn<QByteArray>("data");
+    QTest::addColumn<char>("separator");
+
+    for (qsizetype size : { 64, 4096, 1024 * 1024 }) {
+        const QByteArray data = binaryData(size);
+        QTest::addRow("plain-%lld", qlonglong(size)) << data << '\0';
+        QTest::addRow("separator-%lld", qlonglong(size)) << data << ':';
+    }
+}
+
+void tst_QByteArray::toHex()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(char, separator);
+
+    QByteArray encoded;
+    QBENCHMARK {
+        encoded = data.toHex(separator);
+    }
+    QCOMPARE(QByteArray::fromHex(encoded), data);
+}
+
+void tst_QByteArray::fromHex()
+{
+    QFETCH(QByteArray, data);
+    QFETCH(char, separator);
+
+    const QByteArray encoded = data.toHex(separator);
+    QByteArray decoded;
+    QBENCHMARK {
+        decoded = QByteArray::fromHex(encoded);
+    }
+    QCOMPARE(decoded, data);
+}
+
 QTEST_MAIN(tst_QByteArray)
 
 #include "tst_bench_qbytearray.moc"
@@ -31,6 +31,7 @@ private Q_SLOTS:
     void toUpper_QLocale_2();
     void toUpper_QString();
     void number_QString();
+    void number_double();
     void toLongLong_data();
     void toLongLong();
     void toULongLong_data();
@@ -370,6 +371,14 @@ void tst_QLocale::number_QString()
     }
 }
 
+void tst_QLocale::number_double()
+{
+    QString s;
+    QBENCHMARK {
+        s = QString::number(1234.5678, 'g', QLocale::FloatingPointShortest);
+    }
+}
+
 template <typename Integer>
 void toWholeCommon_data()
 {
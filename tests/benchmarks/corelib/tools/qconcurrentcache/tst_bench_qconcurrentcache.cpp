@@ -0,0 +1,99 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QTest>
+#include <QCache>
+#include <QMutex>
+
+#include <QtCore/private/qconcurrentcache_p.h>
+
+#include <thread>
+#include <vector>
+
+// A QCache shared between threads the way it has to be done without
+// QConcurrentCache
+struct MutexCache
+{
+    explicit MutexCache(qsizetype maxCost) : cache(maxCost) {}
+
+    QSharedPointer<QByteArray> object(int key) const
+    {
+        QMutexLocker locker(&mutex);
+        if (auto o = cache.object(key))
+            return *o;
+        return {};
+    }
+    void insert(int key, QByteArray *value)
+    {
+        QMutexLocker locker(&mutex);
+        cache.insert(key, new QSharedPointer<QByteArray>(value));
+    }
+
+    mutable QMutex mutex;
+    QCache<int, QSharedPointer<QByteArray>> cache;
+};
+
+struct ConcurrentCache : QConcurrentCache<int, QByteArray>
+{
+    using QConcurrentCache::QConcurrentCache;
+    void insert(int key, QByteArray *value) { QConcurrentCache::insert(key, value); }
+};
+
+class tst_QConcurrentCache : public QObject
+{
+    Q_OBJECT
+private slots:
+    void lookup_data();
+    void lookup_mutexCache() { lookup<MutexCache>(); }
+    void lookup_concurrentCache() { lookup<ConcurrentCache>(); }
+
+private:
+    template <typename Cache> void lookup();
+};
+
+static constexpr int KeyCount = 10000;
+static constexpr int LookupsPerThread = 200000;
+
+void tst_QConcurrentCache::lookup_data()
+{
+    QTest::addColumn<int>("threadCount");
+    QTest::addColumn<int>("capacity");
+
+    const int maxThreads = qMax(std::thread::hardware_concurrency(), 1u);
+    for (int threads = 1; threads <= qMax(maxThreads, 8); threads *= 2) {
+        // all hits, and a cache that only holds 90% of the keys
+        QTest::addRow("%d-threads-hits", threads) << threads << KeyCount;
+        QTest::addRow("%d-threads-90%%", threads) << threads << KeyCount * 9 / 10;
+    }
+}
+
+template <typename Cache>
+void tst_QConcurrentCache::lookup()
+{
+    QFETCH(int, threadCount);
+    QFETCH(int, capacity);
+
+    Cache cache(capacity);
+    for (int i = 0; i < KeyCount; ++i)
+        cache.insert(i, new QByteArray(32, char(i)));
+
+    QBENCHMARK {
+        std::vector<std::thread> threads;
+        for (int t = 0; t < threadCount; ++t) {
+            threads.emplace_back([&cache, t] {
+                uint key = uint(t) * 7919;
+                for (int i = 0; i < LookupsPerThread; ++i) {
+                    key = (key * 1103515245 + 12345) % KeyCount;
+                    if (!cache.object(int(key)))
+                        cache.insert(int(key), new QByteArray(32, char(key)));
+                }
+            });
+        }
+        for (auto &thread : threads)
+            thread.join();
+    }
+}
+
+QTEST_MAIN(tst_QConcurrentCache)
+
+#include "tst_bench_qconcurrentcache.moc"
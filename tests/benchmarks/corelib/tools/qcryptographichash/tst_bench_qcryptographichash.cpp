@@ -43,7 +43,7 @@ private Q_SLOTS:
     void hmac_setKey();
 };
 
-const int MaxBlockSize = 65536;
+const int MaxBlockSize = 1024 * 1024;
 
 static void for_each_algorithm(qxp::function_ref<void(QCryptographicHash::Algorithm, const char*) const> f)
 {
@@ -73,9 +73,9 @@ void tst_QCryptographicHash::hash_data()
     QTest::addColumn<Algorithm>("algo");
     QTest::addColumn<QByteArray>("data");
 
-    static const int datasizes[] = { 0, 1, 64, 65, 512, 4095, 4096, 4097, 65536 };
+    static const int datasizes[] = { 0, 1, 64, 65, 512, 4095, 4096, 4097, 65536, 1024 * 1024 };
     for (uint i = 0; i < sizeof(datasizes)/sizeof(datasizes[0]); ++i) {
-        Q_ASSERT(datasizes[i] < MaxBlockSize);
+        Q_ASSERT(datasizes[i] <= MaxBlockSize);
         QByteArray data = QByteArray::fromRawData(blockOfData.constData(), datasizes[i]);
 
         for_each_algorithm([&] (Algorithm algo, const char *name) {
@@ -0,0 +1,122 @@
+// Copyright (C) 2025 The Qt Company Ltd.
+// SPDX-License-Identifier: LicenseRef-Qt-Commercial OR GPL-3.0-only
+
+#include <QMap>
+#include <QString>
+#include <QTest>
+
+#include <private/qflatmap_p.h>
+
+#include <algorithm>
+#include <random>
+
+// Compares QFlatMap with QMap for read-mostly use: building the map once from
+// unsorted data, then looking up keys in it.
+
+class tst_QFlatMap : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void construct_int_data() { sizes(); }
+    void construct_int() { construct<QFlatMap<int, int>>(); }
+    void construct_int_qmap_data() { sizes(); }
+    void construct_int_qmap() { construct<QMap<int, int>>(); }
+
+    void lookup_int_data() { sizes(); }
+    void lookup_int() { lookupInt<QFlatMap<int, int>>(); }
+    void lookup_int_qmap_data() { sizes(); }
+    void lookup_int_qmap() { lookupInt<QMap<int, int>>(); }
+
+    void lookup_string_data() { sizes(); }
+    void lookup_string() { lookupString<QFlatMap<QString, int>>(); }
+    void lookup_string_qmap_data() { sizes(); }
+    void lookup_string_qmap() { lookupString<QMap<QString, int>>(); }
+
+private:
+    void sizes();
+    template <typename Map> void construct();
+    template <typename Map> void lookupInt();
+    template <typename Map> void lookupString();
+};
+
+// a fixed number of lookups, so that the results can be compared between sizes
+constexpr int Lookups = 100000;
+
+static QList<int> shuffledKeys(int size)
+{
+    QList<int> keys(size);
+    for (int i = 0; i < size; ++i)
+        keys[i] = i * 2; // leave gaps, so odd keys are misses
+    std::shuffle(keys.begin(), keys.end(), std::mt19937(size));
+    return keys;
+}
+
+template <typename Map, typename Key>
+static Map buildMap(const QList<Key> &keys, const QList<int> &values)
+{
+    if constexpr (std::is_same_v<Map, QMap<Key, int>>) {
+        Map map;
+        for (qsizetype i = 0; i < keys.size(); ++i)
+            map.insert(keys.at(i), values.at(i));
+        return map;
+    } else {
+        // inserting one by one is quadratic for flat maps
+        return Map(keys, values);
+    }
+}
+
+void tst_QFlatMap::sizes()
+{
+    QTest::addColumn<int>("size");
+    QTest::newRow("100") << 100;
+    QTest::newRow("10K") << 10'000;
+    QTest::newRow("1M") << 1'000'000;
+}
+
+template <typename Map> void tst_QFlatMap::construct()
+{
+    QFETCH(int, size);
+    const QList<int> keys = shuffledKeys(size);
+
+    QBENCHMARK {
+        const Map map = buildMap<Map>(keys, keys);
+        QCOMPARE(map.size(), qsizetype(size));
+    }
+}
+
+template <typename Map> void tst_QFlatMap::lookupInt()
+{
+    QFETCH(int, size);
+    const QList<int> keys = shuffledKeys(size);
+    const Map map = buildMap<Map>(keys, keys);
+
+    qint64 sum = 0;
+    QBENCHMARK {
+        for (int i = 0; i < Lookups; ++i)
+            sum += map.value(keys.at(i % size), -1);
+    }
+    QCOMPARE_GT(sum, 0);
+}
+
+template <typename Map> void tst_QFlatMap::lookupString()
+{
+    QFETCH(int, size);
+    const QList<int> values = shuffledKeys(size);
+    QList<QString> keys;
+    keys.reserve(size);
+    for (int value : values)
+        keys.append(QString::number(value));
+    const Map map = buildMap<Map>(keys, values);
+
+    qint64 sum = 0;
+    QBENCHMARK {
+        for (int i = 0; i < Lookups; ++i)
+            sum += map.value(keys.at(i % size), -1);
+    }
+    QCOMPARE_GT(sum, 0);
+}
+
+QTEST_MAIN(tst_QFlatMap)
+
+#include "tst_bench_qflatmap.moc"
@@ -13,9 +13,19 @@
 #include <QUuid>
 #include <QTest>
 
+#include <unordered_map>
+
 static constexpr quint64 RandomSeed32 = 1045982819;
 static constexpr quint64 RandomSeed64 = QtPrivate::QHashCombine{}(RandomSeed32, RandomSeed32);
 
+// std::hash<quint64> is the identity; giving std::unordered_map the hash
+// QHash uses makes the comparison one of the table layouts alone
+struct QtHasher
+{
+    size_t operator()(quint64 key) const noexcept { return qHash(key, QHashSeed::globalSeed()); }
+};
+using StdHash = std::unordered_map<quint64, quint64, QtHasher>;
+
 class tst_QHash : public QObject
 {
     Q_OBJECT
@@ -49,8 +59,29 @@ private slots:
     void hashing_nonzero_qlatin1string_data() { data(); }
     void hashing_nonzero_qlatin1string() { hashing_nonzero_template<OwningLatin1String>(); }
 
+    void lookupHit_data() { sizeData(); }
+    void lookupHit() { lookup_template<QHash<quint64, quint64>>(true); }
+    void lookupHit_std_data() { sizeData(); }
+    void lookupHit_std() { lookup_template<StdHash>(true); }
+    void lookupMiss_data() { sizeData(); }
+    void lookupMiss() { lookup_template<QHash<quint64, quint64>>(false); }
+    void lookupMiss_std_data() { sizeData(); }
+    void lookupMiss_std() { lookup_template<StdHash>(false); }
+    void insert_data() { sizeData(); }
+    void insert() { insert_template<QHash<quint64, quint64>>(); }
+    void insert_std_data() { sizeData(); }
+    void insert_std() { insert_template<StdHash>(); }
+    void erase_data() { sizeData(); }
+    void erase() { erase_template<QHash<quint64, quint64>>(); }
+    void erase_std_data() { sizeData(); }
+    void erase_std() { erase_template<StdHash>(); }
+
 private:
     void data();
+    void sizeData();
+    template <typename Hash> void lookup_template(bool hit);
+    template <typename Hash> void insert_template();
+    template <typename Hash> void erase_template();
     template <typename String> void qhash_template();
     template <typename String, size_t Seed = 0> void hashing_template();
     template <typename String> void hashing_nonzero_template()
@@ -176,6 +207,85 @@ template <typename String, size_t Seed> void tst_QHash::hashing_template()
     }
 }
 
+///////////////////// lookup, insert and erase /////////////////////
+
+// The keys are spread over the whole 64-bit range, but contain long runs of
+// equal bits, which gives weaker hash functions a hard time.
+static quint64 keyAt(qsizetype i)
+{
+    const quint64 k = quint64(i);
+    return (k << 40) ^ (k << 20) ^ k;
+}
+
+template <typename Iterator> static quint64 valueOf(Iterator it)
+{
+    if constexpr (std::is_same_v<Iterator, QHash<quint64, quint64>::iterator>)
+        return it.value();
+    else
+        return it->second;
+}
+
+void tst_QHash::sizeData()
+{
+    QTest::addColumn<qsizetype>("size");
+    QTest::newRow("1K") << qsizetype(1'000);
+    QTest::newRow("100K") << qsizetype(100'000);
+    // The larger sizes take minutes to fill and need hundreds of MB (10M) or
+    // several GB (100M) of memory, so they only run on request.
+    if (qEnvironmentVariableIsSet("QTEST_QHASH_LARGE"))
+        QTest::newRow("10M") << qsizetype(10'000'000);
+    if (qEnvironmentVariableIsSet("QTEST_QHASH_HUGE"))
+        QTest::newRow("100M") << qsizetype(100'000'000);
+}
+
+template <typename Hash> void tst_QHash::lookup_template(bool hit)
+{
+    QFETCH(qsizetype, size);
+    Hash hash;
+    hash.reserve(size);
+    for (qsizetype i = 0; i < size; ++i)
+        hash.emplace(keyAt(i), quint64(i));
+
+    // look up a fixed number of keys, so that the results can be compared
+    // between sizes
+    constexpr qsizetype Lookups = 1'000'000;
+    const qsizetype offset = hit ? 0 : size;
+    quint64 sum = 0;
+    QBENCHMARK {
+        for (qsizetype i = 0; i < Lookups; ++i) {
+            const auto it = hash.find(keyAt(offset + (i * 7919) % size));
+            if (it != hash.end())
+                sum += valueOf(it);
+        }
+    }
+    QVERIFY(hit ? sum != 0 : sum == 0);
+}
+
+template <typename Hash> void tst_QHash::insert_template()
+{
+    QFETCH(qsizetype, size);
+    QBENCHMARK {
+        Hash hash;
+        for (qsizetype i = 0; i < size; ++i)
+            hash.emplace(keyAt(i), quint64(i));
+        QCOMPARE(qsizetype(hash.size()), size);
+    }
+}
+
+template <typename Hash> void tst_QHash::erase_template()
+{
+    QFETCH(qsizetype, size);
+    Hash hash;
+    for (qsizetype i = 0; i < size; ++i)
+        hash.emplace(keyAt(i), quint64(i));
+
+    QBENCHMARK_ONCE {
+        for (qsizetype i = 0; i < size; ++i)
+            hash.erase(hash.find(keyAt(i)));
+    }
+    QVERIFY(hash.empty());
+}
+
 QTEST_MAIN(tst_QHash)
 
 #include "tst_bench_qhash.moc"
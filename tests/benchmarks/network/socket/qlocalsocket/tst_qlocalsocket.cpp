@@ -25,6 +25,8 @@ private slots:
     void pingPong();
     void dataExchange_data();
     void dataExchange();
+    void readAllFrames_data();
+    void readAllFrames();
 };
 
 class ServerThread : public QThread
@@ -209,6 +211,81 @@ void tst_QLocalSocket::dataExchange()
     serverThread.wait();
 }
 
+class FrameServerThread : public QThread
+{
+public:
+    QSemaphore running;
+
+    explicit FrameServerThread(int frameSize) : frame(frameSize, 'f') { }
+
+    void run() override
+    {
+        QLocalServer server;
+
+        connect(&server, &QLocalServer::newConnection, [this, &server]() {
+            auto socket = server.nextPendingConnection();
+
+            // every byte received asks for another frame
+            connect(socket, &QLocalSocket::readyRead, [this, socket]() {
+                for (qint64 requests = socket->readAll().size(); requests > 0; --requests)
+                    socket->write(this->frame);
+            });
+        });
+
+        QVERIFY2(server.listen("foo"), qPrintable(server.errorString()));
+
+        running.release();
+        exec();
+    }
+
+protected:
+    QByteArray frame;
+};
+
+void tst_QLocalSocket::readAllFrames_data()
+{
+    QTest::addColumn<int>("frameSize");
+    for (int frameSize : {64 * 1024, 1024 * 1024, 16 * 1024 * 1024, 64 * 1024 * 1024})
+        QTest::addRow("frame size: %d", frameSize) << frameSize;
+}
+
+// Measures readAll() alone, for frames that have arrived completely
+void tst_QLocalSocket::readAllFrames()
+{
+    QFETCH(int, frameSize);
+
+    const qint64 bytesToTransfer = 1024 * 1024 * 1024;
+    const int frames = int(qMax(bytesToTransfer / frameSize, qint64(4)));
+
+    FrameServerThread serverThread(frameSize);
+    serverThread.start();
+    // Wait for server to start.
+    QVERIFY(serverThread.running.tryAcquire(1, 3000));
+
+    QLocalSocket socket;
+    socket.connectToServer("foo");
+    QVERIFY(socket.waitForConnected());
+
+    QElapsedTimer timer;
+    qint64 elapsed = 0;
+    for (int i = 0; i < frames; ++i) {
+        QCOMPARE(socket.write("x", 1), 1);
+        QVERIFY(socket.waitForBytesWritten());
+        while (socket.bytesAvailable() < frameSize)
+            QVERIFY(socket.waitForReadyRead());
+
+        timer.start();
+        const QByteArray frame = socket.readAll();
+        elapsed += timer.nsecsElapsed();
+        QCOMPARE(frame.size(), frameSize);
+    }
+
+    qDebug("readAll(): %.1f MB/s", double(frames) * frameSize / 1.048576 / elapsed * 1000);
+    socket.disconnectFromServer();
+    serverThread.quit();
+    serverThread.wait();
+}
+
 QTEST_MAIN(tst_QLocalSocket)
 
 #include "tst_qlocalsocket.moc"